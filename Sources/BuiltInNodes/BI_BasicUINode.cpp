@@ -104,6 +104,11 @@ bool BasicUINode::RegisterFeature (const NodeFeaturePtr& newFeature)
 	return true;
 }
 
+bool BasicUINode::WriteFeatureSet (NE::OutputStream& outputStream) const
+{
+	return nodeFeatureSet.Write (outputStream) == NE::Stream::Status::NoError;
+}
+
 NUIE::EventHandlerResult BasicUINode::HandleMouseClick (NUIE::NodeUIEnvironment& env, const NUIE::ModifierKeys& modifierKeys, NUIE::MouseButton mouseButton, const NUIE::Point& position, NUIE::UINodeCommandInterface& commandInterface)
 {
 	return layout->HandleMouseClick (*this, env, modifierKeys, mouseButton, position, commandInterface);
@@ -35,6 +35,7 @@ protected:
 	virtual void						RegisterParameters (NUIE::NodeParameterList& parameterList) const override;
 	virtual void						RegisterCommands (NUIE::NodeCommandRegistrator& commandRegistrator) const override;
 	bool								RegisterFeature (const NodeFeaturePtr& newFeature);
+	bool								WriteFeatureSet (NE::OutputStream& outputStream) const;
 
 private:
 	virtual NUIE::EventHandlerResult	HandleMouseClick (NUIE::NodeUIEnvironment& env, const NUIE::ModifierKeys& modifierKeys, NUIE::MouseButton mouseButton, const NUIE::Point& position, NUIE::UINodeCommandInterface& commandInterface) override;
@@ -1,18 +1,29 @@
 #include "BI_BinaryOperationNodes.hpp"
 #include "NE_Localization.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_LazyListValues.hpp"
+#include "NE_Debug.hpp"
 #include "NUIE_NodeCommonParameters.hpp"
 
 #include <cmath>
+#include <algorithm>
 
 namespace BI
 {
 
+static const NE::SlotId ASlotId ("a");
+static const NE::SlotId BSlotId ("b");
+static const NE::SlotId ResultSlotId ("result");
+
 SERIALIZATION_INFO (BinaryOperationNode, 1);
 DYNAMIC_SERIALIZATION_INFO (AdditionNode, 1, "{1A72C230-3D90-42AD-835A-43306E641EA2}");
 DYNAMIC_SERIALIZATION_INFO (SubtractionNode, 1, "{80CACB59-C3E6-441B-B60C-37A6F2611FC2}");
 DYNAMIC_SERIALIZATION_INFO (MultiplicationNode, 1, "{75F39B99-8296-4D79-8BB7-418D55F93C25}");
 DYNAMIC_SERIALIZATION_INFO (DivisionNode, 1, "{652DDDFC-A441-40B1-87AC-0BED247F35E7}");
 
+// cross products above this size are calculated only when their items are accessed
+static const size_t MinLazyResultSize = 1 << 16;
+
 BinaryOperationNode::BinaryOperationNode () :
 	BinaryOperationNode (NE::LocString (), NUIE::Point ())
 {
@@ -31,24 +42,30 @@ BinaryOperationNode::~BinaryOperationNode ()
 
 void BinaryOperationNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("a"), NE::LocString (L"A"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("b"), NE::LocString (L"B"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("result"), NE::LocString (L"Result"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (ASlotId, NE::LocString (L"A"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (BSlotId, NE::LocString (L"B"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (ResultSlotId, NE::LocString (L"Result"))));
 	RegisterFeature (NodeFeaturePtr (new ValueCombinationFeature (NE::ValueCombinationMode::Longest)));
 }
 
 NE::ValueConstPtr BinaryOperationNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr aValue = EvaluateInputSlot (NE::SlotId ("a"), env);
-	NE::ValueConstPtr bValue = EvaluateInputSlot (NE::SlotId ("b"), env);
+	NE::ValueConstPtr aValue = EvaluateInputSlot (ASlotId, env);
+	NE::ValueConstPtr bValue = EvaluateInputSlot (BSlotId, env);
 	if (!NE::IsComplexType<NE::NumberValue> (aValue) || !NE::IsComplexType<NE::NumberValue> (bValue)) {
 		return nullptr;
 	}
 
 	if (NE::IsSingleValue (aValue) && NE::IsSingleValue (bValue)) {
 		return DoSingleOperation (aValue, bValue);
+	}
+
+	DoubleArray aArray;
+	DoubleArray bArray;
+	if (aArray.Set (aValue) && bArray.Set (bValue) && aArray.GetSize () > 0 && bArray.GetSize () > 0) {
+		return DoArrayOperation (aArray, bArray);
 	} else {
-		NE::ListValuePtr resultListValue (new NE::ListValue ());
+		NE::ListValuePtr resultListValue = NE::MakeValue<NE::ListValue> ();
 		std::shared_ptr<ValueCombinationFeature> valueCombination = GetValueCombinationFeature (this);
 		bool isValid = valueCombination->CombineValues ({ aValue, bValue }, [&] (const NE::ValueCombination& combination) {
 			NE::ValuePtr result = DoSingleOperation (combination.GetValue (0), combination.GetValue (1));
@@ -68,8 +85,8 @@ NE::ValueConstPtr BinaryOperationNode::Calculate (NE::EvaluationEnv& env) const
 void BinaryOperationNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
 	BasicUINode::RegisterParameters (parameterList);
-	NUIE::RegisterSlotDefaultValueNodeParameter<BinaryOperationNode, NE::DoubleValue> (parameterList, NE::SlotId ("a"), NE::LocString (L"A"), NUIE::ParameterType::Double);
-	NUIE::RegisterSlotDefaultValueNodeParameter<BinaryOperationNode, NE::DoubleValue> (parameterList, NE::SlotId ("b"), NE::LocString (L"B"), NUIE::ParameterType::Double);
+	NUIE::RegisterSlotDefaultValueNodeParameter<BinaryOperationNode, NE::DoubleValue> (parameterList, ASlotId, NE::LocString (L"A"), NUIE::ParameterType::Double);
+	NUIE::RegisterSlotDefaultValueNodeParameter<BinaryOperationNode, NE::DoubleValue> (parameterList, BSlotId, NE::LocString (L"B"), NUIE::ParameterType::Double);
 }
 
 bool BinaryOperationNode::IsForceCalculated () const
@@ -91,6 +108,12 @@ NE::Stream::Status BinaryOperationNode::Write (NE::OutputStream& outputStream) c
 	return outputStream.GetStatus ();
 }
 
+bool BinaryOperationNode::WriteMemoizationKey (NE::OutputStream& outputStream) const
+{
+	// the result depends only on the inputs and the features, the derived classes have no data
+	return WriteFeatureSet (outputStream);
+}
+
 NE::ValuePtr BinaryOperationNode::DoSingleOperation (const NE::ValueConstPtr& aValue, const NE::ValueConstPtr& bValue) const
 {
 	double aDouble = NE::NumberValue::ToDouble (aValue);
@@ -99,7 +122,92 @@ NE::ValuePtr BinaryOperationNode::DoSingleOperation (const NE::ValueConstPtr& aV
 	if (std::isnan (result) || std::isinf (result)) {
 		return nullptr;
 	}
-	return NE::ValuePtr (new NE::DoubleValue (result));
+	return NE::MakeValue<NE::DoubleValue> (result);
+}
+
+NE::ValuePtr BinaryOperationNode::DoArrayOperation (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	const double* a = aArray.GetData ();
+	const double* b = bArray.GetData ();
+	size_t aSize = aArray.GetSize ();
+	size_t bSize = bArray.GetSize ();
+	size_t minSize = std::min (aSize, bSize);
+
+	std::vector<double> result;
+	NE::ValueCombinationMode combinationMode = GetValueCombinationFeature (this)->GetValueCombinationMode ();
+	if (combinationMode == NE::ValueCombinationMode::Shortest) {
+		result.resize (minSize);
+		DoListOperation (a, 1, b, 1, result.data (), minSize);
+	} else if (combinationMode == NE::ValueCombinationMode::Longest) {
+		size_t maxSize = std::max (aSize, bSize);
+		result.resize (maxSize);
+		DoListOperation (a, 1, b, 1, result.data (), minSize);
+		if (aSize < bSize) {
+			DoListOperation (a + aSize - 1, 0, b + minSize, 1, result.data () + minSize, maxSize - minSize);
+		} else if (bSize < aSize) {
+			DoListOperation (a + minSize, 1, b + bSize - 1, 0, result.data () + minSize, maxSize - minSize);
+		}
+	} else if (combinationMode == NE::ValueCombinationMode::CrossProduct) {
+		size_t resultSize = 0;
+		if (!NE::GetCombinationCount (combinationMode, { aSize, bSize }, resultSize)) {
+			return nullptr;
+		}
+		if (resultSize >= MinLazyResultSize && GetArrayOperation () != nullptr && AreResultsFinite (aArray, bArray)) {
+			return DoLazyArrayOperation (aArray, bArray);
+		}
+		result.resize (resultSize);
+		for (size_t i = 0; i < aSize; ++i) {
+			DoListOperation (a + i, 0, b, 1, result.data () + i * bSize, bSize);
+		}
+	} else {
+		DBGBREAK ();
+		return nullptr;
+	}
+
+	if (!IsFiniteArray (result.data (), result.size ())) {
+		return nullptr;
+	}
+	return NE::MakeValue<NE::DoubleListValue> (std::move (result));
+}
+
+NE::ValuePtr BinaryOperationNode::DoLazyArrayOperation (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	// the items are calculated from copies of the inputs, so the list doesn't depend on the node
+	std::shared_ptr<const NE::DoubleListValue> aValue = NE::MakeValue<NE::DoubleListValue> (std::vector<double> (aArray.GetData (), aArray.GetData () + aArray.GetSize ()));
+	std::shared_ptr<const NE::DoubleListValue> bValue = NE::MakeValue<NE::DoubleListValue> (std::vector<double> (bArray.GetData (), bArray.GetData () + bArray.GetSize ()));
+	BinaryArrayOperation operation = GetArrayOperation ();
+	return NE::MakeValue<NE::CombinationListValue> (NE::ValueCombinationMode::CrossProduct, std::vector<NE::ValueConstPtr> { aValue, bValue },
+		[operation, aValue, bValue] (const NE::ValueCombination& combination) {
+			double result = 0.0;
+			double a = aValue->GetItem (combination.GetValueIndex (0));
+			double b = bValue->GetItem (combination.GetValueIndex (1));
+			operation (&a, 0, &b, 0, &result, 1);
+			return NE::MakeValue<NE::DoubleValue> (result);
+		},
+		true, 0
+	);
+}
+
+void BinaryOperationNode::DoListOperation (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count) const
+{
+	BinaryArrayOperation operation = GetArrayOperation ();
+	if (operation != nullptr) {
+		operation (a, aStride, b, bStride, result, count);
+		return;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = DoOperation (a[i * aStride], b[i * bStride]);
+	}
+}
+
+BinaryArrayOperation BinaryOperationNode::GetArrayOperation () const
+{
+	return nullptr;
+}
+
+bool BinaryOperationNode::AreResultsFinite (const DoubleArray&, const DoubleArray&) const
+{
+	return false;
 }
 
 AdditionNode::AdditionNode () :
@@ -124,6 +232,16 @@ double AdditionNode::DoOperation (double a, double b) const
 	return a + b;
 }
 
+BinaryArrayOperation AdditionNode::GetArrayOperation () const
+{
+	return AddArrays;
+}
+
+bool AdditionNode::AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	return std::isfinite (GetMaxAbsValue (aArray) + GetMaxAbsValue (bArray));
+}
+
 SubtractionNode::SubtractionNode () :
 	BinaryOperationNode ()
 {
@@ -146,6 +264,16 @@ double SubtractionNode::DoOperation (double a, double b) const
 	return a - b;
 }
 
+BinaryArrayOperation SubtractionNode::GetArrayOperation () const
+{
+	return SubtractArrays;
+}
+
+bool SubtractionNode::AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	return std::isfinite (GetMaxAbsValue (aArray) + GetMaxAbsValue (bArray));
+}
+
 MultiplicationNode::MultiplicationNode () :
 	BinaryOperationNode ()
 {
@@ -168,6 +296,16 @@ double MultiplicationNode::DoOperation (double a, double b) const
 	return a * b;
 }
 
+BinaryArrayOperation MultiplicationNode::GetArrayOperation () const
+{
+	return MultiplyArrays;
+}
+
+bool MultiplicationNode::AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	return std::isfinite (GetMaxAbsValue (aArray) * GetMaxAbsValue (bArray));
+}
+
 DivisionNode::DivisionNode () :
 	BinaryOperationNode ()
 {
@@ -190,4 +328,15 @@ double DivisionNode::DoOperation (double a, double b) const
 	return a / b;
 }
 
+BinaryArrayOperation DivisionNode::GetArrayOperation () const
+{
+	return DivideArrays;
+}
+
+bool DivisionNode::AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const
+{
+	double bMinAbsValue = GetMinAbsValue (bArray);
+	return bMinAbsValue > 0.0 && std::isfinite (GetMaxAbsValue (aArray) / bMinAbsValue);
+}
+
 }
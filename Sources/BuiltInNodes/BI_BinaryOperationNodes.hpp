@@ -4,6 +4,7 @@
 #include "NE_SingleValues.hpp"
 #include "BI_BasicUINode.hpp"
 #include "BI_BuiltInFeatures.hpp"
+#include "BI_VectorizedOperations.hpp"
 
 namespace BI
 {
@@ -27,8 +28,14 @@ public:
 	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
 
 private:
-	NE::ValuePtr				DoSingleOperation (const NE::ValueConstPtr& aValue, const NE::ValueConstPtr& bValue) const;
-	virtual double				DoOperation (double a, double b) const = 0;
+	virtual bool					WriteMemoizationKey (NE::OutputStream& outputStream) const override;
+	NE::ValuePtr					DoSingleOperation (const NE::ValueConstPtr& aValue, const NE::ValueConstPtr& bValue) const;
+	NE::ValuePtr					DoArrayOperation (const DoubleArray& aArray, const DoubleArray& bArray) const;
+	NE::ValuePtr					DoLazyArrayOperation (const DoubleArray& aArray, const DoubleArray& bArray) const;
+	void							DoListOperation (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count) const;
+	virtual double					DoOperation (double a, double b) const = 0;
+	virtual BinaryArrayOperation	GetArrayOperation () const;
+	virtual bool					AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const;
 };
 
 class AdditionNode : public BinaryOperationNode
@@ -41,7 +48,9 @@ public:
 	virtual ~AdditionNode ();
 
 private:
-	virtual double DoOperation (double a, double b) const override;
+	virtual double					DoOperation (double a, double b) const override;
+	virtual BinaryArrayOperation	GetArrayOperation () const override;
+	virtual bool					AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const override;
 };
 
 class SubtractionNode : public BinaryOperationNode
@@ -54,7 +63,9 @@ public:
 	virtual ~SubtractionNode ();
 
 private:
-	virtual double DoOperation (double a, double b) const override;
+	virtual double					DoOperation (double a, double b) const override;
+	virtual BinaryArrayOperation	GetArrayOperation () const override;
+	virtual bool					AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const override;
 };
 
 class MultiplicationNode : public BinaryOperationNode
@@ -67,7 +78,9 @@ public:
 	virtual ~MultiplicationNode ();
 
 private:
-	virtual double DoOperation (double a, double b) const override;
+	virtual double					DoOperation (double a, double b) const override;
+	virtual BinaryArrayOperation	GetArrayOperation () const override;
+	virtual bool					AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const override;
 };
 
 class DivisionNode : public BinaryOperationNode
@@ -80,7 +93,9 @@ public:
 	virtual ~DivisionNode ();
 
 private:
-	virtual double DoOperation (double a, double b) const override;
+	virtual double					DoOperation (double a, double b) const override;
+	virtual BinaryArrayOperation	GetArrayOperation () const override;
+	virtual bool					AreResultsFinite (const DoubleArray& aArray, const DoubleArray& bArray) const override;
 };
 
 }
@@ -1,6 +1,7 @@
 #include "BI_InputUINodes.hpp"
 #include "BI_UINodePanels.hpp"
 #include "NE_Localization.hpp"
+#include "NE_TypedListValues.hpp"
 #include "NUIE_NodeParameters.hpp"
 #include "NUIE_NodeCommonParameters.hpp"
 #include "NUIE_NodeUIManager.hpp"
@@ -12,6 +13,13 @@
 namespace BI
 {
 
+static const NE::SlotId StartSlotId ("start");
+static const NE::SlotId StepSlotId ("step");
+static const NE::SlotId CountSlotId ("count");
+static const NE::SlotId EndSlotId ("end");
+static const NE::SlotId InSlotId ("in");
+static const NE::SlotId OutSlotId ("out");
+
 DYNAMIC_SERIALIZATION_INFO (BooleanNode, 1, "{72E14D86-E5DC-4AD6-A7E4-F60D47BFB114}");
 
 SERIALIZATION_INFO (NumericUpDownNode, 1);
@@ -102,7 +110,7 @@ BooleanNode::~BooleanNode ()
 
 void BooleanNode::Initialize ()
 {
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"Output"))));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"Output"))));
 }
 
 bool BooleanNode::IsForceCalculated () const
@@ -112,7 +120,7 @@ bool BooleanNode::IsForceCalculated () const
 
 NE::ValueConstPtr BooleanNode::Calculate (NE::EvaluationEnv&) const
 {
-	return NE::ValueConstPtr (new NE::BooleanValue (val));
+	return NE::MakeValue<NE::BooleanValue> (val);
 }
 
 void BooleanNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
@@ -236,7 +244,7 @@ NumericUpDownNode::~NumericUpDownNode ()
 
 void NumericUpDownNode::Initialize ()
 {
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"Output"))));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"Output"))));
 }
 
 bool NumericUpDownNode::IsForceCalculated () const
@@ -244,6 +252,11 @@ bool NumericUpDownNode::IsForceCalculated () const
 	return true;
 }
 
+bool NumericUpDownNode::IsValuePinned () const
+{
+	return true;
+}
+
 NE::Stream::Status NumericUpDownNode::Read (NE::InputStream& inputStream)
 {
 	NE::ObjectHeader header (inputStream);
@@ -279,7 +292,7 @@ IntegerUpDownNode::~IntegerUpDownNode ()
 
 NE::ValueConstPtr IntegerUpDownNode::Calculate (NE::EvaluationEnv&) const
 {
-	return NE::ValueConstPtr (new NE::IntValue (val));
+	return NE::MakeValue<NE::IntValue> (val);
 }
 
 void IntegerUpDownNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
@@ -402,7 +415,7 @@ DoubleUpDownNode::~DoubleUpDownNode ()
 
 NE::ValueConstPtr DoubleUpDownNode::Calculate (NE::EvaluationEnv&) const
 {
-	return NE::ValueConstPtr (new NE::DoubleValue (val));
+	return NE::MakeValue<NE::DoubleValue> (val);
 }
 
 void DoubleUpDownNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
@@ -559,17 +572,17 @@ IntegerIncrementedNode::~IntegerIncrementedNode ()
 
 void IntegerIncrementedNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("start"), NE::LocString (L"Start"), NE::ValuePtr (new NE::IntValue (0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("step"), NE::LocString (L"Step"), NE::ValuePtr (new NE::IntValue (1)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("count"), NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"List"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (StartSlotId, NE::LocString (L"Start"), NE::ValuePtr (new NE::IntValue (0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (StepSlotId, NE::LocString (L"Step"), NE::ValuePtr (new NE::IntValue (1)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (CountSlotId, NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"List"))));
 }
 
 NE::ValueConstPtr IntegerIncrementedNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr start = EvaluateInputSlot (NE::SlotId ("start"), env);
-	NE::ValueConstPtr step = EvaluateInputSlot (NE::SlotId ("step"), env);
-	NE::ValueConstPtr count = EvaluateInputSlot (NE::SlotId ("count"), env);
+	NE::ValueConstPtr start = EvaluateInputSlot (StartSlotId, env);
+	NE::ValueConstPtr step = EvaluateInputSlot (StepSlotId, env);
+	NE::ValueConstPtr count = EvaluateInputSlot (CountSlotId, env);
 	if (!NE::IsSingleType<NE::NumberValue> (start) || !NE::IsSingleType<NE::NumberValue> (step) || !NE::IsSingleType<NE::NumberValue> (count)) {
 		return nullptr;
 	}
@@ -581,9 +594,10 @@ NE::ValueConstPtr IntegerIncrementedNode::Calculate (NE::EvaluationEnv& env) con
 		return nullptr;
 	}
 
-	NE::ListValuePtr list (new NE::ListValue ());
+	NE::IntListValuePtr list = NE::MakeValue<NE::IntListValue> ();
+	list->Reserve (countNum);
 	for (int i = 0; i < countNum; ++i) {
-		list->Push (NE::ValuePtr (new NE::IntValue (startNum + i * stepNum)));
+		list->Push (startNum + i * stepNum);
 	}
 
 	return list;
@@ -592,9 +606,9 @@ NE::ValueConstPtr IntegerIncrementedNode::Calculate (NE::EvaluationEnv& env) con
 void IntegerIncrementedNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
 	BasicUINode::RegisterParameters (parameterList);
-	NUIE::RegisterSlotDefaultValueNodeParameter<IntegerIncrementedNode, NE::IntValue> (parameterList, NE::SlotId ("start"), NE::LocString (L"Start"), NUIE::ParameterType::Integer);
-	NUIE::RegisterSlotDefaultValueNodeParameter<IntegerIncrementedNode, NE::IntValue> (parameterList, NE::SlotId ("step"), NE::LocString (L"Step"), NUIE::ParameterType::Integer);
-	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<IntegerIncrementedNode> (NE::SlotId ("count"), NE::LocString (L"Count"), NUIE::ParameterType::Integer, 0)));
+	NUIE::RegisterSlotDefaultValueNodeParameter<IntegerIncrementedNode, NE::IntValue> (parameterList, StartSlotId, NE::LocString (L"Start"), NUIE::ParameterType::Integer);
+	NUIE::RegisterSlotDefaultValueNodeParameter<IntegerIncrementedNode, NE::IntValue> (parameterList, StepSlotId, NE::LocString (L"Step"), NUIE::ParameterType::Integer);
+	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<IntegerIncrementedNode> (CountSlotId, NE::LocString (L"Count"), NUIE::ParameterType::Integer, 0)));
 }
 
 NE::Stream::Status IntegerIncrementedNode::Read (NE::InputStream& inputStream)
@@ -630,17 +644,17 @@ DoubleIncrementedNode::~DoubleIncrementedNode ()
 
 void DoubleIncrementedNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("start"), NE::LocString (L"Start"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("step"), NE::LocString (L"Step"), NE::ValuePtr (new NE::DoubleValue (1.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("count"), NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"List"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (StartSlotId, NE::LocString (L"Start"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (StepSlotId, NE::LocString (L"Step"), NE::ValuePtr (new NE::DoubleValue (1.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (CountSlotId, NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"List"))));
 }
 
 NE::ValueConstPtr DoubleIncrementedNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr start = EvaluateInputSlot (NE::SlotId ("start"), env);
-	NE::ValueConstPtr step = EvaluateInputSlot (NE::SlotId ("step"), env);
-	NE::ValueConstPtr count = EvaluateInputSlot (NE::SlotId ("count"), env);
+	NE::ValueConstPtr start = EvaluateInputSlot (StartSlotId, env);
+	NE::ValueConstPtr step = EvaluateInputSlot (StepSlotId, env);
+	NE::ValueConstPtr count = EvaluateInputSlot (CountSlotId, env);
 	if (!NE::IsSingleType<NE::NumberValue> (start) || !NE::IsSingleType<NE::NumberValue> (step) || !NE::IsSingleType<NE::NumberValue> (count)) {
 		return nullptr;
 	}
@@ -652,9 +666,10 @@ NE::ValueConstPtr DoubleIncrementedNode::Calculate (NE::EvaluationEnv& env) cons
 		return nullptr;
 	}
 
-	NE::ListValuePtr list (new NE::ListValue ());
+	NE::DoubleListValuePtr list = NE::MakeValue<NE::DoubleListValue> ();
+	list->Reserve (countNum);
 	for (int i = 0; i < countNum; ++i) {
-		list->Push (NE::ValuePtr (new NE::DoubleValue (startNum + i * stepNum)));
+		list->Push (startNum + i * stepNum);
 	}
 
 	return list;
@@ -663,9 +678,9 @@ NE::ValueConstPtr DoubleIncrementedNode::Calculate (NE::EvaluationEnv& env) cons
 void DoubleIncrementedNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
 	BasicUINode::RegisterParameters (parameterList);
-	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleIncrementedNode, NE::DoubleValue> (parameterList, NE::SlotId ("start"), NE::LocString (L"Start"), NUIE::ParameterType::Double);
-	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleIncrementedNode, NE::DoubleValue> (parameterList, NE::SlotId ("step"), NE::LocString (L"Step"), NUIE::ParameterType::Double);
-	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<DoubleIncrementedNode> (NE::SlotId ("count"), NE::LocString (L"Count"), NUIE::ParameterType::Integer, 0)));
+	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleIncrementedNode, NE::DoubleValue> (parameterList, StartSlotId, NE::LocString (L"Start"), NUIE::ParameterType::Double);
+	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleIncrementedNode, NE::DoubleValue> (parameterList, StepSlotId, NE::LocString (L"Step"), NUIE::ParameterType::Double);
+	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<DoubleIncrementedNode> (CountSlotId, NE::LocString (L"Count"), NUIE::ParameterType::Integer, 0)));
 }
 
 NE::Stream::Status DoubleIncrementedNode::Read (NE::InputStream& inputStream)
@@ -701,17 +716,17 @@ DoubleDistributedNode::~DoubleDistributedNode ()
 
 void DoubleDistributedNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("start"), NE::LocString (L"Start"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("end"), NE::LocString (L"End"), NE::ValuePtr (new NE::DoubleValue (1.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("count"), NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"List"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (StartSlotId, NE::LocString (L"Start"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (EndSlotId, NE::LocString (L"End"), NE::ValuePtr (new NE::DoubleValue (1.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (CountSlotId, NE::LocString (L"Count"), NE::ValuePtr (new NE::IntValue (10)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"List"))));
 }
 
 NE::ValueConstPtr DoubleDistributedNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr start = EvaluateInputSlot (NE::SlotId ("start"), env);
-	NE::ValueConstPtr end = EvaluateInputSlot (NE::SlotId ("end"), env);
-	NE::ValueConstPtr count = EvaluateInputSlot (NE::SlotId ("count"), env);
+	NE::ValueConstPtr start = EvaluateInputSlot (StartSlotId, env);
+	NE::ValueConstPtr end = EvaluateInputSlot (EndSlotId, env);
+	NE::ValueConstPtr count = EvaluateInputSlot (CountSlotId, env);
 	if (!NE::IsSingleType<NE::NumberValue> (start) || !NE::IsSingleType<NE::NumberValue> (end) || !NE::IsSingleType<NE::NumberValue> (count)) {
 		return nullptr;
 	}
@@ -724,9 +739,10 @@ NE::ValueConstPtr DoubleDistributedNode::Calculate (NE::EvaluationEnv& env) cons
 	}
 
 	double segmentVal = std::fabs (startNum - endNum) / (double) (countNum - 1);
-	NE::ListValuePtr list (new NE::ListValue ());
+	NE::DoubleListValuePtr list = NE::MakeValue<NE::DoubleListValue> ();
+	list->Reserve (countNum);
 	for (int i = 0; i < countNum; ++i) {
-		list->Push (NE::ValuePtr (new NE::DoubleValue (startNum + i * segmentVal)));
+		list->Push (startNum + i * segmentVal);
 	}
 
 	return list;
@@ -735,9 +751,9 @@ NE::ValueConstPtr DoubleDistributedNode::Calculate (NE::EvaluationEnv& env) cons
 void DoubleDistributedNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
 	BasicUINode::RegisterParameters (parameterList);
-	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleDistributedNode, NE::DoubleValue> (parameterList, NE::SlotId ("start"), NE::LocString (L"Start"), NUIE::ParameterType::Double);
-	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleDistributedNode, NE::DoubleValue> (parameterList, NE::SlotId ("end"), NE::LocString (L"End"), NUIE::ParameterType::Double);
-	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<DoubleDistributedNode> (NE::SlotId ("count"), NE::LocString (L"Count"), NUIE::ParameterType::Integer, 2)));
+	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleDistributedNode, NE::DoubleValue> (parameterList, StartSlotId, NE::LocString (L"Start"), NUIE::ParameterType::Double);
+	NUIE::RegisterSlotDefaultValueNodeParameter<DoubleDistributedNode, NE::DoubleValue> (parameterList, EndSlotId, NE::LocString (L"End"), NUIE::ParameterType::Double);
+	parameterList.AddParameter (NUIE::NodeParameterPtr (new MinValueIntegerParameter<DoubleDistributedNode> (CountSlotId, NE::LocString (L"Count"), NUIE::ParameterType::Integer, 2)));
 }
 
 NE::Stream::Status DoubleDistributedNode::Read (NE::InputStream& inputStream)
@@ -773,18 +789,18 @@ ListBuilderNode::~ListBuilderNode ()
 
 void ListBuilderNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("in"), NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Multiple)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"Output"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (InSlotId, NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Multiple)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"Output"))));
 }
 
 NE::ValueConstPtr ListBuilderNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr in = EvaluateInputSlot (NE::SlotId ("in"), env);
+	NE::ValueConstPtr in = EvaluateInputSlot (InSlotId, env);
 	if (in == nullptr) {
 		return nullptr;
 	}
 
-	NE::ListValuePtr list (new NE::ListValue ());
+	NE::ListValuePtr list = NE::MakeValue<NE::ListValue> ();
 	NE::FlatEnumerate (in, [&] (const NE::ValueConstPtr& innerVal) {
 		list->Push (innerVal);
 		return true;
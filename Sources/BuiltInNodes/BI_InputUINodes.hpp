@@ -68,6 +68,7 @@ public:
 	virtual void						Initialize () override;
 
 	virtual bool						IsForceCalculated () const override;
+	virtual bool						IsValuePinned () const override;
 
 	virtual NE::Stream::Status			Read (NE::InputStream& inputStream) override;
 	virtual NE::Stream::Status			Write (NE::OutputStream& outputStream) const override;
@@ -15,7 +15,8 @@ void HeaderBasedLayout::AddPanels (	const BasicUINode& uiNode,
 									NUIE::NodePanelDrawer& drawer) const
 {
 	NodeUIHeaderPanel::NodeStatus nodeStatus = NodeUIHeaderPanel::NodeStatus::HasNoValue;
-	if (uiNode.HasCalculatedValue () && uiNode.GetCalculatedValue () != nullptr) {
+	// evicted values are up to date, they are only removed from the cache
+	if (uiNode.IsValueEvicted () || (uiNode.HasCalculatedValue () && uiNode.GetCalculatedValue () != nullptr)) {
 		nodeStatus = NodeUIHeaderPanel::NodeStatus::HasValue;
 	}
 	std::wstring nodeName = uiNode.GetName ().GetLocalized ();
@@ -1,5 +1,6 @@
 #include "BI_UnaryOperationNodes.hpp"
 #include "NE_Localization.hpp"
+#include "NE_TypedListValues.hpp"
 #include "NUIE_NodeCommonParameters.hpp"
 
 #include <cmath>
@@ -7,6 +8,9 @@
 namespace BI
 {
 
+static const NE::SlotId ASlotId ("a");
+static const NE::SlotId ResultSlotId ("result");
+
 SERIALIZATION_INFO (UnaryOperationNode, 1);
 DYNAMIC_SERIALIZATION_INFO (AbsNode, 1, "{125E8E5E-F1CB-4AE4-8EA9-53343ACD193B}");
 DYNAMIC_SERIALIZATION_INFO (FloorNode, 1, "{0DB3D5E3-8B32-43A4-82D2-F5B816AB5CC1}");
@@ -32,21 +36,26 @@ UnaryOperationNode::~UnaryOperationNode ()
 
 void UnaryOperationNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("a"), NE::LocString (L"A"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("result"), NE::LocString (L"Result"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (ASlotId, NE::LocString (L"A"), NE::ValuePtr (new NE::DoubleValue (0.0)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (ResultSlotId, NE::LocString (L"Result"))));
 }
 
 NE::ValueConstPtr UnaryOperationNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr aValue = EvaluateInputSlot (NE::SlotId ("a"), env);
+	NE::ValueConstPtr aValue = EvaluateInputSlot (ASlotId, env);
 	if (!NE::IsComplexType<NE::NumberValue> (aValue)) {
 		return nullptr;
 	}
 
 	if (NE::IsSingleValue (aValue)) {
 		return DoSingleOperation (aValue);
+	}
+
+	DoubleArray aArray;
+	if (aArray.Set (aValue)) {
+		return DoArrayOperation (aArray);
 	} else {
-		NE::ListValuePtr resultListValue (new NE::ListValue ());
+		NE::ListValuePtr resultListValue = NE::MakeValue<NE::ListValue> ();
 		bool isValid = NE::FlatEnumerate (aValue, [&] (const NE::ValueConstPtr& val) {
 			NE::ValuePtr result = DoSingleOperation (val);
 			if (result == nullptr) {
@@ -65,7 +74,7 @@ NE::ValueConstPtr UnaryOperationNode::Calculate (NE::EvaluationEnv& env) const
 void UnaryOperationNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
 	BasicUINode::RegisterParameters (parameterList);
-	NUIE::RegisterSlotDefaultValueNodeParameter<UnaryOperationNode, NE::DoubleValue> (parameterList, NE::SlotId ("a"), NE::LocString (L"A"), NUIE::ParameterType::Double);
+	NUIE::RegisterSlotDefaultValueNodeParameter<UnaryOperationNode, NE::DoubleValue> (parameterList, ASlotId, NE::LocString (L"A"), NUIE::ParameterType::Double);
 }
 
 bool UnaryOperationNode::IsForceCalculated () const
@@ -87,6 +96,12 @@ NE::Stream::Status UnaryOperationNode::Write (NE::OutputStream& outputStream) co
 	return outputStream.GetStatus ();
 }
 
+bool UnaryOperationNode::WriteMemoizationKey (NE::OutputStream& outputStream) const
+{
+	// the result depends only on the inputs and the features, the derived classes have no data
+	return WriteFeatureSet (outputStream);
+}
+
 NE::ValuePtr UnaryOperationNode::DoSingleOperation (const NE::ValueConstPtr& aValue) const
 {
 	double aDouble = NE::NumberValue::ToDouble (aValue);
@@ -97,7 +112,19 @@ NE::ValuePtr UnaryOperationNode::DoSingleOperation (const NE::ValueConstPtr& aVa
 	if (std::isnan (result) || std::isinf (result)) {
 		return nullptr;
 	}
-	return NE::ValuePtr (new NE::DoubleValue (result));
+	return NE::MakeValue<NE::DoubleValue> (result);
+}
+
+NE::ValuePtr UnaryOperationNode::DoArrayOperation (const DoubleArray& aArray) const
+{
+	std::vector<double> result (aArray.GetSize ());
+	if (!DoListOperation (aArray.GetData (), result.data (), result.size ())) {
+		return nullptr;
+	}
+	if (!IsFiniteArray (result.data (), result.size ())) {
+		return nullptr;
+	}
+	return NE::MakeValue<NE::DoubleListValue> (std::move (result));
 }
 
 bool UnaryOperationNode::IsValidInput (double) const
@@ -105,6 +132,17 @@ bool UnaryOperationNode::IsValidInput (double) const
 	return true;
 }
 
+bool UnaryOperationNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		if (!IsValidInput (a[i])) {
+			return false;
+		}
+		result[i] = DoOperation (a[i]);
+	}
+	return true;
+}
+
 AbsNode::AbsNode () :
 	UnaryOperationNode ()
 {
@@ -127,6 +165,12 @@ double AbsNode::DoOperation (double a) const
 	return std::abs (a);
 }
 
+bool AbsNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	AbsArray (a, result, count);
+	return true;
+}
+
 FloorNode::FloorNode () :
 	UnaryOperationNode ()
 {
@@ -149,6 +193,12 @@ double FloorNode::DoOperation (double a) const
 	return std::floor (a);
 }
 
+bool FloorNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	FloorArray (a, result, count);
+	return true;
+}
+
 CeilNode::CeilNode () :
 	UnaryOperationNode ()
 {
@@ -171,6 +221,12 @@ double CeilNode::DoOperation (double a) const
 	return std::ceil (a);
 }
 
+bool CeilNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	CeilArray (a, result, count);
+	return true;
+}
+
 NegativeNode::NegativeNode () :
 	UnaryOperationNode ()
 {
@@ -193,6 +249,12 @@ double NegativeNode::DoOperation (double a) const
 	return a * -1.0;
 }
 
+bool NegativeNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	NegateArray (a, result, count);
+	return true;
+}
+
 SqrtNode::SqrtNode () :
 	UnaryOperationNode ()
 {
@@ -220,4 +282,11 @@ double SqrtNode::DoOperation (double a) const
 	return sqrt (a);
 }
 
+bool SqrtNode::DoListOperation (const double* a, double* result, size_t count) const
+{
+	// negative inputs result in nan, so they are rejected by the finite check
+	SqrtArray (a, result, count);
+	return true;
+}
+
 }
@@ -4,6 +4,7 @@
 #include "NE_SingleValues.hpp"
 #include "BI_BasicUINode.hpp"
 #include "BI_BuiltInFeatures.hpp"
+#include "BI_VectorizedOperations.hpp"
 
 namespace BI
 {
@@ -27,9 +28,12 @@ public:
 	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
 
 private:
+	virtual bool				WriteMemoizationKey (NE::OutputStream& outputStream) const override;
 	NE::ValuePtr				DoSingleOperation (const NE::ValueConstPtr& aValue) const;
+	NE::ValuePtr				DoArrayOperation (const DoubleArray& aArray) const;
 	virtual bool				IsValidInput (double a) const;
 	virtual double				DoOperation (double a) const = 0;
+	virtual bool				DoListOperation (const double* a, double* result, size_t count) const;
 };
 
 class AbsNode : public UnaryOperationNode
@@ -42,7 +46,8 @@ public:
 	virtual ~AbsNode ();
 
 private:
-	virtual double DoOperation (double a) const override;
+	virtual double	DoOperation (double a) const override;
+	virtual bool	DoListOperation (const double* a, double* result, size_t count) const override;
 };
 
 class FloorNode : public UnaryOperationNode
@@ -55,7 +60,8 @@ public:
 	virtual ~FloorNode ();
 
 private:
-	virtual double DoOperation (double a) const override;
+	virtual double	DoOperation (double a) const override;
+	virtual bool	DoListOperation (const double* a, double* result, size_t count) const override;
 };
 
 class CeilNode : public UnaryOperationNode
@@ -68,7 +74,8 @@ public:
 	virtual ~CeilNode ();
 
 private:
-	virtual double DoOperation (double a) const override;
+	virtual double	DoOperation (double a) const override;
+	virtual bool	DoListOperation (const double* a, double* result, size_t count) const override;
 };
 
 class NegativeNode : public UnaryOperationNode
@@ -81,7 +88,8 @@ public:
 	virtual ~NegativeNode ();
 
 private:
-	virtual double DoOperation (double a) const override;
+	virtual double	DoOperation (double a) const override;
+	virtual bool	DoListOperation (const double* a, double* result, size_t count) const override;
 };
 
 class SqrtNode : public UnaryOperationNode
@@ -96,6 +104,7 @@ public:
 private:
 	virtual bool	IsValidInput (double a) const override;
 	virtual double	DoOperation (double a) const override;
+	virtual bool	DoListOperation (const double* a, double* result, size_t count) const override;
 };
 
 }
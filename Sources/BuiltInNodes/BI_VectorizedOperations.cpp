@@ -0,0 +1,384 @@
+#include "BI_VectorizedOperations.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_Debug.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined (__AVX__)
+	#include <immintrin.h>
+	#define BI_VECTORIZE_AVX
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BI_VECTORIZE_SSE2
+	#if defined (__SSE4_1__)
+		#include <smmintrin.h>
+		#define BI_VECTORIZE_SSE41
+	#endif
+#endif
+
+namespace BI
+{
+
+#if defined (BI_VECTORIZE_AVX)
+
+#define BI_VECTORIZE
+#define BI_VECTORIZE_ROUNDING
+
+using DoubleVector = __m256d;
+static const size_t VectorSize = 4;
+
+static inline DoubleVector	LoadVector (const double* values)				{ return _mm256_loadu_pd (values); }
+static inline DoubleVector	BroadcastVector (double value)					{ return _mm256_set1_pd (value); }
+static inline void			StoreVector (double* values, DoubleVector vec)	{ _mm256_storeu_pd (values, vec); }
+static inline DoubleVector	AddVectors (DoubleVector a, DoubleVector b)		{ return _mm256_add_pd (a, b); }
+static inline DoubleVector	SubVectors (DoubleVector a, DoubleVector b)		{ return _mm256_sub_pd (a, b); }
+static inline DoubleVector	MulVectors (DoubleVector a, DoubleVector b)		{ return _mm256_mul_pd (a, b); }
+static inline DoubleVector	DivVectors (DoubleVector a, DoubleVector b)		{ return _mm256_div_pd (a, b); }
+static inline DoubleVector	AndNotVectors (DoubleVector a, DoubleVector b)	{ return _mm256_andnot_pd (a, b); }
+static inline DoubleVector	SqrtVector (DoubleVector a)						{ return _mm256_sqrt_pd (a); }
+static inline DoubleVector	FloorVector (DoubleVector a)					{ return _mm256_floor_pd (a); }
+static inline DoubleVector	CeilVector (DoubleVector a)						{ return _mm256_ceil_pd (a); }
+
+#elif defined (BI_VECTORIZE_SSE2)
+
+#define BI_VECTORIZE
+
+using DoubleVector = __m128d;
+static const size_t VectorSize = 2;
+
+static inline DoubleVector	LoadVector (const double* values)				{ return _mm_loadu_pd (values); }
+static inline DoubleVector	BroadcastVector (double value)					{ return _mm_set1_pd (value); }
+static inline void			StoreVector (double* values, DoubleVector vec)	{ _mm_storeu_pd (values, vec); }
+static inline DoubleVector	AddVectors (DoubleVector a, DoubleVector b)		{ return _mm_add_pd (a, b); }
+static inline DoubleVector	SubVectors (DoubleVector a, DoubleVector b)		{ return _mm_sub_pd (a, b); }
+static inline DoubleVector	MulVectors (DoubleVector a, DoubleVector b)		{ return _mm_mul_pd (a, b); }
+static inline DoubleVector	DivVectors (DoubleVector a, DoubleVector b)		{ return _mm_div_pd (a, b); }
+static inline DoubleVector	AndNotVectors (DoubleVector a, DoubleVector b)	{ return _mm_andnot_pd (a, b); }
+static inline DoubleVector	SqrtVector (DoubleVector a)						{ return _mm_sqrt_pd (a); }
+
+#if defined (BI_VECTORIZE_SSE41)
+#define BI_VECTORIZE_ROUNDING
+static inline DoubleVector	FloorVector (DoubleVector a)					{ return _mm_floor_pd (a); }
+static inline DoubleVector	CeilVector (DoubleVector a)						{ return _mm_ceil_pd (a); }
+#endif
+
+#endif
+
+class AddOperation
+{
+public:
+	static double Scalar (double a, double b) { return a + b; }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a, DoubleVector b) { return AddVectors (a, b); }
+#endif
+};
+
+class SubtractOperation
+{
+public:
+	static double Scalar (double a, double b) { return a - b; }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a, DoubleVector b) { return SubVectors (a, b); }
+#endif
+};
+
+class MultiplyOperation
+{
+public:
+	static double Scalar (double a, double b) { return a * b; }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a, DoubleVector b) { return MulVectors (a, b); }
+#endif
+};
+
+class DivideOperation
+{
+public:
+	static double Scalar (double a, double b) { return a / b; }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a, DoubleVector b) { return DivVectors (a, b); }
+#endif
+};
+
+class AbsOperation
+{
+public:
+	static double Scalar (double a) { return std::abs (a); }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a) { return AndNotVectors (BroadcastVector (-0.0), a); }
+#endif
+};
+
+class NegateOperation
+{
+public:
+	static double Scalar (double a) { return a * -1.0; }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a) { return MulVectors (a, BroadcastVector (-1.0)); }
+#endif
+};
+
+class SqrtOperation
+{
+public:
+	static double Scalar (double a) { return std::sqrt (a); }
+#if defined (BI_VECTORIZE)
+	static DoubleVector Vector (DoubleVector a) { return SqrtVector (a); }
+#endif
+};
+
+class FloorOperation
+{
+public:
+	static double Scalar (double a) { return std::floor (a); }
+#if defined (BI_VECTORIZE_ROUNDING)
+	static DoubleVector Vector (DoubleVector a) { return FloorVector (a); }
+#endif
+};
+
+class CeilOperation
+{
+public:
+	static double Scalar (double a) { return std::ceil (a); }
+#if defined (BI_VECTORIZE_ROUNDING)
+	static DoubleVector Vector (DoubleVector a) { return CeilVector (a); }
+#endif
+};
+
+template <class Operation>
+static void DoScalarBinaryOperation (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t from, size_t count)
+{
+	for (size_t i = from; i < count; ++i) {
+		result[i] = Operation::Scalar (a[i * aStride], b[i * bStride]);
+	}
+}
+
+template <class Operation>
+static void DoBinaryOperation (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	DBGASSERT (aStride <= 1 && bStride <= 1);
+	size_t vectorizedCount = 0;
+#if defined (BI_VECTORIZE)
+	vectorizedCount = count - count % VectorSize;
+	if (aStride != 0 && bStride != 0) {
+		for (size_t i = 0; i < vectorizedCount; i += VectorSize) {
+			StoreVector (result + i, Operation::Vector (LoadVector (a + i), LoadVector (b + i)));
+		}
+	} else if (aStride != 0) {
+		DoubleVector bVector = BroadcastVector (b[0]);
+		for (size_t i = 0; i < vectorizedCount; i += VectorSize) {
+			StoreVector (result + i, Operation::Vector (LoadVector (a + i), bVector));
+		}
+	} else if (bStride != 0) {
+		DoubleVector aVector = BroadcastVector (a[0]);
+		for (size_t i = 0; i < vectorizedCount; i += VectorSize) {
+			StoreVector (result + i, Operation::Vector (aVector, LoadVector (b + i)));
+		}
+	} else {
+		vectorizedCount = 0;
+	}
+#endif
+	DoScalarBinaryOperation<Operation> (a, aStride, b, bStride, result, vectorizedCount, count);
+}
+
+template <class Operation>
+static void DoScalarUnaryOperation (const double* a, double* result, size_t from, size_t count)
+{
+	for (size_t i = from; i < count; ++i) {
+		result[i] = Operation::Scalar (a[i]);
+	}
+}
+
+template <class Operation>
+static void DoUnaryOperation (const double* a, double* result, size_t count)
+{
+	size_t vectorizedCount = 0;
+#if defined (BI_VECTORIZE)
+	vectorizedCount = count - count % VectorSize;
+	for (size_t i = 0; i < vectorizedCount; i += VectorSize) {
+		StoreVector (result + i, Operation::Vector (LoadVector (a + i)));
+	}
+#endif
+	DoScalarUnaryOperation<Operation> (a, result, vectorizedCount, count);
+}
+
+DoubleArray::DoubleArray () :
+	buffer (),
+	data (nullptr),
+	size (0)
+{
+
+}
+
+DoubleArray::~DoubleArray ()
+{
+
+}
+
+bool DoubleArray::Set (const NE::ValueConstPtr& value)
+{
+	buffer.clear ();
+	data = nullptr;
+	size = 0;
+
+	if (NE::Value::IsType<NE::DoubleListValue> (value)) {
+		const std::vector<double>& items = NE::Value::Cast<NE::DoubleListValue> (value.get ())->GetItems ();
+		data = items.data ();
+		size = items.size ();
+		return true;
+	}
+
+	if (NE::Value::IsType<NE::NumberValue> (value)) {
+		buffer.push_back (NE::NumberValue::ToDouble (value));
+	} else if (NE::Value::IsType<NE::IntListValue> (value)) {
+		const std::vector<int>& items = NE::Value::Cast<NE::IntListValue> (value.get ())->GetItems ();
+		buffer.assign (items.begin (), items.end ());
+	} else if (NE::Value::IsType<NE::IListValue> (value)) {
+		const NE::IListValue* listValue = NE::Value::Cast<NE::IListValue> (value.get ());
+		buffer.reserve (listValue->GetSize ());
+		bool isNumberList = listValue->EnumerateItems ([&] (const NE::Value* item) {
+			const NE::NumberValue* numberItem = NE::Value::Cast<NE::NumberValue> (item);
+			if (numberItem == nullptr) {
+				return false;
+			}
+			buffer.push_back (numberItem->ToDouble ());
+			return true;
+		});
+		if (!isNumberList) {
+			buffer.clear ();
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	data = buffer.data ();
+	size = buffer.size ();
+	return true;
+}
+
+size_t DoubleArray::GetSize () const
+{
+	return size;
+}
+
+const double* DoubleArray::GetData () const
+{
+	return data;
+}
+
+void AddArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count)
+{
+	DoBinaryOperation<AddOperation> (a, aStride, b, bStride, result, count);
+}
+
+void SubtractArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count)
+{
+	DoBinaryOperation<SubtractOperation> (a, aStride, b, bStride, result, count);
+}
+
+void MultiplyArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count)
+{
+	DoBinaryOperation<MultiplyOperation> (a, aStride, b, bStride, result, count);
+}
+
+void DivideArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count)
+{
+	DoBinaryOperation<DivideOperation> (a, aStride, b, bStride, result, count);
+}
+
+void AbsArray (const double* a, double* result, size_t count)
+{
+	DoUnaryOperation<AbsOperation> (a, result, count);
+}
+
+void FloorArray (const double* a, double* result, size_t count)
+{
+#if defined (BI_VECTORIZE_ROUNDING)
+	DoUnaryOperation<FloorOperation> (a, result, count);
+#else
+	DoScalarUnaryOperation<FloorOperation> (a, result, 0, count);
+#endif
+}
+
+void CeilArray (const double* a, double* result, size_t count)
+{
+#if defined (BI_VECTORIZE_ROUNDING)
+	DoUnaryOperation<CeilOperation> (a, result, count);
+#else
+	DoScalarUnaryOperation<CeilOperation> (a, result, 0, count);
+#endif
+}
+
+void NegateArray (const double* a, double* result, size_t count)
+{
+	DoUnaryOperation<NegateOperation> (a, result, count);
+}
+
+void SqrtArray (const double* a, double* result, size_t count)
+{
+	DoUnaryOperation<SqrtOperation> (a, result, count);
+}
+
+bool IsFiniteArray (const double* values, size_t count)
+{
+	// x - x is zero for finite numbers and nan for nan and infinity,
+	// and the nan is kept by every later addition to the sum
+	size_t vectorizedCount = 0;
+#if defined (BI_VECTORIZE)
+	vectorizedCount = count - count % VectorSize;
+	DoubleVector sumVector = BroadcastVector (0.0);
+	for (size_t i = 0; i < vectorizedCount; i += VectorSize) {
+		DoubleVector vec = LoadVector (values + i);
+		sumVector = AddVectors (sumVector, SubVectors (vec, vec));
+	}
+	double sumValues[VectorSize];
+	StoreVector (sumValues, sumVector);
+	for (size_t i = 0; i < VectorSize; ++i) {
+		if (std::isnan (sumValues[i])) {
+			return false;
+		}
+	}
+#endif
+	for (size_t i = vectorizedCount; i < count; ++i) {
+		if (std::isnan (values[i]) || std::isinf (values[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+double GetMaxAbsValue (const DoubleArray& values)
+{
+	double maxValue = 0.0;
+	for (size_t i = 0; i < values.GetSize (); ++i) {
+		double absValue = std::fabs (values.GetData ()[i]);
+		if (!std::isfinite (absValue)) {
+			return std::numeric_limits<double>::quiet_NaN ();
+		}
+		maxValue = std::max (maxValue, absValue);
+	}
+	return maxValue;
+}
+
+double GetMinAbsValue (const DoubleArray& values)
+{
+	double minValue = std::numeric_limits<double>::infinity ();
+	for (size_t i = 0; i < values.GetSize (); ++i) {
+		double absValue = std::fabs (values.GetData ()[i]);
+		if (!std::isfinite (absValue)) {
+			return std::numeric_limits<double>::quiet_NaN ();
+		}
+		minValue = std::min (minValue, absValue);
+	}
+	return minValue;
+}
+
+}
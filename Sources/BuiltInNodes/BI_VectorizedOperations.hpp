@@ -0,0 +1,53 @@
+#ifndef BI_VECTORIZEDOPERATIONS_HPP
+#define BI_VECTORIZEDOPERATIONS_HPP
+
+#include "NE_Value.hpp"
+
+#include <vector>
+
+namespace BI
+{
+
+class DoubleArray
+{
+public:
+	DoubleArray ();
+	DoubleArray (const DoubleArray&) = delete;
+	~DoubleArray ();
+
+	DoubleArray&	operator= (const DoubleArray&) = delete;
+
+	bool			Set (const NE::ValueConstPtr& value);
+	size_t			GetSize () const;
+	const double*	GetData () const;
+
+private:
+	std::vector<double>	buffer;
+	const double*		data;
+	size_t				size;
+};
+
+// the stride is 0 if the same value is used for every item, and 1 otherwise
+using BinaryArrayOperation = void (*) (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count);
+using UnaryArrayOperation = void (*) (const double* a, double* result, size_t count);
+
+void	AddArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count);
+void	SubtractArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count);
+void	MultiplyArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count);
+void	DivideArrays (const double* a, size_t aStride, const double* b, size_t bStride, double* result, size_t count);
+
+void	AbsArray (const double* a, double* result, size_t count);
+void	FloorArray (const double* a, double* result, size_t count);
+void	CeilArray (const double* a, double* result, size_t count);
+void	NegateArray (const double* a, double* result, size_t count);
+void	SqrtArray (const double* a, double* result, size_t count);
+
+bool	IsFiniteArray (const double* values, size_t count);
+
+// the result is nan if any of the values is not finite
+double	GetMaxAbsValue (const DoubleArray& values);
+double	GetMinAbsValue (const DoubleArray& values);
+
+}
+
+#endif
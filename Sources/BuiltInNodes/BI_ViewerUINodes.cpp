@@ -9,6 +9,9 @@
 namespace BI
 {
 
+static const NE::SlotId InSlotId ("in");
+static const NE::SlotId OutSlotId ("out");
+
 DYNAMIC_SERIALIZATION_INFO (ViewerNode, 1, "{417392AA-F72D-4E84-8F58-766D0AAC07FC}");
 DYNAMIC_SERIALIZATION_INFO (MultiLineViewerNode, 1, "{2BACB82D-84A6-4472-82CB-786C98A50EF0}");
 
@@ -48,8 +51,8 @@ ViewerNode::~ViewerNode ()
 
 void ViewerNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("in"), NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"Output"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (InSlotId, NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"Output"))));
 }
 
 bool ViewerNode::IsForceCalculated () const
@@ -57,9 +60,14 @@ bool ViewerNode::IsForceCalculated () const
 	return true;
 }
 
+bool ViewerNode::IsValuePinned () const
+{
+	return true;
+}
+
 NE::ValueConstPtr ViewerNode::Calculate (NE::EvaluationEnv& env) const
 {
-	NE::ValueConstPtr val = EvaluateInputSlot (NE::SlotId ("in"), env);
+	NE::ValueConstPtr val = EvaluateInputSlot (InSlotId, env);
 	if (val == nullptr) {
 		return nullptr;
 	}
@@ -97,7 +105,7 @@ void MultiLineViewerNode::Layout::GetTextInfo (const BasicUINode& uiNode,
 	if (uiNode.HasCalculatedValue ()) {
 		NE::ValueConstPtr nodeValue = uiNode.GetCalculatedValue ();
 		if (nodeValue != nullptr) {
-			NE::FlatEnumerate (nodeValue, [&] (const NE::ValueConstPtr& value) {
+			NE::FlatEnumerateItems (nodeValue.get (), [&] (const NE::Value* value) {
 				if (value != nullptr) {
 					texts.push_back (value->ToString (stringConverter));
 				} else {
@@ -132,13 +140,13 @@ MultiLineViewerNode::~MultiLineViewerNode ()
 
 void MultiLineViewerNode::Initialize ()
 {
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("in"), NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Single)));
-	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("out"), NE::LocString (L"Output"))));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (InSlotId, NE::LocString (L"Input"), nullptr, NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (OutSlotId, NE::LocString (L"Output"))));
 }
 
 NE::ValueConstPtr MultiLineViewerNode::Calculate (NE::EvaluationEnv& env) const
 {
-	return EvaluateInputSlot (NE::SlotId ("in"), env);
+	return EvaluateInputSlot (InSlotId, env);
 }
 
 void MultiLineViewerNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
@@ -174,6 +182,11 @@ bool MultiLineViewerNode::IsForceCalculated () const
 	return true;
 }
 
+bool MultiLineViewerNode::IsValuePinned () const
+{
+	return true;
+}
+
 NE::Stream::Status MultiLineViewerNode::Read (NE::InputStream& inputStream)
 {
 	NE::ObjectHeader header (inputStream);
@@ -28,6 +28,7 @@ public:
 
 	virtual void						Initialize () override;
 	virtual bool						IsForceCalculated () const override;
+	virtual bool						IsValuePinned () const override;
 
 	virtual NE::ValueConstPtr			Calculate (NE::EvaluationEnv& env) const override;
 
@@ -63,6 +64,7 @@ public:
 	virtual void						RegisterParameters (NUIE::NodeParameterList& parameterList) const override;
 
 	virtual bool						IsForceCalculated () const override;
+	virtual bool						IsValuePinned () const override;
 
 	virtual NE::Stream::Status			Read (NE::InputStream& inputStream) override;
 	virtual NE::Stream::Status			Write (NE::OutputStream& outputStream) const override;
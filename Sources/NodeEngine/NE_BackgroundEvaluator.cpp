@@ -0,0 +1,164 @@
+#include "NE_BackgroundEvaluator.hpp"
+#include "NE_Debug.hpp"
+
+namespace NE
+{
+
+BackgroundEvaluator::BackgroundEvaluator () :
+	snapshot (nullptr),
+	snapshotSourceId (0),
+	workerThread (),
+	cancellationToken (new CancellationToken ()),
+	isStarted (false),
+	isFinished (false),
+	isCompleted (false),
+	sourceId (0),
+	modificationStamp ()
+{
+
+}
+
+BackgroundEvaluator::~BackgroundEvaluator ()
+{
+	Cancel ();
+}
+
+bool BackgroundEvaluator::IsStarted () const
+{
+	return isStarted;
+}
+
+bool BackgroundEvaluator::IsFinished () const
+{
+	return isStarted && isFinished.load ();
+}
+
+bool BackgroundEvaluator::IsOutdated (const NodeManager& nodeManager) const
+{
+	return !isStarted || nodeManager.managerId != sourceId || nodeManager.modificationStamp != modificationStamp;
+}
+
+bool BackgroundEvaluator::Start (const NodeManager& nodeManager, const EvaluationEnv& env, bool isForced)
+{
+	return StartEvaluation (nodeManager, env, [isForced] (const NodeManager& snapshot, EvaluationEnv& workerEnv) {
+		if (isForced) {
+			return snapshot.ForceEvaluateAllNodes (workerEnv);
+		}
+		return snapshot.EvaluateAllNodes (workerEnv);
+	});
+}
+
+bool BackgroundEvaluator::Start (const NodeManager& nodeManager, const NodeCollection& nodes, const EvaluationEnv& env)
+{
+	return StartEvaluation (nodeManager, env, [nodes] (const NodeManager& snapshot, EvaluationEnv& workerEnv) {
+		return snapshot.EvaluateNodes (nodes, workerEnv);
+	});
+}
+
+void BackgroundEvaluator::Cancel ()
+{
+	// a cancelled evaluation keeps its calculated values in the snapshot,
+	// so they can be reused if the next evaluation starts on the same graph
+	cancellationToken->Cancel ();
+	Wait ();
+	isStarted = false;
+	isFinished.store (false);
+}
+
+void BackgroundEvaluator::Wait ()
+{
+	if (workerThread.joinable ()) {
+		workerThread.join ();
+	}
+}
+
+BackgroundEvaluator::PublishResult BackgroundEvaluator::Publish (NodeManager& nodeManager, EvaluationEnv& env, NodeCollection& publishedNodes)
+{
+	if (!IsFinished ()) {
+		return PublishResult::NotFinished;
+	}
+
+	Wait ();
+	PublishResult result = PublishResult::Outdated;
+	if (!IsOutdated (nodeManager)) {
+		// the values are added in one step on the calling thread, so the users of
+		// the original manager never see a partially published result
+		nodeManager.CopyCalculatedNodeValues (*snapshot, &env, publishedNodes);
+		result = isCompleted ? PublishResult::Completed : PublishResult::Cancelled;
+	}
+
+	isStarted = false;
+	isFinished.store (false);
+	return result;
+}
+
+bool BackgroundEvaluator::StartEvaluation (const NodeManager& nodeManager, const EvaluationEnv& env, const Evaluator& evaluator)
+{
+	Cancel ();
+
+	// the snapshot owns its own copy of every node, so the worker thread never
+	// touches the nodes or the value cache of the original manager, the graph
+	// is only written here, and the snapshot is read from it by the worker
+	std::vector<char> graphBuffer;
+	bool isSnapshotReused = (snapshot != nullptr && snapshotSourceId == nodeManager.managerId && nodeManager.modificationStamp == modificationStamp);
+	if (!isSnapshotReused) {
+		if (DBGERROR (!NodeManager::WriteToBuffer (nodeManager, graphBuffer))) {
+			return false;
+		}
+		snapshot.reset (new NodeManager ());
+		snapshotSourceId = nodeManager.managerId;
+	}
+
+	// the values calculated in the original manager are reused by the snapshot
+	std::vector<std::pair<NodeId, ValueConstPtr>> calculatedValues;
+	nodeManager.EnumerateNodes ([&] (const NodeConstPtr& node) {
+		const NodeId& nodeId = node->GetId ();
+		if (nodeManager.nodeValueCache.Contains (nodeId)) {
+			calculatedValues.push_back ({ nodeId, nodeManager.nodeValueCache.Get (nodeId) });
+		}
+		return true;
+	});
+	NodeManager::EvaluationMode evaluationMode = nodeManager.evaluationMode;
+	size_t maxMemorySize = nodeManager.nodeValueCache.GetMaxMemorySize ();
+	NodeCollection pinnedNodes = nodeManager.pinnedNodes;
+
+	sourceId = nodeManager.managerId;
+	modificationStamp = nodeManager.modificationStamp;
+	cancellationToken->Reset ();
+	isStarted = true;
+	isFinished.store (false);
+	isCompleted = false;
+
+	bool hasDeadline = env.HasDeadline ();
+	EvaluationEnv::Clock::time_point deadline = env.GetDeadline ();
+	NodeManager* workerSnapshot = snapshot.get ();
+	workerThread = std::thread ([=] () mutable {
+		isCompleted = false;
+		EvaluationEnv workerEnv (nullptr);
+		workerEnv.SetCancellationToken (cancellationToken);
+		if (hasDeadline) {
+			workerEnv.SetDeadline (deadline);
+		}
+		if (!graphBuffer.empty () && DBGERROR (!NodeManager::ReadFromBuffer (*workerSnapshot, graphBuffer))) {
+			// the thread is joined before the next start, so it can't reuse the snapshot
+			snapshotSourceId = 0;
+		} else {
+			// snapshots are evaluated on other threads, so the calculated values are not processed
+			workerSnapshot->evaluationMode = evaluationMode;
+			workerSnapshot->isValueProcessingEnabled = false;
+			workerSnapshot->SetNodeValueCacheMaxMemorySize (maxMemorySize);
+			workerSnapshot->SetPinnedNodes (pinnedNodes);
+			for (const std::pair<NodeId, ValueConstPtr>& calculatedValue : calculatedValues) {
+				if (workerSnapshot->ContainsNode (calculatedValue.first) && !workerSnapshot->nodeValueCache.Contains (calculatedValue.first)) {
+					workerSnapshot->SetCalculatedNodeValue (calculatedValue.first, calculatedValue.second);
+				}
+			}
+			isCompleted = evaluator (*workerSnapshot, workerEnv);
+		}
+		isFinished.store (true);
+	});
+
+	return true;
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef NE_BACKGROUNDEVALUATOR_HPP
+#define NE_BACKGROUNDEVALUATOR_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeCollection.hpp"
+#include "NE_EvaluationEnv.hpp"
+#include "NE_Stamp.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace NE
+{
+
+// evaluates a snapshot of a node manager on a worker thread, so the original
+// node manager can be modified while the evaluation is running, the results
+// are published into the original node manager only if it has not changed,
+// the snapshot is kept after the evaluation, and it is reused by the next one
+// while the original node manager doesn't change, the worker doesn't get the
+// evaluation data of the caller, because it belongs to the value processing,
+// and that runs on the calling thread when the results are published
+class BackgroundEvaluator
+{
+public:
+	enum class PublishResult
+	{
+		NotFinished,
+		Completed,
+		Cancelled,
+		Outdated
+	};
+
+	BackgroundEvaluator ();
+	BackgroundEvaluator (const BackgroundEvaluator& src) = delete;
+	~BackgroundEvaluator ();
+
+	BackgroundEvaluator&	operator= (const BackgroundEvaluator& rhs) = delete;
+
+	bool					IsStarted () const;
+	bool					IsFinished () const;
+	bool					IsOutdated (const NodeManager& nodeManager) const;
+
+	bool					Start (const NodeManager& nodeManager, const EvaluationEnv& env, bool isForced);
+	bool					Start (const NodeManager& nodeManager, const NodeCollection& nodes, const EvaluationEnv& env);
+	void					Cancel ();
+	void					Wait ();
+	PublishResult			Publish (NodeManager& nodeManager, EvaluationEnv& env, NodeCollection& publishedNodes);
+
+private:
+	using Evaluator = std::function<bool (const NodeManager&, EvaluationEnv&)>;
+
+	bool							StartEvaluation (const NodeManager& nodeManager, const EvaluationEnv& env, const Evaluator& evaluator);
+
+	std::unique_ptr<NodeManager>	snapshot;
+	size_t							snapshotSourceId;
+	std::thread						workerThread;
+	CancellationTokenPtr			cancellationToken;
+	bool							isStarted;
+	std::atomic<bool>				isFinished;
+	bool							isCompleted;
+	size_t							sourceId;
+	Stamp							modificationStamp;
+};
+
+}
+
+#endif
@@ -31,17 +31,35 @@ public:
 	bool				Contains (const KeyType& key) const;
 	void				Clear ();
 
+	size_t				GetSize () const;
+	size_t				GetMaxSize () const;
+	void				SetMaxSize (size_t newMaxSize);
+
 	bool				Add (const KeyType& key, const ValueType& value);
+	bool				Add (const KeyType& key, const ValueType& value, size_t valueSize);
 	const ValueType&	Get (const KeyType& key);
 
 private:
-	using KeyValuePair = std::pair<KeyType, ValueType>;
-	using KeyValuePairIterator = typename std::list<KeyValuePair>::iterator;
+	class Entry
+	{
+	public:
+		Entry (const KeyType& key, const ValueType& value, size_t size);
+
+		KeyType		key;
+		ValueType	value;
+		size_t		size;
+	};
+
+	using EntryIterator = typename std::list<Entry>::iterator;
 
-	size_t												maxSize;
-	Controller*											controller;
-	std::list<KeyValuePair>								valueList;
-	std::unordered_map<KeyType, KeyValuePairIterator>	valueMap;
+	void				InsertEntry (const KeyType& key, const ValueType& value, size_t valueSize);
+	void				RemoveLeastRecentlyUsed ();
+
+	size_t										size;
+	size_t										maxSize;
+	Controller*									controller;
+	std::list<Entry>							valueList;
+	std::unordered_map<KeyType, EntryIterator>	valueMap;
 };
 
 template <typename KeyType, typename ValueType>
@@ -56,6 +74,15 @@ Cache<KeyType, ValueType>::Controller::~Controller ()
 
 }
 
+template <typename KeyType, typename ValueType>
+Cache<KeyType, ValueType>::Entry::Entry (const KeyType& key, const ValueType& value, size_t size) :
+	key (key),
+	value (value),
+	size (size)
+{
+
+}
+
 template <typename KeyType, typename ValueType>
 Cache<KeyType, ValueType>::Cache (size_t maxSize) :
 	Cache (maxSize, nullptr)
@@ -65,6 +92,7 @@ Cache<KeyType, ValueType>::Cache (size_t maxSize) :
 
 template <typename KeyType, typename ValueType>
 Cache<KeyType, ValueType>::Cache (size_t maxSize, Controller* controller) :
+	size (0),
 	maxSize (maxSize),
 	controller (controller),
 	valueList (),
@@ -89,30 +117,52 @@ template <typename KeyType, typename ValueType>
 void Cache<KeyType, ValueType>::Clear ()
 {
 	if (controller != nullptr) {
-		for (KeyValuePair& it : valueList) {
-			controller->DisposeValue (it.second);
+		for (Entry& entry : valueList) {
+			controller->DisposeValue (entry.value);
 		}
 	}
 	valueList.clear ();
 	valueMap.clear ();
+	size = 0;
+}
+
+template <typename KeyType, typename ValueType>
+size_t Cache<KeyType, ValueType>::GetSize () const
+{
+	return size;
+}
+
+template <typename KeyType, typename ValueType>
+size_t Cache<KeyType, ValueType>::GetMaxSize () const
+{
+	return maxSize;
+}
+
+template <typename KeyType, typename ValueType>
+void Cache<KeyType, ValueType>::SetMaxSize (size_t newMaxSize)
+{
+	maxSize = newMaxSize;
+	while (size > maxSize) {
+		RemoveLeastRecentlyUsed ();
+	}
 }
 
 template <typename KeyType, typename ValueType>
 bool Cache<KeyType, ValueType>::Add (const KeyType& key, const ValueType& value)
 {
-	if (Contains (key)) {
+	return Add (key, value, 1);
+}
+
+template <typename KeyType, typename ValueType>
+bool Cache<KeyType, ValueType>::Add (const KeyType& key, const ValueType& value, size_t valueSize)
+{
+	if (Contains (key) || valueSize > maxSize) {
 		return false;
 	}
-	if (valueList.size () >= maxSize) {
-		KeyValuePair& keyValuePair = valueList.front ();
-		if (controller != nullptr) {
-			controller->DisposeValue (keyValuePair.second);
-		}
-		valueMap.erase (keyValuePair.first);
-		valueList.pop_front ();
+	while (size + valueSize > maxSize) {
+		RemoveLeastRecentlyUsed ();
 	}
-	valueList.push_back ({ key, value });
-	valueMap.insert ({ key, std::prev (valueList.end ()) });
+	InsertEntry (key, value, valueSize);
 	return true;
 }
 
@@ -120,10 +170,37 @@ template <typename KeyType, typename ValueType>
 const ValueType& Cache<KeyType, ValueType>::Get (const KeyType& key)
 {
 	if (controller != nullptr && !Contains (key)) {
-		Add (key, controller->CreateValue (key));
+		ValueType newValue = controller->CreateValue (key);
+		if (!Add (key, newValue)) {
+			// the value doesn't fit (e.g. the maximum size is zero), but it has to be
+			// kept until the next call, so it is the only entry over the maximum size
+			Clear ();
+			InsertEntry (key, newValue, 1);
+		}
+	}
+	EntryIterator entryIterator = valueMap.at (key);
+	valueList.splice (valueList.end (), valueList, entryIterator);
+	return entryIterator->value;
+}
+
+template <typename KeyType, typename ValueType>
+void Cache<KeyType, ValueType>::InsertEntry (const KeyType& key, const ValueType& value, size_t valueSize)
+{
+	valueList.push_back (Entry (key, value, valueSize));
+	valueMap.insert ({ key, std::prev (valueList.end ()) });
+	size += valueSize;
+}
+
+template <typename KeyType, typename ValueType>
+void Cache<KeyType, ValueType>::RemoveLeastRecentlyUsed ()
+{
+	Entry& entry = valueList.front ();
+	if (controller != nullptr) {
+		controller->DisposeValue (entry.value);
 	}
-	const KeyValuePair& pair = *valueMap.at (key);
-	return pair.second;
+	size -= entry.size;
+	valueMap.erase (entry.key);
+	valueList.pop_front ();
 }
 
 }
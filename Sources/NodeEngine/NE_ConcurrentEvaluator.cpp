@@ -0,0 +1,119 @@
+#include "NE_ConcurrentEvaluator.hpp"
+#include "NE_Node.hpp"
+#include "NE_Debug.hpp"
+
+namespace NE
+{
+
+// the evaluator of the nodes is shared by every thread, so it looks
+// up the concurrent evaluator that is active on the current thread
+static thread_local const ConcurrentEvaluator* activeEvaluator = nullptr;
+
+ConcurrentEvaluator::ActiveScope::ActiveScope (const ConcurrentEvaluator* evaluator) :
+	prevEvaluator (activeEvaluator)
+{
+	activeEvaluator = evaluator;
+}
+
+ConcurrentEvaluator::ActiveScope::~ActiveScope ()
+{
+	activeEvaluator = prevEvaluator;
+}
+
+ConcurrentEvaluator::ConcurrentEvaluator (const NodeManager& nodeManager) :
+	nodeManager (nodeManager),
+	nodeValueCache ()
+{
+
+}
+
+ConcurrentEvaluator::~ConcurrentEvaluator ()
+{
+
+}
+
+bool ConcurrentEvaluator::EvaluateAllNodes (EvaluationEnv& env)
+{
+	ReadLockGuard lock (nodeManager.GetGraphLock ());
+	ExecutionPlanConstPtr plan = nodeManager.GetExecutionPlan ();
+	std::vector<bool> isStepNeeded (plan->GetStepCount (), true);
+	return EvaluateSteps (*plan, isStepNeeded, env);
+}
+
+bool ConcurrentEvaluator::EvaluateNodes (const NodeCollection& nodes, EvaluationEnv& env)
+{
+	ReadLockGuard lock (nodeManager.GetGraphLock ());
+	ExecutionPlanConstPtr plan = nodeManager.GetExecutionPlan ();
+	std::vector<bool> isStepNeeded = plan->GetRequiredSteps (nodes);
+	return EvaluateSteps (*plan, isStepNeeded, env);
+}
+
+bool ConcurrentEvaluator::HasCalculatedNodeValue (const NodeId& nodeId) const
+{
+	return nodeValueCache.Contains (nodeId);
+}
+
+ValueConstPtr ConcurrentEvaluator::GetCalculatedNodeValue (const NodeId& nodeId) const
+{
+	if (!nodeValueCache.Contains (nodeId)) {
+		return nullptr;
+	}
+	return nodeValueCache.Get (nodeId);
+}
+
+void ConcurrentEvaluator::InvalidateNodeValue (const NodeId& nodeId) const
+{
+	ReadLockGuard lock (nodeManager.GetGraphLock ());
+	RemoveNodeValues (nodeId);
+}
+
+void ConcurrentEvaluator::InvalidateAllNodeValues ()
+{
+	nodeValueCache.Clear ();
+}
+
+bool ConcurrentEvaluator::EvaluateSteps (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env)
+{
+	ActiveScope activeScope (this);
+	for (size_t stepIndex = 0; stepIndex < plan.GetStepCount (); stepIndex++) {
+		if (env.IsCancelled ()) {
+			return false;
+		}
+		if (isStepNeeded[stepIndex]) {
+			plan.GetStep (stepIndex).node->Evaluate (env);
+		}
+	}
+	return !env.IsCancelled ();
+}
+
+void ConcurrentEvaluator::RemoveNodeValues (const NodeId& nodeId) const
+{
+	// a node without value never has dependents with value, so the traversal can stop there
+	std::vector<NodeId> nodesToInvalidate = { nodeId };
+	while (!nodesToInvalidate.empty ()) {
+		NodeId currentNodeId = nodesToInvalidate.back ();
+		nodesToInvalidate.pop_back ();
+		if (!nodeValueCache.Contains (currentNodeId)) {
+			continue;
+		}
+		nodeValueCache.Remove (currentNodeId);
+		nodeManager.EnumerateDependentNodes (nodeManager.GetNode (currentNodeId), [&] (const NodeId& dependentNodeId) {
+			nodesToInvalidate.push_back (dependentNodeId);
+		});
+	}
+}
+
+void ConcurrentEvaluator::SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& value) const
+{
+	nodeValueCache.Add (nodeId, value);
+}
+
+const ConcurrentEvaluator* ConcurrentEvaluator::GetActiveEvaluator (const NodeManager& nodeManager)
+{
+	if (activeEvaluator == nullptr || &activeEvaluator->nodeManager != &nodeManager) {
+		return nullptr;
+	}
+	return activeEvaluator;
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef NE_CONCURRENTEVALUATOR_HPP
+#define NE_CONCURRENTEVALUATOR_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeCollection.hpp"
+#include "NE_NodeValueCache.hpp"
+#include "NE_EvaluationEnv.hpp"
+
+namespace NE
+{
+
+// evaluates the nodes of a node manager into its own value cache, so any number
+// of concurrent evaluators can evaluate the same node manager on different threads,
+// every evaluator must be used by one thread at a time, it holds the read lock of
+// the node manager while evaluating, so structural edits wait for the evaluation
+//
+// nodes evaluated by a concurrent evaluator are always calculated, even in manual
+// update mode, their values are not processed, and early cutoff and structure
+// sharing are not used, the memoization cache of the node manager is shared
+class ConcurrentEvaluator
+{
+	friend class NodeManagerNodeEvaluator;
+
+public:
+	ConcurrentEvaluator (const NodeManager& nodeManager);
+	ConcurrentEvaluator (const ConcurrentEvaluator& src) = delete;
+	~ConcurrentEvaluator ();
+
+	ConcurrentEvaluator&	operator= (const ConcurrentEvaluator& rhs) = delete;
+
+	bool					EvaluateAllNodes (EvaluationEnv& env);
+	bool					EvaluateNodes (const NodeCollection& nodes, EvaluationEnv& env);
+
+	bool					HasCalculatedNodeValue (const NodeId& nodeId) const;
+	ValueConstPtr			GetCalculatedNodeValue (const NodeId& nodeId) const;
+	void					InvalidateNodeValue (const NodeId& nodeId) const;
+	void					InvalidateAllNodeValues ();
+
+private:
+	class ActiveScope
+	{
+	public:
+		ActiveScope (const ConcurrentEvaluator* evaluator);
+		~ActiveScope ();
+
+	private:
+		const ConcurrentEvaluator*	prevEvaluator;
+	};
+
+	bool						EvaluateSteps (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env);
+	void						RemoveNodeValues (const NodeId& nodeId) const;
+	void						SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& value) const;
+
+	static const ConcurrentEvaluator*	GetActiveEvaluator (const NodeManager& nodeManager);
+
+	const NodeManager&			nodeManager;
+	mutable NodeValueCache		nodeValueCache;
+};
+
+}
+
+#endif
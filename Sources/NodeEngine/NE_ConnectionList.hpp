@@ -4,132 +4,141 @@
 #include "NE_Debug.hpp"
 #include <unordered_map>
 #include <vector>
-#include <functional>
 #include <algorithm>
 
 namespace NE
 {
 
-template <class BegSlotType, class EndSlotType>
+// stores the connected slots of one direction with dense slot indices,
+// every connected slot has an index, and the connections are stored as
+// index arrays pointing into the slot list of the other direction,
+// slots without connections are removed and their indices are reused
+template <class SlotType>
 class ConnectionList
 {
 public:
+	using SlotKey = const typename SlotType::element_type*;
+
 	ConnectionList ();
 
-	void	Clear ();
-	bool	IsEmpty () const;
-	size_t	GetConnectionCount () const;
-	size_t	GetConnectionCount (const BegSlotType& begSlot) const;
+	void						Clear ();
+	bool						IsEmpty () const;
 
-	bool	HasConnection (const BegSlotType& begSlot) const;
-	bool	HasConnection (const BegSlotType& begSlot, const EndSlotType& endSlot) const;
-	void	EnumerateConnections (const BegSlotType& begSlot, const std::function<void (const EndSlotType&)>& processor) const;
+	bool						FindSlotIndex (const SlotType& slot, size_t& slotIndex) const;
+	size_t						GetOrAddSlotIndex (const SlotType& slot);
+	const SlotType&				GetSlot (size_t slotIndex) const;
 
-	void	AddConnection (const BegSlotType& begSlot, const EndSlotType& endSlot);
-	void	DeleteConnection (const BegSlotType& begSlot, const EndSlotType& endSlot);
+	const std::vector<size_t>&	GetConnections (size_t slotIndex) const;
+	bool						HasConnection (size_t slotIndex, size_t otherSlotIndex) const;
+	void						AddConnection (size_t slotIndex, size_t otherSlotIndex);
+	void						DeleteConnection (size_t slotIndex, size_t otherSlotIndex);
 
 private:
-	std::unordered_map<BegSlotType, std::vector<EndSlotType>> connections;
+	struct SlotEntry
+	{
+		SlotType			slot;
+		std::vector<size_t>	connections;
+	};
+
+	std::unordered_map<SlotKey, size_t>		slotIndices;
+	std::vector<SlotEntry>					slotEntries;
+	std::vector<size_t>						freeSlotIndices;
 };
 
-template <class BegSlotType, class EndSlotType>
-ConnectionList<BegSlotType, EndSlotType>::ConnectionList ()
+template <class SlotType>
+ConnectionList<SlotType>::ConnectionList () :
+	slotIndices (),
+	slotEntries (),
+	freeSlotIndices ()
 {
 
 }
 
-template <class BegSlotType, class EndSlotType>
-void ConnectionList<BegSlotType, EndSlotType>::Clear ()
+template <class SlotType>
+void ConnectionList<SlotType>::Clear ()
 {
-	connections.clear ();
+	slotIndices.clear ();
+	slotEntries.clear ();
+	freeSlotIndices.clear ();
 }
 
-template <class BegSlotType, class EndSlotType>
-bool ConnectionList<BegSlotType, EndSlotType>::IsEmpty () const
+template <class SlotType>
+bool ConnectionList<SlotType>::IsEmpty () const
 {
-	return GetConnectionCount () == 0;
+	return slotIndices.empty ();
 }
 
-template <class BegSlotType, class EndSlotType>
-size_t ConnectionList<BegSlotType, EndSlotType>::GetConnectionCount () const
+template <class SlotType>
+bool ConnectionList<SlotType>::FindSlotIndex (const SlotType& slot, size_t& slotIndex) const
 {
-	size_t result = 0;
-	for (const auto& connection : connections) {
-		result += connection.second.size ();
+	auto foundSlotIndex = slotIndices.find (slot.get ());
+	if (foundSlotIndex == slotIndices.end ()) {
+		return false;
 	}
-	return result;
+	slotIndex = foundSlotIndex->second;
+	return true;
 }
 
-template <class BegSlotType, class EndSlotType>
-size_t ConnectionList<BegSlotType, EndSlotType>::GetConnectionCount (const BegSlotType& begSlot) const
+template <class SlotType>
+size_t ConnectionList<SlotType>::GetOrAddSlotIndex (const SlotType& slot)
 {
-	auto foundEndSlots = connections.find (begSlot);
-	if (foundEndSlots == connections.end ()) {
-		return 0;
+	size_t slotIndex = 0;
+	if (FindSlotIndex (slot, slotIndex)) {
+		return slotIndex;
+	}
+	if (!freeSlotIndices.empty ()) {
+		slotIndex = freeSlotIndices.back ();
+		freeSlotIndices.pop_back ();
+		slotEntries[slotIndex].slot = slot;
+	} else {
+		slotIndex = slotEntries.size ();
+		slotEntries.push_back ({ slot, {} });
 	}
-	return foundEndSlots->second.size ();
+	slotIndices.insert ({ slot.get (), slotIndex });
+	return slotIndex;
 }
 
-template <class BegSlotType, class EndSlotType>
-bool ConnectionList<BegSlotType, EndSlotType>::HasConnection (const BegSlotType& begSlot) const
+template <class SlotType>
+const SlotType& ConnectionList<SlotType>::GetSlot (size_t slotIndex) const
 {
-	auto foundEndSlots = connections.find (begSlot);
-	if (foundEndSlots == connections.end ()) {
-		return false;
-	}
-	return !foundEndSlots->second.empty ();
+	return slotEntries[slotIndex].slot;
 }
 
-template <class BegSlotType, class EndSlotType>
-bool ConnectionList<BegSlotType, EndSlotType>::HasConnection (const BegSlotType& begSlot, const EndSlotType& endSlot) const
+template <class SlotType>
+const std::vector<size_t>& ConnectionList<SlotType>::GetConnections (size_t slotIndex) const
 {
-	auto foundEndSlots = connections.find (begSlot);
-	if (foundEndSlots == connections.end ()) {
-		return false;
-	}
-	const std::vector<EndSlotType>& endSlots = foundEndSlots->second;
-	return std::find (endSlots.begin (), endSlots.end (), endSlot) != endSlots.end ();
+	return slotEntries[slotIndex].connections;
 }
 
-template <class BegSlotType, class EndSlotType>
-void ConnectionList<BegSlotType, EndSlotType>::EnumerateConnections (const BegSlotType& begSlot, const std::function<void (const EndSlotType&)>& processor) const
+template <class SlotType>
+bool ConnectionList<SlotType>::HasConnection (size_t slotIndex, size_t otherSlotIndex) const
 {
-	auto foundEndSlots = connections.find (begSlot);
-	if (foundEndSlots == connections.end ()) {
-		return;
-	}
-	const std::vector<EndSlotType>& endSlots = foundEndSlots->second;
-	for (const EndSlotType& endSlot : endSlots) {
-		processor (endSlot);
-	}
+	const std::vector<size_t>& connections = slotEntries[slotIndex].connections;
+	return std::find (connections.begin (), connections.end (), otherSlotIndex) != connections.end ();
 }
 
-template <class BegSlotType, class EndSlotType>
-void ConnectionList<BegSlotType, EndSlotType>::AddConnection (const BegSlotType& begSlot, const EndSlotType& endSlot)
+template <class SlotType>
+void ConnectionList<SlotType>::AddConnection (size_t slotIndex, size_t otherSlotIndex)
 {
-	DBGASSERT (!HasConnection (begSlot, endSlot));
-	auto foundEndSlots = connections.find (begSlot);
-	if (foundEndSlots == connections.end ()) {
-		connections.insert ({ begSlot, { endSlot } });
-	} else {
-		foundEndSlots->second.push_back (endSlot);
-	}
+	DBGASSERT (!HasConnection (slotIndex, otherSlotIndex));
+	slotEntries[slotIndex].connections.push_back (otherSlotIndex);
 }
 
-template <class BegSlotType, class EndSlotType>
-void ConnectionList<BegSlotType, EndSlotType>::DeleteConnection (const BegSlotType& begSlot, const EndSlotType& endSlot)
+template <class SlotType>
+void ConnectionList<SlotType>::DeleteConnection (size_t slotIndex, size_t otherSlotIndex)
 {
-	DBGASSERT (HasConnection (begSlot, endSlot));
-	auto foundEndSlots = connections.find (begSlot);
-	if (DBGVERIFY (foundEndSlots != connections.end ())) {
-		std::vector<EndSlotType>& endSlots = foundEndSlots->second;
-		auto foundEndSlot = std::find (endSlots.begin (), endSlots.end (), endSlot);
-		if (DBGVERIFY (foundEndSlot != endSlots.end ())) {
-			endSlots.erase (foundEndSlot);
-			if (endSlots.empty ()) {
-				connections.erase (begSlot);
-			}
-		}
+	SlotEntry& slotEntry = slotEntries[slotIndex];
+	std::vector<size_t>& connections = slotEntry.connections;
+	auto foundConnection = std::find (connections.begin (), connections.end (), otherSlotIndex);
+	if (DBGERROR (foundConnection == connections.end ())) {
+		return;
+	}
+	// the order of the connections is kept, because it is the order of evaluation
+	connections.erase (foundConnection);
+	if (connections.empty ()) {
+		slotIndices.erase (slotEntry.slot.get ());
+		slotEntry.slot = nullptr;
+		freeSlotIndices.push_back (slotIndex);
 	}
 }
 
@@ -8,7 +8,8 @@ namespace NE
 
 ConnectionManager::ConnectionManager () :
 	outputToInputConnections (),
-	inputToOutputConnections ()
+	inputToOutputConnections (),
+	connectionCount (0)
 {
 
 }
@@ -17,48 +18,71 @@ void ConnectionManager::Clear ()
 {
 	outputToInputConnections.Clear ();
 	inputToOutputConnections.Clear ();
+	connectionCount = 0;
 }
 
 bool ConnectionManager::IsEmpty () const
 {
 	DBGASSERT (inputToOutputConnections.IsEmpty () == outputToInputConnections.IsEmpty ());
-	return outputToInputConnections.IsEmpty ();
+	DBGASSERT (outputToInputConnections.IsEmpty () == (connectionCount == 0));
+	return connectionCount == 0;
 }
 
 size_t ConnectionManager::GetConnectionCount () const
 {
-	DBGASSERT (inputToOutputConnections.GetConnectionCount () == outputToInputConnections.GetConnectionCount ());
-	return outputToInputConnections.GetConnectionCount ();
+	return connectionCount;
 }
 
 bool ConnectionManager::HasConnectedOutputSlots (const InputSlotConstPtr& inputSlot) const
 {
-	return inputToOutputConnections.HasConnection (inputSlot);
+	size_t inputSlotIndex = 0;
+	return inputToOutputConnections.FindSlotIndex (inputSlot, inputSlotIndex);
 }
 
 bool ConnectionManager::HasConnectedInputSlots (const OutputSlotConstPtr& outputSlot) const
 {
-	return outputToInputConnections.HasConnection (outputSlot);
+	size_t outputSlotIndex = 0;
+	return outputToInputConnections.FindSlotIndex (outputSlot, outputSlotIndex);
 }
 
 size_t ConnectionManager::GetConnectedOutputSlotCount (const InputSlotConstPtr& inputSlot) const
 {
-	return inputToOutputConnections.GetConnectionCount (inputSlot);
+	size_t inputSlotIndex = 0;
+	if (!inputToOutputConnections.FindSlotIndex (inputSlot, inputSlotIndex)) {
+		return 0;
+	}
+	return inputToOutputConnections.GetConnections (inputSlotIndex).size ();
 }
 
 size_t ConnectionManager::GetConnectedInputSlotCount (const OutputSlotConstPtr& outputSlot) const
 {
-	return outputToInputConnections.GetConnectionCount (outputSlot);
+	size_t outputSlotIndex = 0;
+	if (!outputToInputConnections.FindSlotIndex (outputSlot, outputSlotIndex)) {
+		return 0;
+	}
+	return outputToInputConnections.GetConnections (outputSlotIndex).size ();
 }
 
 void ConnectionManager::EnumerateConnectedOutputSlots (const InputSlotConstPtr& inputSlot, const std::function<void (const OutputSlotConstPtr&)>& processor) const
 {
-	inputToOutputConnections.EnumerateConnections (inputSlot, processor);
+	size_t inputSlotIndex = 0;
+	if (!inputToOutputConnections.FindSlotIndex (inputSlot, inputSlotIndex)) {
+		return;
+	}
+	for (size_t outputSlotIndex : inputToOutputConnections.GetConnections (inputSlotIndex)) {
+		processor (outputToInputConnections.GetSlot (outputSlotIndex));
+	}
 }
 
 void ConnectionManager::EnumerateConnectedInputSlots (const OutputSlotConstPtr& outputSlot, const std::function<void (const InputSlotConstPtr&)>& processor) const
 {
-	outputToInputConnections.EnumerateConnections (outputSlot, processor);
+	size_t outputSlotIndex = 0;
+	if (!outputToInputConnections.FindSlotIndex (outputSlot, outputSlotIndex)) {
+		return;
+	}
+	for (size_t inputSlotIndex : outputToInputConnections.GetConnections (outputSlotIndex)) {
+		processor (inputToOutputConnections.GetSlot (inputSlotIndex));
+	}
 }
 
 bool ConnectionManager::IsOutputSlotConnectedToInputSlot (const OutputSlotConstPtr& outputSlot, const InputSlotConstPtr& inputSlot) const
@@ -66,8 +90,16 @@ bool ConnectionManager::IsOutputSlotConnectedToInputSlot (const OutputSlotConstP
 	if (outputSlot == nullptr || inputSlot == nullptr) {
 		return false;
 	}
-	DBGASSERT (outputToInputConnections.HasConnection (outputSlot, inputSlot) == inputToOutputConnections.HasConnection (inputSlot, outputSlot));
-	return outputToInputConnections.HasConnection (outputSlot, inputSlot);
+	size_t outputSlotIndex = 0;
+	size_t inputSlotIndex = 0;
+	if (!outputToInputConnections.FindSlotIndex (outputSlot, outputSlotIndex) || !inputToOutputConnections.FindSlotIndex (inputSlot, inputSlotIndex)) {
+		return false;
+	}
+	DBGASSERT (outputToInputConnections.HasConnection (outputSlotIndex, inputSlotIndex) == inputToOutputConnections.HasConnection (inputSlotIndex, outputSlotIndex));
+	if (inputToOutputConnections.GetConnections (inputSlotIndex).size () < outputToInputConnections.GetConnections (outputSlotIndex).size ()) {
+		return inputToOutputConnections.HasConnection (inputSlotIndex, outputSlotIndex);
+	}
+	return outputToInputConnections.HasConnection (outputSlotIndex, inputSlotIndex);
 }
 
 bool ConnectionManager::CanConnectOutputSlotToInputSlot (const InputSlotConstPtr& inputSlot) const
@@ -111,8 +143,7 @@ bool ConnectionManager::CanConnectOutputSlotToInputSlot (const OutputSlotConstPt
 		return false;
 	}
 
-	DBGASSERT (outputToInputConnections.HasConnection (outputSlot, inputSlot) == inputToOutputConnections.HasConnection (inputSlot, outputSlot));
-	if (outputToInputConnections.HasConnection (outputSlot, inputSlot)) {
+	if (IsOutputSlotConnectedToInputSlot (outputSlot, inputSlot)) {
 		return false;
 	}
 
@@ -127,8 +158,11 @@ bool ConnectionManager::ConnectOutputSlotToInputSlot (const OutputSlotConstPtr&
 	if (inputSlot->GetOutputSlotConnectionMode () == OutputSlotConnectionMode::Single) {
 		DisconnectAllOutputSlotsFromInputSlot (inputSlot);
 	}
-	inputToOutputConnections.AddConnection (inputSlot, outputSlot);
-	outputToInputConnections.AddConnection (outputSlot, inputSlot);
+	size_t outputSlotIndex = outputToInputConnections.GetOrAddSlotIndex (outputSlot);
+	size_t inputSlotIndex = inputToOutputConnections.GetOrAddSlotIndex (inputSlot);
+	outputToInputConnections.AddConnection (outputSlotIndex, inputSlotIndex);
+	inputToOutputConnections.AddConnection (inputSlotIndex, outputSlotIndex);
+	connectionCount++;
 	return true;
 }
 
@@ -137,8 +171,17 @@ bool ConnectionManager::DisconnectOutputSlotFromInputSlot (const OutputSlotConst
 	if (DBGERROR (outputSlot == nullptr || inputSlot == nullptr)) {
 		return false;
 	}
-	inputToOutputConnections.DeleteConnection (inputSlot, outputSlot);
-	outputToInputConnections.DeleteConnection (outputSlot, inputSlot);
+	size_t outputSlotIndex = 0;
+	size_t inputSlotIndex = 0;
+	if (DBGERROR (!outputToInputConnections.FindSlotIndex (outputSlot, outputSlotIndex) || !inputToOutputConnections.FindSlotIndex (inputSlot, inputSlotIndex))) {
+		return false;
+	}
+	if (DBGERROR (!outputToInputConnections.HasConnection (outputSlotIndex, inputSlotIndex))) {
+		return false;
+	}
+	outputToInputConnections.DeleteConnection (outputSlotIndex, inputSlotIndex);
+	inputToOutputConnections.DeleteConnection (inputSlotIndex, outputSlotIndex);
+	connectionCount--;
 	return true;
 }
 
@@ -147,9 +190,9 @@ bool ConnectionManager::DisconnectAllOutputSlotsFromInputSlot (const InputSlotCo
 	if (DBGERROR (inputSlot == nullptr)) {
 		return false;
 	}
-	std::unordered_set<OutputSlotConstPtr> outputSlotsToDisconnect;
+	std::vector<OutputSlotConstPtr> outputSlotsToDisconnect;
 	EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
-		outputSlotsToDisconnect.insert (outputSlot);
+		outputSlotsToDisconnect.push_back (outputSlot);
 	});
 	for (const OutputSlotConstPtr& outputSlot : outputSlotsToDisconnect) {
 		DisconnectOutputSlotFromInputSlot (outputSlot, inputSlot);
@@ -162,9 +205,9 @@ bool ConnectionManager::DisconnectAllInputSlotsFromOutputSlot (const OutputSlotC
 	if (DBGERROR (outputSlot == nullptr)) {
 		return false;
 	}
-	std::unordered_set<InputSlotConstPtr> inputSlotsToDisconnect;
+	std::vector<InputSlotConstPtr> inputSlotsToDisconnect;
 	EnumerateConnectedInputSlots (outputSlot, [&] (const InputSlotConstPtr& inputSlot) {
-		inputSlotsToDisconnect.insert (inputSlot);
+		inputSlotsToDisconnect.push_back (inputSlot);
 	});
 	for (const InputSlotConstPtr& inputSlot : inputSlotsToDisconnect) {
 		DisconnectOutputSlotFromInputSlot (outputSlot, inputSlot);
@@ -3,8 +3,7 @@
 
 #include "NE_NodeEngineTypes.hpp"
 #include "NE_ConnectionList.hpp"
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 #include <functional>
 
 namespace NE
@@ -38,8 +37,9 @@ public:
 	bool	DisconnectAllInputSlotsFromOutputSlot (const OutputSlotConstPtr& outputSlot);
 
 private:
-	ConnectionList<OutputSlotConstPtr, InputSlotConstPtr>	outputToInputConnections;
-	ConnectionList<InputSlotConstPtr, OutputSlotConstPtr>	inputToOutputConnections;
+	ConnectionList<OutputSlotConstPtr>	outputToInputConnections;
+	ConnectionList<InputSlotConstPtr>	inputToOutputConnections;
+	size_t								connectionCount;
 };
 
 }
@@ -13,8 +13,50 @@ EvaluationData::~EvaluationData ()
 
 }
 
+CancellationToken::CancellationToken () :
+	isCancelled (false)
+{
+
+}
+
+CancellationToken::~CancellationToken ()
+{
+
+}
+
+void CancellationToken::Cancel ()
+{
+	isCancelled.store (true);
+}
+
+void CancellationToken::Reset ()
+{
+	isCancelled.store (false);
+}
+
+bool CancellationToken::IsCancelled () const
+{
+	return isCancelled.load ();
+}
+
 EvaluationEnv::EvaluationEnv (const EvaluationDataPtr& data) :
-	data (data)
+	data (data),
+	cancellationToken (nullptr),
+	hasDeadline (false),
+	deadline (),
+	isForceCalculation (false),
+	interruptionCount (0)
+{
+
+}
+
+EvaluationEnv::EvaluationEnv (const EvaluationEnv& src) :
+	data (src.data),
+	cancellationToken (src.cancellationToken),
+	hasDeadline (src.hasDeadline),
+	deadline (src.deadline),
+	isForceCalculation (src.isForceCalculation),
+	interruptionCount (0)
 {
 
 }
@@ -24,6 +66,72 @@ EvaluationEnv::~EvaluationEnv ()
 
 }
 
+const CancellationTokenPtr& EvaluationEnv::GetCancellationToken () const
+{
+	return cancellationToken;
+}
+
+void EvaluationEnv::SetCancellationToken (const CancellationTokenPtr& newCancellationToken)
+{
+	cancellationToken = newCancellationToken;
+}
+
+bool EvaluationEnv::HasDeadline () const
+{
+	return hasDeadline;
+}
+
+EvaluationEnv::Clock::time_point EvaluationEnv::GetDeadline () const
+{
+	return deadline;
+}
+
+void EvaluationEnv::SetDeadline (const Clock::time_point& newDeadline)
+{
+	hasDeadline = true;
+	deadline = newDeadline;
+}
+
+void EvaluationEnv::SetTimeBudget (const Clock::duration& timeBudget)
+{
+	SetDeadline (Clock::now () + timeBudget);
+}
+
+void EvaluationEnv::ClearDeadline ()
+{
+	hasDeadline = false;
+	deadline = Clock::time_point ();
+}
+
+bool EvaluationEnv::IsForceCalculation () const
+{
+	return isForceCalculation;
+}
+
+void EvaluationEnv::SetForceCalculation (bool newIsForceCalculation)
+{
+	isForceCalculation = newIsForceCalculation;
+}
+
+bool EvaluationEnv::IsCancelled () const
+{
+	if (IsTokenCancelled () || (hasDeadline && Clock::now () >= deadline)) {
+		interruptionCount++;
+		return true;
+	}
+	return false;
+}
+
+bool EvaluationEnv::IsTokenCancelled () const
+{
+	return cancellationToken != nullptr && cancellationToken->IsCancelled ();
+}
+
+size_t EvaluationEnv::GetInterruptionCount () const
+{
+	return interruptionCount;
+}
+
 EvaluationEnv EmptyEvaluationEnv (nullptr);
 
 }
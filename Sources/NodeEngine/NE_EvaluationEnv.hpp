@@ -2,6 +2,8 @@
 #define NE_EVALUATIONENVIRONMENT_HPP
 
 #include <memory>
+#include <atomic>
+#include <chrono>
 
 namespace NE
 {
@@ -16,20 +18,71 @@ public:
 using EvaluationDataPtr = std::shared_ptr<EvaluationData>;
 using EvaluationDataConstPtr = std::shared_ptr<const EvaluationData>;
 
+class CancellationToken
+{
+public:
+	CancellationToken ();
+	CancellationToken (const CancellationToken&) = delete;
+	~CancellationToken ();
+
+	CancellationToken&	operator= (const CancellationToken&) = delete;
+
+	void				Cancel ();
+	void				Reset ();
+	bool				IsCancelled () const;
+
+private:
+	std::atomic<bool>	isCancelled;
+};
+
+using CancellationTokenPtr = std::shared_ptr<CancellationToken>;
+using CancellationTokenConstPtr = std::shared_ptr<const CancellationToken>;
+
 class EvaluationEnv
 {
 public:
+	using Clock = std::chrono::steady_clock;
+
 	EvaluationEnv (const EvaluationDataPtr& data);
+	EvaluationEnv (const EvaluationEnv& src);
 	~EvaluationEnv ();
 
+	EvaluationEnv&					operator= (const EvaluationEnv& rhs) = delete;
+
 	template <typename T>
 	bool IsDataType () const;
 
 	template <typename T>
 	std::shared_ptr<T> GetData ();
 
+	const CancellationTokenPtr&		GetCancellationToken () const;
+	void							SetCancellationToken (const CancellationTokenPtr& newCancellationToken);
+
+	bool							HasDeadline () const;
+	Clock::time_point				GetDeadline () const;
+	void							SetDeadline (const Clock::time_point& newDeadline);
+	void							SetTimeBudget (const Clock::duration& timeBudget);
+	void							ClearDeadline ();
+
+	// a forced evaluation calculates the nodes that the update mode disables
+	bool							IsForceCalculation () const;
+	void							SetForceCalculation (bool newIsForceCalculation);
+
+	// long running nodes can poll this to stop their calculation early
+	bool							IsCancelled () const;
+	bool							IsTokenCancelled () const;
+
+	// counts the IsCancelled calls that returned true, so a calculation that ran
+	// without seeing a cancellation is known to be complete even after the deadline
+	size_t							GetInterruptionCount () const;
+
 private:
-	EvaluationDataPtr data;
+	EvaluationDataPtr				data;
+	CancellationTokenPtr			cancellationToken;
+	bool							hasDeadline;
+	Clock::time_point				deadline;
+	bool							isForceCalculation;
+	mutable std::atomic<size_t>		interruptionCount;
 };
 
 template <typename T>
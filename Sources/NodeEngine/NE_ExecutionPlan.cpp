@@ -0,0 +1,137 @@
+#include "NE_ExecutionPlan.hpp"
+#include "NE_Node.hpp"
+#include "NE_Debug.hpp"
+
+#include <algorithm>
+
+namespace NE
+{
+
+ExecutionPlan::Step::Step (const NodeConstPtr& node) :
+	node (node),
+	inputSteps (),
+	level (0)
+{
+
+}
+
+ExecutionPlan::ExecutionPlan () :
+	steps (),
+	nodeIdToStep (),
+	levels (),
+	isFinalized (false)
+{
+
+}
+
+ExecutionPlan::~ExecutionPlan ()
+{
+
+}
+
+void ExecutionPlan::Clear ()
+{
+	steps.clear ();
+	nodeIdToStep.clear ();
+	levels.clear ();
+	isFinalized = false;
+}
+
+bool ExecutionPlan::IsEmpty () const
+{
+	return steps.empty ();
+}
+
+bool ExecutionPlan::IsFinalized () const
+{
+	return isFinalized;
+}
+
+size_t ExecutionPlan::GetStepCount () const
+{
+	return steps.size ();
+}
+
+const ExecutionPlan::Step& ExecutionPlan::GetStep (size_t stepIndex) const
+{
+	return steps[stepIndex];
+}
+
+bool ExecutionPlan::ContainsNode (const NodeId& nodeId) const
+{
+	return nodeIdToStep.find (nodeId) != nodeIdToStep.end ();
+}
+
+size_t ExecutionPlan::GetStepIndex (const NodeId& nodeId) const
+{
+	return nodeIdToStep.at (nodeId);
+}
+
+std::vector<bool> ExecutionPlan::GetRequiredSteps (const NodeCollection& nodes) const
+{
+	// steps are in topological order, so a backward pass collects
+	// every transitive input of the requested nodes
+	std::vector<bool> isStepRequired (steps.size (), false);
+	nodes.Enumerate ([&] (const NodeId& nodeId) {
+		if (ContainsNode (nodeId)) {
+			isStepRequired[GetStepIndex (nodeId)] = true;
+		}
+		return true;
+	});
+	for (size_t i = steps.size (); i > 0; i--) {
+		size_t stepIndex = i - 1;
+		if (!isStepRequired[stepIndex]) {
+			continue;
+		}
+		for (size_t inputStepIndex : steps[stepIndex].inputSteps) {
+			isStepRequired[inputStepIndex] = true;
+		}
+	}
+	return isStepRequired;
+}
+
+size_t ExecutionPlan::GetLevelCount () const
+{
+	return levels.size ();
+}
+
+const std::vector<size_t>& ExecutionPlan::GetLevelSteps (size_t levelIndex) const
+{
+	return levels[levelIndex];
+}
+
+void ExecutionPlan::AddStep (const NodeConstPtr& node)
+{
+	DBGASSERT (!isFinalized);
+	nodeIdToStep.insert ({ node->GetId (), steps.size () });
+	steps.push_back (Step (node));
+}
+
+void ExecutionPlan::AddInputStep (size_t stepIndex, const NodeId& inputNodeId)
+{
+	DBGASSERT (!isFinalized);
+	size_t inputStepIndex = nodeIdToStep.at (inputNodeId);
+	DBGASSERT (inputStepIndex < stepIndex);
+	steps[stepIndex].inputSteps.push_back (inputStepIndex);
+}
+
+void ExecutionPlan::Finalize ()
+{
+	DBGASSERT (!isFinalized);
+	for (size_t stepIndex = 0; stepIndex < steps.size (); ++stepIndex) {
+		Step& step = steps[stepIndex];
+		std::sort (step.inputSteps.begin (), step.inputSteps.end ());
+		step.inputSteps.erase (std::unique (step.inputSteps.begin (), step.inputSteps.end ()), step.inputSteps.end ());
+		step.level = 0;
+		for (size_t inputStepIndex : step.inputSteps) {
+			step.level = std::max (step.level, steps[inputStepIndex].level + 1);
+		}
+		if (step.level >= levels.size ()) {
+			levels.resize (step.level + 1);
+		}
+		levels[step.level].push_back (stepIndex);
+	}
+	isFinalized = true;
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef NE_EXECUTIONPLAN_HPP
+#define NE_EXECUTIONPLAN_HPP
+
+#include "NE_NodeEngineTypes.hpp"
+#include "NE_NodeId.hpp"
+#include "NE_NodeCollection.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+namespace NE
+{
+
+class ExecutionPlan
+{
+public:
+	class Step
+	{
+	public:
+		Step (const NodeConstPtr& node);
+
+		NodeConstPtr		node;
+		std::vector<size_t>	inputSteps;
+		size_t				level;
+	};
+
+	ExecutionPlan ();
+	~ExecutionPlan ();
+
+	void									Clear ();
+	bool									IsEmpty () const;
+	bool									IsFinalized () const;
+
+	size_t									GetStepCount () const;
+	const Step&								GetStep (size_t stepIndex) const;
+	bool									ContainsNode (const NodeId& nodeId) const;
+	size_t									GetStepIndex (const NodeId& nodeId) const;
+	std::vector<bool>						GetRequiredSteps (const NodeCollection& nodes) const;
+
+	size_t									GetLevelCount () const;
+	const std::vector<size_t>&				GetLevelSteps (size_t levelIndex) const;
+
+	void									AddStep (const NodeConstPtr& node);
+	void									AddInputStep (size_t stepIndex, const NodeId& inputNodeId);
+	void									Finalize ();
+
+private:
+	std::vector<Step>						steps;
+	std::unordered_map<NodeId, size_t>		nodeIdToStep;
+	std::vector<std::vector<size_t>>		levels;
+	bool									isFinalized;
+};
+
+using ExecutionPlanPtr = std::shared_ptr<ExecutionPlan>;
+using ExecutionPlanConstPtr = std::shared_ptr<const ExecutionPlan>;
+
+}
+
+#endif
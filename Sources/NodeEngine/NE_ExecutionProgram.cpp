@@ -0,0 +1,336 @@
+#include "NE_ExecutionProgram.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_Debug.hpp"
+
+namespace NE
+{
+
+// every node of the program has its own evaluator, so the node index is known
+// without any lookup, and the connections are read from the resolved bindings
+class ExecutionProgramNodeEvaluator : public NodeEvaluator
+{
+public:
+	ExecutionProgramNodeEvaluator (ExecutionProgram& program, size_t nodeIndex) :
+		program (program),
+		nodeIndex (nodeIndex)
+	{
+
+	}
+
+	virtual void InvalidateNodeValue (const NodeId&) const override
+	{
+		program.InvalidateNodeValue (nodeIndex);
+	}
+
+	virtual bool HasConnectedOutputSlots (const InputSlotConstPtr& inputSlot) const override
+	{
+		return program.FindInputBinding (nodeIndex, inputSlot) != nullptr;
+	}
+
+	virtual void EnumerateConnectedOutputSlots (const InputSlotConstPtr& inputSlot, const std::function<void (const OutputSlotConstPtr&)>& processor) const override
+	{
+		const ExecutionProgram::InputBinding* binding = program.FindInputBinding (nodeIndex, inputSlot);
+		if (binding == nullptr) {
+			return;
+		}
+		for (size_t i = binding->firstSourceSlot; i < binding->endSourceSlot; i++) {
+			processor (program.sourceSlots[i]);
+		}
+	}
+
+	virtual bool IsCalculationEnabled () const override
+	{
+		return true;
+	}
+
+	virtual bool HasCalculatedNodeValue (const NodeId&) const override
+	{
+		return program.isRegisterValid[nodeIndex];
+	}
+
+	virtual ValueConstPtr GetCalculatedNodeValue (const NodeId&) const override
+	{
+		return program.registers[nodeIndex];
+	}
+
+	virtual bool IsNodeValueEvicted (const NodeId&) const override
+	{
+		return false;
+	}
+
+	virtual void SetCalculatedNodeValue (const NodeId&, const ValueConstPtr& valuePtr) const override
+	{
+		program.registers[nodeIndex] = valuePtr;
+		program.isRegisterValid[nodeIndex] = true;
+	}
+
+	virtual bool IsValueProcessingEnabled () const override
+	{
+		return program.isValueProcessingEnabled;
+	}
+
+	virtual bool RevalidateNodeValue (const NodeId&, EvaluationEnv&) const override
+	{
+		return false;
+	}
+
+	virtual bool IsMemoizationEnabled () const override
+	{
+		return false;
+	}
+
+	virtual bool GetMemoizedNodeValue (const NodeMemoizationKey&, ValueConstPtr&) const override
+	{
+		return false;
+	}
+
+	virtual void SetMemoizedNodeValue (const NodeMemoizationKey&, const ValueConstPtr&) const override
+	{
+
+	}
+
+	virtual NodeEvaluationProfiler* GetProfiler () const override
+	{
+		return nullptr;
+	}
+
+private:
+	ExecutionProgram&	program;
+	size_t				nodeIndex;
+};
+
+ExecutionProgram::Instruction::Instruction (const NodePtr& node) :
+	node (node),
+	firstInputBinding (0),
+	endInputBinding (0),
+	firstSuccessor (0),
+	endSuccessor (0)
+{
+
+}
+
+ExecutionProgram::InputBinding::InputBinding (const InputSlotConstPtr& inputSlot) :
+	inputSlot (inputSlot),
+	firstSourceSlot (0),
+	endSourceSlot (0)
+{
+
+}
+
+ExecutionProgram::ExecutionProgram () :
+	graph (nullptr),
+	instructions (),
+	inputBindings (),
+	sourceSlots (),
+	successors (),
+	nodeIdToIndex (),
+	registers (),
+	isRegisterValid (),
+	isValueProcessingEnabled (true)
+{
+
+}
+
+ExecutionProgram::~ExecutionProgram ()
+{
+	Clear ();
+}
+
+bool ExecutionProgram::Compile (const NodeManager& nodeManager)
+{
+	Clear ();
+
+	// the program works on its own copy of the graph, because the nodes
+	// of the copy are bound to the program instead of the node manager
+	graph.reset (new NodeManager ());
+	if (DBGERROR (!NodeManager::Clone (nodeManager, *graph))) {
+		Clear ();
+		return false;
+	}
+
+	ExecutionPlanConstPtr plan = graph->GetExecutionPlan ();
+	size_t instructionCount = plan->GetStepCount ();
+	instructions.reserve (instructionCount);
+	for (size_t i = 0; i < instructionCount; i++) {
+		const NodeId& nodeId = plan->GetStep (i).node->GetId ();
+		nodeIdToIndex.insert ({ nodeId, i });
+		instructions.push_back (Instruction (graph->GetNode (nodeId)));
+	}
+
+	std::vector<size_t> successorCounts (instructionCount, 0);
+	for (size_t i = 0; i < instructionCount; i++) {
+		Instruction& instruction = instructions[i];
+		instruction.firstInputBinding = inputBindings.size ();
+		NodeConstPtr node = instruction.node;
+		node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
+			if (!graph->HasConnectedOutputSlots (inputSlot)) {
+				return true;
+			}
+			InputBinding binding (inputSlot);
+			binding.firstSourceSlot = sourceSlots.size ();
+			graph->EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+				sourceSlots.push_back (outputSlot);
+			});
+			binding.endSourceSlot = sourceSlots.size ();
+			inputBindings.push_back (binding);
+			return true;
+		});
+		instruction.endInputBinding = inputBindings.size ();
+		for (size_t inputStepIndex : plan->GetStep (i).inputSteps) {
+			successorCounts[inputStepIndex]++;
+		}
+	}
+
+	size_t successorOffset = 0;
+	for (size_t i = 0; i < instructionCount; i++) {
+		instructions[i].firstSuccessor = successorOffset;
+		instructions[i].endSuccessor = successorOffset;
+		successorOffset += successorCounts[i];
+	}
+	successors.resize (successorOffset);
+	for (size_t i = 0; i < instructionCount; i++) {
+		for (size_t inputStepIndex : plan->GetStep (i).inputSteps) {
+			successors[instructions[inputStepIndex].endSuccessor++] = i;
+		}
+	}
+
+	for (size_t i = 0; i < instructionCount; i++) {
+		instructions[i].node->SetEvaluator (NodeEvaluatorConstPtr (new ExecutionProgramNodeEvaluator (*this, i)));
+	}
+
+	registers.assign (instructionCount, nullptr);
+	isRegisterValid.assign (instructionCount, false);
+	return true;
+}
+
+void ExecutionProgram::Clear ()
+{
+	for (Instruction& instruction : instructions) {
+		instruction.node->SetEvaluator (nullptr);
+	}
+	instructions.clear ();
+	inputBindings.clear ();
+	sourceSlots.clear ();
+	successors.clear ();
+	nodeIdToIndex.clear ();
+	registers.clear ();
+	isRegisterValid.clear ();
+	graph.reset ();
+}
+
+bool ExecutionProgram::IsEmpty () const
+{
+	return instructions.empty ();
+}
+
+size_t ExecutionProgram::GetInstructionCount () const
+{
+	return instructions.size ();
+}
+
+bool ExecutionProgram::ContainsNode (const NodeId& nodeId) const
+{
+	return nodeIdToIndex.find (nodeId) != nodeIdToIndex.end ();
+}
+
+size_t ExecutionProgram::GetNodeIndex (const NodeId& nodeId) const
+{
+	return nodeIdToIndex.at (nodeId);
+}
+
+bool ExecutionProgram::IsValueProcessingEnabled () const
+{
+	return isValueProcessingEnabled;
+}
+
+void ExecutionProgram::SetValueProcessingEnabled (bool isEnabled)
+{
+	isValueProcessingEnabled = isEnabled;
+}
+
+bool ExecutionProgram::SetInputSlotDefaultValue (size_t nodeIndex, const SlotId& slotId, const ValueConstPtr& value)
+{
+	const NodePtr& node = instructions[nodeIndex].node;
+	if (DBGERROR (!node->HasInputSlot (slotId))) {
+		return false;
+	}
+	node->SetInputSlotDefaultValue (slotId, value);
+	InvalidateNodeValue (nodeIndex);
+	return true;
+}
+
+void ExecutionProgram::InvalidateNodeValue (size_t nodeIndex)
+{
+	// an invalid register never has valid successors, so the
+	// traversal can stop at the already invalid registers
+	std::vector<size_t> nodesToInvalidate = { nodeIndex };
+	while (!nodesToInvalidate.empty ()) {
+		size_t currentIndex = nodesToInvalidate.back ();
+		nodesToInvalidate.pop_back ();
+		if (!isRegisterValid[currentIndex]) {
+			continue;
+		}
+		registers[currentIndex] = nullptr;
+		isRegisterValid[currentIndex] = false;
+		const Instruction& instruction = instructions[currentIndex];
+		for (size_t i = instruction.firstSuccessor; i < instruction.endSuccessor; i++) {
+			nodesToInvalidate.push_back (successors[i]);
+		}
+	}
+}
+
+void ExecutionProgram::InvalidateAllNodeValues ()
+{
+	registers.assign (instructions.size (), nullptr);
+	isRegisterValid.assign (instructions.size (), false);
+}
+
+bool ExecutionProgram::Run (EvaluationEnv& env)
+{
+	for (size_t i = 0; i < instructions.size (); i++) {
+		if (isRegisterValid[i]) {
+			continue;
+		}
+		if (env.IsCancelled ()) {
+			return false;
+		}
+		const Node* node = instructions[i].node.get ();
+		size_t interruptionCount = env.GetInterruptionCount ();
+		ValueConstPtr value = node->Calculate (env);
+		if (env.IsTokenCancelled () || env.GetInterruptionCount () != interruptionCount) {
+			return false;
+		}
+		registers[i] = value;
+		isRegisterValid[i] = true;
+		if (isValueProcessingEnabled) {
+			node->ProcessCalculatedValue (value, env);
+		}
+	}
+	return true;
+}
+
+bool ExecutionProgram::HasNodeValue (size_t nodeIndex) const
+{
+	return isRegisterValid[nodeIndex];
+}
+
+ValueConstPtr ExecutionProgram::GetNodeValue (size_t nodeIndex) const
+{
+	return registers[nodeIndex];
+}
+
+const ExecutionProgram::InputBinding* ExecutionProgram::FindInputBinding (size_t nodeIndex, const InputSlotConstPtr& inputSlot) const
+{
+	// nodes have only a few connected input slots, so a linear search is the fastest
+	const Instruction& instruction = instructions[nodeIndex];
+	for (size_t i = instruction.firstInputBinding; i < instruction.endInputBinding; i++) {
+		if (inputBindings[i].inputSlot == inputSlot) {
+			return &inputBindings[i];
+		}
+	}
+	return nullptr;
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef NE_EXECUTIONPROGRAM_HPP
+#define NE_EXECUTIONPROGRAM_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeId.hpp"
+#include "NE_SlotId.hpp"
+#include "NE_Value.hpp"
+#include "NE_EvaluationEnv.hpp"
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+namespace NE
+{
+
+// a node manager graph compiled into a linear list of instructions, every node
+// gets a dense index and a value register, and the connections are resolved at
+// compile time, so running the program again does not touch the node manager
+class ExecutionProgram
+{
+	friend class ExecutionProgramNodeEvaluator;
+
+public:
+	ExecutionProgram ();
+	ExecutionProgram (const ExecutionProgram& src) = delete;
+	~ExecutionProgram ();
+
+	ExecutionProgram&	operator= (const ExecutionProgram& rhs) = delete;
+
+	bool				Compile (const NodeManager& nodeManager);
+	void				Clear ();
+	bool				IsEmpty () const;
+
+	size_t				GetInstructionCount () const;
+	bool				ContainsNode (const NodeId& nodeId) const;
+	size_t				GetNodeIndex (const NodeId& nodeId) const;
+
+	bool				IsValueProcessingEnabled () const;
+	void				SetValueProcessingEnabled (bool isEnabled);
+
+	bool				SetInputSlotDefaultValue (size_t nodeIndex, const SlotId& slotId, const ValueConstPtr& value);
+	void				InvalidateNodeValue (size_t nodeIndex);
+	void				InvalidateAllNodeValues ();
+
+	bool				Run (EvaluationEnv& env);
+	bool				HasNodeValue (size_t nodeIndex) const;
+	ValueConstPtr		GetNodeValue (size_t nodeIndex) const;
+
+private:
+	class Instruction
+	{
+	public:
+		Instruction (const NodePtr& node);
+
+		NodePtr		node;
+		size_t		firstInputBinding;
+		size_t		endInputBinding;
+		size_t		firstSuccessor;
+		size_t		endSuccessor;
+	};
+
+	class InputBinding
+	{
+	public:
+		InputBinding (const InputSlotConstPtr& inputSlot);
+
+		InputSlotConstPtr	inputSlot;
+		size_t				firstSourceSlot;
+		size_t				endSourceSlot;
+	};
+
+	const InputBinding*		FindInputBinding (size_t nodeIndex, const InputSlotConstPtr& inputSlot) const;
+
+	std::unique_ptr<NodeManager>		graph;
+	std::vector<Instruction>			instructions;
+	std::vector<InputBinding>			inputBindings;
+	std::vector<OutputSlotConstPtr>		sourceSlots;
+	std::vector<size_t>					successors;
+	std::unordered_map<NodeId, size_t>	nodeIdToIndex;
+	std::vector<ValueConstPtr>			registers;
+	std::vector<bool>					isRegisterValid;
+	bool								isValueProcessingEnabled;
+};
+
+}
+
+#endif
@@ -11,6 +11,8 @@ namespace NE
 template <class Type>
 class GenericValue : public SingleValue
 {
+	VALUE_TYPE (GenericValue);
+
 public:
 	GenericValue (const Type& val);
 	GenericValue (const GenericValue&) = delete;
@@ -29,6 +31,9 @@ protected:
 	Type val;
 };
 
+template <class Type>
+const ValueTypeInfo GenericValue<Type>::valueTypeInfo (&SingleValue::valueTypeInfo);
+
 template <class Type>
 GenericValue<Type>::GenericValue (const Type& val) :
 	val (val)
@@ -0,0 +1,372 @@
+#include "NE_LazyListValues.hpp"
+#include "NE_Debug.hpp"
+
+#include <algorithm>
+
+namespace NE
+{
+
+VALUE_TYPE_INFO (LazyListValue, Value);
+VALUE_TYPE_INFO (CombinationListValue, LazyListValue);
+VALUE_TYPE_INFO (ListSliceValue, LazyListValue);
+
+static const size_t MaxMaterializedChunkCount = 16;
+
+class IndexedValueCombination : public ValueCombination
+{
+public:
+	IndexedValueCombination (const std::vector<IListValueConstPtr>& values, const std::vector<size_t>& indices) :
+		values (values),
+		indices (indices)
+	{
+
+	}
+
+	virtual size_t GetSize () const override
+	{
+		return values.size ();
+	}
+
+	virtual ValueConstPtr GetValue (size_t valueIndex) const override
+	{
+		return values[valueIndex]->GetValue (indices[valueIndex]);
+	}
+
+	virtual size_t GetValueIndex (size_t valueIndex) const override
+	{
+		return indices[valueIndex];
+	}
+
+private:
+	const std::vector<IListValueConstPtr>&	values;
+	const std::vector<size_t>&				indices;
+};
+
+static std::vector<size_t> GetListSizes (const std::vector<ValueConstPtr>& values)
+{
+	std::vector<size_t> sizes;
+	for (const ValueConstPtr& value : values) {
+		const IListValue* listValue = Value::Cast<IListValue> (value.get ());
+		sizes.push_back (listValue != nullptr ? listValue->GetSize () : 1);
+	}
+	return sizes;
+}
+
+static size_t GetListCombinationCount (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values)
+{
+	// invalid inputs make an empty list, the constructor asserts on them
+	size_t count = 0;
+	if (!GetCombinationCount (combinationMode, GetListSizes (values), count)) {
+		return 0;
+	}
+	return count;
+}
+
+LazyListValue::LazyListValue (size_t size, size_t chunkSize) :
+	Value (),
+	IListValue (),
+	size (size),
+	chunkSize (chunkSize),
+	chunksMutex (),
+	chunks ()
+{
+
+}
+
+LazyListValue::~LazyListValue ()
+{
+
+}
+
+std::wstring LazyListValue::ToString (const StringConverter& stringConverter) const
+{
+	class ListEnumerator : public StringConverter::ListEnumerator
+	{
+	public:
+		ListEnumerator (const LazyListValue* val, const StringConverter& converter) :
+			val (val),
+			converter (converter)
+		{
+		}
+
+		virtual size_t GetSize () const override
+		{
+			return val->GetSize ();
+		}
+
+		virtual std::wstring GetItem (size_t index) const override
+		{
+			return val->GetValue (index)->ToString (converter);
+		}
+
+	private:
+		const LazyListValue*	val;
+		const StringConverter&	converter;
+	};
+
+	ListEnumerator enumerator (this, stringConverter);
+	return stringConverter.ListToString (enumerator);
+}
+
+size_t LazyListValue::GetMemorySize () const
+{
+	std::lock_guard<std::mutex> lock (chunksMutex);
+	size_t memorySize = sizeof (LazyListValue);
+	for (const Chunk& chunk : chunks) {
+		memorySize += chunk.values.capacity () * sizeof (ValueConstPtr);
+		for (const ValueConstPtr& value : chunk.values) {
+			if (value != nullptr) {
+				memorySize += value->GetMemorySize ();
+			}
+		}
+	}
+	return memorySize;
+}
+
+const IListValue* LazyListValue::GetListValueInterface () const
+{
+	return this;
+}
+
+const NumberValue* LazyListValue::GetNumberValueInterface () const
+{
+	return nullptr;
+}
+
+const DynamicSerializationInfo* LazyListValue::GetDynamicSerializationInfo () const
+{
+	// lazy lists are written as materialized lists, so they are read back as a ListValue
+	static const ListValue listValue;
+	return listValue.GetDynamicSerializationInfo ();
+}
+
+Stream::Status LazyListValue::Read (InputStream&)
+{
+	DBGBREAK ();
+	return Stream::Status::Error;
+}
+
+Stream::Status LazyListValue::Write (OutputStream& outputStream) const
+{
+	return Materialize ()->Write (outputStream);
+}
+
+size_t LazyListValue::GetSize () const
+{
+	return size;
+}
+
+ValueConstPtr LazyListValue::GetValue (size_t index) const
+{
+	DBGASSERT (index < size);
+	if (chunkSize == 0) {
+		return CalculateValue (index);
+	}
+
+	size_t chunkIndex = index / chunkSize;
+	size_t chunkStart = chunkIndex * chunkSize;
+	{
+		std::lock_guard<std::mutex> lock (chunksMutex);
+		for (const Chunk& chunk : chunks) {
+			if (chunk.chunkIndex == chunkIndex) {
+				return chunk.values[index - chunkStart];
+			}
+		}
+	}
+
+	Chunk newChunk;
+	newChunk.chunkIndex = chunkIndex;
+	size_t chunkEnd = std::min (chunkStart + chunkSize, size);
+	newChunk.values.reserve (chunkEnd - chunkStart);
+	for (size_t i = chunkStart; i < chunkEnd; i++) {
+		newChunk.values.push_back (CalculateValue (i));
+	}
+	ValueConstPtr result = newChunk.values[index - chunkStart];
+
+	std::lock_guard<std::mutex> lock (chunksMutex);
+	if (chunks.size () >= MaxMaterializedChunkCount) {
+		chunks.pop_front ();
+	}
+	chunks.push_back (std::move (newChunk));
+	return result;
+}
+
+bool LazyListValue::Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const
+{
+	// the materialized chunks are reused, the others are calculated without storing
+	// them, so a full enumeration doesn't push out the chunks used by random access
+	size_t enumeratedChunkSize = (chunkSize > 0 ? chunkSize : size);
+	for (size_t chunkStart = 0; chunkStart < size; chunkStart += enumeratedChunkSize) {
+		std::vector<ValueConstPtr> chunkValues;
+		if (chunkSize > 0) {
+			std::lock_guard<std::mutex> lock (chunksMutex);
+			for (const Chunk& chunk : chunks) {
+				if (chunk.chunkIndex == chunkStart / chunkSize) {
+					chunkValues = chunk.values;
+					break;
+				}
+			}
+		}
+		size_t chunkEnd = std::min (chunkStart + enumeratedChunkSize, size);
+		for (size_t i = chunkStart; i < chunkEnd; i++) {
+			ValueConstPtr value = chunkValues.empty () ? CalculateValue (i) : chunkValues[i - chunkStart];
+			if (!processor (value)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+ListValuePtr LazyListValue::Materialize () const
+{
+	ListValuePtr result = MakeValue<ListValue> ();
+	result->Reserve (size);
+	Enumerate ([&] (const ValueConstPtr& value) {
+		result->Push (value);
+		return true;
+	});
+	return result;
+}
+
+size_t LazyListValue::GetChunkSize () const
+{
+	return chunkSize;
+}
+
+size_t LazyListValue::GetMaterializedChunkCount () const
+{
+	std::lock_guard<std::mutex> lock (chunksMutex);
+	return chunks.size ();
+}
+
+CombinationListValue::CombinationListValue (	ValueCombinationMode combinationMode,
+												const std::vector<ValueConstPtr>& values,
+												const ItemCalculator& calculator,
+												bool hasUniformItemType,
+												size_t chunkSize) :
+	LazyListValue (GetListCombinationCount (combinationMode, values), chunkSize),
+	combinationMode (combinationMode),
+	values (values),
+	listValues (),
+	sizes (GetListSizes (values)),
+	calculator (calculator),
+	hasUniformItemType (hasUniformItemType)
+{
+	DBGASSERT (IsValidInput (combinationMode, values));
+	// list adapters refer to the stored values, so they are created after the values are copied
+	for (const ValueConstPtr& value : this->values) {
+		listValues.push_back (CreateListValue (value));
+	}
+}
+
+CombinationListValue::~CombinationListValue ()
+{
+
+}
+
+ValuePtr CombinationListValue::Clone () const
+{
+	return MakeValue<CombinationListValue> (combinationMode, values, calculator, hasUniformItemType, GetChunkSize ());
+}
+
+bool CombinationListValue::HasUniformItemType () const
+{
+	return hasUniformItemType;
+}
+
+bool CombinationListValue::IsValidInput (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values)
+{
+	for (const ValueConstPtr& value : values) {
+		if (!IsSingleValue (value) && !IsListValue (value)) {
+			return false;
+		}
+		const IListValue* listValue = Value::Cast<IListValue> (value.get ());
+		if (listValue != nullptr && listValue->GetSize () == 0) {
+			return false;
+		}
+	}
+	size_t count = 0;
+	if (!GetCombinationCount (combinationMode, GetListSizes (values), count)) {
+		return false;
+	}
+	return !values.empty ();
+}
+
+ValueConstPtr CombinationListValue::CalculateValue (size_t index) const
+{
+	std::vector<size_t> indices;
+	GetCombinationIndices (combinationMode, sizes, index, indices);
+	IndexedValueCombination combination (listValues, indices);
+	return calculator (combination);
+}
+
+ListSliceValue::ListSliceValue (const ValueConstPtr& listValue, size_t offset, size_t length, size_t stride) :
+	LazyListValue (length, 0),
+	sourceValue (listValue),
+	sourceList (Value::Cast<IListValue> (listValue.get ())),
+	offset (offset),
+	stride (stride)
+{
+	DBGASSERT (sourceList != nullptr);
+	DBGASSERT (length == 0 || offset + (length - 1) * stride < sourceList->GetSize ());
+}
+
+ListSliceValue::~ListSliceValue ()
+{
+
+}
+
+ValuePtr ListSliceValue::Clone () const
+{
+	return MakeValue<ListSliceValue> (sourceValue, offset, GetSize (), stride);
+}
+
+bool ListSliceValue::HasUniformItemType () const
+{
+	return sourceList->HasUniformItemType ();
+}
+
+const ValueConstPtr& ListSliceValue::GetSourceValue () const
+{
+	return sourceValue;
+}
+
+size_t ListSliceValue::GetOffset () const
+{
+	return offset;
+}
+
+size_t ListSliceValue::GetStride () const
+{
+	return stride;
+}
+
+ValueConstPtr ListSliceValue::CalculateValue (size_t index) const
+{
+	return sourceList->GetValue (offset + index * stride);
+}
+
+ValueConstPtr CreateListSlice (const ValueConstPtr& listValue, size_t offset, size_t length, size_t stride)
+{
+	const IListValue* sourceList = Value::Cast<IListValue> (listValue.get ());
+	if (DBGERROR (sourceList == nullptr || stride == 0)) {
+		return nullptr;
+	}
+
+	size_t sourceSize = sourceList->GetSize ();
+	if (offset >= sourceSize) {
+		length = 0;
+	} else {
+		length = std::min (length, (sourceSize - offset - 1) / stride + 1);
+	}
+
+	const ListSliceValue* sourceSlice = Value::Cast<ListSliceValue> (listValue.get ());
+	if (sourceSlice != nullptr) {
+		size_t sourceOffset = sourceSlice->GetOffset () + (length > 0 ? offset * sourceSlice->GetStride () : 0);
+		return MakeValue<ListSliceValue> (sourceSlice->GetSourceValue (), sourceOffset, length, stride * sourceSlice->GetStride ());
+	}
+	return MakeValue<ListSliceValue> (listValue, offset, length, stride);
+}
+
+}
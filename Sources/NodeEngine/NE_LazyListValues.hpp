@@ -0,0 +1,130 @@
+#ifndef NE_LAZYLISTVALUES_HPP
+#define NE_LAZYLISTVALUES_HPP
+
+#include "NE_Value.hpp"
+#include "NE_ValueCombination.hpp"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+
+namespace NE
+{
+
+class LazyListValue :	public Value,
+						public IListValue
+{
+	VALUE_TYPE (LazyListValue);
+
+public:
+	LazyListValue (size_t size, size_t chunkSize);
+	LazyListValue (const LazyListValue&) = delete;
+	virtual ~LazyListValue ();
+
+	LazyListValue&								operator= (const LazyListValue&) = delete;
+
+	virtual std::wstring						ToString (const StringConverter& stringConverter) const override;
+	virtual size_t								GetMemorySize () const override;
+	virtual const IListValue*					GetListValueInterface () const override;
+	virtual const NumberValue*					GetNumberValueInterface () const override;
+	virtual const DynamicSerializationInfo*		GetDynamicSerializationInfo () const override;
+	virtual Stream::Status						Read (InputStream& inputStream) override;
+	virtual Stream::Status						Write (OutputStream& outputStream) const override;
+
+	virtual size_t								GetSize () const override;
+	virtual ValueConstPtr						GetValue (size_t index) const override;
+	virtual bool								Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const override;
+
+	ListValuePtr								Materialize () const;
+	size_t										GetChunkSize () const;
+	size_t										GetMaterializedChunkCount () const;
+
+protected:
+	virtual ValueConstPtr						CalculateValue (size_t index) const = 0;
+
+private:
+	class Chunk
+	{
+	public:
+		size_t						chunkIndex;
+		std::vector<ValueConstPtr>	values;
+	};
+
+	size_t						size;
+	size_t						chunkSize;
+	mutable std::mutex			chunksMutex;
+	mutable std::deque<Chunk>	chunks;
+};
+
+class CombinationListValue : public LazyListValue
+{
+	VALUE_TYPE (CombinationListValue);
+
+public:
+	using ItemCalculator = std::function<ValueConstPtr (const ValueCombination&)>;
+
+	CombinationListValue (	ValueCombinationMode combinationMode,
+							const std::vector<ValueConstPtr>& values,
+							const ItemCalculator& calculator,
+							bool hasUniformItemType,
+							size_t chunkSize);
+	virtual ~CombinationListValue ();
+
+	virtual ValuePtr			Clone () const override;
+	virtual bool				HasUniformItemType () const override;
+
+	static bool					IsValidInput (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values);
+
+protected:
+	virtual ValueConstPtr		CalculateValue (size_t index) const override;
+
+private:
+	ValueCombinationMode				combinationMode;
+	std::vector<ValueConstPtr>			values;
+	std::vector<IListValueConstPtr>		listValues;
+	std::vector<size_t>					sizes;
+	ItemCalculator						calculator;
+	bool								hasUniformItemType;
+};
+
+class ListSliceValue : public LazyListValue
+{
+	VALUE_TYPE (ListSliceValue);
+
+public:
+	ListSliceValue (const ValueConstPtr& listValue, size_t offset, size_t length, size_t stride);
+	virtual ~ListSliceValue ();
+
+	virtual ValuePtr			Clone () const override;
+	virtual bool				HasUniformItemType () const override;
+
+	const ValueConstPtr&		GetSourceValue () const;
+	size_t						GetOffset () const;
+	size_t						GetStride () const;
+
+protected:
+	virtual ValueConstPtr		CalculateValue (size_t index) const override;
+
+private:
+	ValueConstPtr		sourceValue;
+	const IListValue*	sourceList;
+	size_t				offset;
+	size_t				stride;
+};
+
+using LazyListValuePtr = std::shared_ptr<LazyListValue>;
+using LazyListValueConstPtr = std::shared_ptr<const LazyListValue>;
+
+using CombinationListValuePtr = std::shared_ptr<CombinationListValue>;
+using CombinationListValueConstPtr = std::shared_ptr<const CombinationListValue>;
+
+using ListSliceValuePtr = std::shared_ptr<ListSliceValue>;
+using ListSliceValueConstPtr = std::shared_ptr<const ListSliceValue>;
+
+// slices of slices refer to the original list, the length is clamped to the end of the list
+ValueConstPtr	CreateListSlice (const ValueConstPtr& listValue, size_t offset, size_t length, size_t stride);
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "NE_OutputSlot.hpp"
 #include "NE_Debug.hpp"
 #include "NE_MemoryStream.hpp"
+#include "NE_LazyListValues.hpp"
 
 namespace NE
 {
@@ -19,11 +20,31 @@ NodeEvaluator::~NodeEvaluator ()
 
 }
 
+static bool IsMemoizableValue (const Value* value)
+{
+	// hashing a lazy list would calculate all of its items
+	if (value == nullptr || Value::IsType<LazyListValue> (value)) {
+		return false;
+	}
+	const IListValue* listValue = Value::Cast<IListValue> (value);
+	if (listValue != nullptr) {
+		bool isUniform = listValue->HasUniformItemType ();
+		bool isMemoizable = true;
+		listValue->EnumerateItems ([&] (const Value* item) {
+			isMemoizable = IsMemoizableValue (item);
+			return isMemoizable && !isUniform;
+		});
+		return isMemoizable;
+	}
+	return value->GetDynamicSerializationInfo () != nullptr;
+}
+
 Node::Node () :
 	nodeId (NullNodeId),
 	inputSlots (),
 	outputSlots (),
-	nodeEvaluator (nullptr)
+	nodeEvaluator (nullptr),
+	invalidationStamp ()
 {
 
 }
@@ -111,18 +132,60 @@ ValueConstPtr Node::Evaluate (EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	NodeEvaluationProfiler* profiler = nodeEvaluator->GetProfiler ();
 	CalculationStatus calcStatus = GetCalculationStatus ();
 	if (calcStatus == CalculationStatus::Calculated) {
+		if (profiler != nullptr) {
+			profiler->AddCacheHit (nodeId);
+		}
 		return nodeEvaluator->GetCalculatedNodeValue (nodeId);
 	}
 
+	if (calcStatus == CalculationStatus::NeedToCalculateButDisabled && env.IsForceCalculation ()) {
+		calcStatus = CalculationStatus::NeedToCalculate;
+	}
+
 	if (calcStatus != CalculationStatus::NeedToCalculate) {
 		return nullptr;
 	}
 
-	ValueConstPtr value = Calculate (env);
+	if (profiler != nullptr) {
+		profiler->AddCacheMiss (nodeId);
+	}
+
+	if (nodeEvaluator->RevalidateNodeValue (nodeId, env)) {
+		return nodeEvaluator->GetCalculatedNodeValue (nodeId);
+	}
+
+	// a cancelled evaluation keeps the already calculated values, but calculates no new ones
+	if (env.IsCancelled ()) {
+		return nullptr;
+	}
+
+	ValueConstPtr value = nullptr;
+	NodeMemoizationKey memoizationKey;
+	bool isMemoizable = nodeEvaluator->IsMemoizationEnabled () && GetMemoizationKey (env, memoizationKey);
+	if (!isMemoizable || !nodeEvaluator->GetMemoizedNodeValue (memoizationKey, value)) {
+		size_t interruptionCount = env.GetInterruptionCount ();
+		{
+			NodeEvaluationProfiler::CalculationScope profilerScope (profiler, nodeId);
+			value = Calculate (env);
+			profilerScope.SetValue (value);
+		}
+		// a deadline passed during the calculation doesn't make the value wrong, but an
+		// input or a poll stopped by the cancellation does, so that value is not stored
+		if (env.IsTokenCancelled () || env.GetInterruptionCount () != interruptionCount) {
+			return value;
+		}
+		if (isMemoizable) {
+			nodeEvaluator->SetMemoizedNodeValue (memoizationKey, value);
+		}
+	}
+
 	nodeEvaluator->SetCalculatedNodeValue (nodeId, value);
-	ProcessCalculatedValue (value, env);
+	if (nodeEvaluator->IsValueProcessingEnabled ()) {
+		ProcessCalculatedValue (value, env);
+	}
 
 	return value;
 }
@@ -148,6 +211,14 @@ bool Node::HasCalculatedValue () const
 	return nodeEvaluator->HasCalculatedNodeValue (GetId ());
 }
 
+bool Node::IsValueEvicted () const
+{
+	if (DBGERROR (nodeEvaluator == nullptr)) {
+		return false;
+	}
+	return nodeEvaluator->IsNodeValueEvicted (GetId ());
+}
+
 Node::CalculationStatus Node::GetCalculationStatus () const
 {
 	if (DBGERROR (nodeEvaluator == nullptr)) {
@@ -315,11 +386,21 @@ bool Node::IsForceCalculated () const
 	return false;
 }
 
+bool Node::IsValuePinned () const
+{
+	return false;
+}
+
 void Node::ProcessCalculatedValue (const ValueConstPtr&, EvaluationEnv&) const
 {
 
 }
 
+bool Node::WriteMemoizationKey (OutputStream&) const
+{
+	return false;
+}
+
 ValueConstPtr Node::EvaluateInputSlot (const InputSlotConstPtr& inputSlot, EvaluationEnv& env) const
 {
 	if (DBGERROR (nodeEvaluator == nullptr)) {
@@ -340,7 +421,8 @@ ValueConstPtr Node::EvaluateInputSlot (const InputSlotConstPtr& inputSlot, Evalu
 		DBGASSERT (connectedOutputSlots.size () == 1);
 		return connectedOutputSlots[0]->Evaluate (env);
 	} else if (inputSlot->GetOutputSlotConnectionMode () == OutputSlotConnectionMode::Multiple) {
-		ListValuePtr result (new ListValue ());
+		ListValuePtr result = MakeValue<ListValue> ();
+		result->Reserve (connectedOutputSlots.size ());
 		for (const OutputSlotConstPtr& outputSlot : connectedOutputSlots) {
 			result->Push (outputSlot->Evaluate (env));
 		}
@@ -351,6 +433,33 @@ ValueConstPtr Node::EvaluateInputSlot (const InputSlotConstPtr& inputSlot, Evalu
 	return nullptr;
 }
 
+bool Node::GetMemoizationKey (EvaluationEnv& env, NodeMemoizationKey& key) const
+{
+	MemoryOutputStream nodeDataStream;
+	const DynamicSerializationInfo* serializationInfo = GetDynamicSerializationInfo ();
+	if (DBGERROR (serializationInfo == nullptr)) {
+		return false;
+	}
+	serializationInfo->GetObjectId ().Write (nodeDataStream);
+	if (!WriteMemoizationKey (nodeDataStream)) {
+		return false;
+	}
+	key.SetNodeData (nodeDataStream.GetBuffer ());
+
+	// the node result depends only on the node data and the content of its inputs,
+	// nodes with an input that can't be compared by its content are not memoized
+	bool isInputMemoizable = true;
+	inputSlots.Enumerate ([&] (const InputSlotConstPtr& inputSlot) {
+		ValueConstPtr inputValue = EvaluateInputSlot (inputSlot, env);
+		isInputMemoizable = IsMemoizableValue (inputValue.get ());
+		if (isInputMemoizable) {
+			key.AddInputValue (inputValue);
+		}
+		return isInputMemoizable;
+	});
+	return isInputMemoizable;
+}
+
 NodePtr Node::Clone (const NodeConstPtr& node)
 {
 	MemoryOutputStream outputStream;
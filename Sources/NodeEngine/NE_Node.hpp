@@ -10,6 +10,9 @@
 #include "NE_Value.hpp"
 #include "NE_EvaluationEnv.hpp"
 #include "NE_NodeValueCache.hpp"
+#include "NE_NodeMemoizationCache.hpp"
+#include "NE_NodeEvaluationProfiler.hpp"
+#include "NE_Stamp.hpp"
 
 #include <memory>
 #include <functional>
@@ -31,7 +34,16 @@ public:
 	virtual bool			IsCalculationEnabled () const = 0;
 	virtual bool			HasCalculatedNodeValue (const NodeId& nodeId) const = 0;
 	virtual ValueConstPtr	GetCalculatedNodeValue (const NodeId& nodeId) const = 0;
+	virtual bool			IsNodeValueEvicted (const NodeId& nodeId) const = 0;
 	virtual void			SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& valuePtr) const = 0;
+	virtual bool			IsValueProcessingEnabled () const = 0;
+	virtual bool			RevalidateNodeValue (const NodeId& nodeId, EvaluationEnv& env) const = 0;
+
+	virtual bool			IsMemoizationEnabled () const = 0;
+	virtual bool			GetMemoizedNodeValue (const NodeMemoizationKey& key, ValueConstPtr& value) const = 0;
+	virtual void			SetMemoizedNodeValue (const NodeMemoizationKey& key, const ValueConstPtr& value) const = 0;
+
+	virtual NodeEvaluationProfiler*	GetProfiler () const = 0;
 };
 
 using NodeEvaluatorPtr = std::shared_ptr<NodeEvaluator>;
@@ -41,6 +53,7 @@ class Node : public DynamicSerializable
 {
 	SERIALIZABLE;
 	friend class NodeManager;
+	friend class ExecutionProgram;
 
 public:
 	enum class CalculationStatus
@@ -76,6 +89,7 @@ public:
 	ValueConstPtr			Evaluate (EvaluationEnv& env) const;
 	ValueConstPtr			GetCalculatedValue () const;
 	bool					HasCalculatedValue () const;
+	bool					IsValueEvicted () const;
 	CalculationStatus		GetCalculationStatus () const;
 	void					InvalidateValue () const;
 
@@ -121,15 +135,19 @@ private:
 	virtual ValueConstPtr	Calculate (EvaluationEnv& env) const = 0;
 
 	virtual bool			IsForceCalculated () const;
+	virtual bool			IsValuePinned () const;
 	virtual void			ProcessCalculatedValue (const ValueConstPtr& value, EvaluationEnv& env) const;
+	virtual bool			WriteMemoizationKey (OutputStream& outputStream) const;
 
 	ValueConstPtr			EvaluateInputSlot (const InputSlotConstPtr& inputSlot, EvaluationEnv& env) const;
+	bool					GetMemoizationKey (EvaluationEnv& env, NodeMemoizationKey& key) const;
 
 	NodeId					nodeId;
 	SlotList<InputSlot>		inputSlots;
 	SlotList<OutputSlot>	outputSlots;
 
 	NodeEvaluatorConstPtr	nodeEvaluator;
+	mutable Stamp			invalidationStamp;
 };
 
 template <class Type>
@@ -0,0 +1,295 @@
+#include "NE_NodeEvaluationProfiler.hpp"
+#include "NE_StringUtils.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <locale>
+
+namespace NE
+{
+
+// durations of the nested calculations on the current thread, used for calculating self durations
+static thread_local std::vector<uint64_t> childDurationStack;
+
+static uint64_t GetNanoseconds (NodeEvaluationProfiler::Clock::duration duration)
+{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (duration).count ();
+}
+
+static std::wstring GetDefaultNodeName (const NodeId& nodeId)
+{
+	return L"Node " + std::to_wstring (nodeId.GetUniqueId ());
+}
+
+static void WriteMicroseconds (std::ostream& stream, uint64_t nanoseconds)
+{
+	stream << nanoseconds / 1000 << '.' << std::setw (3) << std::setfill ('0') << nanoseconds % 1000;
+}
+
+static std::string EscapeJsonString (const std::string& str)
+{
+	std::ostringstream result;
+	result.imbue (std::locale::classic ());
+	for (char c : str) {
+		if (c == '"' || c == '\\') {
+			result << '\\' << c;
+		} else if ((unsigned char) c < 0x20) {
+			result << "\\u" << std::hex << std::setw (4) << std::setfill ('0') << (int) c << std::dec;
+		} else {
+			result << c;
+		}
+	}
+	return result.str ();
+}
+
+static std::string EscapeCsvString (const std::string& str)
+{
+	if (str.find_first_of (",\"\r\n") == std::string::npos) {
+		return str;
+	}
+	std::string result = "\"";
+	for (char c : str) {
+		if (c == '"') {
+			result += '"';
+		}
+		result += c;
+	}
+	result += '"';
+	return result;
+}
+
+NodeEvaluationProfiler::Event::Event () :
+	nodeId (NullNodeId),
+	threadIndex (0),
+	startTime (0),
+	duration (0),
+	selfDuration (0),
+	valueSize (0)
+{
+
+}
+
+NodeEvaluationProfiler::NodeStatistics::NodeStatistics () :
+	calculationCount (0),
+	cacheHitCount (0),
+	cacheMissCount (0),
+	totalDuration (0),
+	selfDuration (0),
+	valueSize (0),
+	threadIndex (0)
+{
+
+}
+
+NodeEvaluationProfiler::CalculationScope::CalculationScope (NodeEvaluationProfiler* profiler, const NodeId& nodeId) :
+	profiler (profiler),
+	nodeId (nodeId),
+	startTime (),
+	valueSize (0)
+{
+	if (profiler == nullptr) {
+		return;
+	}
+	childDurationStack.push_back (0);
+	startTime = Clock::now ();
+}
+
+NodeEvaluationProfiler::CalculationScope::~CalculationScope ()
+{
+	if (profiler == nullptr) {
+		return;
+	}
+	Clock::time_point endTime = Clock::now ();
+	uint64_t childDuration = childDurationStack.back ();
+	childDurationStack.pop_back ();
+	if (!childDurationStack.empty ()) {
+		childDurationStack.back () += GetNanoseconds (endTime - startTime);
+	}
+	profiler->AddCalculation (nodeId, startTime, endTime, childDuration, valueSize);
+}
+
+void NodeEvaluationProfiler::CalculationScope::SetValue (const ValueConstPtr& value)
+{
+	if (profiler == nullptr || value == nullptr) {
+		return;
+	}
+	valueSize = value->GetMemorySize ();
+}
+
+NodeEvaluationProfiler::NodeEvaluationProfiler () :
+	isEnabled (false),
+	profileStartTime (Clock::now ()),
+	events (),
+	nodeStatistics (),
+	threadIds (),
+	profilerMutex ()
+{
+
+}
+
+NodeEvaluationProfiler::~NodeEvaluationProfiler ()
+{
+
+}
+
+bool NodeEvaluationProfiler::IsEnabled () const
+{
+	return isEnabled.load (std::memory_order_relaxed);
+}
+
+void NodeEvaluationProfiler::SetEnabled (bool newIsEnabled)
+{
+	isEnabled.store (newIsEnabled, std::memory_order_relaxed);
+}
+
+void NodeEvaluationProfiler::Clear ()
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	profileStartTime = Clock::now ();
+	events.clear ();
+	nodeStatistics.clear ();
+	threadIds.clear ();
+}
+
+void NodeEvaluationProfiler::AddCacheHit (const NodeId& nodeId)
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	nodeStatistics[nodeId].cacheHitCount++;
+}
+
+void NodeEvaluationProfiler::AddCacheMiss (const NodeId& nodeId)
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	nodeStatistics[nodeId].cacheMissCount++;
+}
+
+size_t NodeEvaluationProfiler::GetEventCount () const
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	return events.size ();
+}
+
+void NodeEvaluationProfiler::EnumerateEvents (const std::function<void (const Event&)>& processor) const
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	for (const Event& event : events) {
+		processor (event);
+	}
+}
+
+bool NodeEvaluationProfiler::GetNodeStatistics (const NodeId& nodeId, NodeStatistics& statistics) const
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	auto found = nodeStatistics.find (nodeId);
+	if (found == nodeStatistics.end ()) {
+		return false;
+	}
+	statistics = found->second;
+	return true;
+}
+
+void NodeEvaluationProfiler::EnumerateNodeStatistics (const std::function<void (const NodeId&, const NodeStatistics&)>& processor) const
+{
+	std::vector<std::pair<NodeId, NodeStatistics>> sortedStatistics;
+	{
+		std::lock_guard<std::mutex> lock (profilerMutex);
+		sortedStatistics.assign (nodeStatistics.begin (), nodeStatistics.end ());
+	}
+	std::sort (sortedStatistics.begin (), sortedStatistics.end (), [] (const std::pair<NodeId, NodeStatistics>& a, const std::pair<NodeId, NodeStatistics>& b) {
+		return a.first < b.first;
+	});
+	for (const auto& it : sortedStatistics) {
+		processor (it.first, it.second);
+	}
+}
+
+std::string NodeEvaluationProfiler::ExportChromeTrace () const
+{
+	return ExportChromeTrace (GetDefaultNodeName);
+}
+
+std::string NodeEvaluationProfiler::ExportChromeTrace (const NodeNameGetter& nodeNameGetter) const
+{
+	std::ostringstream result;
+	result.imbue (std::locale::classic ());
+	result << "{\"traceEvents\":[";
+	bool isFirst = true;
+	EnumerateEvents ([&] (const Event& event) {
+		if (!isFirst) {
+			result << ",";
+		}
+		isFirst = false;
+		result << "\n{\"name\":\"" << EscapeJsonString (WStringToString (nodeNameGetter (event.nodeId))) << "\"";
+		result << ",\"cat\":\"node\",\"ph\":\"X\",\"pid\":1";
+		result << ",\"tid\":" << event.threadIndex;
+		result << ",\"ts\":";
+		WriteMicroseconds (result, event.startTime);
+		result << ",\"dur\":";
+		WriteMicroseconds (result, event.duration);
+		result << ",\"args\":{\"nodeId\":" << event.nodeId.GetUniqueId ();
+		result << ",\"selfTime\":";
+		WriteMicroseconds (result, event.selfDuration);
+		result << ",\"valueSize\":" << event.valueSize << "}}";
+	});
+	result << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return result.str ();
+}
+
+std::string NodeEvaluationProfiler::ExportCsv () const
+{
+	return ExportCsv (GetDefaultNodeName);
+}
+
+std::string NodeEvaluationProfiler::ExportCsv (const NodeNameGetter& nodeNameGetter) const
+{
+	std::ostringstream result;
+	result.imbue (std::locale::classic ());
+	result << "node_id,name,calculation_count,cache_hit_count,cache_miss_count,total_time_us,self_time_us,value_size,thread\n";
+	EnumerateNodeStatistics ([&] (const NodeId& nodeId, const NodeStatistics& statistics) {
+		result << nodeId.GetUniqueId () << ",";
+		result << EscapeCsvString (WStringToString (nodeNameGetter (nodeId))) << ",";
+		result << statistics.calculationCount << ",";
+		result << statistics.cacheHitCount << ",";
+		result << statistics.cacheMissCount << ",";
+		WriteMicroseconds (result, statistics.totalDuration);
+		result << ",";
+		WriteMicroseconds (result, statistics.selfDuration);
+		result << ",";
+		result << statistics.valueSize << ",";
+		result << statistics.threadIndex << "\n";
+	});
+	return result.str ();
+}
+
+void NodeEvaluationProfiler::AddCalculation (const NodeId& nodeId, Clock::time_point startTime, Clock::time_point endTime, uint64_t childDuration, size_t valueSize)
+{
+	std::lock_guard<std::mutex> lock (profilerMutex);
+	Event event;
+	event.nodeId = nodeId;
+	event.threadIndex = GetThreadIndex (std::this_thread::get_id ());
+	event.startTime = startTime > profileStartTime ? GetNanoseconds (startTime - profileStartTime) : 0;
+	event.duration = GetNanoseconds (endTime - startTime);
+	event.selfDuration = event.duration > childDuration ? event.duration - childDuration : 0;
+	event.valueSize = valueSize;
+	events.push_back (event);
+
+	NodeStatistics& statistics = nodeStatistics[nodeId];
+	statistics.calculationCount++;
+	statistics.totalDuration += event.duration;
+	statistics.selfDuration += event.selfDuration;
+	statistics.valueSize = valueSize;
+	statistics.threadIndex = event.threadIndex;
+}
+
+size_t NodeEvaluationProfiler::GetThreadIndex (const std::thread::id& threadId)
+{
+	auto found = std::find (threadIds.begin (), threadIds.end (), threadId);
+	if (found != threadIds.end ()) {
+		return found - threadIds.begin ();
+	}
+	threadIds.push_back (threadId);
+	return threadIds.size () - 1;
+}
+
+}
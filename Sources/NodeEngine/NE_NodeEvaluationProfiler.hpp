@@ -0,0 +1,109 @@
+#ifndef NE_NODEEVALUATIONPROFILER_HPP
+#define NE_NODEEVALUATIONPROFILER_HPP
+
+#include "NE_NodeId.hpp"
+#include "NE_Value.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace NE
+{
+
+class NodeEvaluationProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using NodeNameGetter = std::function<std::wstring (const NodeId&)>;
+
+	class Event
+	{
+	public:
+		Event ();
+
+		NodeId		nodeId;
+		size_t		threadIndex;
+		uint64_t	startTime;
+		uint64_t	duration;
+		uint64_t	selfDuration;
+		size_t		valueSize;
+	};
+
+	class NodeStatistics
+	{
+	public:
+		NodeStatistics ();
+
+		size_t		calculationCount;
+		size_t		cacheHitCount;
+		size_t		cacheMissCount;
+		uint64_t	totalDuration;
+		uint64_t	selfDuration;
+		size_t		valueSize;
+		size_t		threadIndex;
+	};
+
+	// measures the calculation of one node, does nothing if there is no profiler
+	class CalculationScope
+	{
+	public:
+		CalculationScope (NodeEvaluationProfiler* profiler, const NodeId& nodeId);
+		CalculationScope (const CalculationScope&) = delete;
+		~CalculationScope ();
+
+		CalculationScope&	operator= (const CalculationScope&) = delete;
+
+		void				SetValue (const ValueConstPtr& value);
+
+	private:
+		NodeEvaluationProfiler*		profiler;
+		NodeId						nodeId;
+		Clock::time_point			startTime;
+		size_t						valueSize;
+	};
+
+	NodeEvaluationProfiler ();
+	NodeEvaluationProfiler (const NodeEvaluationProfiler&) = delete;
+	~NodeEvaluationProfiler ();
+
+	NodeEvaluationProfiler&		operator= (const NodeEvaluationProfiler&) = delete;
+
+	bool			IsEnabled () const;
+	void			SetEnabled (bool isEnabled);
+	void			Clear ();
+
+	void			AddCacheHit (const NodeId& nodeId);
+	void			AddCacheMiss (const NodeId& nodeId);
+
+	size_t			GetEventCount () const;
+	void			EnumerateEvents (const std::function<void (const Event&)>& processor) const;
+	bool			GetNodeStatistics (const NodeId& nodeId, NodeStatistics& statistics) const;
+	void			EnumerateNodeStatistics (const std::function<void (const NodeId&, const NodeStatistics&)>& processor) const;
+
+	std::string		ExportChromeTrace () const;
+	std::string		ExportChromeTrace (const NodeNameGetter& nodeNameGetter) const;
+	std::string		ExportCsv () const;
+	std::string		ExportCsv (const NodeNameGetter& nodeNameGetter) const;
+
+private:
+	void			AddCalculation (const NodeId& nodeId, Clock::time_point startTime, Clock::time_point endTime, uint64_t childDuration, size_t valueSize);
+	size_t			GetThreadIndex (const std::thread::id& threadId);
+
+	std::atomic<bool>							isEnabled;
+	Clock::time_point							profileStartTime;
+	std::vector<Event>							events;
+	std::unordered_map<NodeId, NodeStatistics>	nodeStatistics;
+	std::vector<std::thread::id>				threadIds;
+	mutable std::mutex							profilerMutex;
+};
+
+}
+
+#endif
@@ -6,12 +6,22 @@
 #include "NE_OutputSlot.hpp"
 #include "NE_MemoryStream.hpp"
 #include "NE_NodeManagerSerialization.hpp"
+#include "NE_WorkerThreadPool.hpp"
+#include "NE_ConcurrentEvaluator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 namespace NE
 {
 
 SERIALIZATION_INFO (NodeManager, 4);
 
+// managers created at the same address get different ids, so data
+// taken from a manager can't be matched to an other one by its address
+static std::atomic<size_t> nextManagerId (1);
+
 template <typename SlotListType, typename SlotType>
 static bool HasDuplicates (const SlotListType& slots)
 {
@@ -39,6 +49,11 @@ public:
 
 	virtual void InvalidateNodeValue (const NodeId& nodeId) const override
 	{
+		const ConcurrentEvaluator* concurrentEvaluator = ConcurrentEvaluator::GetActiveEvaluator (nodeManager);
+		if (concurrentEvaluator != nullptr) {
+			concurrentEvaluator->RemoveNodeValues (nodeId);
+			return;
+		}
 		nodeManager.InvalidateNodeValue (nodeId);
 	}
 
@@ -54,22 +69,82 @@ public:
 
 	virtual bool IsCalculationEnabled () const override
 	{
+		if (ConcurrentEvaluator::GetActiveEvaluator (nodeManager) != nullptr) {
+			return true;
+		}
 		return nodeManager.IsCalculationEnabled ();
 	}
 
 	virtual bool HasCalculatedNodeValue (const NodeId& nodeId) const override
 	{
+		const ConcurrentEvaluator* concurrentEvaluator = ConcurrentEvaluator::GetActiveEvaluator (nodeManager);
+		if (concurrentEvaluator != nullptr) {
+			return concurrentEvaluator->HasCalculatedNodeValue (nodeId);
+		}
 		return nodeValueCache.Contains (nodeId);
 	}
 
 	virtual ValueConstPtr GetCalculatedNodeValue (const NodeId& nodeId) const override
 	{
+		const ConcurrentEvaluator* concurrentEvaluator = ConcurrentEvaluator::GetActiveEvaluator (nodeManager);
+		if (concurrentEvaluator != nullptr) {
+			return concurrentEvaluator->GetCalculatedNodeValue (nodeId);
+		}
 		return nodeValueCache.Get (nodeId);
 	}
 
+	virtual bool IsNodeValueEvicted (const NodeId& nodeId) const override
+	{
+		if (ConcurrentEvaluator::GetActiveEvaluator (nodeManager) != nullptr) {
+			return false;
+		}
+		return nodeValueCache.IsEvicted (nodeId);
+	}
+
 	virtual void SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& valuePtr) const override
 	{
-		nodeValueCache.Add (nodeId, valuePtr);
+		const ConcurrentEvaluator* concurrentEvaluator = ConcurrentEvaluator::GetActiveEvaluator (nodeManager);
+		if (concurrentEvaluator != nullptr) {
+			concurrentEvaluator->SetCalculatedNodeValue (nodeId, valuePtr);
+			return;
+		}
+		nodeManager.SetCalculatedNodeValue (nodeId, valuePtr);
+	}
+
+	virtual bool IsValueProcessingEnabled () const override
+	{
+		if (ConcurrentEvaluator::GetActiveEvaluator (nodeManager) != nullptr) {
+			return false;
+		}
+		return nodeManager.IsValueProcessingActive ();
+	}
+
+	virtual bool RevalidateNodeValue (const NodeId& nodeId, EvaluationEnv& env) const override
+	{
+		if (ConcurrentEvaluator::GetActiveEvaluator (nodeManager) != nullptr) {
+			return false;
+		}
+		return nodeManager.RevalidateNodeValue (nodeId, env);
+	}
+
+	virtual bool IsMemoizationEnabled () const override
+	{
+		return nodeManager.memoizationCache.IsEnabled ();
+	}
+
+	virtual bool GetMemoizedNodeValue (const NodeMemoizationKey& key, ValueConstPtr& value) const override
+	{
+		return nodeManager.memoizationCache.Get (key, value);
+	}
+
+	virtual void SetMemoizedNodeValue (const NodeMemoizationKey& key, const ValueConstPtr& value) const override
+	{
+		nodeManager.memoizationCache.Add (key, value);
+	}
+
+	virtual NodeEvaluationProfiler* GetProfiler () const override
+	{
+		return nodeManager.profiler.IsEnabled () ? &nodeManager.profiler : nullptr;
 	}
 
 private:
@@ -112,10 +187,25 @@ NodeManager::NodeManager () :
 	nodeList (),
 	connectionManager (),
 	nodeGroupList (),
+	topologicalOrder (),
 	updateMode (UpdateMode::Automatic),
+	evaluationMode (EvaluationMode::Sequential),
+	invalidationMode (InvalidationMode::Eager),
+	executionPlan (nullptr),
+	executionPlanMutex (),
 	nodeValueCache (),
+	pinnedNodes (),
+	nodeValueTrace (),
+	memoizationCache (),
+	structureCache (),
+	profiler (),
 	nodeEvaluator (nullptr),
-	isForceCalculate (false)
+	isValueProcessingEnabled (true),
+	isValueProcessingDeferred (false),
+	invalidationStamp (),
+	modificationStamp (),
+	managerId (nextManagerId++),
+	graphLock ()
 {
 	nodeEvaluator.reset (new NodeManagerNodeEvaluator (*this, nodeValueCache));
 }
@@ -127,15 +217,21 @@ NodeManager::~NodeManager ()
 
 void NodeManager::Clear ()
 {
+	WriteLockGuard lock (graphLock);
 	idGenerator.Clear ();
 	nodeList.Clear ();
 	connectionManager.Clear ();
 	nodeGroupList.Clear ();
+	topologicalOrder.Clear ();
 	updateMode = UpdateMode::Automatic;
 
+	InvalidateExecutionPlan ();
 	nodeValueCache.Clear ();
+	pinnedNodes.Clear ();
+	nodeValueTrace.Clear ();
+	structureCache.Clear ();
 	nodeEvaluator.reset (new NodeManagerNodeEvaluator (*this, nodeValueCache));
-	isForceCalculate = false;
+	modificationStamp.Update ();
 }
 
 bool NodeManager::IsEmpty () const
@@ -185,11 +281,13 @@ NodePtr NodeManager::GetNode (const NodeId& id)
 
 NodePtr NodeManager::AddNode (const NodePtr& node)
 {
+	WriteLockGuard lock (graphLock);
 	return AddNode (node, IdPolicy::GenerateNew, InitPolicy::Initialize);
 }
 
 bool NodeManager::DeleteNode (const NodeId& id)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (!ContainsNode (id))) {
 		return false;
 	}
@@ -198,6 +296,7 @@ bool NodeManager::DeleteNode (const NodeId& id)
 
 bool NodeManager::DeleteNode (const NodePtr& node)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (node == nullptr || !node->IsEvaluatorSet ())) {
 		return false;
 	}
@@ -207,7 +306,13 @@ bool NodeManager::DeleteNode (const NodePtr& node)
 	}
 
 	nodeGroupList.RemoveNodeFromGroup (node->GetId ());
-	node->InvalidateValue ();
+
+	// the dependent nodes lose an input, so they can't reuse their values
+	std::vector<NodeConstPtr> nodesToInvalidate = { node };
+	EnumerateDependentNodes (NodeConstPtr (node), [&] (const NodeConstPtr& dependentNode) {
+		nodesToInvalidate.push_back (dependentNode);
+	});
+	InvalidateNodeValues (nodesToInvalidate);
 
 	node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
 		connectionManager.DisconnectAllOutputSlotsFromInputSlot (inputSlot);
@@ -219,7 +324,10 @@ bool NodeManager::DeleteNode (const NodePtr& node)
 		return true;
 	});
 
+	topologicalOrder.DeleteNode (node->GetId ());
 	nodeList.DeleteNode (node->GetId ());
+	nodeValueTrace.Remove (node->GetId ());
+	InvalidateExecutionPlan ();
 	node->ClearEvaluator ();
 
 	return true;
@@ -254,16 +362,9 @@ bool NodeManager::CanConnectOutputSlotToInputSlot (const OutputSlotConstPtr& out
 		return false;
 	}
 
-	bool willCreateCycle = false;
-	if (outputNode == inputNode) {
-		willCreateCycle = true;
-	} else {
-		EnumerateDependentNodesRecursive (inputNode, [&] (const NodeConstPtr& dependentNode) {
-			if (outputNode == dependentNode) {
-				willCreateCycle = true;
-			}
-		});
-	}
+	bool willCreateCycle = topologicalOrder.IsReachable (inputNode->GetId (), outputNode->GetId (), [&] (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) {
+		EnumerateSuccessorNodes (nodeId, processor);
+	});
 
 	if (willCreateCycle) {
 		return false;
@@ -320,16 +421,27 @@ bool NodeManager::CanConnectOutputSlotToInputSlots (const OutputSlotConstPtr& ou
 
 bool NodeManager::ConnectOutputSlotToInputSlot (const OutputSlotConstPtr& outputSlot, const InputSlotConstPtr& inputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (!CanConnectOutputSlotToInputSlot (outputSlot, inputSlot))) {
 		return false;
 	}
 
 	InvalidateNodeValue (GetNode (inputSlot->GetOwnerNodeId ()));
+	topologicalOrder.AddEdge (outputSlot->GetOwnerNodeId (), inputSlot->GetOwnerNodeId (),
+		[&] (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) {
+			EnumerateSuccessorNodes (nodeId, processor);
+		},
+		[&] (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) {
+			EnumeratePredecessorNodes (nodeId, processor);
+		}
+	);
+	InvalidateExecutionPlan ();
 	return connectionManager.ConnectOutputSlotToInputSlot (outputSlot, inputSlot);
 }
 
 bool NodeManager::ConnectOutputSlotsToInputSlot (const OutputSlotList& outputSlots, const InputSlotConstPtr& inputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (!CanConnectOutputSlotsToInputSlot (outputSlots, inputSlot))) {
 		return false;
 	}
@@ -347,6 +459,7 @@ bool NodeManager::ConnectOutputSlotsToInputSlot (const OutputSlotList& outputSlo
 
 bool NodeManager::ConnectOutputSlotToInputSlots (const OutputSlotConstPtr& outputSlot, const InputSlotList& inputSlots)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (!CanConnectOutputSlotToInputSlots (outputSlot, inputSlots))) {
 		return false;
 	}
@@ -364,6 +477,7 @@ bool NodeManager::ConnectOutputSlotToInputSlots (const OutputSlotConstPtr& outpu
 
 bool NodeManager::DisconnectOutputSlotFromInputSlot (const OutputSlotConstPtr& outputSlot, const InputSlotConstPtr& inputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (outputSlot == nullptr || inputSlot == nullptr)) {
 		return false;
 	}
@@ -373,11 +487,13 @@ bool NodeManager::DisconnectOutputSlotFromInputSlot (const OutputSlotConstPtr& o
 	}
 
 	InvalidateNodeValue (GetNode (inputSlot->GetOwnerNodeId ()));
+	InvalidateExecutionPlan ();
 	return connectionManager.DisconnectOutputSlotFromInputSlot (outputSlot, inputSlot);
 }
 
 bool NodeManager::DisconnectOutputSlotsFromInputSlot (const OutputSlotList& outputSlots, const InputSlotConstPtr& inputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (outputSlots.IsEmpty () || inputSlot == nullptr)) {
 		return false;
 	}
@@ -411,6 +527,7 @@ bool NodeManager::DisconnectOutputSlotsFromInputSlot (const OutputSlotList& outp
 
 bool NodeManager::DisconnectOutputSlotFromInputSlots (const OutputSlotConstPtr& outputSlot, const InputSlotList& inputSlots)
 {
+	WriteLockGuard lock (graphLock);
 	if (DBGERROR (outputSlot == nullptr || inputSlots.IsEmpty ())) {
 		return false;
 	}
@@ -444,13 +561,17 @@ bool NodeManager::DisconnectOutputSlotFromInputSlots (const OutputSlotConstPtr&
 
 bool NodeManager::DisconnectAllInputSlotsFromOutputSlot (const OutputSlotConstPtr& outputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	InvalidateNodeValue (GetNode (outputSlot->GetOwnerNodeId ()));
+	InvalidateExecutionPlan ();
 	return connectionManager.DisconnectAllInputSlotsFromOutputSlot (outputSlot);
 }
 
 bool NodeManager::DisconnectAllOutputSlotsFromInputSlot (const InputSlotConstPtr& inputSlot)
 {
+	WriteLockGuard lock (graphLock);
 	InvalidateNodeValue (GetNode (inputSlot->GetOwnerNodeId ()));
+	InvalidateExecutionPlan ();
 	return connectionManager.DisconnectAllOutputSlotsFromInputSlot (inputSlot);
 }
 
@@ -513,30 +634,48 @@ void NodeManager::EnumerateConnections (const NodeCollection& nodes, const std::
 	});
 }
 
-void NodeManager::EvaluateAllNodes (EvaluationEnv& env) const
+bool NodeManager::EvaluateAllNodes (EvaluationEnv& env) const
 {
-	EnumerateNodes ([&] (NodeConstPtr node) {
-		node->Evaluate (env);
-		return true;
-	});
+	ReadLockGuard lock (graphLock);
+	ExecutionPlanConstPtr plan = GetExecutionPlan ();
+	std::vector<bool> isStepNeeded (plan->GetStepCount (), true);
+	return EvaluateSteps (*plan, isStepNeeded, env);
+}
+
+bool NodeManager::EvaluateNodes (const NodeCollection& nodes, EvaluationEnv& env) const
+{
+	ReadLockGuard lock (graphLock);
+	ExecutionPlanConstPtr plan = GetExecutionPlan ();
+	std::vector<bool> isStepNeeded = plan->GetRequiredSteps (nodes);
+	return EvaluateSteps (*plan, isStepNeeded, env);
 }
 
-void NodeManager::ForceEvaluateAllNodes (EvaluationEnv& env) const
+bool NodeManager::ForceEvaluateAllNodes (EvaluationEnv& env) const
 {
-	ValueGuard<bool> isForceCalculateGuard (isForceCalculate, true);
+	ReadLockGuard lock (graphLock);
 	std::vector<NodeConstPtr> nodesToRecalculate;
 	EnumerateNodes ([&] (NodeConstPtr node) {
+		// evicted values are up to date, they are calculated again only when
+		// a dependent needs them, and the pinned values are never evicted
 		Node::CalculationStatus calcStatus = node->GetCalculationStatus ();
-		DBGASSERT (calcStatus != Node::CalculationStatus::NeedToCalculateButDisabled);
-		if (calcStatus == Node::CalculationStatus::NeedToCalculate) {
+		if (calcStatus != Node::CalculationStatus::Calculated && !nodeValueCache.IsEvicted (node->GetId ())) {
 			nodesToRecalculate.push_back (node);
 		}
 		return true;
 	});
-	for (const NodeConstPtr& node : nodesToRecalculate) {
-		InvalidateNodeValue (node);
-	}
-	EvaluateAllNodes (env);
+	InvalidateNodeValues (nodesToRecalculate);
+	return ResumeForceEvaluateAllNodes (env);
+}
+
+bool NodeManager::ResumeForceEvaluateAllNodes (EvaluationEnv& env) const
+{
+	// the nodes left by a cancelled forced evaluation are calculated without
+	// invalidating them again, so the already calculated values are kept
+	// the flag is set on a copy, because the env of the caller may be shared
+	ReadLockGuard lock (graphLock);
+	EvaluationEnv forceEnv (env);
+	forceEnv.SetForceCalculation (true);
+	return EvaluateAllNodes (forceEnv);
 }
 
 void NodeManager::InvalidateNodeValue (const NodeId& nodeId) const
@@ -547,13 +686,18 @@ void NodeManager::InvalidateNodeValue (const NodeId& nodeId) const
 
 void NodeManager::InvalidateNodeValue (const NodeConstPtr& node) const
 {
-	const NodeId& nodeId = node->GetId ();
-	if (nodeValueCache.Contains (nodeId)) {
-		nodeValueCache.Remove (nodeId);
-	}
-	EnumerateDependentNodes (node, [&] (const NodeConstPtr& dependentNode) {
-		InvalidateNodeValue (dependentNode);
+	std::vector<NodeConstPtr> nodesToInvalidate = { node };
+	InvalidateNodeValues (nodesToInvalidate);
+}
+
+void NodeManager::InvalidateNodeValues (const NodeCollection& nodes) const
+{
+	std::vector<NodeConstPtr> nodesToInvalidate;
+	nodes.Enumerate ([&] (const NodeId& nodeId) {
+		nodesToInvalidate.push_back (GetNode (nodeId));
+		return true;
 	});
+	InvalidateNodeValues (nodesToInvalidate);
 }
 
 void NodeManager::EnumerateDependentNodes (const NodeConstPtr& node, const std::function<void (const NodeId&)>& processor) const
@@ -570,11 +714,18 @@ void NodeManager::EnumerateDependentNodes (const NodeConstPtr& node, const std::
 
 void NodeManager::EnumerateDependentNodesRecursive (const NodeConstPtr& node, const std::function<void (const NodeId&)>& processor) const
 {
-	EnumerateDependentNodes (node, [&] (const NodeId& dependentNodeId) {
-		NodeConstPtr dependentNode = GetNode (dependentNodeId);
-		processor (dependentNodeId);
-		EnumerateDependentNodesRecursive (dependentNode, processor);
-	});
+	std::unordered_set<NodeId> visitedNodes;
+	std::vector<NodeConstPtr> nodesToVisit = { node };
+	while (!nodesToVisit.empty ()) {
+		NodeConstPtr currentNode = nodesToVisit.back ();
+		nodesToVisit.pop_back ();
+		EnumerateDependentNodes (currentNode, [&] (const NodeId& dependentNodeId) {
+			if (visitedNodes.insert (dependentNodeId).second) {
+				processor (dependentNodeId);
+				nodesToVisit.push_back (GetNode (dependentNodeId));
+			}
+		});
+	}
 }
 
 void NodeManager::EnumerateDependentNodes (const NodePtr& node, const std::function<void (const NodePtr&)>& processor)
@@ -612,6 +763,7 @@ bool NodeManager::ContainsNodeGroup (const NodeGroupId& groupId) const
 
 NodeGroupPtr NodeManager::AddNodeGroup (const NodeGroupPtr& group)
 {
+	WriteLockGuard lock (graphLock);
 	return AddNodeGroup (group, IdPolicy::GenerateNew);
 }
 
@@ -621,19 +773,453 @@ void NodeManager::MakeNodesAndGroupsSorted ()
 	nodeGroupList.MakeSorted ();
 }
 
+ExecutionPlanConstPtr NodeManager::GetExecutionPlan () const
+{
+	// concurrent evaluators can ask for the plan at the same time, and the
+	// returned plan stays valid even if the graph changes after the call
+	std::lock_guard<std::mutex> lock (executionPlanMutex);
+	if (executionPlan != nullptr) {
+		return executionPlan;
+	}
+
+	std::vector<NodeConstPtr> sortedNodes;
+	EnumerateNodes ([&] (NodeConstPtr node) {
+		sortedNodes.push_back (node);
+		return true;
+	});
+	std::sort (sortedNodes.begin (), sortedNodes.end (), [&] (const NodeConstPtr& a, const NodeConstPtr& b) {
+		return topologicalOrder.GetOrder (a->GetId ()) < topologicalOrder.GetOrder (b->GetId ());
+	});
+
+	ExecutionPlanPtr newExecutionPlan (new ExecutionPlan ());
+	for (const NodeConstPtr& node : sortedNodes) {
+		newExecutionPlan->AddStep (node);
+	}
+	for (size_t stepIndex = 0; stepIndex < sortedNodes.size (); ++stepIndex) {
+		EnumeratePredecessorNodes (sortedNodes[stepIndex]->GetId (), [&] (const NodeId& inputNodeId) {
+			newExecutionPlan->AddInputStep (stepIndex, inputNodeId);
+		});
+	}
+	newExecutionPlan->Finalize ();
+
+	executionPlan = newExecutionPlan;
+	return executionPlan;
+}
+
+void NodeManager::InvalidateExecutionPlan ()
+{
+	{
+		std::lock_guard<std::mutex> lock (executionPlanMutex);
+		executionPlan = nullptr;
+	}
+	modificationStamp.Update ();
+}
+
+bool NodeManager::EvaluateSteps (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env) const
+{
+	if (evaluationMode == EvaluationMode::Parallel) {
+		return EvaluateStepsParallel (plan, isStepNeeded, env);
+	}
+
+	// the inputs of every step are already evaluated by the previous steps,
+	// so evaluating a node never recurses into the upstream graph
+	bool isBounded = nodeValueCache.IsBounded ();
+	for (size_t stepIndex = 0; stepIndex < plan.GetStepCount (); ++stepIndex) {
+		if (env.IsCancelled ()) {
+			return false;
+		}
+		if (!isStepNeeded[stepIndex]) {
+			continue;
+		}
+		if (!isBounded) {
+			plan.GetStep (stepIndex).node->Evaluate (env);
+			continue;
+		}
+		if (NeedToEvaluateStep (plan, stepIndex)) {
+			EvaluateEvictedInputSteps (plan, stepIndex, env);
+			EvaluateStep (plan, stepIndex, env);
+			EvictNodeValues (plan, isStepNeeded);
+		}
+	}
+	return !env.IsCancelled ();
+}
+
+bool NodeManager::EvaluateStepsParallel (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env) const
+{
+	// every node of a level depends only on nodes of previous levels, so the nodes
+	// of a level can be calculated at the same time while their inputs are cached
+	bool isBounded = nodeValueCache.IsBounded ();
+	for (size_t levelIndex = 0; levelIndex < plan.GetLevelCount (); ++levelIndex) {
+		if (env.IsCancelled ()) {
+			return false;
+		}
+		std::vector<size_t> levelSteps;
+		for (size_t stepIndex : plan.GetLevelSteps (levelIndex)) {
+			if (isStepNeeded[stepIndex]) {
+				levelSteps.push_back (stepIndex);
+			}
+		}
+		if (!isBounded) {
+			EvaluateLevelSteps (plan, levelSteps, isBounded, env);
+			continue;
+		}
+
+		// evicted inputs are shared between the steps of the level,
+		// so they are recalculated before the parallel part starts
+		std::vector<size_t> stepsToEvaluate;
+		for (size_t stepIndex : levelSteps) {
+			if (NeedToEvaluateStep (plan, stepIndex)) {
+				EvaluateEvictedInputSteps (plan, stepIndex, env);
+				stepsToEvaluate.push_back (stepIndex);
+			}
+		}
+		EvaluateLevelSteps (plan, stepsToEvaluate, isBounded, env);
+		EvictNodeValues (plan, isStepNeeded);
+	}
+	return !env.IsCancelled ();
+}
+
+void NodeManager::EvaluateLevelSteps (const ExecutionPlan& plan, const std::vector<size_t>& levelSteps, bool isBounded, EvaluationEnv& env) const
+{
+	std::vector<bool> wasCalculated (levelSteps.size (), false);
+	for (size_t taskIndex = 0; taskIndex < levelSteps.size (); ++taskIndex) {
+		wasCalculated[taskIndex] = (plan.GetStep (levelSteps[taskIndex]).node->GetCalculationStatus () == Node::CalculationStatus::Calculated);
+	}
+
+	{
+		ValueGuard<bool> isValueProcessingDeferredGuard (isValueProcessingDeferred, true);
+		WorkerThreadPool::GetSharedPool ().ParallelFor (levelSteps.size (), [&] (size_t taskIndex) {
+			if (isBounded) {
+				EvaluateStep (plan, levelSteps[taskIndex], env);
+			} else {
+				plan.GetStep (levelSteps[taskIndex]).node->Evaluate (env);
+			}
+		});
+	}
+
+	// the processing can modify the evaluation data of the caller, so it
+	// is done on the calling thread in the order of the execution plan
+	if (!nodeEvaluator->IsValueProcessingEnabled ()) {
+		return;
+	}
+	for (size_t taskIndex = 0; taskIndex < levelSteps.size (); ++taskIndex) {
+		const NodeConstPtr& node = plan.GetStep (levelSteps[taskIndex]).node;
+		if (!wasCalculated[taskIndex] && node->GetCalculationStatus () == Node::CalculationStatus::Calculated) {
+			node->ProcessCalculatedValue (node->GetCalculatedValue (), env);
+		}
+	}
+}
+
+bool NodeManager::NeedToEvaluateStep (const ExecutionPlan& plan, size_t stepIndex) const
+{
+	const NodeId& nodeId = plan.GetStep (stepIndex).node->GetId ();
+	return !nodeValueCache.Contains (nodeId) && !nodeValueCache.IsEvicted (nodeId);
+}
+
+void NodeManager::EvaluateEvictedInputSteps (const ExecutionPlan& plan, size_t stepIndex, EvaluationEnv& env) const
+{
+	for (size_t inputStepIndex : plan.GetStep (stepIndex).inputSteps) {
+		if (nodeValueCache.IsEvicted (plan.GetStep (inputStepIndex).node->GetId ())) {
+			EvaluateEvictedInputSteps (plan, inputStepIndex, env);
+			EvaluateStep (plan, inputStepIndex, env);
+		}
+	}
+}
+
+void NodeManager::EvaluateStep (const ExecutionPlan& plan, size_t stepIndex, EvaluationEnv& env) const
+{
+	const NodeConstPtr& node = plan.GetStep (stepIndex).node;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	node->Evaluate (env);
+	std::chrono::duration<double> cost = std::chrono::steady_clock::now () - start;
+	nodeValueCache.SetCalculationCost (node->GetId (), cost.count ());
+}
+
+void NodeManager::EvictNodeValues (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded) const
+{
+	// values are kept while one of their dependents still has to be
+	// calculated, otherwise they would be recalculated right away
+	nodeValueCache.EvictValues ([&] (const NodeId& nodeId) {
+		bool isNeeded = false;
+		EnumerateSuccessorNodes (nodeId, [&] (const NodeId& dependentNodeId) {
+			if (isNeeded || !isStepNeeded[plan.GetStepIndex (dependentNodeId)]) {
+				return;
+			}
+			if (!nodeValueCache.Contains (dependentNodeId) && !nodeValueCache.IsEvicted (dependentNodeId)) {
+				isNeeded = true;
+			}
+		});
+		return !isNeeded;
+	}, [&] (const NodeId& nodeId) {
+		nodeValueTrace.Remove (nodeId);
+	});
+}
+
+void NodeManager::EnumerateSuccessorNodes (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) const
+{
+	EnumerateDependentNodes (GetNode (nodeId), processor);
+}
+
+void NodeManager::EnumeratePredecessorNodes (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) const
+{
+	NodeConstPtr node = GetNode (nodeId);
+	node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
+		connectionManager.EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+			processor (outputSlot->GetOwnerNodeId ());
+		});
+		return true;
+	});
+}
+
+void NodeManager::InvalidateNodeValues (std::vector<NodeConstPtr>& nodesToInvalidate) const
+{
+	bool isEarlyCutoff = (invalidationMode == InvalidationMode::EarlyCutoff);
+	if (isEarlyCutoff) {
+		nodeValueTrace.StartRevision ();
+	}
+
+	// every node gets the stamp of the current pass when visited, so
+	// nodes reachable on more than one path are invalidated only once
+	invalidationStamp.Update ();
+	modificationStamp.Update ();
+	bool isStructureCacheEnabled = structureCache.IsEnabled ();
+	auto invalidateNode = [&] (const NodeConstPtr& node, bool isMaybeValid) {
+		node->invalidationStamp = invalidationStamp;
+		const NodeId& nodeId = node->GetId ();
+		if (nodeValueCache.Contains (nodeId) || nodeValueCache.IsEvicted (nodeId)) {
+			nodeValueCache.Remove (nodeId);
+		}
+		if (isEarlyCutoff) {
+			nodeValueTrace.Invalidate (nodeId, isMaybeValid);
+		}
+		if (isStructureCacheEnabled) {
+			structureCache.Remove (nodeId);
+		}
+	};
+
+	// the given nodes have to be recalculated, but in early cutoff mode
+	// the dependent nodes can keep their values if their inputs don't change
+	for (const NodeConstPtr& node : nodesToInvalidate) {
+		invalidateNode (node, false);
+	}
+	while (!nodesToInvalidate.empty ()) {
+		NodeConstPtr node = nodesToInvalidate.back ();
+		nodesToInvalidate.pop_back ();
+		EnumerateDependentNodes (node, [&] (const NodeConstPtr& dependentNode) {
+			if (dependentNode->invalidationStamp != invalidationStamp) {
+				invalidateNode (dependentNode, true);
+				nodesToInvalidate.push_back (dependentNode);
+			}
+		});
+	}
+}
+
+void NodeManager::SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& value) const
+{
+	AddNodeValueToCache (nodeId, value);
+	if (invalidationMode == InvalidationMode::EarlyCutoff) {
+		nodeValueTrace.SetCalculatedValue (nodeId, value);
+	}
+	if (structureCache.IsEnabled ()) {
+		AddNodeToStructureCache (nodeId);
+	}
+}
+
+void NodeManager::CopyCalculatedNodeValues (const NodeManager& source, EvaluationEnv* processEnv, NodeCollection& copiedNodes) const
+{
+	source.EnumerateNodes ([&] (NodeConstPtr sourceNode) {
+		const NodeId& nodeId = sourceNode->GetId ();
+		if (!source.nodeValueCache.Contains (nodeId) || nodeValueCache.Contains (nodeId) || !ContainsNode (nodeId)) {
+			return true;
+		}
+		ValueConstPtr value = source.nodeValueCache.Get (nodeId);
+		SetCalculatedNodeValue (nodeId, value);
+		if (processEnv != nullptr && isValueProcessingEnabled) {
+			GetNode (nodeId)->ProcessCalculatedValue (value, *processEnv);
+		}
+		copiedNodes.Insert (nodeId);
+		return true;
+	});
+}
+
+bool NodeManager::RevalidateNodeValue (const NodeId& nodeId, EvaluationEnv& env) const
+{
+	if (ReuseTracedNodeValue (nodeId, env)) {
+		return true;
+	}
+	if (structureCache.IsEnabled () && ShareIdenticalNodeValue (nodeId, env)) {
+		return true;
+	}
+	return false;
+}
+
+bool NodeManager::ReuseTracedNodeValue (const NodeId& nodeId, EvaluationEnv& env) const
+{
+	if (invalidationMode != InvalidationMode::EarlyCutoff || !nodeValueTrace.IsMaybeValid (nodeId)) {
+		return false;
+	}
+
+	// the inputs must be up to date before it can be checked if they have changed
+	std::vector<NodeId> inputNodeIds;
+	EnumeratePredecessorNodes (nodeId, [&] (const NodeId& inputNodeId) {
+		inputNodeIds.push_back (inputNodeId);
+	});
+	for (const NodeId& inputNodeId : inputNodeIds) {
+		GetNode (inputNodeId)->Evaluate (env);
+	}
+	if (env.IsCancelled ()) {
+		return false;
+	}
+
+	ValueConstPtr value = nullptr;
+	if (!nodeValueTrace.ReuseValue (nodeId, inputNodeIds, value)) {
+		return false;
+	}
+	AddNodeValueToCache (nodeId, value);
+	if (structureCache.IsEnabled ()) {
+		// the invalidation removed the node from the structure cache, so
+		// its reused value must be registered again to be shared
+		AddNodeToStructureCache (nodeId);
+	}
+	if (IsValueProcessingActive ()) {
+		GetNode (nodeId)->ProcessCalculatedValue (value, env);
+	}
+	return true;
+}
+
+bool NodeManager::ShareIdenticalNodeValue (const NodeId& nodeId, EvaluationEnv& env) const
+{
+	// the structure key refers to the values of the inputs, so they must be calculated first
+	NodeConstPtr node = GetNode (nodeId);
+	std::vector<NodeId> inputNodeIds;
+	EnumeratePredecessorNodes (nodeId, [&] (const NodeId& inputNodeId) {
+		inputNodeIds.push_back (inputNodeId);
+	});
+	for (const NodeId& inputNodeId : inputNodeIds) {
+		GetNode (inputNodeId)->Evaluate (env);
+	}
+	if (env.IsCancelled ()) {
+		return false;
+	}
+
+	std::string key;
+	if (!GetStructureKey (node, key)) {
+		return false;
+	}
+	NodeId sharedNodeId;
+	if (!structureCache.Get (key, sharedNodeId) || sharedNodeId == nodeId || !nodeValueCache.Contains (sharedNodeId)) {
+		return false;
+	}
+
+	// the node gets the value id of the shared node, so
+	// the identical dependents of the two nodes match too
+	ValueConstPtr value = nodeValueCache.Get (sharedNodeId);
+	AddNodeValueToCache (nodeId, value);
+	if (invalidationMode == InvalidationMode::EarlyCutoff) {
+		nodeValueTrace.SetCalculatedValue (nodeId, value);
+	}
+	structureCache.SetValueId (nodeId, structureCache.GetValueId (sharedNodeId));
+	if (IsValueProcessingActive ()) {
+		node->ProcessCalculatedValue (value, env);
+	}
+	return true;
+}
+
+bool NodeManager::GetStructureKey (const NodeConstPtr& node, std::string& key) const
+{
+	const DynamicSerializationInfo* serializationInfo = node->GetDynamicSerializationInfo ();
+	if (serializationInfo == nullptr) {
+		return false;
+	}
+
+	MemoryOutputStream keyStream;
+	serializationInfo->GetObjectId ().Write (keyStream);
+	if (!node->WriteMemoizationKey (keyStream)) {
+		return false;
+	}
+
+	// connected inputs are identified by the value of the connected node,
+	// so the position and the name of the nodes don't matter
+	bool isValid = true;
+	node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
+		inputSlot->GetId ().Write (keyStream);
+		keyStream.Write (connectionManager.GetConnectedOutputSlotCount (inputSlot));
+		if (!connectionManager.HasConnectedOutputSlots (inputSlot)) {
+			ValueConstPtr defaultValue = inputSlot->GetDefaultValue ();
+			isValid = (defaultValue != nullptr && WriteDynamicObject (keyStream, defaultValue.get ()));
+			return isValid;
+		}
+		connectionManager.EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+			uint64_t valueId = structureCache.GetValueId (outputSlot->GetOwnerNodeId ());
+			keyStream.Write ((const char*) &valueId, sizeof (valueId));
+			outputSlot->GetId ().Write (keyStream);
+		});
+		return true;
+	});
+	if (!isValid) {
+		return false;
+	}
+
+	const std::vector<char>& keyBuffer = keyStream.GetBuffer ();
+	key.assign (keyBuffer.begin (), keyBuffer.end ());
+	return true;
+}
+
+void NodeManager::AddNodeToStructureCache (const NodeId& nodeId) const
+{
+	std::string key;
+	if (GetStructureKey (GetNode (nodeId), key)) {
+		structureCache.Add (key, nodeId);
+	} else {
+		structureCache.Remove (nodeId);
+	}
+}
+
+void NodeManager::AddNodeValueToCache (const NodeId& nodeId, const ValueConstPtr& value) const
+{
+	bool isPinned = false;
+	if (nodeValueCache.IsBounded ()) {
+		isPinned = IsNodeValuePinned (nodeId);
+	}
+	nodeValueCache.Add (nodeId, value, isPinned);
+}
+
+bool NodeManager::IsNodeValuePinned (const NodeId& nodeId) const
+{
+	// the values of nodes without connected outputs, and the values shown
+	// or observed by the user are never evicted from a bounded cache
+	if (pinnedNodes.Contains (nodeId) || GetNode (nodeId)->IsValuePinned ()) {
+		return true;
+	}
+	bool hasSuccessors = false;
+	EnumerateSuccessorNodes (nodeId, [&] (const NodeId&) {
+		hasSuccessors = true;
+	});
+	return !hasSuccessors;
+}
+
+bool NodeManager::IsValueProcessingActive () const
+{
+	// the values calculated on worker threads are processed later by the caller
+	return isValueProcessingEnabled && !isValueProcessingDeferred;
+}
+
 void NodeManager::DeleteNodeGroup (const NodeGroupId& groupId)
 {
+	WriteLockGuard lock (graphLock);
 	return nodeGroupList.DeleteGroup (groupId);
 }
 
 void NodeManager::AddNodeToGroup (const NodeGroupId& groupId, const NodeId& nodeId)
 {
+	WriteLockGuard lock (graphLock);
 	DBGASSERT (ContainsNode (nodeId));
 	nodeGroupList.AddNodeToGroup (groupId, nodeId);
 }
 
 void NodeManager::RemoveNodeFromGroup (const NodeId& nodeId)
 {
+	WriteLockGuard lock (graphLock);
 	nodeGroupList.RemoveNodeFromGroup (nodeId);
 }
 
@@ -659,12 +1245,13 @@ void NodeManager::EnumerateNodeGroups (const std::function<bool (NodeGroupPtr)>&
 
 void NodeManager::DeleteAllNodeGroups ()
 {
+	WriteLockGuard lock (graphLock);
 	nodeGroupList.Clear ();
 }
 
 bool NodeManager::IsCalculationEnabled () const
 {
-	return updateMode == UpdateMode::Automatic || isForceCalculate;
+	return updateMode == UpdateMode::Automatic;
 }
 
 NodeManager::UpdateMode NodeManager::GetUpdateMode () const
@@ -677,8 +1264,140 @@ void NodeManager::SetUpdateMode (UpdateMode newUpdateMode)
 	updateMode = newUpdateMode;
 }
 
+NodeManager::EvaluationMode NodeManager::GetEvaluationMode () const
+{
+	return evaluationMode;
+}
+
+void NodeManager::SetEvaluationMode (EvaluationMode newEvaluationMode)
+{
+	evaluationMode = newEvaluationMode;
+}
+
+NodeManager::InvalidationMode NodeManager::GetInvalidationMode () const
+{
+	return invalidationMode;
+}
+
+void NodeManager::SetInvalidationMode (InvalidationMode newInvalidationMode)
+{
+	invalidationMode = newInvalidationMode;
+	nodeValueTrace.Clear ();
+}
+
+const NodeMemoizationCache& NodeManager::GetMemoizationCache () const
+{
+	return memoizationCache;
+}
+
+NodeMemoizationCache& NodeManager::GetMemoizationCache ()
+{
+	return memoizationCache;
+}
+
+const NodeStructureCache& NodeManager::GetStructureCache () const
+{
+	return structureCache;
+}
+
+NodeStructureCache& NodeManager::GetStructureCache ()
+{
+	return structureCache;
+}
+
+const NodeEvaluationProfiler& NodeManager::GetProfiler () const
+{
+	return profiler;
+}
+
+NodeEvaluationProfiler& NodeManager::GetProfiler ()
+{
+	return profiler;
+}
+
+size_t NodeManager::GetNodeValueCacheMemorySize () const
+{
+	return nodeValueCache.GetMemorySize ();
+}
+
+size_t NodeManager::GetNodeValueCacheMaxMemorySize () const
+{
+	return nodeValueCache.GetMaxMemorySize ();
+}
+
+void NodeManager::SetNodeValueCacheMaxMemorySize (size_t newMaxMemorySize)
+{
+	nodeValueCache.SetMaxMemorySize (newMaxMemorySize);
+	if (newMaxMemorySize == 0) {
+		return;
+	}
+
+	// values are not pinned while the cache is unbounded
+	EnumerateNodes ([&] (const NodeConstPtr& node) {
+		const NodeId& nodeId = node->GetId ();
+		if (nodeValueCache.Contains (nodeId)) {
+			nodeValueCache.SetPinned (nodeId, IsNodeValuePinned (nodeId));
+		}
+		return true;
+	});
+	ExecutionPlanConstPtr plan = GetExecutionPlan ();
+	std::vector<bool> isStepNeeded (plan->GetStepCount (), true);
+	EvictNodeValues (*plan, isStepNeeded);
+}
+
+bool NodeManager::IsNodeValueEvicted (const NodeId& nodeId) const
+{
+	return nodeValueCache.IsEvicted (nodeId);
+}
+
+const NodeCollection& NodeManager::GetPinnedNodes () const
+{
+	return pinnedNodes;
+}
+
+void NodeManager::SetPinnedNodes (const NodeCollection& newPinnedNodes)
+{
+	WriteLockGuard lock (graphLock);
+	NodeCollection changedNodes = pinnedNodes;
+	newPinnedNodes.Enumerate ([&] (const NodeId& nodeId) {
+		if (!changedNodes.Contains (nodeId)) {
+			changedNodes.Insert (nodeId);
+		}
+		return true;
+	});
+	pinnedNodes = newPinnedNodes;
+	if (!nodeValueCache.IsBounded ()) {
+		return;
+	}
+
+	// evicted values of newly pinned nodes are removed, so they are
+	// calculated again by the next evaluation and kept from then on
+	changedNodes.Enumerate ([&] (const NodeId& nodeId) {
+		if (!ContainsNode (nodeId)) {
+			return true;
+		}
+		bool isPinned = IsNodeValuePinned (nodeId);
+		if (nodeValueCache.Contains (nodeId)) {
+			nodeValueCache.SetPinned (nodeId, isPinned);
+		} else if (isPinned && nodeValueCache.IsEvicted (nodeId)) {
+			nodeValueCache.Remove (nodeId);
+		}
+		return true;
+	});
+
+	ExecutionPlanConstPtr plan = GetExecutionPlan ();
+	std::vector<bool> isStepNeeded (plan->GetStepCount (), true);
+	EvictNodeValues (*plan, isStepNeeded);
+}
+
+ReadWriteLock& NodeManager::GetGraphLock () const
+{
+	return graphLock;
+}
+
 Stream::Status NodeManager::Read (InputStream& inputStream)
 {
+	WriteLockGuard lock (graphLock);
 	return NodeManagerSerialization::Read (*this, inputStream);
 }
 
@@ -706,6 +1425,24 @@ bool NodeManager::Clone (const NodeManager& source, NodeManager& target)
 	return true;
 }
 
+bool NodeManager::CloneSnapshot (const NodeManager& source, NodeManager& target)
+{
+	if (!Clone (source, target)) {
+		return false;
+	}
+
+	// snapshots are evaluated on other threads, so the calculated values
+	// must not be processed, and the already calculated values are reused
+	target.evaluationMode = source.evaluationMode;
+	target.isValueProcessingEnabled = false;
+	target.nodeValueCache.SetMaxMemorySize (source.nodeValueCache.GetMaxMemorySize ());
+	target.pinnedNodes = source.pinnedNodes;
+
+	NodeCollection copiedNodes;
+	target.CopyCalculatedNodeValues (source, nullptr, copiedNodes);
+	return true;
+}
+
 bool NodeManager::ReadFromBuffer (NodeManager& nodeManager, const std::vector<char>& buffer)
 {
 	MemoryInputStream inputStream (buffer);
@@ -747,6 +1484,7 @@ NE::NodePtr NodeManager::AddNode (const NodePtr& node, IdPolicy idPolicy, InitPo
 
 	node->SetId (nodeId);
 	node->SetEvaluator (nodeEvaluator);
+	node->invalidationStamp = Stamp ();
 	if (initPolicy == InitPolicy::Initialize) {
 		node->Initialize ();
 	}
@@ -754,6 +1492,8 @@ NE::NodePtr NodeManager::AddNode (const NodePtr& node, IdPolicy idPolicy, InitPo
 	if (DBGERROR (!nodeList.AddNode (node->GetId (), node))) {
 		return nullptr;
 	}
+	topologicalOrder.AddNode (node->GetId ());
+	InvalidateExecutionPlan ();
 
 	return node;
 }
@@ -12,8 +12,17 @@
 #include "NE_NodeList.hpp"
 #include "NE_NodeGroupList.hpp"
 #include "NE_NodeValueCache.hpp"
+#include "NE_NodeValueTrace.hpp"
+#include "NE_NodeMemoizationCache.hpp"
+#include "NE_NodeStructureCache.hpp"
+#include "NE_NodeEvaluationProfiler.hpp"
 #include "NE_UniqueIdGenerator.hpp"
+#include "NE_Stamp.hpp"
+#include "NE_TopologicalOrder.hpp"
+#include "NE_ExecutionPlan.hpp"
+#include "NE_ReadWriteLock.hpp"
 #include <functional>
+#include <mutex>
 
 namespace NE
 {
@@ -40,11 +49,18 @@ public:
 	virtual void	Enumerate (const std::function<bool (InputSlotConstPtr)>& processor) const = 0;
 };
 
+// graph edits take the write lock, evaluations and other readers take the read lock
 class NodeManager
 {
 	SERIALIZABLE;
 	friend class NodeManagerMerge;
 	friend class NodeManagerSerialization;
+	friend class NodeManagerNodeEvaluator;
+	friend class BackgroundEvaluator;
+	friend class ParameterSweep;
+	friend class ExecutionProgram;
+	friend class ConcurrentEvaluator;
+	friend class NodeManagerSnapshot;
 
 public:
 	enum class UpdateMode
@@ -53,6 +69,23 @@ public:
 		Manual		= 1
 	};
 
+	// the parallel mode calculates the nodes of a level on the shared worker
+	// thread pool, the workers share the evaluation env of the caller, so
+	// the nodes may only read it, and the values are processed afterwards
+	// on the calling thread, so the evaluation data is never used by the
+	// workers through value processing
+	enum class EvaluationMode
+	{
+		Sequential	= 0,
+		Parallel	= 1
+	};
+
+	enum class InvalidationMode
+	{
+		Eager		= 0,
+		EarlyCutoff	= 1
+	};
+
 	NodeManager ();
 	NodeManager (const NodeManager& src) = delete;
 	NodeManager (NodeManager&& src) = delete;
@@ -102,10 +135,13 @@ public:
 	void					EnumerateConnections (const std::function<void (const OutputSlotConstPtr&, const InputSlotConstPtr&)>& processor) const;
 	void					EnumerateConnections (const NodeCollection& nodes, const std::function<void (const OutputSlotConstPtr&, const InputSlotConstPtr&)>& processor) const;
 
-	void					EvaluateAllNodes (EvaluationEnv& env) const;
-	void					ForceEvaluateAllNodes (EvaluationEnv& env) const;
+	bool					EvaluateAllNodes (EvaluationEnv& env) const;
+	bool					ForceEvaluateAllNodes (EvaluationEnv& env) const;
+	bool					ResumeForceEvaluateAllNodes (EvaluationEnv& env) const;
+	bool					EvaluateNodes (const NodeCollection& nodes, EvaluationEnv& env) const;
 	void					InvalidateNodeValue (const NodeId& nodeId) const;
 	void					InvalidateNodeValue (const NodeConstPtr& node) const;
+	void					InvalidateNodeValues (const NodeCollection& nodes) const;
 	
 	void					EnumerateDependentNodes (const NodeConstPtr& node, const std::function<void (const NodeId&)>& processor) const;
 	void					EnumerateDependentNodesRecursive (const NodeConstPtr& node, const std::function<void (const NodeId&)>& processor) const;
@@ -134,6 +170,30 @@ public:
 	UpdateMode				GetUpdateMode () const;
 	void					SetUpdateMode (UpdateMode newUpdateMode);
 
+	EvaluationMode			GetEvaluationMode () const;
+	void					SetEvaluationMode (EvaluationMode newEvaluationMode);
+
+	InvalidationMode		GetInvalidationMode () const;
+	void					SetInvalidationMode (InvalidationMode newInvalidationMode);
+
+	const NodeMemoizationCache&	GetMemoizationCache () const;
+	NodeMemoizationCache&		GetMemoizationCache ();
+
+	const NodeStructureCache&	GetStructureCache () const;
+	NodeStructureCache&			GetStructureCache ();
+
+	const NodeEvaluationProfiler&	GetProfiler () const;
+	NodeEvaluationProfiler&			GetProfiler ();
+
+	size_t					GetNodeValueCacheMemorySize () const;
+	size_t					GetNodeValueCacheMaxMemorySize () const;
+	void					SetNodeValueCacheMaxMemorySize (size_t newMaxMemorySize);
+	bool					IsNodeValueEvicted (const NodeId& nodeId) const;
+	const NodeCollection&	GetPinnedNodes () const;
+	void					SetPinnedNodes (const NodeCollection& newPinnedNodes);
+
+	ReadWriteLock&			GetGraphLock () const;
+
 	Stream::Status			Read (InputStream& inputStream);
 	Stream::Status			Write (OutputStream& outputStream) const;
 
@@ -157,16 +217,55 @@ private:
 	NodePtr				AddNode (const NodePtr& node, IdPolicy idHandling, InitPolicy initPolicy);
 	NodeGroupPtr		AddNodeGroup (const NodeGroupPtr& group, IdPolicy idHandling);
 	void				MakeNodesAndGroupsSorted ();
+	ExecutionPlanConstPtr	GetExecutionPlan () const;
+	void				InvalidateExecutionPlan ();
+	bool				EvaluateSteps (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env) const;
+	bool				EvaluateStepsParallel (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded, EvaluationEnv& env) const;
+	void				EvaluateLevelSteps (const ExecutionPlan& plan, const std::vector<size_t>& levelSteps, bool isBounded, EvaluationEnv& env) const;
+	bool				NeedToEvaluateStep (const ExecutionPlan& plan, size_t stepIndex) const;
+	void				EvaluateEvictedInputSteps (const ExecutionPlan& plan, size_t stepIndex, EvaluationEnv& env) const;
+	void				EvaluateStep (const ExecutionPlan& plan, size_t stepIndex, EvaluationEnv& env) const;
+	void				EvictNodeValues (const ExecutionPlan& plan, const std::vector<bool>& isStepNeeded) const;
+	void				InvalidateNodeValues (std::vector<NodeConstPtr>& nodesToInvalidate) const;
+	void				SetCalculatedNodeValue (const NodeId& nodeId, const ValueConstPtr& value) const;
+	void				CopyCalculatedNodeValues (const NodeManager& source, EvaluationEnv* processEnv, NodeCollection& copiedNodes) const;
+
+	static bool			CloneSnapshot (const NodeManager& source, NodeManager& target);
+	bool				RevalidateNodeValue (const NodeId& nodeId, EvaluationEnv& env) const;
+	bool				ReuseTracedNodeValue (const NodeId& nodeId, EvaluationEnv& env) const;
+	bool				ShareIdenticalNodeValue (const NodeId& nodeId, EvaluationEnv& env) const;
+	bool				GetStructureKey (const NodeConstPtr& node, std::string& key) const;
+	void				AddNodeToStructureCache (const NodeId& nodeId) const;
+	void				AddNodeValueToCache (const NodeId& nodeId, const ValueConstPtr& value) const;
+	bool				IsNodeValuePinned (const NodeId& nodeId) const;
+	bool				IsValueProcessingActive () const;
+	void				EnumerateSuccessorNodes (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) const;
+	void				EnumeratePredecessorNodes (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) const;
 
 	UniqueIdGenerator						idGenerator;
 	NodeList								nodeList;
 	ConnectionManager						connectionManager;
 	NodeGroupList							nodeGroupList;
+	TopologicalOrder						topologicalOrder;
 	UpdateMode								updateMode;
+	EvaluationMode							evaluationMode;
+	InvalidationMode						invalidationMode;
 
+	mutable ExecutionPlanConstPtr			executionPlan;
+	mutable std::mutex						executionPlanMutex;
 	mutable NodeValueCache					nodeValueCache;
+	NodeCollection							pinnedNodes;
+	mutable NodeValueTrace					nodeValueTrace;
+	mutable NodeMemoizationCache			memoizationCache;
+	mutable NodeStructureCache				structureCache;
+	mutable NodeEvaluationProfiler			profiler;
 	mutable NodeEvaluatorConstPtr			nodeEvaluator;
-	mutable bool							isForceCalculate;
+	bool									isValueProcessingEnabled;
+	mutable bool							isValueProcessingDeferred;
+	mutable Stamp							invalidationStamp;
+	mutable Stamp							modificationStamp;
+	size_t									managerId;
+	mutable ReadWriteLock					graphLock;
 };
 
 }
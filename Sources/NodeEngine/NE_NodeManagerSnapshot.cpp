@@ -0,0 +1,386 @@
+#include "NE_NodeManagerSnapshot.hpp"
+#include "NE_Node.hpp"
+#include "NE_NodeGroup.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_MemoryStream.hpp"
+#include "NE_Debug.hpp"
+
+#include <unordered_set>
+
+namespace NE
+{
+
+static const size_t NodeBucketCount = 256;
+
+static size_t GetNodeBucketIndex (const NodeId& nodeId)
+{
+	return std::hash<NodeId> () (nodeId) % NodeBucketCount;
+}
+
+NodeManagerSnapshot::InputConnection::InputConnection (const SlotId& inputSlotId, const SlotInfo& outputSlotInfo) :
+	inputSlotId (inputSlotId),
+	outputSlotInfo (outputSlotInfo)
+{
+
+}
+
+bool NodeManagerSnapshot::InputConnection::operator== (const InputConnection& rhs) const
+{
+	return inputSlotId == rhs.inputSlotId && outputSlotInfo == rhs.outputSlotInfo;
+}
+
+bool NodeManagerSnapshot::InputConnection::operator!= (const InputConnection& rhs) const
+{
+	return !operator== (rhs);
+}
+
+NodeManagerSnapshot::NodeState::NodeState () :
+	nodeData (),
+	inputConnections ()
+{
+
+}
+
+bool NodeManagerSnapshot::NodeState::operator== (const NodeState& rhs) const
+{
+	return nodeData == rhs.nodeData && inputConnections == rhs.inputConnections;
+}
+
+NodeManagerSnapshot::GroupState::GroupState () :
+	groupData (),
+	groupNodes ()
+{
+
+}
+
+bool NodeManagerSnapshot::GroupState::operator== (const GroupState& rhs) const
+{
+	return groupData == rhs.groupData && groupNodes == rhs.groupNodes;
+}
+
+NodeManagerSnapshot::NodeManagerSnapshot () :
+	nodeBuckets (NodeBucketCount, nullptr),
+	groups (nullptr),
+	nodeCount (0)
+{
+
+}
+
+NodeManagerSnapshot::~NodeManagerSnapshot ()
+{
+
+}
+
+bool NodeManagerSnapshot::IsEmpty () const
+{
+	return nodeCount == 0 && (groups == nullptr || groups->empty ());
+}
+
+size_t NodeManagerSnapshot::GetNodeCount () const
+{
+	return nodeCount;
+}
+
+bool NodeManagerSnapshot::ContainsNode (const NodeId& nodeId) const
+{
+	return GetNodeState (nodeId) != nullptr;
+}
+
+bool NodeManagerSnapshot::IsNodeShared (const NodeId& nodeId, const NodeManagerSnapshot& other) const
+{
+	NodeStateConstPtr nodeState = GetNodeState (nodeId);
+	return nodeState != nullptr && nodeState == other.GetNodeState (nodeId);
+}
+
+size_t NodeManagerSnapshot::GetMemorySize () const
+{
+	std::unordered_set<const void*> countedParts;
+	return GetMemorySize (countedParts);
+}
+
+size_t NodeManagerSnapshot::GetMemorySize (std::unordered_set<const void*>& countedParts) const
+{
+	// the parts are shared between snapshots, so every part is counted only once
+	size_t memorySize = sizeof (NodeManagerSnapshot) + NodeBucketCount * sizeof (NodeBucketConstPtr);
+	for (const NodeBucketConstPtr& nodeBucket : nodeBuckets) {
+		if (nodeBucket == nullptr || !countedParts.insert (nodeBucket.get ()).second) {
+			continue;
+		}
+		memorySize += sizeof (NodeBucket) + nodeBucket->size () * sizeof (NodeBucket::value_type);
+		for (const auto& entry : *nodeBucket) {
+			const NodeState* nodeState = entry.second.get ();
+			if (countedParts.insert (nodeState).second) {
+				memorySize += sizeof (NodeState) + nodeState->nodeData.size () + nodeState->inputConnections.size () * sizeof (InputConnection);
+			}
+		}
+	}
+	if (groups != nullptr && countedParts.insert (groups.get ()).second) {
+		for (const GroupState& groupState : *groups) {
+			memorySize += sizeof (GroupState) + groupState.groupData.size () + groupState.groupNodes.size () * sizeof (NodeId);
+		}
+	}
+	return memorySize;
+}
+
+void NodeManagerSnapshot::Clear ()
+{
+	nodeBuckets.assign (NodeBucketCount, nullptr);
+	groups = nullptr;
+	nodeCount = 0;
+}
+
+bool NodeManagerSnapshot::Capture (const NodeManager& nodeManager, const NodeManagerSnapshot& baseSnapshot)
+{
+	// the nodes are serialized to find the changed ones, but only the changed ones are stored
+	bool success = true;
+	std::vector<NodeBucket> newNodeBuckets (NodeBucketCount);
+	nodeManager.EnumerateNodes ([&] (NodeConstPtr node) {
+		NodeState nodeState;
+		MemoryOutputStream nodeStream;
+		if (DBGERROR (!WriteDynamicObject (nodeStream, node.get ()))) {
+			success = false;
+			return false;
+		}
+		nodeState.nodeData = nodeStream.GetBuffer ();
+		node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
+			nodeManager.EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+				nodeState.inputConnections.push_back (InputConnection (inputSlot->GetId (), SlotInfo (outputSlot->GetOwnerNodeId (), outputSlot->GetId ())));
+			});
+			return true;
+		});
+
+		const NodeId& nodeId = node->GetId ();
+		NodeStateConstPtr baseNodeState = baseSnapshot.GetNodeState (nodeId);
+		if (baseNodeState == nullptr || !(*baseNodeState == nodeState)) {
+			baseNodeState.reset (new NodeState (std::move (nodeState)));
+		}
+		newNodeBuckets[GetNodeBucketIndex (nodeId)].push_back ({ nodeId, baseNodeState });
+		return true;
+	});
+	if (!success) {
+		return false;
+	}
+
+	nodeCount = 0;
+	for (size_t bucketIndex = 0; bucketIndex < NodeBucketCount; bucketIndex++) {
+		NodeBucket& newNodeBucket = newNodeBuckets[bucketIndex];
+		const NodeBucketConstPtr& baseNodeBucket = baseSnapshot.nodeBuckets[bucketIndex];
+		nodeCount += newNodeBucket.size ();
+		if (newNodeBucket.empty ()) {
+			nodeBuckets[bucketIndex] = nullptr;
+		} else if (baseNodeBucket != nullptr && *baseNodeBucket == newNodeBucket) {
+			nodeBuckets[bucketIndex] = baseNodeBucket;
+		} else {
+			nodeBuckets[bucketIndex].reset (new NodeBucket (std::move (newNodeBucket)));
+		}
+	}
+
+	GroupStateList newGroups;
+	nodeManager.EnumerateNodeGroups ([&] (NodeGroupConstPtr group) {
+		GroupState groupState;
+		MemoryOutputStream groupStream;
+		if (DBGERROR (!WriteDynamicObject (groupStream, group.get ()))) {
+			success = false;
+			return false;
+		}
+		groupState.groupData = groupStream.GetBuffer ();
+		nodeManager.GetGroupNodes (group->GetId ()).Enumerate ([&] (const NodeId& nodeId) {
+			groupState.groupNodes.push_back (nodeId);
+			return true;
+		});
+		newGroups.push_back (std::move (groupState));
+		return true;
+	});
+	if (!success) {
+		return false;
+	}
+
+	if (newGroups.empty ()) {
+		groups = nullptr;
+	} else if (baseSnapshot.groups != nullptr && *baseSnapshot.groups == newGroups) {
+		groups = baseSnapshot.groups;
+	} else {
+		groups.reset (new GroupStateList (std::move (newGroups)));
+	}
+
+	return true;
+}
+
+bool NodeManagerSnapshot::Restore (const NodeManagerSnapshot& currentSnapshot, NodeManager& target, UpdateEventHandler& eventHandler) const
+{
+	// the current snapshot describes the target, so the shared buckets can be skipped
+	std::vector<NodeId> nodesToDelete;
+	std::vector<NodeId> nodesToCreate;
+	std::vector<NodeId> nodesToReconnect;
+	for (size_t bucketIndex = 0; bucketIndex < NodeBucketCount; bucketIndex++) {
+		const NodeBucketConstPtr& nodeBucket = nodeBuckets[bucketIndex];
+		const NodeBucketConstPtr& currentNodeBucket = currentSnapshot.nodeBuckets[bucketIndex];
+		if (nodeBucket == currentNodeBucket) {
+			continue;
+		}
+		if (currentNodeBucket != nullptr) {
+			for (const auto& currentEntry : *currentNodeBucket) {
+				const NodeStateConstPtr* nodeState = FindNodeState (nodeBucket, currentEntry.first);
+				if (nodeState == nullptr) {
+					nodesToDelete.push_back (currentEntry.first);
+				} else if (*nodeState != currentEntry.second) {
+					if ((*nodeState)->nodeData != currentEntry.second->nodeData) {
+						nodesToDelete.push_back (currentEntry.first);
+						nodesToCreate.push_back (currentEntry.first);
+					} else {
+						nodesToReconnect.push_back (currentEntry.first);
+					}
+				}
+			}
+		}
+		if (nodeBucket != nullptr) {
+			for (const auto& entry : *nodeBucket) {
+				if (FindNodeState (currentNodeBucket, entry.first) == nullptr) {
+					nodesToCreate.push_back (entry.first);
+				}
+			}
+		}
+	}
+
+	// deleting a node removes the connections of its dependents, too
+	for (const NodeId& nodeId : nodesToDelete) {
+		NodeConstPtr node = target.GetNode (nodeId);
+		if (DBGERROR (node == nullptr)) {
+			return false;
+		}
+		target.EnumerateDependentNodes (node, [&] (const NodeId& dependentNodeId) {
+			nodesToReconnect.push_back (dependentNodeId);
+		});
+	}
+
+	for (const NodeId& nodeId : nodesToDelete) {
+		eventHandler.BeforeNodeDelete (nodeId);
+		target.DeleteNode (nodeId);
+	}
+	for (const NodeId& nodeId : nodesToCreate) {
+		NodeStateConstPtr nodeState = GetNodeState (nodeId);
+		MemoryInputStream nodeStream (nodeState->nodeData);
+		NodePtr node (ReadDynamicObject<Node> (nodeStream));
+		if (DBGERROR (node == nullptr)) {
+			return false;
+		}
+		target.AddNode (node, NodeManager::IdPolicy::KeepOriginal, NodeManager::InitPolicy::DoNotInitialize);
+		nodesToReconnect.push_back (nodeId);
+	}
+
+	std::unordered_set<NodeId> reconnectedNodes;
+	for (const NodeId& nodeId : nodesToReconnect) {
+		if (reconnectedNodes.find (nodeId) != reconnectedNodes.end () || !ContainsNode (nodeId)) {
+			continue;
+		}
+		reconnectedNodes.insert (nodeId);
+		if (DBGERROR (!ReconnectNode (nodeId, target))) {
+			return false;
+		}
+	}
+
+	// deleted nodes are removed from their groups, so groups are restored in that case, too
+	bool needToRestoreGroups = !nodesToDelete.empty () || groups != currentSnapshot.groups;
+	if (needToRestoreGroups && nodesToDelete.empty () && groups != nullptr && currentSnapshot.groups != nullptr) {
+		needToRestoreGroups = !(*groups == *currentSnapshot.groups);
+	}
+	if (needToRestoreGroups) {
+		if (DBGERROR (!RestoreGroups (target))) {
+			return false;
+		}
+	}
+
+	target.MakeNodesAndGroupsSorted ();
+	return true;
+}
+
+NodeManagerSnapshot::NodeStateConstPtr NodeManagerSnapshot::GetNodeState (const NodeId& nodeId) const
+{
+	const NodeStateConstPtr* nodeState = FindNodeState (nodeBuckets[GetNodeBucketIndex (nodeId)], nodeId);
+	if (nodeState == nullptr) {
+		return nullptr;
+	}
+	return *nodeState;
+}
+
+const NodeManagerSnapshot::NodeStateConstPtr* NodeManagerSnapshot::FindNodeState (const NodeBucketConstPtr& nodeBucket, const NodeId& nodeId)
+{
+	if (nodeBucket == nullptr) {
+		return nullptr;
+	}
+	for (const auto& entry : *nodeBucket) {
+		if (entry.first == nodeId) {
+			return &entry.second;
+		}
+	}
+	return nullptr;
+}
+
+bool NodeManagerSnapshot::ReconnectNode (const NodeId& nodeId, NodeManager& target) const
+{
+	NodeStateConstPtr nodeState = GetNodeState (nodeId);
+	NodeConstPtr node = target.GetNode (nodeId);
+	if (DBGERROR (nodeState == nullptr || node == nullptr)) {
+		return false;
+	}
+
+	bool success = true;
+	node->EnumerateInputSlots ([&] (InputSlotConstPtr inputSlot) {
+		std::vector<SlotInfo> outputSlotInfos;
+		for (const InputConnection& inputConnection : nodeState->inputConnections) {
+			if (inputConnection.inputSlotId == inputSlot->GetId ()) {
+				outputSlotInfos.push_back (inputConnection.outputSlotInfo);
+			}
+		}
+		std::vector<SlotInfo> targetOutputSlotInfos;
+		target.EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+			targetOutputSlotInfos.push_back (SlotInfo (outputSlot->GetOwnerNodeId (), outputSlot->GetId ()));
+		});
+		if (outputSlotInfos == targetOutputSlotInfos) {
+			return true;
+		}
+		target.DisconnectAllOutputSlotsFromInputSlot (inputSlot);
+		for (const SlotInfo& outputSlotInfo : outputSlotInfos) {
+			NodeConstPtr outputNode = target.GetNode (outputSlotInfo.GetNodeId ());
+			if (DBGERROR (outputNode == nullptr)) {
+				success = false;
+				return false;
+			}
+			OutputSlotConstPtr outputSlot = outputNode->GetOutputSlot (outputSlotInfo.GetSlotId ());
+			if (DBGERROR (outputSlot == nullptr || !target.ConnectOutputSlotToInputSlot (outputSlot, inputSlot))) {
+				success = false;
+				return false;
+			}
+		}
+		return true;
+	});
+
+	return success;
+}
+
+bool NodeManagerSnapshot::RestoreGroups (NodeManager& target) const
+{
+	target.DeleteAllNodeGroups ();
+	if (groups == nullptr) {
+		return true;
+	}
+
+	for (const GroupState& groupState : *groups) {
+		MemoryInputStream groupStream (groupState.groupData);
+		NodeGroupPtr group (ReadDynamicObject<NodeGroup> (groupStream));
+		if (DBGERROR (group == nullptr)) {
+			return false;
+		}
+		target.AddNodeGroup (group, NodeManager::IdPolicy::KeepOriginal);
+		for (const NodeId& nodeId : groupState.groupNodes) {
+			if (target.ContainsNode (nodeId)) {
+				target.AddNodeToGroup (group->GetId (), nodeId);
+			}
+		}
+	}
+
+	return true;
+}
+
+}
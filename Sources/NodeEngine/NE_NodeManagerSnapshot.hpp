@@ -0,0 +1,91 @@
+#ifndef NE_NODEMANAGERSNAPSHOT_HPP
+#define NE_NODEMANAGERSNAPSHOT_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeManagerMerge.hpp"
+#include "NE_ConnectionInfo.hpp"
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+
+namespace NE
+{
+
+// an immutable copy of the nodes, connections and groups of a node manager, the
+// parts that are not changed since the base snapshot are shared with it, so every
+// snapshot stores only the changed nodes, and restoring a snapshot modifies only
+// the nodes that are different in the node manager
+class NodeManagerSnapshot
+{
+public:
+	NodeManagerSnapshot ();
+	~NodeManagerSnapshot ();
+
+	bool		IsEmpty () const;
+	size_t		GetNodeCount () const;
+	bool		ContainsNode (const NodeId& nodeId) const;
+	bool		IsNodeShared (const NodeId& nodeId, const NodeManagerSnapshot& other) const;
+	size_t		GetMemorySize () const;
+	size_t		GetMemorySize (std::unordered_set<const void*>& countedParts) const;
+	void		Clear ();
+
+	bool		Capture (const NodeManager& nodeManager, const NodeManagerSnapshot& baseSnapshot);
+	bool		Restore (const NodeManagerSnapshot& currentSnapshot, NodeManager& target, UpdateEventHandler& eventHandler) const;
+
+private:
+	class InputConnection
+	{
+	public:
+		InputConnection (const SlotId& inputSlotId, const SlotInfo& outputSlotInfo);
+
+		bool		operator== (const InputConnection& rhs) const;
+		bool		operator!= (const InputConnection& rhs) const;
+
+		SlotId		inputSlotId;
+		SlotInfo	outputSlotInfo;
+	};
+
+	class NodeState
+	{
+	public:
+		NodeState ();
+
+		bool		operator== (const NodeState& rhs) const;
+
+		std::vector<char>				nodeData;
+		std::vector<InputConnection>	inputConnections;
+	};
+
+	class GroupState
+	{
+	public:
+		GroupState ();
+
+		bool		operator== (const GroupState& rhs) const;
+
+		std::vector<char>				groupData;
+		std::vector<NodeId>				groupNodes;
+	};
+
+	using NodeStateConstPtr = std::shared_ptr<const NodeState>;
+	using NodeBucket = std::vector<std::pair<NodeId, NodeStateConstPtr>>;
+	using NodeBucketConstPtr = std::shared_ptr<const NodeBucket>;
+	using GroupStateList = std::vector<GroupState>;
+	using GroupStateListConstPtr = std::shared_ptr<const GroupStateList>;
+
+	NodeStateConstPtr		GetNodeState (const NodeId& nodeId) const;
+	bool					ReconnectNode (const NodeId& nodeId, NodeManager& target) const;
+	bool					RestoreGroups (NodeManager& target) const;
+
+	static const NodeStateConstPtr*	FindNodeState (const NodeBucketConstPtr& nodeBucket, const NodeId& nodeId);
+
+	std::vector<NodeBucketConstPtr>		nodeBuckets;
+	GroupStateListConstPtr				groups;
+	size_t								nodeCount;
+};
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include "NE_NodeMemoizationCache.hpp"
+
+namespace NE
+{
+
+static const uint64_t HashPrime = 1099511628211ULL;
+
+NodeMemoizationKey::NodeMemoizationKey () :
+	nodeData (),
+	inputValues (),
+	hashValue (0)
+{
+
+}
+
+NodeMemoizationKey::~NodeMemoizationKey ()
+{
+
+}
+
+void NodeMemoizationKey::SetNodeData (const std::vector<char>& newNodeData)
+{
+	nodeData.assign (newNodeData.begin (), newNodeData.end ());
+	hashValue = std::hash<std::string> {} (nodeData);
+}
+
+void NodeMemoizationKey::AddInputValue (const ValueConstPtr& inputValue)
+{
+	inputValues.push_back (inputValue);
+	hashValue = (hashValue ^ Value::GenerateHashValue (inputValue)) * HashPrime;
+}
+
+uint64_t NodeMemoizationKey::GetHashValue () const
+{
+	return hashValue;
+}
+
+size_t NodeMemoizationKey::GetMemorySize () const
+{
+	// the input values are shared with the values of the input nodes,
+	// so only the references to them are counted
+	return sizeof (NodeMemoizationKey) + nodeData.size () + inputValues.size () * sizeof (ValueConstPtr);
+}
+
+bool NodeMemoizationKey::IsEqual (const NodeMemoizationKey& rhs) const
+{
+	if (hashValue != rhs.hashValue || nodeData != rhs.nodeData || inputValues.size () != rhs.inputValues.size ()) {
+		return false;
+	}
+	for (size_t i = 0; i < inputValues.size (); i++) {
+		if (!Value::IsEqual (inputValues[i], rhs.inputValues[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+NodeMemoizationCache::NodeMemoizationCache () :
+	cache (0),
+	cacheMutex ()
+{
+
+}
+
+NodeMemoizationCache::~NodeMemoizationCache ()
+{
+
+}
+
+bool NodeMemoizationCache::IsEnabled () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return cache.GetMaxSize () > 0;
+}
+
+void NodeMemoizationCache::Clear ()
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	cache.Clear ();
+}
+
+size_t NodeMemoizationCache::GetMemorySize () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return cache.GetSize ();
+}
+
+size_t NodeMemoizationCache::GetMaxMemorySize () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return cache.GetMaxSize ();
+}
+
+void NodeMemoizationCache::SetMaxMemorySize (size_t newMaxMemorySize)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	cache.SetMaxSize (newMaxMemorySize);
+}
+
+bool NodeMemoizationCache::Add (const NodeMemoizationKey& key, const ValueConstPtr& value)
+{
+	// on a hash collision the existing entry is kept
+	size_t memorySize = key.GetMemorySize () + sizeof (ValueConstPtr);
+	if (value != nullptr) {
+		memorySize += value->GetMemorySize ();
+	}
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return cache.Add (key.GetHashValue (), { key, value }, memorySize);
+}
+
+bool NodeMemoizationCache::Get (const NodeMemoizationKey& key, ValueConstPtr& value) const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	if (!cache.Contains (key.GetHashValue ())) {
+		return false;
+	}
+	const Entry& entry = cache.Get (key.GetHashValue ());
+	if (!entry.key.IsEqual (key)) {
+		return false;
+	}
+	value = entry.value;
+	return true;
+}
+
+}
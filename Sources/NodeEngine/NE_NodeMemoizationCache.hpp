@@ -0,0 +1,64 @@
+#ifndef NE_NODEMEMOIZATIONCACHE_HPP
+#define NE_NODEMEMOIZATIONCACHE_HPP
+
+#include "NE_Value.hpp"
+#include "NE_Cache.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace NE
+{
+
+// identifies a calculation by the node data and the input values, it is looked up
+// by a fixed size hash, and the input values are compared only on a hash match
+class NodeMemoizationKey
+{
+public:
+	NodeMemoizationKey ();
+	~NodeMemoizationKey ();
+
+	void			SetNodeData (const std::vector<char>& newNodeData);
+	void			AddInputValue (const ValueConstPtr& inputValue);
+
+	uint64_t		GetHashValue () const;
+	size_t			GetMemorySize () const;
+	bool			IsEqual (const NodeMemoizationKey& rhs) const;
+
+private:
+	std::string						nodeData;
+	std::vector<ValueConstPtr>		inputValues;
+	uint64_t						hashValue;
+};
+
+class NodeMemoizationCache
+{
+public:
+	NodeMemoizationCache ();
+	~NodeMemoizationCache ();
+
+	bool			IsEnabled () const;
+	void			Clear ();
+
+	size_t			GetMemorySize () const;
+	size_t			GetMaxMemorySize () const;
+	void			SetMaxMemorySize (size_t newMaxMemorySize);
+
+	bool			Add (const NodeMemoizationKey& key, const ValueConstPtr& value);
+	bool			Get (const NodeMemoizationKey& key, ValueConstPtr& value) const;
+
+private:
+	class Entry
+	{
+	public:
+		NodeMemoizationKey	key;
+		ValueConstPtr		value;
+	};
+
+	mutable Cache<uint64_t, Entry>	cache;
+	mutable std::mutex				cacheMutex;
+};
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include "NE_NodeStructureCache.hpp"
+
+namespace NE
+{
+
+NodeStructureCache::Entry::Entry (const NodeId& nodeId, uint64_t valueId) :
+	nodeId (nodeId),
+	valueId (valueId)
+{
+
+}
+
+NodeStructureCache::NodeStructureCache () :
+	isEnabled (false),
+	nextValueId (0),
+	nodeValueIds (),
+	nodeKeys (),
+	keyEntries (),
+	cacheMutex ()
+{
+
+}
+
+NodeStructureCache::~NodeStructureCache ()
+{
+
+}
+
+bool NodeStructureCache::IsEnabled () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return isEnabled;
+}
+
+void NodeStructureCache::SetEnabled (bool newIsEnabled)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	isEnabled = newIsEnabled;
+	nodeValueIds.clear ();
+	nodeKeys.clear ();
+	keyEntries.clear ();
+}
+
+void NodeStructureCache::Clear ()
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	nodeValueIds.clear ();
+	nodeKeys.clear ();
+	keyEntries.clear ();
+}
+
+uint64_t NodeStructureCache::GetValueId (const NodeId& nodeId) const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return GetValueIdInternal (nodeId);
+}
+
+void NodeStructureCache::SetValueId (const NodeId& nodeId, uint64_t valueId)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	nodeValueIds[nodeId] = valueId;
+}
+
+void NodeStructureCache::Add (const std::string& key, const NodeId& nodeId)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	RemoveInternal (nodeId);
+	uint64_t valueId = nextValueId++;
+	nodeValueIds[nodeId] = valueId;
+	nodeKeys[nodeId] = key;
+	keyEntries.erase (key);
+	keyEntries.insert ({ key, Entry (nodeId, valueId) });
+}
+
+bool NodeStructureCache::Get (const std::string& key, NodeId& nodeId) const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	auto found = keyEntries.find (key);
+	if (found == keyEntries.end ()) {
+		return false;
+	}
+
+	// the node may have a new value since it was added
+	const Entry& entry = found->second;
+	auto foundValueId = nodeValueIds.find (entry.nodeId);
+	if (foundValueId == nodeValueIds.end () || foundValueId->second != entry.valueId) {
+		return false;
+	}
+	nodeId = entry.nodeId;
+	return true;
+}
+
+void NodeStructureCache::Remove (const NodeId& nodeId)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	RemoveInternal (nodeId);
+}
+
+uint64_t NodeStructureCache::GetValueIdInternal (const NodeId& nodeId) const
+{
+	// values calculated without a structure key get their id when they are first referred
+	auto found = nodeValueIds.find (nodeId);
+	if (found != nodeValueIds.end ()) {
+		return found->second;
+	}
+	uint64_t valueId = nextValueId++;
+	nodeValueIds.insert ({ nodeId, valueId });
+	return valueId;
+}
+
+void NodeStructureCache::RemoveInternal (const NodeId& nodeId)
+{
+	nodeValueIds.erase (nodeId);
+	auto foundKey = nodeKeys.find (nodeId);
+	if (foundKey == nodeKeys.end ()) {
+		return;
+	}
+	auto foundEntry = keyEntries.find (foundKey->second);
+	if (foundEntry != keyEntries.end () && foundEntry->second.nodeId == nodeId) {
+		keyEntries.erase (foundEntry);
+	}
+	nodeKeys.erase (foundKey);
+}
+
+}
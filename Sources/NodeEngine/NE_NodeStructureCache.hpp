@@ -0,0 +1,57 @@
+#ifndef NE_NODESTRUCTURECACHE_HPP
+#define NE_NODESTRUCTURECACHE_HPP
+
+#include "NE_NodeId.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+namespace NE
+{
+
+// maps the structure of nodes (class, parameters and inputs) to a node that
+// already has a value for that structure, every calculated value gets a value
+// id, so the structure of a node refers to the values of its inputs by id
+class NodeStructureCache
+{
+public:
+	NodeStructureCache ();
+	~NodeStructureCache ();
+
+	bool		IsEnabled () const;
+	void		SetEnabled (bool newIsEnabled);
+	void		Clear ();
+
+	uint64_t	GetValueId (const NodeId& nodeId) const;
+	void		SetValueId (const NodeId& nodeId, uint64_t valueId);
+
+	void		Add (const std::string& key, const NodeId& nodeId);
+	bool		Get (const std::string& key, NodeId& nodeId) const;
+	void		Remove (const NodeId& nodeId);
+
+private:
+	class Entry
+	{
+	public:
+		Entry (const NodeId& nodeId, uint64_t valueId);
+
+		NodeId		nodeId;
+		uint64_t	valueId;
+	};
+
+	uint64_t	GetValueIdInternal (const NodeId& nodeId) const;
+	void		RemoveInternal (const NodeId& nodeId);
+
+	bool												isEnabled;
+	mutable uint64_t									nextValueId;
+	mutable std::unordered_map<NodeId, uint64_t>		nodeValueIds;
+	std::unordered_map<NodeId, std::string>				nodeKeys;
+	std::unordered_map<std::string, Entry>				keyEntries;
+	mutable std::mutex									cacheMutex;
+};
+
+}
+
+#endif
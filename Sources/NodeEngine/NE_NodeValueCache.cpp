@@ -1,10 +1,38 @@
 #include "NE_NodeValueCache.hpp"
 #include "NE_Debug.hpp"
 
+#include <algorithm>
+
 namespace NE
 {
 
-NodeValueCache::NodeValueCache ()
+static size_t EstimateMemorySize (const ValueConstPtr& value)
+{
+	size_t memorySize = sizeof (ValueConstPtr);
+	if (value != nullptr) {
+		memorySize += value->GetMemorySize ();
+	}
+	return memorySize;
+}
+
+NodeValueCache::Entry::Entry (const ValueConstPtr& value, size_t memorySize, bool isPinned) :
+	value (value),
+	memorySize (memorySize),
+	calculationCost (0.0),
+	priority (0.0),
+	isPinned (isPinned)
+{
+
+}
+
+NodeValueCache::NodeValueCache () :
+	cache (),
+	evictionQueue (),
+	evictedIds (),
+	memorySize (0),
+	maxMemorySize (0),
+	inflation (0.0),
+	cacheMutex ()
 {
 
 }
@@ -16,35 +44,196 @@ NodeValueCache::~NodeValueCache ()
 
 bool NodeValueCache::Add (const NodeId& id, const ValueConstPtr& value)
 {
-	if (DBGERROR (Contains (id))) {
+	return Add (id, value, false);
+}
+
+bool NodeValueCache::Add (const NodeId& id, const ValueConstPtr& value, bool isPinned)
+{
+	size_t valueMemorySize = 0;
+	if (IsBounded ()) {
+		valueMemorySize = EstimateMemorySize (value);
+	}
+
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	auto inserted = cache.insert ({ id, Entry (value, valueMemorySize, isPinned) });
+	if (DBGERROR (!inserted.second)) {
 		return false;
 	}
-	cache.insert ({ id, value });
+	evictedIds.erase (id);
+	memorySize += valueMemorySize;
+	if (!isPinned) {
+		UpdatePriority (id, inserted.first->second);
+	}
 	return true;
 }
 
 bool NodeValueCache::Remove (const NodeId& id)
 {
-	if (DBGERROR (!Contains (id))) {
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	if (evictedIds.erase (id) > 0) {
+		return true;
+	}
+
+	auto found = cache.find (id);
+	if (DBGERROR (found == cache.end ())) {
 		return false;
 	}
-	cache.erase (id);
+	const Entry& entry = found->second;
+	if (!entry.isPinned) {
+		evictionQueue.erase (PriorityKey (entry.priority, id));
+	}
+	memorySize -= entry.memorySize;
+	cache.erase (found);
 	return true;
 }
 
 void NodeValueCache::Clear ()
 {
-	return cache.clear ();
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	cache.clear ();
+	evictionQueue.clear ();
+	evictedIds.clear ();
+	memorySize = 0;
+	inflation = 0.0;
 }
 
 bool NodeValueCache::Contains (const NodeId& id) const
 {
+	std::lock_guard<std::mutex> lock (cacheMutex);
 	return cache.find (id) != cache.end ();
 }
 
-const ValueConstPtr& NodeValueCache::Get (const NodeId& id) const
+ValueConstPtr NodeValueCache::Get (const NodeId& id) const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return cache.at (id).value;
+}
+
+bool NodeValueCache::IsBounded () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return maxMemorySize > 0;
+}
+
+size_t NodeValueCache::GetMemorySize () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return memorySize;
+}
+
+size_t NodeValueCache::GetMaxMemorySize () const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return maxMemorySize;
+}
+
+void NodeValueCache::SetMaxMemorySize (size_t newMaxMemorySize)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	if (maxMemorySize == 0 && newMaxMemorySize > 0) {
+		// sizes are not estimated while the cache is unbounded
+		evictionQueue.clear ();
+		memorySize = 0;
+		for (auto& it : cache) {
+			Entry& entry = it.second;
+			entry.memorySize = EstimateMemorySize (entry.value);
+			memorySize += entry.memorySize;
+			if (!entry.isPinned) {
+				UpdatePriority (it.first, entry);
+			}
+		}
+	} else if (newMaxMemorySize == 0) {
+		evictedIds.clear ();
+	}
+	maxMemorySize = newMaxMemorySize;
+}
+
+void NodeValueCache::SetPinned (const NodeId& id, bool isPinned)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	auto found = cache.find (id);
+	if (found == cache.end ()) {
+		return;
+	}
+	Entry& entry = found->second;
+	if (entry.isPinned == isPinned) {
+		return;
+	}
+	entry.isPinned = isPinned;
+	if (isPinned) {
+		evictionQueue.erase (PriorityKey (entry.priority, id));
+	} else {
+		UpdatePriority (id, entry);
+	}
+}
+
+void NodeValueCache::SetCalculationCost (const NodeId& id, double costInSeconds)
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	auto found = cache.find (id);
+	if (found == cache.end ()) {
+		return;
+	}
+	Entry& entry = found->second;
+	entry.calculationCost = costInSeconds;
+	if (!entry.isPinned) {
+		evictionQueue.erase (PriorityKey (entry.priority, id));
+		UpdatePriority (id, entry);
+	}
+}
+
+bool NodeValueCache::IsEvicted (const NodeId& id) const
+{
+	std::lock_guard<std::mutex> lock (cacheMutex);
+	return evictedIds.find (id) != evictedIds.end ();
+}
+
+void NodeValueCache::EvictValues (const std::function<bool (const NodeId&)>& canEvict, const std::function<void (const NodeId&)>& processor)
+{
+	// the callbacks may query the cache, so the lock is not held while they run
+	PriorityKey candidate (0.0, NodeId ());
+	bool isFirstCandidate = true;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lock (cacheMutex);
+			if (maxMemorySize == 0 || memorySize <= maxMemorySize) {
+				break;
+			}
+			auto next = isFirstCandidate ? evictionQueue.begin () : evictionQueue.upper_bound (candidate);
+			if (next == evictionQueue.end ()) {
+				break;
+			}
+			candidate = *next;
+			isFirstCandidate = false;
+		}
+
+		const NodeId& id = candidate.second;
+		if (!canEvict (id)) {
+			continue;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock (cacheMutex);
+			if (evictionQueue.erase (candidate) == 0) {
+				continue;
+			}
+			inflation = candidate.first;
+			auto found = cache.find (id);
+			memorySize -= found->second.memorySize;
+			cache.erase (found);
+			evictedIds.insert (id);
+		}
+		processor (id);
+	}
+}
+
+void NodeValueCache::UpdatePriority (const NodeId& id, Entry& entry)
 {
-	return cache.at (id);
+	// greedy dual size: cheap to recalculate and large values are evicted first,
+	// and the inflation makes values that were not recalculated for a while age
+	double costInMicroseconds = entry.calculationCost * 1000000.0;
+	entry.priority = inflation + (1.0 + costInMicroseconds) / (double) std::max (entry.memorySize, (size_t) 1);
+	evictionQueue.insert (PriorityKey (entry.priority, id));
 }
 
 }
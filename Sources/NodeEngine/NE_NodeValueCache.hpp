@@ -4,6 +4,11 @@
 #include "NE_NodeId.hpp"
 #include "NE_Value.hpp"
 #include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <vector>
+#include <functional>
+#include <mutex>
 
 namespace NE
 {
@@ -14,15 +19,48 @@ public:
 	NodeValueCache ();
 	~NodeValueCache ();
 
-	bool					Add (const NodeId& id, const ValueConstPtr& value);
-	bool					Remove (const NodeId& id);
-	void					Clear ();
-	
-	bool					Contains (const NodeId& id) const;
-	const ValueConstPtr&	Get (const NodeId& id) const;
+	bool			Add (const NodeId& id, const ValueConstPtr& value);
+	bool			Add (const NodeId& id, const ValueConstPtr& value, bool isPinned);
+	bool			Remove (const NodeId& id);
+	void			Clear ();
+
+	bool			Contains (const NodeId& id) const;
+	ValueConstPtr	Get (const NodeId& id) const;
+
+	bool			IsBounded () const;
+	size_t			GetMemorySize () const;
+	size_t			GetMaxMemorySize () const;
+	void			SetMaxMemorySize (size_t newMaxMemorySize);
+
+	void			SetPinned (const NodeId& id, bool isPinned);
+	void			SetCalculationCost (const NodeId& id, double costInSeconds);
+	bool			IsEvicted (const NodeId& id) const;
+	void			EvictValues (const std::function<bool (const NodeId&)>& canEvict, const std::function<void (const NodeId&)>& processor);
 
 private:
-	std::unordered_map<NodeId, ValueConstPtr>	cache;
+	class Entry
+	{
+	public:
+		Entry (const ValueConstPtr& value, size_t memorySize, bool isPinned);
+
+		ValueConstPtr	value;
+		size_t			memorySize;
+		double			calculationCost;
+		double			priority;
+		bool			isPinned;
+	};
+
+	using PriorityKey = std::pair<double, NodeId>;
+
+	void			UpdatePriority (const NodeId& id, Entry& entry);
+
+	std::unordered_map<NodeId, Entry>	cache;
+	std::set<PriorityKey>				evictionQueue;
+	std::unordered_set<NodeId>			evictedIds;
+	size_t								memorySize;
+	size_t								maxMemorySize;
+	double								inflation;
+	mutable std::mutex					cacheMutex;
 };
 
 }
@@ -0,0 +1,129 @@
+#include "NE_NodeValueTrace.hpp"
+
+namespace NE
+{
+
+NodeValueTrace::Record::Record (const ValueConstPtr& value, size_t revision) :
+	value (value),
+	state (State::Valid),
+	verifiedRevision (revision),
+	changedRevision (revision)
+{
+
+}
+
+NodeValueTrace::NodeValueTrace () :
+	records (),
+	revision (0),
+	traceMutex ()
+{
+
+}
+
+NodeValueTrace::~NodeValueTrace ()
+{
+
+}
+
+void NodeValueTrace::Clear ()
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	records.clear ();
+	revision = 0;
+}
+
+void NodeValueTrace::Remove (const NodeId& id)
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	records.erase (id);
+}
+
+void NodeValueTrace::StartRevision ()
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	revision++;
+}
+
+void NodeValueTrace::Invalidate (const NodeId& id, bool isMaybeValid)
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	auto found = records.find (id);
+	if (found == records.end ()) {
+		return;
+	}
+
+	Record& record = found->second;
+	if (record.state == State::Valid) {
+		record.state = isMaybeValid ? State::MaybeInvalid : State::Invalid;
+	} else if (!isMaybeValid) {
+		record.state = State::Invalid;
+	}
+}
+
+bool NodeValueTrace::IsMaybeValid (const NodeId& id) const
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	auto found = records.find (id);
+	return found != records.end () && found->second.state == State::MaybeInvalid;
+}
+
+bool NodeValueTrace::ReuseValue (const NodeId& id, const std::vector<NodeId>& inputIds, ValueConstPtr& value)
+{
+	std::lock_guard<std::mutex> lock (traceMutex);
+	auto found = records.find (id);
+	if (found == records.end () || found->second.state != State::MaybeInvalid) {
+		return false;
+	}
+
+	// the last value is still valid if none of the inputs has changed since it was verified
+	Record& record = found->second;
+	for (const NodeId& inputId : inputIds) {
+		auto foundInput = records.find (inputId);
+		if (foundInput == records.end ()) {
+			return false;
+		}
+		const Record& inputRecord = foundInput->second;
+		if (inputRecord.state != State::Valid || inputRecord.changedRevision > record.verifiedRevision) {
+			return false;
+		}
+	}
+
+	record.state = State::Valid;
+	record.verifiedRevision = revision;
+	value = record.value;
+	return true;
+}
+
+void NodeValueTrace::SetCalculatedValue (const NodeId& id, const ValueConstPtr& value)
+{
+	ValueConstPtr lastValue = nullptr;
+	{
+		std::lock_guard<std::mutex> lock (traceMutex);
+		auto found = records.find (id);
+		if (found == records.end ()) {
+			records.insert ({ id, Record (value, revision) });
+			return;
+		}
+		if (found->second.state == State::Valid) {
+			found->second.changedRevision = revision;
+			found->second.value = value;
+			return;
+		}
+		lastValue = found->second.value;
+	}
+
+	// values are compared without locking, so nodes evaluated on
+	// different threads don't have to wait for each other
+	bool isChanged = !Value::IsEqual (lastValue, value);
+
+	std::lock_guard<std::mutex> lock (traceMutex);
+	Record& record = records.at (id);
+	if (isChanged) {
+		record.changedRevision = revision;
+	}
+	record.value = value;
+	record.state = State::Valid;
+	record.verifiedRevision = revision;
+}
+
+}
@@ -0,0 +1,54 @@
+#ifndef NE_NODEVALUETRACE_HPP
+#define NE_NODEVALUETRACE_HPP
+
+#include "NE_NodeId.hpp"
+#include "NE_Value.hpp"
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+namespace NE
+{
+
+class NodeValueTrace
+{
+public:
+	NodeValueTrace ();
+	~NodeValueTrace ();
+
+	void			Clear ();
+	void			Remove (const NodeId& id);
+	void			StartRevision ();
+
+	void			Invalidate (const NodeId& id, bool isMaybeValid);
+	bool			IsMaybeValid (const NodeId& id) const;
+	bool			ReuseValue (const NodeId& id, const std::vector<NodeId>& inputIds, ValueConstPtr& value);
+	void			SetCalculatedValue (const NodeId& id, const ValueConstPtr& value);
+
+private:
+	enum class State
+	{
+		Valid,
+		MaybeInvalid,
+		Invalid
+	};
+
+	class Record
+	{
+	public:
+		Record (const ValueConstPtr& value, size_t revision);
+
+		ValueConstPtr	value;
+		State			state;
+		size_t			verifiedRevision;
+		size_t			changedRevision;
+	};
+
+	std::unordered_map<NodeId, Record>	records;
+	size_t								revision;
+	mutable std::mutex					traceMutex;
+};
+
+}
+
+#endif
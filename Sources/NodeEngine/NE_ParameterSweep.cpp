@@ -0,0 +1,228 @@
+#include "NE_ParameterSweep.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_WorkerThreadPool.hpp"
+#include "NE_Debug.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_set>
+
+namespace NE
+{
+
+ParameterSweep::Parameter::Parameter (const NodeId& nodeId) :
+	nodeId (nodeId),
+	slotId (),
+	isInputSlot (false)
+{
+
+}
+
+ParameterSweep::Parameter::Parameter (const NodeId& nodeId, const SlotId& slotId) :
+	nodeId (nodeId),
+	slotId (slotId),
+	isInputSlot (true)
+{
+
+}
+
+ParameterSweep::ParameterSweep () :
+	parameters (),
+	rows (),
+	threadCount (WorkerThreadPool::GetDefaultThreadCount ())
+{
+
+}
+
+ParameterSweep::~ParameterSweep ()
+{
+
+}
+
+size_t ParameterSweep::AddNodeValueParameter (const NodeId& nodeId)
+{
+	DBGASSERT (rows.empty ());
+	parameters.push_back (Parameter (nodeId));
+	return parameters.size () - 1;
+}
+
+size_t ParameterSweep::AddInputSlotParameter (const NodeId& nodeId, const SlotId& slotId)
+{
+	DBGASSERT (rows.empty ());
+	parameters.push_back (Parameter (nodeId, slotId));
+	return parameters.size () - 1;
+}
+
+size_t ParameterSweep::GetParameterCount () const
+{
+	return parameters.size ();
+}
+
+bool ParameterSweep::AddRow (const std::vector<ValueConstPtr>& values)
+{
+	if (DBGERROR (values.size () != parameters.size ())) {
+		return false;
+	}
+	rows.push_back (values);
+	return true;
+}
+
+size_t ParameterSweep::GetRowCount () const
+{
+	return rows.size ();
+}
+
+void ParameterSweep::ClearRows ()
+{
+	rows.clear ();
+}
+
+size_t ParameterSweep::GetThreadCount () const
+{
+	return threadCount;
+}
+
+void ParameterSweep::SetThreadCount (size_t newThreadCount)
+{
+	threadCount = std::max (newThreadCount, (size_t) 1);
+}
+
+bool ParameterSweep::Evaluate (const NodeManager& nodeManager, const std::vector<NodeId>& outputNodes, EvaluationEnv& env, std::vector<std::vector<ValueConstPtr>>& results) const
+{
+	for (const Parameter& parameter : parameters) {
+		if (DBGERROR (!IsValidParameter (nodeManager, parameter))) {
+			return false;
+		}
+	}
+	NodeCollection outputNodeCollection;
+	for (const NodeId& outputNodeId : outputNodes) {
+		if (DBGERROR (!nodeManager.ContainsNode (outputNodeId))) {
+			return false;
+		}
+		if (!outputNodeCollection.Contains (outputNodeId)) {
+			outputNodeCollection.Insert (outputNodeId);
+		}
+	}
+
+	results.assign (rows.size (), std::vector<ValueConstPtr> (outputNodes.size (), nullptr));
+	if (rows.empty ()) {
+		return true;
+	}
+
+	// only the parameter nodes and their dependents have to be recalculated for a row
+	NodeCollection affectedNodes;
+	for (const Parameter& parameter : parameters) {
+		if (!affectedNodes.Contains (parameter.nodeId)) {
+			affectedNodes.Insert (parameter.nodeId);
+		}
+		nodeManager.EnumerateDependentNodesRecursive (nodeManager.GetNode (parameter.nodeId), [&] (const NodeId& dependentNodeId) {
+			if (!affectedNodes.Contains (dependentNodeId)) {
+				affectedNodes.Insert (dependentNodeId);
+			}
+		});
+	}
+
+	// the other inputs of the outputs are the same for every row
+	NodeCollection sharedNodes;
+	std::unordered_set<NodeId> visitedNodes;
+	std::vector<NodeId> nodesToVisit (outputNodes);
+	while (!nodesToVisit.empty ()) {
+		NodeId nodeId = nodesToVisit.back ();
+		nodesToVisit.pop_back ();
+		if (visitedNodes.find (nodeId) != visitedNodes.end ()) {
+			continue;
+		}
+		visitedNodes.insert (nodeId);
+		if (!affectedNodes.Contains (nodeId)) {
+			sharedNodes.Insert (nodeId);
+		}
+		nodeManager.EnumeratePredecessorNodes (nodeId, [&] (const NodeId& inputNodeId) {
+			nodesToVisit.push_back (inputNodeId);
+		});
+	}
+
+	// the injected parameter values can't be calculated again, so they
+	// must not be evicted from a bounded value cache of the workers
+	NodeCollection pinnedNodes = nodeManager.GetPinnedNodes ();
+	for (const Parameter& parameter : parameters) {
+		if (!pinnedNodes.Contains (parameter.nodeId)) {
+			pinnedNodes.Insert (parameter.nodeId);
+		}
+	}
+
+	// every thread works on its own copy of the graph with its own value cache
+	size_t workerCount = std::min (threadCount, rows.size ());
+	std::vector<std::unique_ptr<NodeManager>> workerManagers;
+	for (size_t i = 0; i < workerCount; i++) {
+		std::unique_ptr<NodeManager> workerManager (new NodeManager ());
+		if (DBGERROR (!NodeManager::CloneSnapshot (nodeManager, *workerManager))) {
+			return false;
+		}
+		workerManager->evaluationMode = NodeManager::EvaluationMode::Sequential;
+		workerManager->SetPinnedNodes (pinnedNodes);
+		workerManagers.push_back (std::move (workerManager));
+	}
+
+	if (!workerManagers[0]->EvaluateNodes (sharedNodes, env)) {
+		return false;
+	}
+	for (size_t i = 1; i < workerCount; i++) {
+		NodeCollection copiedNodes;
+		workerManagers[i]->CopyCalculatedNodeValues (*workerManagers[0], nullptr, copiedNodes);
+	}
+
+	std::atomic<size_t> nextRowIndex (0);
+	WorkerThreadPool::GetSharedPool ().ParallelFor (workerCount, [&] (size_t workerIndex) {
+		NodeManager& workerManager = *workerManagers[workerIndex];
+		for (size_t rowIndex = nextRowIndex++; rowIndex < rows.size (); rowIndex = nextRowIndex++) {
+			if (env.IsCancelled ()) {
+				break;
+			}
+			EvaluateRow (workerManager, affectedNodes, outputNodeCollection, rowIndex, env);
+			for (size_t outputIndex = 0; outputIndex < outputNodes.size (); outputIndex++) {
+				results[rowIndex][outputIndex] = workerManager.GetNode (outputNodes[outputIndex])->Evaluate (env);
+			}
+		}
+	});
+
+	return !env.IsCancelled ();
+}
+
+bool ParameterSweep::IsValidParameter (const NodeManager& nodeManager, const Parameter& parameter) const
+{
+	NodeConstPtr node = nodeManager.GetNode (parameter.nodeId);
+	if (node == nullptr) {
+		return false;
+	}
+	if (parameter.isInputSlot && !node->HasInputSlot (parameter.slotId)) {
+		return false;
+	}
+	return true;
+}
+
+void ParameterSweep::EvaluateRow (NodeManager& nodeManager, const NodeCollection& affectedNodes, const NodeCollection& outputNodeCollection, size_t rowIndex, EvaluationEnv& env) const
+{
+	nodeManager.InvalidateNodeValues (affectedNodes);
+
+	const std::vector<ValueConstPtr>& row = rows[rowIndex];
+	for (size_t parameterIndex = 0; parameterIndex < parameters.size (); parameterIndex++) {
+		const Parameter& parameter = parameters[parameterIndex];
+		if (parameter.isInputSlot) {
+			nodeManager.GetNode (parameter.nodeId)->SetInputSlotDefaultValue (parameter.slotId, row[parameterIndex]);
+		}
+	}
+
+	// node value parameters replace the value of the node, so it is not calculated at all
+	for (size_t parameterIndex = 0; parameterIndex < parameters.size (); parameterIndex++) {
+		const Parameter& parameter = parameters[parameterIndex];
+		if (!parameter.isInputSlot) {
+			nodeManager.SetCalculatedNodeValue (parameter.nodeId, row[parameterIndex]);
+		}
+	}
+
+	nodeManager.EvaluateNodes (outputNodeCollection, env);
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef NE_PARAMETERSWEEP_HPP
+#define NE_PARAMETERSWEEP_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeId.hpp"
+#include "NE_SlotId.hpp"
+#include "NE_Value.hpp"
+#include "NE_EvaluationEnv.hpp"
+
+#include <vector>
+
+namespace NE
+{
+
+// evaluates the same graph for many sets of input values, every row of the
+// sweep gives a value for every parameter, the nodes that do not depend on any
+// parameter are calculated only once and shared between the rows
+class ParameterSweep
+{
+public:
+	ParameterSweep ();
+	~ParameterSweep ();
+
+	size_t		AddNodeValueParameter (const NodeId& nodeId);
+	size_t		AddInputSlotParameter (const NodeId& nodeId, const SlotId& slotId);
+	size_t		GetParameterCount () const;
+
+	bool		AddRow (const std::vector<ValueConstPtr>& values);
+	size_t		GetRowCount () const;
+	void		ClearRows ();
+
+	size_t		GetThreadCount () const;
+	void		SetThreadCount (size_t newThreadCount);
+
+	bool		Evaluate (const NodeManager& nodeManager, const std::vector<NodeId>& outputNodes, EvaluationEnv& env, std::vector<std::vector<ValueConstPtr>>& results) const;
+
+private:
+	class Parameter
+	{
+	public:
+		Parameter (const NodeId& nodeId);
+		Parameter (const NodeId& nodeId, const SlotId& slotId);
+
+		NodeId		nodeId;
+		SlotId		slotId;
+		bool		isInputSlot;
+	};
+
+	bool		IsValidParameter (const NodeManager& nodeManager, const Parameter& parameter) const;
+	void		EvaluateRow (NodeManager& nodeManager, const NodeCollection& affectedNodes, const NodeCollection& outputNodeCollection, size_t rowIndex, EvaluationEnv& env) const;
+
+	std::vector<Parameter>					parameters;
+	std::vector<std::vector<ValueConstPtr>>	rows;
+	size_t									threadCount;
+};
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "NE_ReadWriteLock.hpp"
+#include "NE_Debug.hpp"
+
+#include <vector>
+
+namespace NE
+{
+
+class HeldLock
+{
+public:
+	const ReadWriteLock*	lock;
+	size_t					readCount;
+	size_t					writeCount;
+};
+
+// the locks held by the current thread, so locking again doesn't touch the shared state
+static thread_local std::vector<HeldLock> heldLocks;
+
+static HeldLock* FindHeldLock (const ReadWriteLock* lock)
+{
+	for (HeldLock& heldLock : heldLocks) {
+		if (heldLock.lock == lock) {
+			return &heldLock;
+		}
+	}
+	return nullptr;
+}
+
+static void RemoveHeldLock (const HeldLock* heldLock)
+{
+	heldLocks.erase (heldLocks.begin () + (heldLock - heldLocks.data ()));
+}
+
+ReadWriteLock::ReadWriteLock () :
+	mutex (),
+	condition (),
+	readerCount (0),
+	waitingWriterCount (0),
+	isWriteLocked (false)
+{
+
+}
+
+ReadWriteLock::~ReadWriteLock ()
+{
+	DBGASSERT (readerCount == 0 && !isWriteLocked);
+}
+
+void ReadWriteLock::LockRead ()
+{
+	HeldLock* heldLock = FindHeldLock (this);
+	if (heldLock != nullptr) {
+		heldLock->readCount++;
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		condition.wait (lock, [&] () {
+			return !isWriteLocked && waitingWriterCount == 0;
+		});
+		readerCount++;
+	}
+	heldLocks.push_back ({ this, 1, 0 });
+}
+
+void ReadWriteLock::UnlockRead ()
+{
+	HeldLock* heldLock = FindHeldLock (this);
+	if (DBGERROR (heldLock == nullptr || heldLock->readCount == 0)) {
+		return;
+	}
+	heldLock->readCount--;
+	if (heldLock->readCount > 0 || heldLock->writeCount > 0) {
+		return;
+	}
+	RemoveHeldLock (heldLock);
+	std::lock_guard<std::mutex> lock (mutex);
+	readerCount--;
+	if (readerCount == 0) {
+		condition.notify_all ();
+	}
+}
+
+void ReadWriteLock::LockWrite ()
+{
+	HeldLock* heldLock = FindHeldLock (this);
+	if (heldLock != nullptr) {
+		// a reader would wait for itself
+		DBGASSERT (heldLock->writeCount > 0);
+		heldLock->writeCount++;
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock (mutex);
+		waitingWriterCount++;
+		condition.wait (lock, [&] () {
+			return !isWriteLocked && readerCount == 0;
+		});
+		waitingWriterCount--;
+		isWriteLocked = true;
+	}
+	heldLocks.push_back ({ this, 0, 1 });
+}
+
+void ReadWriteLock::UnlockWrite ()
+{
+	HeldLock* heldLock = FindHeldLock (this);
+	if (DBGERROR (heldLock == nullptr || heldLock->writeCount == 0)) {
+		return;
+	}
+	heldLock->writeCount--;
+	if (heldLock->writeCount > 0) {
+		return;
+	}
+	// the read locks taken inside the write lock are kept as a normal read lock
+	bool isReader = (heldLock->readCount > 0);
+	if (!isReader) {
+		RemoveHeldLock (heldLock);
+	}
+	std::lock_guard<std::mutex> lock (mutex);
+	isWriteLocked = false;
+	if (isReader) {
+		readerCount++;
+	}
+	condition.notify_all ();
+}
+
+ReadLockGuard::ReadLockGuard (ReadWriteLock& lock) :
+	lock (lock)
+{
+	lock.LockRead ();
+}
+
+ReadLockGuard::~ReadLockGuard ()
+{
+	lock.UnlockRead ();
+}
+
+WriteLockGuard::WriteLockGuard (ReadWriteLock& lock) :
+	lock (lock)
+{
+	lock.LockWrite ();
+}
+
+WriteLockGuard::~WriteLockGuard ()
+{
+	lock.UnlockWrite ();
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef NE_READWRITELOCK_HPP
+#define NE_READWRITELOCK_HPP
+
+#include <condition_variable>
+#include <mutex>
+
+namespace NE
+{
+
+// many readers or one writer, waiting writers block new readers, the locks held by
+// a thread are counted per thread, so it can lock again without waiting, but a
+// reader can't upgrade to a write lock
+class ReadWriteLock
+{
+public:
+	ReadWriteLock ();
+	ReadWriteLock (const ReadWriteLock& src) = delete;
+	~ReadWriteLock ();
+
+	ReadWriteLock&				operator= (const ReadWriteLock& rhs) = delete;
+
+	void						LockRead ();
+	void						UnlockRead ();
+	void						LockWrite ();
+	void						UnlockWrite ();
+
+private:
+	std::mutex					mutex;
+	std::condition_variable		condition;
+	size_t						readerCount;
+	size_t						waitingWriterCount;
+	bool						isWriteLocked;
+};
+
+class ReadLockGuard
+{
+public:
+	ReadLockGuard (ReadWriteLock& lock);
+	ReadLockGuard (const ReadLockGuard& src) = delete;
+	~ReadLockGuard ();
+
+	ReadLockGuard&	operator= (const ReadLockGuard& rhs) = delete;
+
+private:
+	ReadWriteLock&	lock;
+};
+
+class WriteLockGuard
+{
+public:
+	WriteLockGuard (ReadWriteLock& lock);
+	WriteLockGuard (const WriteLockGuard& src) = delete;
+	~WriteLockGuard ();
+
+	WriteLockGuard&	operator= (const WriteLockGuard& rhs) = delete;
+
+private:
+	ReadWriteLock&	lock;
+};
+
+}
+
+#endif
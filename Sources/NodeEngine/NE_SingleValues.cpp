@@ -1,4 +1,5 @@
 #include "NE_SingleValues.hpp"
+#include "NE_ValueAllocator.hpp"
 #include "NE_Localization.hpp"
 
 namespace NE
@@ -10,6 +11,12 @@ DYNAMIC_SERIALIZATION_INFO (FloatValue, 1, "{D7FB2FE0-90E3-4A85-9C0F-9D90AFC8CD8
 DYNAMIC_SERIALIZATION_INFO (DoubleValue, 1, "{4D6581DC-7A20-4F2A-A1A3-95BF6DDFFDB6}");
 DYNAMIC_SERIALIZATION_INFO (StringValue, 1, "{FABFAA20-48F4-4F15-A9FB-FD8F05581F31}");
 
+VALUE_TYPE_INFO (BooleanValue, GenericValue<bool>);
+VALUE_TYPE_INFO (IntValue, GenericValue<int>);
+VALUE_TYPE_INFO (FloatValue, GenericValue<float>);
+VALUE_TYPE_INFO (DoubleValue, GenericValue<double>);
+VALUE_TYPE_INFO (StringValue, GenericValue<std::wstring>);
+
 BooleanValue::BooleanValue () :
 	BooleanValue (false)
 {
@@ -29,7 +36,7 @@ BooleanValue::~BooleanValue ()
 
 ValuePtr BooleanValue::Clone () const
 {
-	return std::make_shared<BooleanValue> (val);
+	return MakeValue<BooleanValue> (val);
 }
 
 std::wstring BooleanValue::ToString (const StringConverter&) const
@@ -37,6 +44,16 @@ std::wstring BooleanValue::ToString (const StringConverter&) const
 	return val ? LocalizeString (L"true") : LocalizeString (L"false");
 }
 
+size_t BooleanValue::GetMemorySize () const
+{
+	return sizeof (BooleanValue);
+}
+
+const NumberValue* BooleanValue::GetNumberValueInterface () const
+{
+	return nullptr;
+}
+
 Stream::Status BooleanValue::Read (InputStream& inputStream)
 {
 	ObjectHeader header (inputStream);
@@ -72,7 +89,7 @@ StringValue::~StringValue ()
 
 ValuePtr StringValue::Clone () const
 {
-	return std::make_shared<StringValue> (val);
+	return MakeValue<StringValue> (val);
 }
 
 std::wstring StringValue::ToString (const StringConverter&) const
@@ -80,6 +97,16 @@ std::wstring StringValue::ToString (const StringConverter&) const
 	return val;
 }
 
+size_t StringValue::GetMemorySize () const
+{
+	return sizeof (StringValue) + val.capacity () * sizeof (wchar_t);
+}
+
+const NumberValue* StringValue::GetNumberValueInterface () const
+{
+	return nullptr;
+}
+
 Stream::Status StringValue::Read (InputStream& inputStream)
 {
 	ObjectHeader header (inputStream);
@@ -108,12 +135,12 @@ NumberValue::~NumberValue ()
 
 int NumberValue::ToInteger (const ValueConstPtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToInteger ();
+	return Value::Cast<NumberValue> (val.get ())->ToInteger ();
 }
 
 int NumberValue::ToInteger (const ValuePtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToInteger ();
+	return Value::Cast<NumberValue> (val.get ())->ToInteger ();
 }
 
 int NumberValue::ToInteger (Value* val)
@@ -123,12 +150,12 @@ int NumberValue::ToInteger (Value* val)
 
 float NumberValue::ToFloat (const ValuePtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToFloat ();
+	return Value::Cast<NumberValue> (val.get ())->ToFloat ();
 }
 
 float NumberValue::ToFloat (const ValueConstPtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToFloat ();
+	return Value::Cast<NumberValue> (val.get ())->ToFloat ();
 }
 
 float NumberValue::ToFloat (Value* val)
@@ -138,12 +165,12 @@ float NumberValue::ToFloat (Value* val)
 
 double NumberValue::ToDouble (const ValueConstPtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToDouble ();
+	return Value::Cast<NumberValue> (val.get ())->ToDouble ();
 }
 
 double NumberValue::ToDouble (const ValuePtr& val)
 {
-	return Value::Cast<NumberValue> (val)->ToDouble ();
+	return Value::Cast<NumberValue> (val.get ())->ToDouble ();
 }
 
 double NumberValue::ToDouble (Value* val)
@@ -171,7 +198,7 @@ IntValue::~IntValue ()
 
 ValuePtr IntValue::Clone () const
 {
-	return std::make_shared<IntValue> (val);
+	return MakeValue<IntValue> (val);
 }
 
 std::wstring IntValue::ToString (const StringConverter&) const
@@ -179,6 +206,16 @@ std::wstring IntValue::ToString (const StringConverter&) const
 	return std::to_wstring (val);
 }
 
+size_t IntValue::GetMemorySize () const
+{
+	return sizeof (IntValue);
+}
+
+const NumberValue* IntValue::GetNumberValueInterface () const
+{
+	return this;
+}
+
 int IntValue::ToInteger () const
 {
 	return val;
@@ -230,7 +267,7 @@ FloatValue::~FloatValue ()
 
 ValuePtr FloatValue::Clone () const
 {
-	return std::make_shared<FloatValue> (val);
+	return MakeValue<FloatValue> (val);
 }
 
 std::wstring FloatValue::ToString (const StringConverter& stringConverter) const
@@ -238,6 +275,16 @@ std::wstring FloatValue::ToString (const StringConverter& stringConverter) const
 	return stringConverter.NumberToString (val, StringConverter::Measure::Number);
 }
 
+size_t FloatValue::GetMemorySize () const
+{
+	return sizeof (FloatValue);
+}
+
+const NumberValue* FloatValue::GetNumberValueInterface () const
+{
+	return this;
+}
+
 int FloatValue::ToInteger () const
 {
 	return (int) val;
@@ -289,7 +336,7 @@ DoubleValue::~DoubleValue ()
 
 ValuePtr DoubleValue::Clone () const
 {
-	return std::make_shared<DoubleValue> (val);
+	return MakeValue<DoubleValue> (val);
 }
 
 std::wstring DoubleValue::ToString (const StringConverter& stringConverter) const
@@ -297,6 +344,16 @@ std::wstring DoubleValue::ToString (const StringConverter& stringConverter) cons
 	return stringConverter.NumberToString (val, StringConverter::Measure::Number);
 }
 
+size_t DoubleValue::GetMemorySize () const
+{
+	return sizeof (DoubleValue);
+}
+
+const NumberValue* DoubleValue::GetNumberValueInterface () const
+{
+	return this;
+}
+
 int DoubleValue::ToInteger () const
 {
 	return (int) val;
@@ -10,17 +10,20 @@ namespace NE
 class BooleanValue : public GenericValue<bool>
 {
 	DYNAMIC_SERIALIZABLE (BooleanValue);
+	VALUE_TYPE (BooleanValue);
 
 public:
 	BooleanValue ();
 	BooleanValue (bool val);
 	virtual ~BooleanValue ();
 
-	virtual ValuePtr		Clone () const override;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const override;
+	virtual ValuePtr			Clone () const override;
+	virtual std::wstring		ToString (const StringConverter& stringConverter) const override;
+	virtual size_t				GetMemorySize () const override;
+	virtual const NumberValue*	GetNumberValueInterface () const override;
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 class NumberValue
@@ -48,79 +51,91 @@ class IntValue : public NumberValue,
 				 public GenericValue<int>
 {
 	DYNAMIC_SERIALIZABLE (IntValue);
+	VALUE_TYPE (IntValue);
 
 public:
 	IntValue ();
 	IntValue (int val);
 	virtual ~IntValue ();
 
-	virtual ValuePtr		Clone () const override;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const override;
+	virtual ValuePtr			Clone () const override;
+	virtual std::wstring		ToString (const StringConverter& stringConverter) const override;
+	virtual size_t				GetMemorySize () const override;
+	virtual const NumberValue*	GetNumberValueInterface () const override;
 
-	virtual int				ToInteger () const override;
-	virtual float			ToFloat () const override;
-	virtual double			ToDouble () const override;
+	virtual int					ToInteger () const override;
+	virtual float				ToFloat () const override;
+	virtual double				ToDouble () const override;
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 class FloatValue :	public NumberValue,
 					public GenericValue<float>
 {
 	DYNAMIC_SERIALIZABLE (FloatValue);
+	VALUE_TYPE (FloatValue);
 
 public:
 	FloatValue ();
 	FloatValue (float val);
 	virtual ~FloatValue ();
 
-	virtual ValuePtr		Clone () const override;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const override;
+	virtual ValuePtr			Clone () const override;
+	virtual std::wstring		ToString (const StringConverter& stringConverter) const override;
+	virtual size_t				GetMemorySize () const override;
+	virtual const NumberValue*	GetNumberValueInterface () const override;
 
-	virtual int				ToInteger () const override;
-	virtual float			ToFloat () const override;
-	virtual double			ToDouble () const override;
+	virtual int					ToInteger () const override;
+	virtual float				ToFloat () const override;
+	virtual double				ToDouble () const override;
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 class DoubleValue : public NumberValue,
 					public GenericValue<double>
 {
 	DYNAMIC_SERIALIZABLE (DoubleValue);
+	VALUE_TYPE (DoubleValue);
 
 public:
 	DoubleValue ();
 	DoubleValue (double val);
 	virtual ~DoubleValue ();
 
-	virtual ValuePtr		Clone () const override;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const override;
+	virtual ValuePtr			Clone () const override;
+	virtual std::wstring		ToString (const StringConverter& stringConverter) const override;
+	virtual size_t				GetMemorySize () const override;
+	virtual const NumberValue*	GetNumberValueInterface () const override;
 
-	virtual int				ToInteger () const override;
-	virtual float			ToFloat () const override;
-	virtual double			ToDouble () const override;
+	virtual int					ToInteger () const override;
+	virtual float				ToFloat () const override;
+	virtual double				ToDouble () const override;
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 class StringValue : public GenericValue<std::wstring>
 {
 	DYNAMIC_SERIALIZABLE (StringValue);
+	VALUE_TYPE (StringValue);
 
 public:
 	StringValue ();
 	StringValue (const std::wstring& val);
 	virtual ~StringValue ();
 
-	virtual ValuePtr		Clone () const override;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const override;
+	virtual ValuePtr			Clone () const override;
+	virtual std::wstring		ToString (const StringConverter& stringConverter) const override;
+	virtual size_t				GetMemorySize () const override;
+	virtual const NumberValue*	GetNumberValueInterface () const override;
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 }
@@ -1,18 +1,28 @@
 #include "NE_SlotId.hpp"
 
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
 namespace NE
 {
 
 SERIALIZATION_INFO (SlotId, 1);
 
+struct SlotId::Symbol
+{
+	std::string	name;
+	size_t		hashValue;
+};
+
 SlotId::SlotId () :
-	id ()
+	symbol (InternSymbol (std::string ()))
 {
 
 }
 
 SlotId::SlotId (const std::string& id) :
-	id (id)
+	symbol (InternSymbol (id))
 {
 
 }
@@ -22,24 +32,35 @@ SlotId::~SlotId ()
 
 }
 
+const std::string& SlotId::GetName () const
+{
+	return symbol->name;
+}
+
 size_t SlotId::GenerateHashValue () const
 {
-	return std::hash<std::string> {} (id);
+	return symbol->hashValue;
 }
 
 bool SlotId::operator< (const SlotId& rhs) const
 {
-	return id < rhs.id;
+	if (symbol == rhs.symbol) {
+		return false;
+	}
+	return symbol->name < rhs.symbol->name;
 }
 
 bool SlotId::operator> (const SlotId& rhs) const
 {
-	return id > rhs.id;
+	if (symbol == rhs.symbol) {
+		return false;
+	}
+	return symbol->name > rhs.symbol->name;
 }
 
 bool SlotId::operator== (const SlotId& rhs) const
 {
-	return id == rhs.id;
+	return symbol == rhs.symbol;
 }
 
 bool SlotId::operator!= (const SlotId& rhs) const
@@ -50,17 +71,35 @@ bool SlotId::operator!= (const SlotId& rhs) const
 Stream::Status SlotId::Read (InputStream& inputStream)
 {
 	ObjectHeader header (inputStream);
+	std::string id;
 	inputStream.Read (id);
+	symbol = InternSymbol (id);
 	return inputStream.GetStatus ();
 }
 
 Stream::Status SlotId::Write (OutputStream& outputStream) const
 {
 	ObjectHeader header (outputStream, serializationInfo);
-	outputStream.Write (id);
+	outputStream.Write (symbol->name);
 	return outputStream.GetStatus ();
 }
 
+const SlotId::Symbol* SlotId::InternSymbol (const std::string& name)
+{
+	// symbols are never released, so the slot identifiers can refer to them directly
+	static std::mutex symbolTableMutex;
+	static std::unordered_map<std::string, std::unique_ptr<Symbol>> symbolTable;
+
+	std::lock_guard<std::mutex> lock (symbolTableMutex);
+	auto foundSymbol = symbolTable.find (name);
+	if (foundSymbol != symbolTable.end ()) {
+		return foundSymbol->second.get ();
+	}
+	Symbol* newSymbol = new Symbol { name, std::hash<std::string> {} (name) };
+	symbolTable.insert ({ name, std::unique_ptr<Symbol> (newSymbol) });
+	return newSymbol;
+}
+
 const SlotId NullSlotId;
 
 }
@@ -8,6 +8,9 @@
 namespace NE
 {
 
+// slot identifiers are interned in a global symbol table, so copying,
+// comparing and hashing them doesn't touch the identifier string,
+// construct them once (e.g. as static constants) to avoid the lookup
 class SlotId
 {
 	SERIALIZABLE;
@@ -17,18 +20,23 @@ public:
 	explicit SlotId (const std::string& id);
 	~SlotId ();
 
-	size_t			GenerateHashValue () const;
+	const std::string&	GetName () const;
+	size_t				GenerateHashValue () const;
 
-	bool			operator< (const SlotId& rhs) const;
-	bool			operator> (const SlotId& rhs) const;
-	bool			operator== (const SlotId& rhs) const;
-	bool			operator!= (const SlotId& rhs) const;
+	bool				operator< (const SlotId& rhs) const;
+	bool				operator> (const SlotId& rhs) const;
+	bool				operator== (const SlotId& rhs) const;
+	bool				operator!= (const SlotId& rhs) const;
 
-	Stream::Status	Read (InputStream& inputStream);
-	Stream::Status	Write (OutputStream& outputStream) const;
+	Stream::Status		Read (InputStream& inputStream);
+	Stream::Status		Write (OutputStream& outputStream) const;
 
 private:
-	std::string id;
+	struct Symbol;
+
+	static const Symbol*	InternSymbol (const std::string& name);
+
+	const Symbol*	symbol;
 };
 
 extern const SlotId NullSlotId;
@@ -0,0 +1,136 @@
+#include "NE_TopologicalOrder.hpp"
+#include "NE_Debug.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace NE
+{
+
+TopologicalOrder::TopologicalOrder () :
+	nodeOrders (),
+	nextOrder (0)
+{
+
+}
+
+TopologicalOrder::~TopologicalOrder ()
+{
+
+}
+
+void TopologicalOrder::Clear ()
+{
+	nodeOrders.clear ();
+	nextOrder = 0;
+}
+
+bool TopologicalOrder::IsEmpty () const
+{
+	return nodeOrders.empty ();
+}
+
+bool TopologicalOrder::Contains (const NodeId& nodeId) const
+{
+	return nodeOrders.find (nodeId) != nodeOrders.end ();
+}
+
+size_t TopologicalOrder::GetOrder (const NodeId& nodeId) const
+{
+	return nodeOrders.at (nodeId);
+}
+
+void TopologicalOrder::AddNode (const NodeId& nodeId)
+{
+	DBGASSERT (!Contains (nodeId));
+	nodeOrders.insert ({ nodeId, nextOrder++ });
+}
+
+void TopologicalOrder::DeleteNode (const NodeId& nodeId)
+{
+	DBGASSERT (Contains (nodeId));
+	nodeOrders.erase (nodeId);
+}
+
+bool TopologicalOrder::IsReachable (const NodeId& begNodeId, const NodeId& endNodeId, const NeighborEnumerator& successors) const
+{
+	if (begNodeId == endNodeId) {
+		return true;
+	}
+
+	// every edge points to a node with a greater order, so there is nothing
+	// to search for if the end node precedes the beginning node
+	size_t begOrder = GetOrder (begNodeId);
+	size_t endOrder = GetOrder (endNodeId);
+	if (endOrder < begOrder) {
+		return false;
+	}
+
+	std::vector<NodeId> reachableNodes;
+	CollectNodes (begNodeId, begOrder, endOrder, successors, reachableNodes);
+	return std::find (reachableNodes.begin (), reachableNodes.end (), endNodeId) != reachableNodes.end ();
+}
+
+void TopologicalOrder::AddEdge (const NodeId& begNodeId, const NodeId& endNodeId, const NeighborEnumerator& successors, const NeighborEnumerator& predecessors)
+{
+	size_t lowerBound = GetOrder (endNodeId);
+	size_t upperBound = GetOrder (begNodeId);
+	if (lowerBound > upperBound) {
+		return;
+	}
+
+	// Pearce-Kelly: only the nodes between the two orders can be affected,
+	// the nodes reachable from the end node are moved after the nodes
+	// the beginning node is reachable from, using the same order values
+	std::vector<NodeId> forwardNodes;
+	std::vector<NodeId> backwardNodes;
+	CollectNodes (endNodeId, lowerBound, upperBound, successors, forwardNodes);
+	CollectNodes (begNodeId, lowerBound, upperBound, predecessors, backwardNodes);
+	DBGASSERT (std::find (forwardNodes.begin (), forwardNodes.end (), begNodeId) == forwardNodes.end ());
+
+	auto compareOrders = [&] (const NodeId& a, const NodeId& b) {
+		return GetOrder (a) < GetOrder (b);
+	};
+	std::sort (forwardNodes.begin (), forwardNodes.end (), compareOrders);
+	std::sort (backwardNodes.begin (), backwardNodes.end (), compareOrders);
+
+	std::vector<size_t> orders;
+	for (const NodeId& nodeId : backwardNodes) {
+		orders.push_back (GetOrder (nodeId));
+	}
+	for (const NodeId& nodeId : forwardNodes) {
+		orders.push_back (GetOrder (nodeId));
+	}
+	std::sort (orders.begin (), orders.end ());
+
+	size_t orderIndex = 0;
+	for (const NodeId& nodeId : backwardNodes) {
+		nodeOrders[nodeId] = orders[orderIndex++];
+	}
+	for (const NodeId& nodeId : forwardNodes) {
+		nodeOrders[nodeId] = orders[orderIndex++];
+	}
+}
+
+void TopologicalOrder::CollectNodes (const NodeId& startNodeId, size_t lowerBound, size_t upperBound, const NeighborEnumerator& neighbors, std::vector<NodeId>& result) const
+{
+	std::unordered_set<NodeId> visitedNodes;
+	std::vector<NodeId> nodesToVisit = { startNodeId };
+	visitedNodes.insert (startNodeId);
+	while (!nodesToVisit.empty ()) {
+		NodeId currentNodeId = nodesToVisit.back ();
+		nodesToVisit.pop_back ();
+		result.push_back (currentNodeId);
+		neighbors (currentNodeId, [&] (const NodeId& neighborNodeId) {
+			size_t neighborOrder = GetOrder (neighborNodeId);
+			if (neighborOrder < lowerBound || neighborOrder > upperBound) {
+				return;
+			}
+			if (visitedNodes.insert (neighborNodeId).second) {
+				nodesToVisit.push_back (neighborNodeId);
+			}
+		});
+	}
+}
+
+}
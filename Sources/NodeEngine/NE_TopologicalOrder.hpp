@@ -0,0 +1,41 @@
+#ifndef NE_TOPOLOGICALORDER_HPP
+#define NE_TOPOLOGICALORDER_HPP
+
+#include "NE_NodeId.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace NE
+{
+
+class TopologicalOrder
+{
+public:
+	using NeighborEnumerator = std::function<void (const NodeId&, const std::function<void (const NodeId&)>&)>;
+
+	TopologicalOrder ();
+	~TopologicalOrder ();
+
+	void	Clear ();
+	bool	IsEmpty () const;
+	bool	Contains (const NodeId& nodeId) const;
+	size_t	GetOrder (const NodeId& nodeId) const;
+
+	void	AddNode (const NodeId& nodeId);
+	void	DeleteNode (const NodeId& nodeId);
+
+	bool	IsReachable (const NodeId& begNodeId, const NodeId& endNodeId, const NeighborEnumerator& successors) const;
+	void	AddEdge (const NodeId& begNodeId, const NodeId& endNodeId, const NeighborEnumerator& successors, const NeighborEnumerator& predecessors);
+
+private:
+	void	CollectNodes (const NodeId& startNodeId, size_t lowerBound, size_t upperBound, const NeighborEnumerator& neighbors, std::vector<NodeId>& result) const;
+
+	std::unordered_map<NodeId, size_t>	nodeOrders;
+	size_t								nextOrder;
+};
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "NE_TypedListValues.hpp"
+#include "NE_ValueAllocator.hpp"
+
+namespace NE
+{
+
+DYNAMIC_SERIALIZATION_INFO (BooleanListValue, 1, "{3C0A5D7E-6B0F-4F2B-9C3E-0F6A1D2B8E41}");
+DYNAMIC_SERIALIZATION_INFO (IntListValue, 1, "{8E2F4A1C-5D3B-4C7E-A6F9-2B1D7C3E5A90}");
+DYNAMIC_SERIALIZATION_INFO (DoubleListValue, 1, "{B5D1E8C2-9A4F-4E3B-8D7C-6F0A2E1B4C73}");
+
+using BooleanTypedListValue = TypedListValue<bool, BooleanValue>;
+using IntTypedListValue = TypedListValue<int, IntValue>;
+using DoubleTypedListValue = TypedListValue<double, DoubleValue>;
+
+VALUE_TYPE_INFO (BooleanListValue, BooleanTypedListValue);
+VALUE_TYPE_INFO (IntListValue, IntTypedListValue);
+VALUE_TYPE_INFO (DoubleListValue, DoubleTypedListValue);
+
+BooleanListValue::BooleanListValue () :
+	BooleanListValue (std::vector<bool> ())
+{
+
+}
+
+BooleanListValue::BooleanListValue (const std::vector<bool>& items) :
+	TypedListValue<bool, BooleanValue> (items)
+{
+
+}
+
+BooleanListValue::BooleanListValue (std::vector<bool>&& items) :
+	TypedListValue<bool, BooleanValue> (std::move (items))
+{
+
+}
+
+BooleanListValue::~BooleanListValue ()
+{
+
+}
+
+ValuePtr BooleanListValue::Clone () const
+{
+	return MakeValue<BooleanListValue> (items);
+}
+
+Stream::Status BooleanListValue::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Value::Read (inputStream);
+	ReadItems (inputStream);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status BooleanListValue::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Value::Write (outputStream);
+	WriteItems (outputStream);
+	return outputStream.GetStatus ();
+}
+
+IntListValue::IntListValue () :
+	IntListValue (std::vector<int> ())
+{
+
+}
+
+IntListValue::IntListValue (const std::vector<int>& items) :
+	TypedListValue<int, IntValue> (items)
+{
+
+}
+
+IntListValue::IntListValue (std::vector<int>&& items) :
+	TypedListValue<int, IntValue> (std::move (items))
+{
+
+}
+
+IntListValue::~IntListValue ()
+{
+
+}
+
+ValuePtr IntListValue::Clone () const
+{
+	return MakeValue<IntListValue> (items);
+}
+
+Stream::Status IntListValue::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Value::Read (inputStream);
+	ReadItems (inputStream);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status IntListValue::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Value::Write (outputStream);
+	WriteItems (outputStream);
+	return outputStream.GetStatus ();
+}
+
+DoubleListValue::DoubleListValue () :
+	DoubleListValue (std::vector<double> ())
+{
+
+}
+
+DoubleListValue::DoubleListValue (const std::vector<double>& items) :
+	TypedListValue<double, DoubleValue> (items)
+{
+
+}
+
+DoubleListValue::DoubleListValue (std::vector<double>&& items) :
+	TypedListValue<double, DoubleValue> (std::move (items))
+{
+
+}
+
+DoubleListValue::~DoubleListValue ()
+{
+
+}
+
+ValuePtr DoubleListValue::Clone () const
+{
+	return MakeValue<DoubleListValue> (items);
+}
+
+Stream::Status DoubleListValue::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Value::Read (inputStream);
+	ReadItems (inputStream);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status DoubleListValue::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Value::Write (outputStream);
+	WriteItems (outputStream);
+	return outputStream.GetStatus ();
+}
+
+}
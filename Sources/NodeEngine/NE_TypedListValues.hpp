@@ -0,0 +1,299 @@
+#ifndef NE_TYPEDLISTVALUES_HPP
+#define NE_TYPEDLISTVALUES_HPP
+
+#include "NE_Value.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_Serializable.hpp"
+#include "NE_ValueAllocator.hpp"
+
+#include <vector>
+
+namespace NE
+{
+
+template <class ItemType, class ItemValueType>
+class TypedListValue :	public Value,
+						public IListValue
+{
+	VALUE_TYPE (TypedListValue);
+
+public:
+	TypedListValue ();
+	TypedListValue (const std::vector<ItemType>& items);
+	TypedListValue (std::vector<ItemType>&& items);
+	TypedListValue (const TypedListValue&) = delete;
+	virtual ~TypedListValue ();
+
+	TypedListValue&					operator= (const TypedListValue&) = delete;
+
+	virtual std::wstring			ToString (const StringConverter& stringConverter) const override;
+	virtual size_t					GetMemorySize () const override;
+	virtual const IListValue*		GetListValueInterface () const override;
+	virtual const NumberValue*		GetNumberValueInterface () const override;
+
+	virtual size_t					GetSize () const override;
+	virtual ValueConstPtr			GetValue (size_t index) const override;
+	virtual bool					Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const override;
+	virtual bool					HasUniformItemType () const override;
+	virtual bool					EnumerateItems (const std::function<bool (const Value*)>& processor) const override;
+
+	void							Reserve (size_t size);
+	void							Push (const ItemType& item);
+	ItemType						GetItem (size_t index) const;
+	const std::vector<ItemType>&	GetItems () const;
+
+protected:
+	Stream::Status					ReadItems (InputStream& inputStream);
+	Stream::Status					WriteItems (OutputStream& outputStream) const;
+
+	std::vector<ItemType>	items;
+};
+
+template <class ItemType>
+size_t GetItemsMemorySize (const std::vector<ItemType>& items)
+{
+	return items.capacity () * sizeof (ItemType);
+}
+
+inline size_t GetItemsMemorySize (const std::vector<bool>& items)
+{
+	return items.capacity () / 8;
+}
+
+template <class ItemType, class ItemValueType>
+const ValueTypeInfo TypedListValue<ItemType, ItemValueType>::valueTypeInfo (&Value::valueTypeInfo);
+
+template <class ItemType, class ItemValueType>
+TypedListValue<ItemType, ItemValueType>::TypedListValue () :
+	TypedListValue (std::vector<ItemType> ())
+{
+
+}
+
+template <class ItemType, class ItemValueType>
+TypedListValue<ItemType, ItemValueType>::TypedListValue (const std::vector<ItemType>& items) :
+	Value (),
+	IListValue (),
+	items (items)
+{
+
+}
+
+template <class ItemType, class ItemValueType>
+TypedListValue<ItemType, ItemValueType>::TypedListValue (std::vector<ItemType>&& items) :
+	Value (),
+	IListValue (),
+	items (std::move (items))
+{
+
+}
+
+template <class ItemType, class ItemValueType>
+TypedListValue<ItemType, ItemValueType>::~TypedListValue ()
+{
+
+}
+
+template <class ItemType, class ItemValueType>
+std::wstring TypedListValue<ItemType, ItemValueType>::ToString (const StringConverter& stringConverter) const
+{
+	class ListEnumerator : public StringConverter::ListEnumerator
+	{
+	public:
+		ListEnumerator (const TypedListValue* val, const StringConverter& converter) :
+			val (val),
+			converter (converter)
+		{
+		}
+
+		virtual size_t GetSize () const override
+		{
+			return val->GetSize ();
+		}
+
+		virtual std::wstring GetItem (size_t index) const override
+		{
+			ItemValueType itemValue (val->GetItem (index));
+			return itemValue.ToString (converter);
+		}
+
+	private:
+		const TypedListValue*	val;
+		const StringConverter&	converter;
+	};
+
+	ListEnumerator enumerator (this, stringConverter);
+	return stringConverter.ListToString (enumerator);
+}
+
+template <class ItemType, class ItemValueType>
+size_t TypedListValue<ItemType, ItemValueType>::GetMemorySize () const
+{
+	return sizeof (TypedListValue) + GetItemsMemorySize (items);
+}
+
+template <class ItemType, class ItemValueType>
+const IListValue* TypedListValue<ItemType, ItemValueType>::GetListValueInterface () const
+{
+	return this;
+}
+
+template <class ItemType, class ItemValueType>
+const NumberValue* TypedListValue<ItemType, ItemValueType>::GetNumberValueInterface () const
+{
+	return nullptr;
+}
+
+template <class ItemType, class ItemValueType>
+size_t TypedListValue<ItemType, ItemValueType>::GetSize () const
+{
+	return items.size ();
+}
+
+template <class ItemType, class ItemValueType>
+ValueConstPtr TypedListValue<ItemType, ItemValueType>::GetValue (size_t index) const
+{
+	return MakeValue<ItemValueType> (items[index]);
+}
+
+template <class ItemType, class ItemValueType>
+bool TypedListValue<ItemType, ItemValueType>::Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const
+{
+	for (size_t i = 0; i < items.size (); ++i) {
+		if (!processor (GetValue (i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class ItemType, class ItemValueType>
+bool TypedListValue<ItemType, ItemValueType>::HasUniformItemType () const
+{
+	return true;
+}
+
+template <class ItemType, class ItemValueType>
+bool TypedListValue<ItemType, ItemValueType>::EnumerateItems (const std::function<bool (const Value*)>& processor) const
+{
+	for (size_t i = 0; i < items.size (); ++i) {
+		ItemValueType itemValue (items[i]);
+		if (!processor (&itemValue)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class ItemType, class ItemValueType>
+void TypedListValue<ItemType, ItemValueType>::Reserve (size_t size)
+{
+	items.reserve (size);
+}
+
+template <class ItemType, class ItemValueType>
+void TypedListValue<ItemType, ItemValueType>::Push (const ItemType& item)
+{
+	items.push_back (item);
+}
+
+template <class ItemType, class ItemValueType>
+ItemType TypedListValue<ItemType, ItemValueType>::GetItem (size_t index) const
+{
+	return items[index];
+}
+
+template <class ItemType, class ItemValueType>
+const std::vector<ItemType>& TypedListValue<ItemType, ItemValueType>::GetItems () const
+{
+	return items;
+}
+
+template <class ItemType, class ItemValueType>
+Stream::Status TypedListValue<ItemType, ItemValueType>::ReadItems (InputStream& inputStream)
+{
+	size_t itemCount = 0;
+	inputStream.Read (itemCount);
+	items.clear ();
+	for (size_t i = 0; i < itemCount && inputStream.GetStatus () == Stream::Status::NoError; i++) {
+		ItemType item;
+		inputStream.Read (item);
+		items.push_back (item);
+	}
+	return inputStream.GetStatus ();
+}
+
+template <class ItemType, class ItemValueType>
+Stream::Status TypedListValue<ItemType, ItemValueType>::WriteItems (OutputStream& outputStream) const
+{
+	outputStream.Write (items.size ());
+	for (size_t i = 0; i < items.size (); i++) {
+		ItemType item = items[i];
+		outputStream.Write (item);
+	}
+	return outputStream.GetStatus ();
+}
+
+class BooleanListValue : public TypedListValue<bool, BooleanValue>
+{
+	DYNAMIC_SERIALIZABLE (BooleanListValue);
+	VALUE_TYPE (BooleanListValue);
+
+public:
+	BooleanListValue ();
+	BooleanListValue (const std::vector<bool>& items);
+	BooleanListValue (std::vector<bool>&& items);
+	virtual ~BooleanListValue ();
+
+	virtual ValuePtr		Clone () const override;
+
+	virtual Stream::Status	Read (InputStream& inputStream) override;
+	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+};
+
+class IntListValue : public TypedListValue<int, IntValue>
+{
+	DYNAMIC_SERIALIZABLE (IntListValue);
+	VALUE_TYPE (IntListValue);
+
+public:
+	IntListValue ();
+	IntListValue (const std::vector<int>& items);
+	IntListValue (std::vector<int>&& items);
+	virtual ~IntListValue ();
+
+	virtual ValuePtr		Clone () const override;
+
+	virtual Stream::Status	Read (InputStream& inputStream) override;
+	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+};
+
+class DoubleListValue : public TypedListValue<double, DoubleValue>
+{
+	DYNAMIC_SERIALIZABLE (DoubleListValue);
+	VALUE_TYPE (DoubleListValue);
+
+public:
+	DoubleListValue ();
+	DoubleListValue (const std::vector<double>& items);
+	DoubleListValue (std::vector<double>&& items);
+	virtual ~DoubleListValue ();
+
+	virtual ValuePtr		Clone () const override;
+
+	virtual Stream::Status	Read (InputStream& inputStream) override;
+	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+};
+
+using BooleanListValuePtr = std::shared_ptr<BooleanListValue>;
+using BooleanListValueConstPtr = std::shared_ptr<const BooleanListValue>;
+
+using IntListValuePtr = std::shared_ptr<IntListValue>;
+using IntListValueConstPtr = std::shared_ptr<const IntListValue>;
+
+using DoubleListValuePtr = std::shared_ptr<DoubleListValue>;
+using DoubleListValueConstPtr = std::shared_ptr<const DoubleListValue>;
+
+}
+
+#endif
@@ -1,13 +1,34 @@
 #include "NE_Value.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
 #include "NE_Debug.hpp"
+#include "NE_MemoryStream.hpp"
+
+#include <cstring>
 
 namespace NE
 {
 
+static const uint64_t HashOffsetBasis = 14695981039346656037ULL;
+static const uint64_t HashPrime = 1099511628211ULL;
+
+static uint64_t HashBytes (uint64_t hash, const char* bytes, size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char) bytes[i];
+		hash *= HashPrime;
+	}
+	return hash;
+}
+
 SERIALIZATION_INFO (Value, 1);
 SERIALIZATION_INFO (SingleValue, 1);
 DYNAMIC_SERIALIZATION_INFO (ListValue, 1, "{95418CFC-BAE7-4FB3-8ED5-E6EC3AB930AC}");
 
+const ValueTypeInfo Value::valueTypeInfo (nullptr);
+VALUE_TYPE_INFO (SingleValue, Value);
+VALUE_TYPE_INFO (ListValue, Value);
+
 Value::Value ()
 {
 
@@ -24,12 +45,170 @@ Stream::Status Value::Read (InputStream& inputStream)
 	return inputStream.GetStatus ();
 }
 
+size_t Value::GetMemorySize () const
+{
+	// the serialized size is a good enough estimation for unknown value types
+	MemoryOutputStream stream;
+	if (!WriteDynamicObject (stream, this)) {
+		return 0;
+	}
+	return stream.GetBuffer ().size ();
+}
+
+const ValueTypeInfo* Value::GetValueTypeInfo () const
+{
+	return &valueTypeInfo;
+}
+
+const IListValue* Value::GetListValueInterface () const
+{
+	return dynamic_cast<const IListValue*> (this);
+}
+
+const NumberValue* Value::GetNumberValueInterface () const
+{
+	return dynamic_cast<const NumberValue*> (this);
+}
+
 Stream::Status Value::Write (OutputStream& outputStream) const
 {
 	ObjectHeader header (outputStream, serializationInfo);
 	return outputStream.GetStatus ();
 }
 
+template <class ItemType>
+static bool AreItemsEqual (const std::vector<ItemType>& aItems, const std::vector<ItemType>& bItems)
+{
+	// the items are compared by their bytes the same way as the serialized values
+	return aItems.size () == bItems.size () && std::memcmp (aItems.data (), bItems.data (), aItems.size () * sizeof (ItemType)) == 0;
+}
+
+static bool AreItemsEqual (const std::vector<bool>& aItems, const std::vector<bool>& bItems)
+{
+	return aItems == bItems;
+}
+
+template <class ListType>
+static bool IsEqualTypedList (const Value* aValue, const Value* bValue, bool& isEqual)
+{
+	const ListType* aList = Value::Cast<ListType> (aValue);
+	const ListType* bList = Value::Cast<ListType> (bValue);
+	if (aList == nullptr || bList == nullptr) {
+		return false;
+	}
+	isEqual = AreItemsEqual (aList->GetItems (), bList->GetItems ());
+	return true;
+}
+
+static bool IsEqualValue (const Value* aValue, const Value* bValue)
+{
+	if (aValue == bValue) {
+		return true;
+	}
+	if (aValue == nullptr || bValue == nullptr) {
+		return false;
+	}
+
+	const IListValue* aList = Value::Cast<IListValue> (aValue);
+	const IListValue* bList = Value::Cast<IListValue> (bValue);
+	if (aList != nullptr && bList != nullptr) {
+		if (aList->GetSize () != bList->GetSize ()) {
+			return false;
+		}
+
+		// typed lists of the same type are compared without creating item values
+		bool isEqual = false;
+		if (IsEqualTypedList<DoubleListValue> (aValue, bValue, isEqual) ||
+			IsEqualTypedList<IntListValue> (aValue, bValue, isEqual) ||
+			IsEqualTypedList<BooleanListValue> (aValue, bValue, isEqual))
+		{
+			return isEqual;
+		}
+
+		// the items are compared by index, so the comparison stops at the first
+		// difference, and lazy lists hold only their bounded chunk cache
+		for (size_t i = 0; i < aList->GetSize (); i++) {
+			if (!IsEqualValue (aList->GetValue (i).get (), bList->GetValue (i).get ())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	MemoryOutputStream aStream;
+	MemoryOutputStream bStream;
+	if (!WriteDynamicObject (aStream, aValue) || !WriteDynamicObject (bStream, bValue)) {
+		return false;
+	}
+
+	return aStream.GetBuffer () == bStream.GetBuffer ();
+}
+
+static uint64_t GenerateValueHash (const Value* value)
+{
+	if (value == nullptr) {
+		return HashOffsetBasis;
+	}
+
+	// lists are hashed by their items the same way as they are compared
+	const IListValue* list = Value::Cast<IListValue> (value);
+	if (list != nullptr) {
+		size_t size = list->GetSize ();
+		uint64_t hash = HashBytes (HashOffsetBasis, (const char*) &size, sizeof (size));
+		list->EnumerateItems ([&] (const Value* item) {
+			uint64_t itemHash = GenerateValueHash (item);
+			hash = HashBytes (hash, (const char*) &itemHash, sizeof (itemHash));
+			return true;
+		});
+		return hash;
+	}
+
+	MemoryOutputStream stream;
+	if (!WriteDynamicObject (stream, value)) {
+		return HashOffsetBasis;
+	}
+	const std::vector<char>& buffer = stream.GetBuffer ();
+	return HashBytes (HashOffsetBasis, buffer.data (), buffer.size ());
+}
+
+bool Value::IsEqual (const ValueConstPtr& aValue, const ValueConstPtr& bValue)
+{
+	return IsEqualValue (aValue.get (), bValue.get ());
+}
+
+uint64_t Value::GenerateHashValue (const ValueConstPtr& value)
+{
+	return GenerateValueHash (value.get ());
+}
+
+bool Value::WriteContent (OutputStream& outputStream, const Value* value)
+{
+	// equal values write the same bytes, lists are written by their items,
+	// values without serialization can't be identified by their content
+	if (value == nullptr) {
+		return false;
+	}
+
+	const IListValue* list = Value::Cast<IListValue> (value);
+	if (list != nullptr) {
+		outputStream.Write (true);
+		outputStream.Write (list->GetSize ());
+		return list->EnumerateItems ([&] (const Value* item) {
+			return WriteContent (outputStream, item);
+		});
+	}
+
+	const DynamicSerializationInfo* serializationInfo = value->GetDynamicSerializationInfo ();
+	if (serializationInfo == nullptr) {
+		return false;
+	}
+	outputStream.Write (false);
+	if (serializationInfo->GetObjectId ().Write (outputStream) != Stream::Status::NoError) {
+		return false;
+	}
+	return value->Write (outputStream) == Stream::Status::NoError;
+}
+
 SingleValue::SingleValue ()
 {
 
@@ -40,6 +219,11 @@ SingleValue::~SingleValue ()
 
 }
 
+const IListValue* SingleValue::GetListValueInterface () const
+{
+	return nullptr;
+}
+
 Stream::Status SingleValue::Read (InputStream& inputStream)
 {
 	ObjectHeader header (inputStream);
@@ -64,13 +248,25 @@ IListValue::~IListValue ()
 
 }
 
+bool IListValue::HasUniformItemType () const
+{
+	return false;
+}
+
+bool IListValue::EnumerateItems (const std::function<bool (const Value*)>& processor) const
+{
+	return Enumerate ([&] (const ValueConstPtr& item) {
+		return processor (item.get ());
+	});
+}
+
 ListValue::ListValue ()
 {
 
 }
 
 ListValue::ListValue (const std::vector<ValueConstPtr>& values) :
-	values (values)
+	values (values.begin (), values.end ())
 {
 
 }
@@ -82,7 +278,8 @@ ListValue::~ListValue ()
 
 ValuePtr ListValue::Clone () const
 {
-	ListValuePtr result (new ListValue ());
+	ListValuePtr result = MakeValue<ListValue> ();
+	result->Reserve (values.size ());
 	for (const ValueConstPtr& value : values) {
 		result->Push (value->Clone ());
 	}
@@ -119,6 +316,27 @@ std::wstring ListValue::ToString (const StringConverter& stringConverter) const
 	return stringConverter.ListToString (enumerator);
 }
 
+const IListValue* ListValue::GetListValueInterface () const
+{
+	return this;
+}
+
+const NumberValue* ListValue::GetNumberValueInterface () const
+{
+	return nullptr;
+}
+
+size_t ListValue::GetMemorySize () const
+{
+	size_t memorySize = sizeof (ListValue) + values.capacity () * sizeof (ValueConstPtr);
+	for (const ValueConstPtr& value : values) {
+		if (value != nullptr) {
+			memorySize += value->GetMemorySize ();
+		}
+	}
+	return memorySize;
+}
+
 Stream::Status ListValue::Read (InputStream& inputStream)
 {
 	ObjectHeader header (inputStream);
@@ -150,7 +368,7 @@ size_t ListValue::GetSize () const
 	return values.size ();
 }
 
-const ValueConstPtr& ListValue::GetValue (size_t index) const
+ValueConstPtr ListValue::GetValue (size_t index) const
 {
 	return values[index];
 }
@@ -165,6 +383,11 @@ bool ListValue::Enumerate (const std::function<bool (const ValueConstPtr&)>& pro
 	return true;
 }
 
+void ListValue::Reserve (size_t size)
+{
+	values.reserve (size);
+}
+
 void ListValue::Push (const ValueConstPtr& value)
 {
 	values.push_back (value);
@@ -181,7 +404,7 @@ size_t ValueToListValueAdapter::GetSize () const
 	return 1;
 }
 
-const ValueConstPtr& ValueToListValueAdapter::GetValue (size_t) const
+ValueConstPtr ValueToListValueAdapter::GetValue (size_t) const
 {
 	return val;
 }
@@ -198,15 +421,17 @@ bool IsSingleValue (const ValueConstPtr& value)
 
 bool IsListValue (const ValueConstPtr& value)
 {
-	return Value::IsType<ListValue> (value);
+	return Value::IsType<IListValue> (value);
 }
 
 ValueConstPtr CreateSingleValue (const ValueConstPtr& value)
 {
 	if (Value::IsType<SingleValue> (value)) {
 		return value;
-	} else if (Value::IsType<ListValue> (value)) {
-		ListValueConstPtr listVal = Value::Cast<ListValue> (value);
+	}
+
+	const IListValue* listVal = Value::Cast<IListValue> (value.get ());
+	if (listVal != nullptr) {
 		if (listVal->GetSize () != 1) {
 			return nullptr;
 		}
@@ -222,8 +447,8 @@ IListValueConstPtr CreateListValue (const ValueConstPtr& value)
 {
 	if (Value::IsType<SingleValue> (value)) {
 		return std::make_shared<ValueToListValueAdapter> (value);
-	} else if (Value::IsType<ListValue> (value)) {
-		return std::dynamic_pointer_cast<const IListValue> (value);
+	} else if (Value::IsType<IListValue> (value)) {
+		return Value::Cast<IListValue> (value);
 	}
 
 	DBGBREAK ();
@@ -248,9 +473,20 @@ bool FlatEnumerate (const ValueConstPtr& value, const std::function<bool (const
 	});
 }
 
+bool FlatEnumerateItems (const Value* value, const std::function<bool (const Value*)>& processor)
+{
+	const IListValue* listValue = Value::Cast<IListValue> (value);
+	if (listValue == nullptr) {
+		return processor (value);
+	}
+	return listValue->EnumerateItems ([&] (const Value* innerValue) {
+		return FlatEnumerateItems (innerValue, processor);
+	});
+}
+
 ValueConstPtr FlattenValue (const ValueConstPtr& value)
 {
-	ListValuePtr listValue (new ListValue ());
+	ListValuePtr listValue = MakeValue<ListValue> ();
 	FlatEnumerate (value, [&] (const ValueConstPtr& value) {
 		listValue->Push (value);
 		return true;
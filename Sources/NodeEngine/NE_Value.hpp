@@ -3,11 +3,14 @@
 
 #include "NE_Serializable.hpp"
 #include "NE_StringConverter.hpp"
+#include "NE_ValueAllocator.hpp"
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <string>
 #include <functional>
+#include <type_traits>
 
 namespace NE
 {
@@ -28,24 +31,80 @@ class IListValue;
 using IListValuePtr = std::shared_ptr<IListValue>;
 using IListValueConstPtr = std::shared_ptr<const IListValue>;
 
+class NumberValue;
+
+class ValueTypeInfo
+{
+public:
+	constexpr ValueTypeInfo (const ValueTypeInfo* parentInfo) :
+		parentInfo (parentInfo)
+	{
+
+	}
+
+	bool IsDerivedFrom (const ValueTypeInfo* baseInfo) const
+	{
+		for (const ValueTypeInfo* info = this; info != nullptr; info = info->parentInfo) {
+			if (info == baseInfo) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	const ValueTypeInfo* parentInfo;
+};
+
+#define VALUE_TYPE(ClassName)																\
+public:																						\
+using ValueTypeClass = ClassName;															\
+static const NE::ValueTypeInfo valueTypeInfo;												\
+virtual const NE::ValueTypeInfo* GetValueTypeInfo () const override							\
+{																							\
+	return &valueTypeInfo;																	\
+}																							\
+private:																					\
+
+#define VALUE_TYPE_INFO(ClassName,ParentClassName) \
+const NE::ValueTypeInfo ClassName::valueTypeInfo (&ParentClassName::valueTypeInfo)
+
 class Value : public DynamicSerializable
 {
 	SERIALIZABLE;
 
 public:
+	using ValueTypeClass = Value;
+	static const ValueTypeInfo valueTypeInfo;
+
 	Value ();
 	Value (const Value& src) = delete;
 	virtual ~Value ();
 
-	virtual ValuePtr		Clone () const = 0;
-	virtual std::wstring	ToString (const StringConverter& stringConverter) const = 0;
+	virtual ValuePtr				Clone () const = 0;
+	virtual std::wstring			ToString (const StringConverter& stringConverter) const = 0;
+	virtual size_t					GetMemorySize () const;
+
+	virtual const ValueTypeInfo*	GetValueTypeInfo () const;
+	virtual const IListValue*		GetListValueInterface () const;
+	virtual const NumberValue*		GetNumberValueInterface () const;
 
 	virtual Stream::Status	Read (InputStream& inputStream) override;
 	virtual Stream::Status	Write (OutputStream& outputStream) const override;
 
+	// equal values have equal hashes, so memoization keys compare the hashes
+	// before IsEqual, early cutoff calls IsEqual directly, because it stops at
+	// the first difference while the hash reads the whole value
+	static bool				IsEqual (const ValueConstPtr& aValue, const ValueConstPtr& bValue);
+	static uint64_t			GenerateHashValue (const ValueConstPtr& value);
+	static bool				WriteContent (OutputStream& outputStream, const Value* value);
+
 	template <class Type>
 	static bool IsType (Value* val);
 
+	template <class Type>
+	static bool IsType (const Value* val);
+
 	template <class Type>
 	static bool IsType (const ValuePtr& val);
 
@@ -65,58 +124,126 @@ public:
 	static std::shared_ptr<const Type> Cast (const ValueConstPtr& val);
 };
 
+// types registered with VALUE_TYPE are checked with their type info,
+// every other type falls back to dynamic_cast
+template <class Type, class Enable = void>
+class ValueTypeCaster
+{
+public:
+	static const Type* Cast (const Value* val)
+	{
+		return dynamic_cast<const Type*> (val);
+	}
+};
+
+template <class Type>
+class ValueTypeCaster<Type, typename std::enable_if<std::is_same<typename Type::ValueTypeClass, Type>::value>::type>
+{
+public:
+	static const Type* Cast (const Value* val)
+	{
+		if (val == nullptr || !val->GetValueTypeInfo ()->IsDerivedFrom (&Type::valueTypeInfo)) {
+			return nullptr;
+		}
+		return static_cast<const Type*> (val);
+	}
+};
+
+template <>
+class ValueTypeCaster<IListValue>
+{
+public:
+	static const IListValue* Cast (const Value* val)
+	{
+		if (val == nullptr) {
+			return nullptr;
+		}
+		return val->GetListValueInterface ();
+	}
+};
+
+template <>
+class ValueTypeCaster<NumberValue>
+{
+public:
+	static const NumberValue* Cast (const Value* val)
+	{
+		if (val == nullptr) {
+			return nullptr;
+		}
+		return val->GetNumberValueInterface ();
+	}
+};
+
 template <class Type>
 bool Value::IsType (Value* val)
 {
-	return dynamic_cast<Type*> (val) != nullptr;
+	return ValueTypeCaster<Type>::Cast (val) != nullptr;
+}
+
+template <class Type>
+bool Value::IsType (const Value* val)
+{
+	return ValueTypeCaster<Type>::Cast (val) != nullptr;
 }
 
 template <class Type>
 bool Value::IsType (const ValuePtr& val)
 {
-	return dynamic_cast<Type*> (val.get ()) != nullptr;
+	return ValueTypeCaster<Type>::Cast (val.get ()) != nullptr;
 }
 
 template <class Type>
 bool Value::IsType (const ValueConstPtr& val)
 {
-	return dynamic_cast<const Type*> (val.get ()) != nullptr;
+	return ValueTypeCaster<Type>::Cast (val.get ()) != nullptr;
 }
 
 template <class Type>
 Type* Value::Cast (Value* val)
 {
-	return dynamic_cast<Type*> (val);
+	return const_cast<Type*> (ValueTypeCaster<Type>::Cast (val));
 }
 
 template <class Type>
 const Type* Value::Cast (const Value* val)
 {
-	return dynamic_cast<const Type*> (val);
+	return ValueTypeCaster<Type>::Cast (val);
 }
 
 template <class Type>
 std::shared_ptr<Type> Value::Cast (const ValuePtr& val)
 {
-	return std::dynamic_pointer_cast<Type> (val);
+	Type* typedVal = const_cast<Type*> (ValueTypeCaster<Type>::Cast (val.get ()));
+	if (typedVal == nullptr) {
+		return nullptr;
+	}
+	return std::shared_ptr<Type> (val, typedVal);
 }
 
 template <class Type>
 std::shared_ptr<const Type> Value::Cast (const ValueConstPtr& val)
 {
-	return std::dynamic_pointer_cast<const Type> (val);
+	const Type* typedVal = ValueTypeCaster<Type>::Cast (val.get ());
+	if (typedVal == nullptr) {
+		return nullptr;
+	}
+	return std::shared_ptr<const Type> (val, typedVal);
 }
 
 class SingleValue : public Value
 {
 	SERIALIZABLE;
+	VALUE_TYPE (SingleValue);
 
 public:
 	SingleValue ();
 	virtual ~SingleValue ();
 
-	virtual Stream::Status	Read (InputStream& inputStream) override;
-	virtual Stream::Status	Write (OutputStream& outputStream) const override;
+	virtual const IListValue*	GetListValueInterface () const override;
+
+	virtual Stream::Status		Read (InputStream& inputStream) override;
+	virtual Stream::Status		Write (OutputStream& outputStream) const override;
 };
 
 class IListValue
@@ -126,14 +253,21 @@ public:
 	virtual ~IListValue ();
 
 	virtual size_t					GetSize () const = 0;
-	virtual const ValueConstPtr&	GetValue (size_t index) const = 0;
+	// returned by value, because typed and lazy lists create their items on access
+	virtual ValueConstPtr			GetValue (size_t index) const = 0;
 	virtual bool					Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const = 0;
+	virtual bool					HasUniformItemType () const;
+
+	// the items may be temporary objects that are valid only while the processor
+	// runs, so typed and lazy lists can enumerate them without allocating them
+	virtual bool					EnumerateItems (const std::function<bool (const Value*)>& processor) const;
 };
 
 class ListValue :	public Value,
 					public IListValue
 {
 	DYNAMIC_SERIALIZABLE (ListValue);
+	VALUE_TYPE (ListValue);
 
 public:
 	ListValue ();
@@ -142,17 +276,21 @@ public:
 
 	virtual ValuePtr				Clone () const override;
 	virtual std::wstring			ToString (const StringConverter& stringConverter) const override;
+	virtual size_t					GetMemorySize () const override;
+	virtual const IListValue*		GetListValueInterface () const override;
+	virtual const NumberValue*		GetNumberValueInterface () const override;
 	virtual Stream::Status			Read (InputStream& inputStream) override;
 	virtual Stream::Status			Write (OutputStream& outputStream) const override;
 
 	virtual size_t					GetSize () const override;
-	virtual const ValueConstPtr&	GetValue (size_t index) const override;
+	virtual ValueConstPtr			GetValue (size_t index) const override;
 	virtual bool					Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const override;
 
+	void							Reserve (size_t size);
 	void							Push (const ValueConstPtr& value);
 	
 private:
-	std::vector<ValueConstPtr>	values;
+	std::vector<ValueConstPtr, ValueAllocator<ValueConstPtr>>	values;
 };
 
 class ValueToListValueAdapter : public IListValue
@@ -161,7 +299,7 @@ public:
 	ValueToListValueAdapter (const ValueConstPtr& val);
 
 	virtual size_t					GetSize () const override;
-	virtual const ValueConstPtr&	GetValue (size_t index) const override;
+	virtual ValueConstPtr			GetValue (size_t index) const override;
 	virtual bool					Enumerate (const std::function<bool (const ValueConstPtr&)>& processor) const override;
 
 private:
@@ -169,43 +307,60 @@ private:
 };
 
 template <class Type>
-bool IsSingleType (const ValueConstPtr& val)
+bool IsSingleType (const Value* val)
 {
 	if (Value::IsType<Type> (val)) {
 		return true;
 	}
-	if (Value::IsType<ListValue> (val)) {
-		const ListValue* listVal = Value::Cast<ListValue> (val.get ());
-		if (listVal->GetSize () == 1 && Value::IsType<Type> (listVal->GetValue (0))) {
-			return true;
-		}
+	const IListValue* listVal = Value::Cast<IListValue> (val);
+	if (listVal != nullptr && listVal->GetSize () == 1) {
+		bool isType = false;
+		listVal->EnumerateItems ([&] (const Value* innerVal) {
+			isType = Value::IsType<Type> (innerVal);
+			return false;
+		});
+		return isType;
 	}
 	return false;
 }
 
 template <class Type>
-bool IsComplexType (const ValueConstPtr& val)
+bool IsSingleType (const ValueConstPtr& val)
+{
+	return IsSingleType<Type> (val.get ());
+}
+
+template <class Type>
+bool IsComplexType (const Value* val)
 {
 	if (Value::IsType<Type> (val)) {
 		return true;
 	}
-	if (Value::IsType<ListValue> (val)) {
-		ListValueConstPtr listVal = Value::Cast<ListValue> (val);
+	const IListValue* listVal = Value::Cast<IListValue> (val);
+	if (listVal != nullptr) {
 		if (listVal->GetSize () == 0) {
 			return false;
 		}
+		// for uniform lists it is enough to check the first item
+		bool isUniform = listVal->HasUniformItemType ();
 		bool isType = true;
-		listVal->Enumerate ([&] (const ValueConstPtr& innerVal) {
+		listVal->EnumerateItems ([&] (const Value* innerVal) {
 			if (!IsComplexType<Type> (innerVal)) {
 				isType = false;
 			}
-			return isType;
+			return isType && !isUniform;
 		});
 		return isType;
 	}
 	return false;
 }
 
+template <class Type>
+bool IsComplexType (const ValueConstPtr& val)
+{
+	return IsComplexType<Type> (val.get ());
+}
+
 bool				IsSingleValue (const ValueConstPtr& value);
 bool				IsListValue (const ValueConstPtr& value);
 
@@ -213,6 +368,7 @@ ValueConstPtr		CreateSingleValue (const ValueConstPtr& value);
 IListValueConstPtr	CreateListValue (const ValueConstPtr& value);
 
 bool				FlatEnumerate (const ValueConstPtr& value, const std::function<bool (const ValueConstPtr&)>& processor);
+bool				FlatEnumerateItems (const Value* value, const std::function<bool (const Value*)>& processor);
 ValueConstPtr		FlattenValue (const ValueConstPtr& value);
 
 }
@@ -0,0 +1,406 @@
+#include "NE_ValueAllocator.hpp"
+#include "NE_Debug.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <cstddef>
+
+namespace NE
+{
+
+static const size_t BlockAlignment = 16;
+static const size_t MaxPooledBlockSize = 256;
+static const size_t SizeClassCount = MaxPooledBlockSize / BlockAlignment;
+static const size_t SlabSize = 64 * 1024;
+static const size_t MaxSlabCount = 32;
+static const size_t TransferBlockCount = 64;
+static const size_t MaxCachedBlockCount = 4 * TransferBlockCount;
+
+static void IncreaseCounter (std::atomic<size_t>& counter)
+{
+	// counters are written only by their owner thread, so no atomic increment is needed
+	counter.store (counter.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static size_t GetBlockSize (size_t sizeClass)
+{
+	return (sizeClass + 1) * BlockAlignment;
+}
+
+class FreeBlockList
+{
+public:
+	FreeBlockList () :
+		first (nullptr),
+		count (0)
+	{
+
+	}
+
+	bool IsEmpty () const
+	{
+		return first == nullptr;
+	}
+
+	size_t GetCount () const
+	{
+		return count;
+	}
+
+	void Push (void* memory)
+	{
+		FreeBlock* block = static_cast<FreeBlock*> (memory);
+		block->next = first;
+		first = block;
+		count++;
+	}
+
+	void* Pop ()
+	{
+		DBGASSERT (first != nullptr);
+		FreeBlock* block = first;
+		first = block->next;
+		count--;
+		return block;
+	}
+
+	void MoveTo (FreeBlockList& target, size_t maxCount)
+	{
+		for (size_t i = 0; i < maxCount && !IsEmpty (); i++) {
+			target.Push (Pop ());
+		}
+	}
+
+private:
+	class FreeBlock
+	{
+	public:
+		FreeBlock* next;
+	};
+
+	FreeBlock*	first;
+	size_t		count;
+};
+
+class ThreadValueCache;
+
+class SharedValuePool
+{
+public:
+	SharedValuePool () :
+		mutex (),
+		freeLists (),
+		slabs (),
+		slabCounts (),
+		caches (),
+		retiredStatistics ()
+	{
+		for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+			slabCounts[sizeClass].store (0);
+		}
+	}
+
+	bool IsSlabBlock (size_t sizeClass, const void* memory) const
+	{
+		// the slabs of a size class are only added, so they can be read without the lock
+		const char* block = static_cast<const char*> (memory);
+		size_t slabCount = slabCounts[sizeClass].load (std::memory_order_acquire);
+		for (size_t i = 0; i < slabCount; i++) {
+			const char* slab = slabs[sizeClass][i];
+			if (block >= slab && block < slab + SlabSize + BlockAlignment) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void RegisterCache (ThreadValueCache* cache)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		caches.push_back (cache);
+	}
+
+	void UnregisterCache (ThreadValueCache* cache, const ValueAllocationStatistics& statistics)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		caches.erase (std::find (caches.begin (), caches.end (), cache));
+		retiredStatistics.allocationCount += statistics.allocationCount;
+		retiredStatistics.systemAllocationCount += statistics.systemAllocationCount;
+	}
+
+	bool Refill (size_t sizeClass, FreeBlockList& target)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (freeLists[sizeClass].IsEmpty () && !AllocateSlab (sizeClass)) {
+			return false;
+		}
+		freeLists[sizeClass].MoveTo (target, TransferBlockCount);
+		return true;
+	}
+
+	void Release (size_t sizeClass, FreeBlockList& source, size_t count)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		source.MoveTo (freeLists[sizeClass], count);
+	}
+
+	void* AllocateBlock (size_t sizeClass)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (freeLists[sizeClass].IsEmpty () && !AllocateSlab (sizeClass)) {
+			return nullptr;
+		}
+		retiredStatistics.allocationCount++;
+		return freeLists[sizeClass].Pop ();
+	}
+
+	void DeallocateBlock (size_t sizeClass, void* memory)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		freeLists[sizeClass].Push (memory);
+	}
+
+	void CountSystemAllocation ()
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		retiredStatistics.allocationCount++;
+		retiredStatistics.systemAllocationCount++;
+	}
+
+	ValueAllocationStatistics GetStatistics () const;
+
+private:
+	bool AllocateSlab (size_t sizeClass)
+	{
+		// slabs are kept for reuse, so their count is limited, the blocks
+		// over the limit are allocated from the system and given back to it
+		size_t slabCount = slabCounts[sizeClass].load (std::memory_order_relaxed);
+		if (slabCount >= MaxSlabCount) {
+			return false;
+		}
+		size_t blockSize = GetBlockSize (sizeClass);
+		char* slab = static_cast<char*> (::operator new (SlabSize + BlockAlignment));
+		slabs[sizeClass][slabCount] = slab;
+		slabCounts[sizeClass].store (slabCount + 1, std::memory_order_release);
+		retiredStatistics.systemAllocationCount++;
+
+		uintptr_t alignedAddress = (reinterpret_cast<uintptr_t> (slab) + BlockAlignment - 1) & ~(uintptr_t) (BlockAlignment - 1);
+		char* blockStart = reinterpret_cast<char*> (alignedAddress);
+		for (size_t offset = 0; offset + blockSize <= SlabSize; offset += blockSize) {
+			freeLists[sizeClass].Push (blockStart + offset);
+		}
+		return true;
+	}
+
+	mutable std::mutex					mutex;
+	FreeBlockList						freeLists[SizeClassCount];
+	char*								slabs[SizeClassCount][MaxSlabCount];
+	std::atomic<size_t>					slabCounts[SizeClassCount];
+	std::vector<ThreadValueCache*>		caches;
+	ValueAllocationStatistics			retiredStatistics;
+};
+
+static SharedValuePool& GetSharedValuePool ()
+{
+	// the pool is never destroyed, because values may be released after static destruction started
+	static SharedValuePool* sharedPool = new SharedValuePool ();
+	return *sharedPool;
+}
+
+static thread_local bool isThreadCacheDestroyed = false;
+
+class ThreadValueCache
+{
+public:
+	ThreadValueCache () :
+		freeLists (),
+		allocationCount (0),
+		systemAllocationCount (0)
+	{
+		GetSharedValuePool ().RegisterCache (this);
+	}
+
+	~ThreadValueCache ()
+	{
+		SharedValuePool& sharedPool = GetSharedValuePool ();
+		for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+			sharedPool.Release (sizeClass, freeLists[sizeClass], freeLists[sizeClass].GetCount ());
+		}
+		sharedPool.UnregisterCache (this, GetStatistics ());
+		isThreadCacheDestroyed = true;
+	}
+
+	void* Allocate (size_t sizeClass)
+	{
+		FreeBlockList& freeList = freeLists[sizeClass];
+		if (freeList.IsEmpty () && !GetSharedValuePool ().Refill (sizeClass, freeList)) {
+			return nullptr;
+		}
+		IncreaseCounter (allocationCount);
+		return freeList.Pop ();
+	}
+
+	void Deallocate (size_t sizeClass, void* memory)
+	{
+		FreeBlockList& freeList = freeLists[sizeClass];
+		freeList.Push (memory);
+		if (freeList.GetCount () > MaxCachedBlockCount) {
+			GetSharedValuePool ().Release (sizeClass, freeList, TransferBlockCount);
+		}
+	}
+
+	void CountSystemAllocation ()
+	{
+		IncreaseCounter (allocationCount);
+		IncreaseCounter (systemAllocationCount);
+	}
+
+	ValueAllocationStatistics GetStatistics () const
+	{
+		ValueAllocationStatistics statistics;
+		statistics.allocationCount = allocationCount.load (std::memory_order_relaxed);
+		statistics.systemAllocationCount = systemAllocationCount.load (std::memory_order_relaxed);
+		return statistics;
+	}
+
+private:
+	FreeBlockList			freeLists[SizeClassCount];
+	std::atomic<size_t>		allocationCount;
+	std::atomic<size_t>		systemAllocationCount;
+};
+
+ValueAllocationStatistics SharedValuePool::GetStatistics () const
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	ValueAllocationStatistics statistics = retiredStatistics;
+	for (const ThreadValueCache* cache : caches) {
+		ValueAllocationStatistics cacheStatistics = cache->GetStatistics ();
+		statistics.allocationCount += cacheStatistics.allocationCount;
+		statistics.systemAllocationCount += cacheStatistics.systemAllocationCount;
+	}
+	return statistics;
+}
+
+static ThreadValueCache* GetThreadValueCache ()
+{
+	if (isThreadCacheDestroyed) {
+		return nullptr;
+	}
+	static thread_local ThreadValueCache threadCache;
+	return &threadCache;
+}
+
+static void* AllocateSystemMemory (size_t size, size_t alignment)
+{
+	if (alignment <= alignof (std::max_align_t)) {
+		return ::operator new (size);
+	}
+	// over-aligned memory keeps the original address right before the aligned block
+	char* memory = static_cast<char*> (::operator new (size + alignment + sizeof (void*)));
+	uintptr_t alignedAddress = (reinterpret_cast<uintptr_t> (memory + sizeof (void*)) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+	void** alignedMemory = reinterpret_cast<void**> (alignedAddress);
+	alignedMemory[-1] = memory;
+	return alignedMemory;
+}
+
+static void DeallocateSystemMemory (void* memory, size_t alignment)
+{
+	if (alignment <= alignof (std::max_align_t)) {
+		::operator delete (memory);
+		return;
+	}
+	::operator delete (static_cast<void**> (memory)[-1]);
+}
+
+static bool IsPooledAllocation (size_t size, size_t alignment)
+{
+	return size <= MaxPooledBlockSize && alignment <= BlockAlignment;
+}
+
+static size_t GetSizeClass (size_t size)
+{
+	return size == 0 ? 0 : (size - 1) / BlockAlignment;
+}
+
+ValueAllocationStatistics::ValueAllocationStatistics () :
+	allocationCount (0),
+	systemAllocationCount (0)
+{
+
+}
+
+size_t ValueAllocationStatistics::GetAvoidedAllocationCount () const
+{
+	if (systemAllocationCount > allocationCount) {
+		return 0;
+	}
+	return allocationCount - systemAllocationCount;
+}
+
+ValueAllocationStatistics GetValueAllocationStatistics ()
+{
+	return GetSharedValuePool ().GetStatistics ();
+}
+
+void* AllocateValueMemory (size_t size, size_t alignment)
+{
+	ThreadValueCache* threadCache = GetThreadValueCache ();
+	if (!IsPooledAllocation (size, alignment)) {
+		if (threadCache != nullptr) {
+			threadCache->CountSystemAllocation ();
+		} else {
+			GetSharedValuePool ().CountSystemAllocation ();
+		}
+		return AllocateSystemMemory (size, alignment);
+	}
+
+	size_t sizeClass = GetSizeClass (size);
+	void* memory = nullptr;
+	if (threadCache == nullptr) {
+		memory = GetSharedValuePool ().AllocateBlock (sizeClass);
+	} else {
+		memory = threadCache->Allocate (sizeClass);
+	}
+	if (memory != nullptr) {
+		return memory;
+	}
+
+	// all slabs of the size class are in use
+	if (threadCache != nullptr) {
+		threadCache->CountSystemAllocation ();
+	} else {
+		GetSharedValuePool ().CountSystemAllocation ();
+	}
+	return AllocateSystemMemory (GetBlockSize (sizeClass), BlockAlignment);
+}
+
+void DeallocateValueMemory (void* memory, size_t size, size_t alignment)
+{
+	if (memory == nullptr) {
+		return;
+	}
+
+	if (!IsPooledAllocation (size, alignment)) {
+		DeallocateSystemMemory (memory, alignment);
+		return;
+	}
+
+	size_t sizeClass = GetSizeClass (size);
+	if (!GetSharedValuePool ().IsSlabBlock (sizeClass, memory)) {
+		DeallocateSystemMemory (memory, BlockAlignment);
+		return;
+	}
+
+	ThreadValueCache* threadCache = GetThreadValueCache ();
+	if (threadCache == nullptr) {
+		GetSharedValuePool ().DeallocateBlock (sizeClass, memory);
+		return;
+	}
+	threadCache->Deallocate (sizeClass, memory);
+}
+
+}
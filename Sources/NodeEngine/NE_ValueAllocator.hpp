@@ -0,0 +1,75 @@
+#ifndef NE_VALUEALLOCATOR_HPP
+#define NE_VALUEALLOCATOR_HPP
+
+#include <memory>
+#include <cstddef>
+
+namespace NE
+{
+
+class ValueAllocationStatistics
+{
+public:
+	ValueAllocationStatistics ();
+
+	size_t	GetAvoidedAllocationCount () const;
+
+	size_t	allocationCount;
+	size_t	systemAllocationCount;
+};
+
+ValueAllocationStatistics	GetValueAllocationStatistics ();
+
+void*						AllocateValueMemory (size_t size, size_t alignment);
+void						DeallocateValueMemory (void* memory, size_t size, size_t alignment);
+
+template <class Type>
+class ValueAllocator
+{
+public:
+	using value_type = Type;
+
+	ValueAllocator ()
+	{
+
+	}
+
+	template <class OtherType>
+	ValueAllocator (const ValueAllocator<OtherType>&)
+	{
+
+	}
+
+	Type* allocate (size_t count)
+	{
+		return static_cast<Type*> (AllocateValueMemory (count * sizeof (Type), alignof (Type)));
+	}
+
+	void deallocate (Type* memory, size_t count)
+	{
+		DeallocateValueMemory (memory, count * sizeof (Type), alignof (Type));
+	}
+
+	template <class OtherType>
+	bool operator== (const ValueAllocator<OtherType>&) const
+	{
+		return true;
+	}
+
+	template <class OtherType>
+	bool operator!= (const ValueAllocator<OtherType>&) const
+	{
+		return false;
+	}
+};
+
+// the object and its reference counter are placed in one pooled block
+template <class ValueType, class... Args>
+std::shared_ptr<ValueType> MakeValue (Args&&... args)
+{
+	return std::allocate_shared<ValueType> (ValueAllocator<ValueType> (), std::forward<Args> (args)...);
+}
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "NE_Debug.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace NE
 {
@@ -36,11 +37,16 @@ static bool EnumerateShortestCombinations (	const std::vector<IListValueConstPtr
 			return values.size ();
 		}
 
-		virtual const ValueConstPtr& GetValue (size_t valueIndex) const override
+		virtual ValueConstPtr GetValue (size_t valueIndex) const override
 		{
 			return values[valueIndex]->GetValue (combinationIndex);
 		}
 
+		virtual size_t GetValueIndex (size_t) const override
+		{
+			return combinationIndex;
+		}
+
 	private:
 		size_t									combinationIndex;
 		const std::vector<IListValueConstPtr>&	values;
@@ -80,14 +86,14 @@ static bool EnumerateLongestCombinations (	const std::vector<IListValueConstPtr>
 			return values.size ();
 		}
 
-		virtual const ValueConstPtr& GetValue (size_t valueIndex) const override
+		virtual ValueConstPtr GetValue (size_t valueIndex) const override
 		{
-			const IListValueConstPtr& value = values[valueIndex];
-			if (combinationIndex < value->GetSize ()) {
-				return value->GetValue (combinationIndex);
-			} else {
-				return value->GetValue (value->GetSize () - 1);
-			}
+			return values[valueIndex]->GetValue (GetValueIndex (valueIndex));
+		}
+
+		virtual size_t GetValueIndex (size_t valueIndex) const override
+		{
+			return std::min (combinationIndex, values[valueIndex]->GetSize () - 1);
 		}
 
 	private:
@@ -129,11 +135,16 @@ static bool EnumerateCrossProductCombinations (	const std::vector<IListValueCons
 			return values.size ();
 		}
 
-		virtual const ValueConstPtr& GetValue (size_t valueIndex) const override
+		virtual ValueConstPtr GetValue (size_t valueIndex) const override
 		{
 			return values[valueIndex]->GetValue (indices[valueIndex]);
 		}
 
+		virtual size_t GetValueIndex (size_t valueIndex) const override
+		{
+			return indices[valueIndex];
+		}
+
 	private:
 		const std::vector<IListValueConstPtr>&	values;
 		const std::vector<size_t>&				indices;
@@ -181,4 +192,54 @@ bool CombineValues (ValueCombinationMode combinationMode, const std::vector<Valu
 	return false;
 }
 
+bool GetCombinationCount (ValueCombinationMode combinationMode, const std::vector<size_t>& sizes, size_t& count)
+{
+	count = 0;
+	if (sizes.empty ()) {
+		return true;
+	}
+
+	if (combinationMode == ValueCombinationMode::Shortest) {
+		count = *std::min_element (sizes.begin (), sizes.end ());
+		return true;
+	} else if (combinationMode == ValueCombinationMode::Longest) {
+		count = *std::max_element (sizes.begin (), sizes.end ());
+		return true;
+	} else if (combinationMode == ValueCombinationMode::CrossProduct) {
+		size_t product = 1;
+		for (size_t size : sizes) {
+			if (size != 0 && product > std::numeric_limits<size_t>::max () / size) {
+				return false;
+			}
+			product *= size;
+		}
+		count = product;
+		return true;
+	}
+
+	DBGBREAK ();
+	return false;
+}
+
+void GetCombinationIndices (ValueCombinationMode combinationMode, const std::vector<size_t>& sizes, size_t combinationIndex, std::vector<size_t>& indices)
+{
+	indices.resize (sizes.size ());
+	if (combinationMode == ValueCombinationMode::Shortest) {
+		std::fill (indices.begin (), indices.end (), combinationIndex);
+	} else if (combinationMode == ValueCombinationMode::Longest) {
+		for (size_t i = 0; i < sizes.size (); i++) {
+			indices[i] = std::min (combinationIndex, sizes[i] - 1);
+		}
+	} else if (combinationMode == ValueCombinationMode::CrossProduct) {
+		// the last value changes the fastest, the same way as in the enumeration
+		size_t remainingIndex = combinationIndex;
+		for (size_t i = sizes.size (); i > 0; i--) {
+			indices[i - 1] = remainingIndex % sizes[i - 1];
+			remainingIndex /= sizes[i - 1];
+		}
+	} else {
+		DBGBREAK ();
+	}
+}
+
 }
@@ -23,11 +23,17 @@ public:
 	virtual ~ValueCombination ();
 
 	virtual size_t					GetSize () const = 0;
-	virtual const ValueConstPtr&	GetValue (size_t index) const = 0;
+	// returned by value, because the items of typed and lazy lists are created on access
+	virtual ValueConstPtr			GetValue (size_t index) const = 0;
+	virtual size_t					GetValueIndex (size_t index) const = 0;
 };
 
-bool CombineValues (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values,
-					const std::function<bool (const ValueCombination&)>& processor);
+bool	CombineValues (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values,
+					   const std::function<bool (const ValueCombination&)>& processor);
+
+// fails if the count of the cross product doesn't fit in size_t
+bool	GetCombinationCount (ValueCombinationMode combinationMode, const std::vector<size_t>& sizes, size_t& count);
+void	GetCombinationIndices (ValueCombinationMode combinationMode, const std::vector<size_t>& sizes, size_t combinationIndex, std::vector<size_t>& indices);
 
 }
 
@@ -0,0 +1,138 @@
+#include "NE_WorkerThreadPool.hpp"
+#include "NE_Debug.hpp"
+
+namespace NE
+{
+
+WorkerThreadPool::WorkerThreadPool (size_t threadCount) :
+	workers (),
+	jobMutex (),
+	jobStarted (),
+	jobFinished (),
+	jobProcessor (nullptr),
+	jobTaskCount (0),
+	jobGeneration (0),
+	busyWorkerCount (0),
+	isStopping (false),
+	nextTaskIndex (0)
+{
+	// the calling thread takes part in the work, so one less worker is needed
+	for (size_t i = 1; i < threadCount; ++i) {
+		workers.push_back (std::thread (&WorkerThreadPool::WorkerMain, this));
+	}
+}
+
+WorkerThreadPool::~WorkerThreadPool ()
+{
+	{
+		std::lock_guard<std::mutex> lock (jobMutex);
+		isStopping = true;
+	}
+	jobStarted.notify_all ();
+	for (std::thread& worker : workers) {
+		worker.join ();
+	}
+}
+
+size_t WorkerThreadPool::GetThreadCount () const
+{
+	return workers.size () + 1;
+}
+
+void WorkerThreadPool::ParallelFor (size_t taskCount, const std::function<void (size_t)>& processor)
+{
+	if (taskCount == 0) {
+		return;
+	}
+
+	bool isPoolAvailable = !workers.empty () && taskCount > 1;
+	if (isPoolAvailable) {
+		std::lock_guard<std::mutex> lock (jobMutex);
+		isPoolAvailable = (jobProcessor == nullptr);
+		if (isPoolAvailable) {
+			DBGASSERT (busyWorkerCount == 0);
+			jobProcessor = &processor;
+			jobTaskCount = taskCount;
+			nextTaskIndex = 0;
+			busyWorkerCount = workers.size ();
+			jobGeneration++;
+		}
+	}
+
+	if (!isPoolAvailable) {
+		for (size_t i = 0; i < taskCount; ++i) {
+			processor (i);
+		}
+		return;
+	}
+
+	jobStarted.notify_all ();
+
+	ProcessTasks ();
+
+	{
+		std::unique_lock<std::mutex> lock (jobMutex);
+		jobFinished.wait (lock, [&] () {
+			return busyWorkerCount == 0;
+		});
+		jobProcessor = nullptr;
+		jobTaskCount = 0;
+	}
+}
+
+size_t WorkerThreadPool::GetDefaultThreadCount ()
+{
+	size_t threadCount = std::thread::hardware_concurrency ();
+	if (threadCount == 0) {
+		return 1;
+	}
+	return threadCount;
+}
+
+WorkerThreadPool& WorkerThreadPool::GetSharedPool ()
+{
+	static WorkerThreadPool sharedPool (GetDefaultThreadCount ());
+	return sharedPool;
+}
+
+void WorkerThreadPool::WorkerMain ()
+{
+	size_t processedGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock (jobMutex);
+			jobStarted.wait (lock, [&] () {
+				return isStopping || jobGeneration != processedGeneration;
+			});
+			if (isStopping) {
+				return;
+			}
+			processedGeneration = jobGeneration;
+		}
+
+		ProcessTasks ();
+
+		{
+			std::lock_guard<std::mutex> lock (jobMutex);
+			busyWorkerCount--;
+			if (busyWorkerCount == 0) {
+				jobFinished.notify_one ();
+			}
+		}
+	}
+}
+
+void WorkerThreadPool::ProcessTasks ()
+{
+	// every thread takes the next unprocessed task until the job runs out,
+	// so a slow task never holds back the remaining ones
+	while (true) {
+		size_t taskIndex = nextTaskIndex.fetch_add (1);
+		if (taskIndex >= jobTaskCount) {
+			break;
+		}
+		(*jobProcessor) (taskIndex);
+	}
+}
+
+}
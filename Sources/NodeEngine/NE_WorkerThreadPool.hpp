@@ -0,0 +1,51 @@
+#ifndef NE_WORKERTHREADPOOL_HPP
+#define NE_WORKERTHREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NE
+{
+
+// runs the tasks of one job at a time on the worker threads and on the
+// calling thread, a job started while another one is running (from an
+// other thread or from a task) is processed by its caller alone
+class WorkerThreadPool
+{
+public:
+	WorkerThreadPool (size_t threadCount);
+	WorkerThreadPool (const WorkerThreadPool& src) = delete;
+	~WorkerThreadPool ();
+
+	WorkerThreadPool&	operator= (const WorkerThreadPool& rhs) = delete;
+
+	size_t				GetThreadCount () const;
+	void				ParallelFor (size_t taskCount, const std::function<void (size_t)>& processor);
+
+	static size_t				GetDefaultThreadCount ();
+	static WorkerThreadPool&	GetSharedPool ();
+
+private:
+	void				WorkerMain ();
+	void				ProcessTasks ();
+
+	std::vector<std::thread>				workers;
+	std::mutex								jobMutex;
+	std::condition_variable					jobStarted;
+	std::condition_variable					jobFinished;
+
+	const std::function<void (size_t)>*		jobProcessor;
+	size_t									jobTaskCount;
+	size_t									jobGeneration;
+	size_t									busyWorkerCount;
+	bool									isStopping;
+	std::atomic<size_t>						nextTaskIndex;
+};
+
+}
+
+#endif
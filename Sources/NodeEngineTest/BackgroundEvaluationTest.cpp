@@ -0,0 +1,311 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_BackgroundEvaluator.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "NUIE_NodeUIManager.hpp"
+#include "BI_InputUINodes.hpp"
+#include "BI_BinaryOperationNodes.hpp"
+#include "TestNodes.hpp"
+#include "TestUtils.hpp"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+
+using namespace NE;
+using namespace NUIE;
+using namespace BI;
+
+namespace BackgroundEvaluationTest
+{
+
+static std::atomic<bool> isBlockingNodeReleased (false);
+static std::atomic<bool> hasCalculationData (false);
+static std::thread::id calculationThreadId;
+
+class ProbeNode : public Node
+{
+	DYNAMIC_SERIALIZABLE (ProbeNode);
+
+public:
+	ProbeNode () :
+		Node ()
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationThreadId = std::this_thread::get_id ();
+		hasCalculationData = env.IsDataType<EvaluationData> ();
+		return ValuePtr (new IntValue (1));
+	}
+
+	virtual Stream::Status Read (InputStream& inputStream) override
+	{
+		ObjectHeader header (inputStream);
+		Node::Read (inputStream);
+		return inputStream.GetStatus ();
+	}
+
+	virtual Stream::Status Write (OutputStream& outputStream) const override
+	{
+		ObjectHeader header (outputStream, serializationInfo);
+		Node::Write (outputStream);
+		return outputStream.GetStatus ();
+	}
+};
+
+class BlockingNode : public Node
+{
+	DYNAMIC_SERIALIZABLE (BlockingNode);
+
+public:
+	BlockingNode () :
+		Node ()
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		while (!isBlockingNodeReleased.load ()) {
+			if (env.IsCancelled ()) {
+				return nullptr;
+			}
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		}
+		return ValuePtr (new IntValue (1));
+	}
+
+	virtual Stream::Status Read (InputStream& inputStream) override
+	{
+		ObjectHeader header (inputStream);
+		Node::Read (inputStream);
+		return inputStream.GetStatus ();
+	}
+
+	virtual Stream::Status Write (OutputStream& outputStream) const override
+	{
+		ObjectHeader header (outputStream, serializationInfo);
+		Node::Write (outputStream);
+		return outputStream.GetStatus ();
+	}
+};
+
+DYNAMIC_SERIALIZATION_INFO (ProbeNode, 1, "{3EF718F5-AD97-4D54-B59F-ABF62768295C}");
+DYNAMIC_SERIALIZATION_INFO (BlockingNode, 1, "{9362E078-5FDD-40ED-9AAF-AB64B04DB50D}");
+
+TEST (BackgroundEvaluatorPublishTest)
+{
+	TestChainGraph graph (2);
+	BackgroundEvaluator evaluator;
+	ASSERT (!evaluator.IsStarted ());
+
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	ASSERT (evaluator.IsStarted ());
+	ASSERT (!evaluator.IsOutdated (graph.manager));
+	evaluator.Wait ();
+	ASSERT (evaluator.IsFinished ());
+	ASSERT (CountingTestNode::totalCalculationCount == 3);
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (!evaluator.IsStarted ());
+	ASSERT (publishedNodes.Count () == 3);
+	ASSERT (graph.nodes[1]->processThreadId == std::this_thread::get_id ());
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 7);
+
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (CountingTestNode::totalCalculationCount == 3);
+}
+
+TEST (BackgroundEvaluatorReusesCalculatedValuesTest)
+{
+	TestChainGraph graph (2);
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (CountingTestNode::totalCalculationCount == 3);
+
+	graph.nodes[1]->InvalidateValue ();
+	ASSERT (graph.nodes[0]->HasCalculatedValue ());
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+
+	BackgroundEvaluator evaluator;
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	evaluator.Wait ();
+	ASSERT (CountingTestNode::totalCalculationCount == 4);
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (publishedNodes == NodeCollection ({ graph.nodes[1]->GetId () }));
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 7);
+}
+
+TEST (BackgroundEvaluatorOutdatedTest)
+{
+	TestChainGraph graph (2);
+	BackgroundEvaluator evaluator;
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	graph.source->SetValue (10);
+	ASSERT (evaluator.IsOutdated (graph.manager));
+	evaluator.Wait ();
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Outdated);
+	ASSERT (publishedNodes.IsEmpty ());
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	evaluator.Wait ();
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 12);
+}
+
+TEST (BackgroundEvaluatorCancelTest)
+{
+	NodeManager manager;
+	NodePtr blockingNode = manager.AddNode (NodePtr (new BlockingNode ()));
+
+	isBlockingNodeReleased = false;
+	BackgroundEvaluator evaluator;
+	ASSERT (evaluator.Start (manager, EmptyEvaluationEnv, false));
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::NotFinished);
+	evaluator.Cancel ();
+	ASSERT (!evaluator.IsStarted ());
+	ASSERT (!blockingNode->HasCalculatedValue ());
+
+	ASSERT (evaluator.Start (manager, EmptyEvaluationEnv, false));
+	isBlockingNodeReleased = true;
+	evaluator.Wait ();
+	ASSERT (evaluator.Publish (manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (IntValue::Get (blockingNode->GetCalculatedValue ()) == 1);
+}
+
+TEST (BackgroundEvaluatorReusesSnapshotTest)
+{
+	TestChainGraph graph (2);
+	NodePtr blockingNode = graph.manager.AddNode (NodePtr (new BlockingNode ()));
+
+	isBlockingNodeReleased = false;
+	BackgroundEvaluator evaluator;
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	while (CountingTestNode::totalCalculationCount < 3) {
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+	evaluator.Cancel ();
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	isBlockingNodeReleased = true;
+	evaluator.Wait ();
+	ASSERT (CountingTestNode::totalCalculationCount == 3);
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (publishedNodes.Count () == 4);
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 7);
+
+	graph.source->SetValue (10);
+	ASSERT (evaluator.Start (graph.manager, EmptyEvaluationEnv, false));
+	evaluator.Wait ();
+	ASSERT (CountingTestNode::totalCalculationCount == 6);
+	ASSERT (evaluator.Publish (graph.manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 12);
+}
+
+TEST (BackgroundEvaluatorSnapshotSourceTest)
+{
+	BackgroundEvaluator evaluator;
+	std::unique_ptr<TestChainGraph> graph (new TestChainGraph (2));
+	graph->source->SetValue (10);
+	ASSERT (evaluator.Start (graph->manager, EmptyEvaluationEnv, false));
+	evaluator.Wait ();
+
+	// the new manager has the same stamp, and it may get the same address
+	graph.reset (new TestChainGraph (2));
+	graph->source->SetValue (20);
+	ASSERT (evaluator.IsOutdated (graph->manager));
+	ASSERT (evaluator.Start (graph->manager, EmptyEvaluationEnv, false));
+	evaluator.Wait ();
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (graph->manager, EmptyEvaluationEnv, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (IntValue::Get (graph->nodes[1]->GetCalculatedValue ()) == 22);
+}
+
+TEST (BackgroundEvaluatorKeepsEvaluationDataTest)
+{
+	NodeManager manager;
+	NodePtr probeNode = manager.AddNode (NodePtr (new ProbeNode ()));
+	EvaluationEnv env (EvaluationDataPtr (new EvaluationData ()));
+	BackgroundEvaluator evaluator;
+	hasCalculationData = true;
+	calculationThreadId = std::this_thread::get_id ();
+	ASSERT (evaluator.Start (manager, env, false));
+	evaluator.Wait ();
+	ASSERT (!hasCalculationData);
+	ASSERT (calculationThreadId != std::this_thread::get_id ());
+
+	NodeCollection publishedNodes;
+	ASSERT (evaluator.Publish (manager, env, publishedNodes) == BackgroundEvaluator::PublishResult::Completed);
+	ASSERT (IntValue::Get (probeNode->GetCalculatedValue ()) == 1);
+}
+
+TEST (NodeUIManagerBackgroundEvaluationTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	ASSERT (uiManager.GetEvaluationMode () == NodeUIManager::EvaluationMode::Synchronous);
+	uiManager.SetEvaluationMode (NodeUIManager::EvaluationMode::Background);
+
+	std::shared_ptr<IntegerUpDownNode> intNode (new IntegerUpDownNode (LocString (L"Integer"), Point (0, 0), 5, 1));
+	UINodePtr addNode (new AdditionNode (LocString (L"Addition"), Point (0, 0)));
+	uiManager.AddNode (intNode);
+	uiManager.AddNode (addNode);
+	uiManager.ConnectOutputSlotToInputSlot (intNode->GetUIOutputSlot (SlotId ("out")), addNode->GetUIInputSlot (SlotId ("a")));
+	uiManager.ConnectOutputSlotToInputSlot (intNode->GetUIOutputSlot (SlotId ("out")), addNode->GetUIInputSlot (SlotId ("b")));
+
+	uiManager.Update (env);
+	ASSERT (uiManager.IsBackgroundEvaluationRunning ());
+	ASSERT (!addNode->HasCalculatedValue ());
+	uiManager.WaitForBackgroundEvaluation (env);
+	ASSERT (!uiManager.IsBackgroundEvaluationRunning ());
+	ASSERT (DoubleValue::Get (addNode->GetCalculatedValue ()) == 10.0);
+
+	intNode->SetValue (6);
+	uiManager.InvalidateNodeValue (intNode);
+	uiManager.Update (env);
+	ASSERT (uiManager.IsBackgroundEvaluationRunning ());
+	intNode->SetValue (7);
+	uiManager.InvalidateNodeValue (intNode);
+	uiManager.WaitForBackgroundEvaluation (env);
+	ASSERT (!addNode->HasCalculatedValue ());
+
+	uiManager.Update (env);
+	uiManager.WaitForBackgroundEvaluation (env);
+	ASSERT (DoubleValue::Get (addNode->GetCalculatedValue ()) == 14.0);
+
+	uiManager.SetEvaluationMode (NodeUIManager::EvaluationMode::Synchronous);
+	intNode->SetValue (8);
+	uiManager.InvalidateNodeValue (intNode);
+	uiManager.Update (env);
+	ASSERT (DoubleValue::Get (addNode->GetCalculatedValue ()) == 16.0);
+}
+
+}
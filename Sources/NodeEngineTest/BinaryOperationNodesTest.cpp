@@ -2,6 +2,8 @@
 #include "NUIE_NodeUIManager.hpp"
 #include "BI_BinaryOperationNodes.hpp"
 #include "BI_InputUINodes.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_LazyListValues.hpp"
 #include "TestUtils.hpp"
 
 using namespace NE;
@@ -11,6 +13,31 @@ using namespace BI;
 namespace BinaryOperationNodesTest
 {
 
+static std::vector<double> GetListAdditionResult (ValueCombinationMode combinationMode, int aCount, const ValuePtr& bValue)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	UINodePtr val1 = uiManager.AddNode (UINodePtr (new DoubleIncrementedNode (LocString (L"Value1"), Point (0, 0))));
+	std::shared_ptr<AdditionNode> op (new AdditionNode (LocString (L"Addition"), Point (0, 0)));
+	uiManager.AddNode (op);
+	val1->SetInputSlotDefaultValue (SlotId ("count"), ValuePtr (new IntValue (aCount)));
+	uiManager.ConnectOutputSlotToInputSlot (val1->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("a")));
+	op->SetInputSlotDefaultValue (SlotId ("b"), bValue);
+	GetValueCombinationFeature (op.get ())->SetValueCombinationMode (combinationMode);
+
+	std::vector<double> values;
+	ValueConstPtr result = op->Evaluate (EmptyEvaluationEnv);
+	if (result == nullptr) {
+		return values;
+	}
+	FlatEnumerate (result, [&] (const ValueConstPtr& v) {
+		values.push_back (NumberValue::ToDouble (v));
+		return true;
+	});
+	return values;
+}
+
 static double GetBinaryOperationResult (double a, double b, const std::function<UINodePtr ()>& nodeCreator)
 {
 	TestUIEnvironment env;
@@ -46,7 +73,7 @@ TEST (TestAdditionNodeWithList)
 	uiManager.ConnectOutputSlotToInputSlot (val2->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("b")));
 
 	ValueConstPtr val = op->Evaluate (EmptyEvaluationEnv);
-	ASSERT (Value::IsType<ListValue> (val));
+	ASSERT (Value::IsType<DoubleListValue> (val));
 	ASSERT (IsComplexType<NumberValue> (val));
 	std::vector<double> values;
 	FlatEnumerate (val, [&] (const ValueConstPtr& v) {
@@ -80,4 +107,90 @@ TEST (TestDivisionNode)
 	ASSERT (IsEqual (result, 2.0 / 3.0));
 }
 
+TEST (TestAdditionNodeCombinationModes)
+{
+	ValuePtr bList (new DoubleListValue ({ 10.0, 11.0, 12.0, 13.0, 14.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Shortest, 3, bList) == std::vector<double> ({ 10.0, 12.0, 14.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Longest, 3, bList) == std::vector<double> ({ 10.0, 12.0, 14.0, 15.0, 16.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Longest, 7, bList) == std::vector<double> ({ 10.0, 12.0, 14.0, 16.0, 18.0, 19.0, 20.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::CrossProduct, 3, bList) == std::vector<double> ({
+		10.0, 11.0, 12.0, 13.0, 14.0,
+		11.0, 12.0, 13.0, 14.0, 15.0,
+		12.0, 13.0, 14.0, 15.0, 16.0
+	}));
+}
+
+TEST (TestAdditionNodeGenericListInput)
+{
+	ListValuePtr bList (new ListValue ());
+	bList->Push (ValuePtr (new IntValue (10)));
+	bList->Push (ValuePtr (new DoubleValue (20.0)));
+	bList->Push (ValuePtr (new IntValue (30)));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Longest, 5, bList) == std::vector<double> ({ 10.0, 21.0, 32.0, 33.0, 34.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Shortest, 5, ValuePtr (new DoubleValue (1.0))) == std::vector<double> ({ 1.0 }));
+	ASSERT (GetListAdditionResult (ValueCombinationMode::Longest, 5, ValuePtr (new DoubleValue (1.0))) == std::vector<double> ({ 1.0, 2.0, 3.0, 4.0, 5.0 }));
+}
+
+TEST (TestDivisionNodeWithListByZero)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	UINodePtr val1 = uiManager.AddNode (UINodePtr (new DoubleIncrementedNode (LocString (L"Value1"), Point (0, 0))));
+	UINodePtr op = uiManager.AddNode (UINodePtr (new DivisionNode (LocString (L"Division"), Point (0, 0))));
+	uiManager.ConnectOutputSlotToInputSlot (val1->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("a")));
+	ASSERT (op->Evaluate (EmptyEvaluationEnv) == nullptr);
+
+	uiManager.ConnectOutputSlotToInputSlot (val1->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("b")));
+	ASSERT (op->Evaluate (EmptyEvaluationEnv) == nullptr);
+}
+
+static ValueConstPtr GetLargeCrossProductResult (const std::shared_ptr<BinaryOperationNode>& op, const std::vector<double>& aItems, const std::vector<double>& bItems)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	uiManager.AddNode (op);
+	op->SetInputSlotDefaultValue (SlotId ("a"), ValuePtr (new DoubleListValue (aItems)));
+	op->SetInputSlotDefaultValue (SlotId ("b"), ValuePtr (new DoubleListValue (bItems)));
+	GetValueCombinationFeature (op.get ())->SetValueCombinationMode (ValueCombinationMode::CrossProduct);
+	return op->Evaluate (EmptyEvaluationEnv);
+}
+
+TEST (TestLargeCrossProductIsLazy)
+{
+	std::vector<double> aItems;
+	std::vector<double> bItems;
+	for (size_t i = 0; i < 300; i++) {
+		aItems.push_back ((double) i);
+	}
+	for (size_t i = 0; i < 400; i++) {
+		bItems.push_back ((double) i * 1000.0);
+	}
+
+	ValueConstPtr result = GetLargeCrossProductResult (std::shared_ptr<BinaryOperationNode> (new AdditionNode (LocString (L"Addition"), Point (0, 0))), aItems, bItems);
+	ASSERT (Value::IsType<LazyListValue> (result));
+	ASSERT (IsComplexType<NumberValue> (result));
+	const IListValue* resultList = Value::Cast<IListValue> (result.get ());
+	ASSERT (resultList->GetSize () == 300 * 400);
+	ASSERT (IsEqual (NumberValue::ToDouble (resultList->GetValue (0)), 0.0));
+	ASSERT (IsEqual (NumberValue::ToDouble (resultList->GetValue (401)), 1001.0));
+	ASSERT (IsEqual (NumberValue::ToDouble (resultList->GetValue (299 * 400 + 399)), 399299.0));
+	ASSERT (result->GetMemorySize () < aItems.size () * bItems.size ());
+}
+
+TEST (TestLargeCrossProductDivisionByZero)
+{
+	std::vector<double> aItems (300, 1.0);
+	std::vector<double> bItems (400, 2.0);
+
+	ValueConstPtr result = GetLargeCrossProductResult (std::shared_ptr<BinaryOperationNode> (new DivisionNode (LocString (L"Division"), Point (0, 0))), aItems, bItems);
+	ASSERT (Value::IsType<LazyListValue> (result));
+	ASSERT (IsEqual (NumberValue::ToDouble (Value::Cast<IListValue> (result.get ())->GetValue (1234)), 0.5));
+
+	bItems[123] = 0.0;
+	result = GetLargeCrossProductResult (std::shared_ptr<BinaryOperationNode> (new DivisionNode (LocString (L"Division"), Point (0, 0))), aItems, bItems);
+	ASSERT (result == nullptr);
+}
+
 }
@@ -0,0 +1,347 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "NUIE_NodeUIManager.hpp"
+#include "BI_InputUINodes.hpp"
+#include "BI_BinaryOperationNodes.hpp"
+#include "BI_ViewerUINodes.hpp"
+#include "TestNodes.hpp"
+#include "TestUtils.hpp"
+
+#include <algorithm>
+
+using namespace NE;
+using namespace NUIE;
+using namespace BI;
+
+namespace BoundedValueCacheTest
+{
+
+static const int ListSize = 1000;
+
+class ListNode : public SerializableTestNode
+{
+public:
+	ListNode () :
+		SerializableTestNode (),
+		calculationCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		int first = 0;
+		FlatEnumerate (in, [&] (const ValueConstPtr& val) {
+			first = IntValue::Get (val);
+			return false;
+		});
+		ListValuePtr result (new ListValue ());
+		for (int i = 0; i < ListSize; i++) {
+			result->Push (ValuePtr (new IntValue (first + 1)));
+		}
+		return result;
+	}
+
+	mutable int calculationCount;
+};
+
+class CountingUINode : public SerializableTestUINode
+{
+public:
+	CountingUINode () :
+		SerializableTestUINode (LocString (L"Counting"), Point (0.0, 0.0)),
+		calculationCount (0),
+		drawingCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterUIInputSlot (UIInputSlotPtr (new UIInputSlot (SlotId ("in"), LocString (L"In"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterUIOutputSlot (UIOutputSlotPtr (new UIOutputSlot (SlotId ("out"), LocString (L"Out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		return ValuePtr (new IntValue (IntValue::Get (in) + 1));
+	}
+
+	virtual void UpdateDrawingImage (NodeUIDrawingEnvironment&, NodeDrawingImage& drawingImage) const override
+	{
+		drawingCount++;
+		Rect nodeRect (0.0, 0.0, 100.0, 50.0);
+		drawingImage.SetNodeRect (nodeRect);
+		drawingImage.AddItem (DrawingItemPtr (new DrawingFillRect (nodeRect, Color (0, 0, 0))));
+	}
+
+	mutable int calculationCount;
+	mutable int drawingCount;
+};
+
+static int GetFirstItem (const ValueConstPtr& value)
+{
+	IListValueConstPtr listValue = Value::Cast<IListValue> (value);
+	return IntValue::Get (listValue->GetValue (0));
+}
+
+static std::vector<std::shared_ptr<ListNode>> CreateChain (NodeManager& manager, size_t nodeCount)
+{
+	std::vector<std::shared_ptr<ListNode>> nodes;
+	for (size_t i = 0; i < nodeCount; ++i) {
+		nodes.push_back (std::shared_ptr<ListNode> (new ListNode ()));
+		manager.AddNode (nodes.back ());
+		if (i > 0) {
+			manager.ConnectOutputSlotToInputSlot (nodes[i - 1]->GetOutputSlot (SlotId ("out")), nodes[i]->GetInputSlot (SlotId ("in")));
+		}
+	}
+	return nodes;
+}
+
+static size_t GetListMemorySize ()
+{
+	ListValuePtr list (new ListValue ());
+	for (int i = 0; i < ListSize; i++) {
+		list->Push (ValuePtr (new IntValue (0)));
+	}
+	return list->GetMemorySize ();
+}
+
+TEST (ValueMemorySizeTest)
+{
+	ListValuePtr list (new ListValue ());
+	size_t emptySize = list->GetMemorySize ();
+	list->Push (ValuePtr (new IntValue (1)));
+	list->Push (ValuePtr (new StringValue (L"something long enough")));
+	ASSERT (list->GetMemorySize () > emptySize + sizeof (IntValue) + sizeof (StringValue));
+}
+
+TEST (UnboundedCacheTest)
+{
+	NodeManager manager;
+	std::vector<std::shared_ptr<ListNode>> nodes = CreateChain (manager, 10);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (manager.GetNodeValueCacheMaxMemorySize () == 0);
+	ASSERT (manager.GetNodeValueCacheMemorySize () == 0);
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		ASSERT (node->HasCalculatedValue ());
+	}
+}
+
+TEST (EvictionTest)
+{
+	NodeManager manager;
+	size_t maxMemorySize = 3 * GetListMemorySize ();
+	manager.SetNodeValueCacheMaxMemorySize (maxMemorySize);
+	std::vector<std::shared_ptr<ListNode>> nodes = CreateChain (manager, 10);
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (manager.GetNodeValueCacheMemorySize () <= maxMemorySize);
+	ASSERT (nodes.back ()->HasCalculatedValue ());
+	ASSERT (GetFirstItem (nodes.back ()->GetCalculatedValue ()) == 10);
+	size_t evictedCount = 0;
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		ASSERT (node->calculationCount == 1);
+		if (manager.IsNodeValueEvicted (node->GetId ())) {
+			ASSERT (!node->HasCalculatedValue ());
+			evictedCount++;
+		}
+	}
+	ASSERT (evictedCount >= 7);
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		ASSERT (node->calculationCount == 1);
+	}
+}
+
+TEST (RecalculateOnDemandTest)
+{
+	NodeManager manager;
+	manager.SetNodeValueCacheMaxMemorySize (3 * GetListMemorySize ());
+	std::vector<std::shared_ptr<ListNode>> nodes = CreateChain (manager, 10);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	std::shared_ptr<ListNode> evictedNode = nullptr;
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		if (manager.IsNodeValueEvicted (node->GetId ())) {
+			evictedNode = node;
+		}
+	}
+	ASSERT (evictedNode != nullptr);
+	size_t evictedIndex = std::find (nodes.begin (), nodes.end (), evictedNode) - nodes.begin ();
+	ASSERT (GetFirstItem (evictedNode->Evaluate (EmptyEvaluationEnv)) == (int) evictedIndex + 1);
+	ASSERT (evictedNode->HasCalculatedValue ());
+	ASSERT (!manager.IsNodeValueEvicted (evictedNode->GetId ()));
+	ASSERT (evictedNode->calculationCount == 2);
+
+	nodes[0]->InvalidateValue ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (GetFirstItem (nodes.back ()->GetCalculatedValue ()) == 10);
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		ASSERT (node->calculationCount >= 2);
+	}
+
+	nodes[5]->InvalidateValue ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (GetFirstItem (nodes.back ()->GetCalculatedValue ()) == 10);
+}
+
+TEST (ChangeMaxMemorySizeTest)
+{
+	NodeManager manager;
+	std::vector<std::shared_ptr<ListNode>> nodes = CreateChain (manager, 10);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	size_t maxMemorySize = 2 * GetListMemorySize ();
+	manager.SetNodeValueCacheMaxMemorySize (maxMemorySize);
+	ASSERT (manager.GetNodeValueCacheMemorySize () <= maxMemorySize);
+	ASSERT (nodes.back ()->HasCalculatedValue ());
+
+	manager.SetNodeValueCacheMaxMemorySize (0);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	for (const std::shared_ptr<ListNode>& node : nodes) {
+		ASSERT (node->HasCalculatedValue ());
+		ASSERT (!manager.IsNodeValueEvicted (node->GetId ()));
+	}
+}
+
+TEST (PinnedSinkNodesTest)
+{
+	NodeManager manager;
+	manager.SetNodeValueCacheMaxMemorySize (GetListMemorySize ());
+	std::vector<std::shared_ptr<ListNode>> chain1 = CreateChain (manager, 5);
+	std::vector<std::shared_ptr<ListNode>> chain2 = CreateChain (manager, 5);
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (chain1.back ()->HasCalculatedValue ());
+	ASSERT (chain2.back ()->HasCalculatedValue ());
+	ASSERT (manager.GetNodeValueCacheMemorySize () >= 2 * GetListMemorySize ());
+}
+
+TEST (ParallelEvictionTest)
+{
+	NodeManager manager;
+	manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	manager.SetNodeValueCacheMaxMemorySize (3 * GetListMemorySize ());
+	std::vector<std::vector<std::shared_ptr<ListNode>>> chains;
+	for (size_t i = 0; i < 4; ++i) {
+		chains.push_back (CreateChain (manager, 8));
+	}
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	for (const std::vector<std::shared_ptr<ListNode>>& chain : chains) {
+		ASSERT (GetFirstItem (chain.back ()->GetCalculatedValue ()) == 8);
+	}
+
+	for (const std::vector<std::shared_ptr<ListNode>>& chain : chains) {
+		chain[3]->InvalidateValue ();
+	}
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	for (const std::vector<std::shared_ptr<ListNode>>& chain : chains) {
+		ASSERT (GetFirstItem (chain.back ()->GetCalculatedValue ()) == 8);
+		ASSERT (chain[3]->calculationCount == 2);
+	}
+}
+
+TEST (EarlyCutoffEvictionTest)
+{
+	NodeManager manager;
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	manager.SetNodeValueCacheMaxMemorySize (3 * GetListMemorySize ());
+	std::vector<std::shared_ptr<ListNode>> nodes = CreateChain (manager, 10);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	nodes[0]->InvalidateValue ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (GetFirstItem (nodes.back ()->GetCalculatedValue ()) == 10);
+}
+
+TEST (UIEvictedNodesDrawingTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	uiManager.SetNodeValueCacheMaxMemorySize (1);
+
+	std::vector<std::shared_ptr<CountingUINode>> nodes;
+	for (size_t i = 0; i < 3; ++i) {
+		nodes.push_back (std::shared_ptr<CountingUINode> (new CountingUINode ()));
+		uiManager.AddNode (nodes.back ());
+		if (i > 0) {
+			uiManager.ConnectOutputSlotToInputSlot (nodes[i - 1]->GetUIOutputSlot (SlotId ("out")), nodes[i]->GetUIInputSlot (SlotId ("in")));
+		}
+	}
+
+	uiManager.Update (env);
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+	ASSERT (nodes[0]->IsValueEvicted ());
+	ASSERT (nodes[1]->IsValueEvicted ());
+	for (const std::shared_ptr<CountingUINode>& node : nodes) {
+		node->GetRect (env);
+		ASSERT (node->drawingCount == 1);
+	}
+
+	// evicted values are up to date, so neither a manual update
+	// recalculates them, nor their drawings are invalidated
+	uiManager.ManualUpdate (env);
+	uiManager.Update (env);
+	for (const std::shared_ptr<CountingUINode>& node : nodes) {
+		node->GetRect (env);
+		ASSERT (node->calculationCount == 1);
+		ASSERT (node->drawingCount == 1);
+	}
+}
+
+TEST (UIDisplayedValuesPinnedTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	uiManager.SetNodeValueCacheMaxMemorySize (1);
+
+	UINodePtr intNode (new IntegerUpDownNode (LocString (L"Integer"), Point (0, 0), 5, 1));
+	UINodePtr addNode1 (new AdditionNode (LocString (L"Addition"), Point (0, 0)));
+	UINodePtr addNode2 (new AdditionNode (LocString (L"Addition"), Point (0, 0)));
+	UINodePtr viewerNode (new ViewerNode (LocString (L"Viewer"), Point (0, 0)));
+	uiManager.AddNode (intNode);
+	uiManager.AddNode (addNode1);
+	uiManager.AddNode (addNode2);
+	uiManager.AddNode (viewerNode);
+	uiManager.ConnectOutputSlotToInputSlot (intNode->GetUIOutputSlot (SlotId ("out")), addNode1->GetUIInputSlot (SlotId ("a")));
+	uiManager.ConnectOutputSlotToInputSlot (addNode1->GetUIOutputSlot (SlotId ("result")), addNode2->GetUIInputSlot (SlotId ("a")));
+	uiManager.ConnectOutputSlotToInputSlot (addNode2->GetUIOutputSlot (SlotId ("result")), viewerNode->GetUIInputSlot (SlotId ("in")));
+
+	uiManager.Update (env);
+	ASSERT (IntValue::Get (intNode->GetCalculatedValue ()) == 5);
+	ASSERT (DoubleValue::Get (viewerNode->GetCalculatedValue ()) == 5.0);
+	ASSERT (addNode1->IsValueEvicted ());
+	ASSERT (addNode2->IsValueEvicted ());
+
+	// observed nodes are pinned, so they get their values back
+	uiManager.SetObservedNodes (NodeCollection ({ addNode1->GetId () }));
+	ASSERT (!addNode1->IsValueEvicted ());
+	uiManager.ManualUpdate (env);
+	ASSERT (DoubleValue::Get (addNode1->GetCalculatedValue ()) == 5.0);
+	ASSERT (IntValue::Get (intNode->GetCalculatedValue ()) == 5);
+	ASSERT (DoubleValue::Get (viewerNode->GetCalculatedValue ()) == 5.0);
+	ASSERT (addNode2->IsValueEvicted ());
+
+	uiManager.SetObservedNodes (NodeCollection ());
+	ASSERT (addNode1->IsValueEvicted ());
+	ASSERT (IntValue::Get (intNode->GetCalculatedValue ()) == 5);
+}
+
+}
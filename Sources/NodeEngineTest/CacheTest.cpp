@@ -64,6 +64,42 @@ TEST (CacheMaxSizeTest)
 	ASSERT (cache.Contains (4));
 }
 
+TEST (CacheLeastRecentlyUsedTest)
+{
+	Cache<int, std::string> cache (3);
+	ASSERT (cache.Add (1, "1"));
+	ASSERT (cache.Add (2, "2"));
+	ASSERT (cache.Add (3, "3"));
+	ASSERT (cache.Get (1) == "1");
+	ASSERT (cache.Add (4, "4"));
+	ASSERT (cache.Contains (1));
+	ASSERT (!cache.Contains (2));
+	ASSERT (cache.Contains (3));
+	ASSERT (cache.Contains (4));
+}
+
+TEST (CacheValueSizeTest)
+{
+	Cache<int, std::string> cache (10);
+	ASSERT (cache.Add (1, "1", 4));
+	ASSERT (cache.Add (2, "2", 4));
+	ASSERT (cache.GetSize () == 8);
+	ASSERT (!cache.Add (3, "3", 11));
+	ASSERT (cache.Add (3, "3", 6));
+	ASSERT (cache.GetSize () == 10);
+	ASSERT (!cache.Contains (1));
+	ASSERT (cache.Contains (2));
+	ASSERT (cache.Contains (3));
+
+	ASSERT (cache.Add (4, "4", 1));
+	ASSERT (!cache.Contains (2));
+	ASSERT (cache.GetSize () == 7);
+	cache.SetMaxSize (5);
+	ASSERT (cache.GetSize () == 1);
+	ASSERT (!cache.Contains (3));
+	ASSERT (cache.Contains (4));
+}
+
 TEST (CacheWithController)
 {
 	TestController controller;
@@ -108,4 +144,22 @@ TEST (CacheWithControllerLarge)
 	ASSERT (controller.disposeCount == 100);
 }
 
+TEST (CacheWithControllerZeroSize)
+{
+	TestController controller;
+	{
+		Cache<int, std::string> cache (0, &controller);
+		ASSERT (cache.Get (1) == "1");
+		ASSERT (cache.Get (1) == "1");
+		ASSERT (cache.Get (2) == "2");
+		ASSERT (!cache.Contains (1));
+		ASSERT (cache.Contains (2));
+		ASSERT (controller.createCount == 2);
+		ASSERT (controller.disposeCount == 1);
+	}
+
+	ASSERT (controller.createCount == 2);
+	ASSERT (controller.disposeCount == 2);
+}
+
 }
@@ -0,0 +1,295 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "NUIE_NodeUIManager.hpp"
+#include "TestNodes.hpp"
+#include "TestUtils.hpp"
+
+#include <thread>
+
+using namespace NE;
+using namespace NUIE;
+
+namespace CancellationTest
+{
+
+class LongRunningNode : public SerializableTestNode
+{
+public:
+	LongRunningNode (const CancellationTokenPtr& token) :
+		SerializableTestNode (),
+		token (token),
+		calculationCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		for (int i = 0; i < 100; i++) {
+			if (i == 10) {
+				token->Cancel ();
+			}
+			if (env.IsCancelled ()) {
+				return nullptr;
+			}
+		}
+		return ValuePtr (new IntValue (100));
+	}
+
+	CancellationTokenPtr	token;
+	mutable int				calculationCount;
+};
+
+class CancellingUINode : public SerializableTestUINode
+{
+public:
+	CancellingUINode () :
+		SerializableTestUINode (LocString (L"Cancelling"), Point (0.0, 0.0)),
+		tokenToCancel (nullptr),
+		calculationTime (0),
+		calculationCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterUIInputSlot (UIInputSlotPtr (new UIInputSlot (SlotId ("in"), LocString (L"In"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterUIOutputSlot (UIOutputSlotPtr (new UIOutputSlot (SlotId ("out"), LocString (L"Out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		std::this_thread::sleep_for (calculationTime);
+		if (tokenToCancel != nullptr) {
+			tokenToCancel->Cancel ();
+		}
+		return ValuePtr (new IntValue (IntValue::Get (in) + 1));
+	}
+
+	CancellationTokenPtr		tokenToCancel;
+	std::chrono::milliseconds	calculationTime;
+	mutable int					calculationCount;
+};
+
+static std::vector<std::shared_ptr<CancellingUINode>> CreateUIChain (NodeUIManager& uiManager, size_t nodeCount)
+{
+	std::vector<std::shared_ptr<CancellingUINode>> nodes;
+	for (size_t i = 0; i < nodeCount; ++i) {
+		nodes.push_back (std::shared_ptr<CancellingUINode> (new CancellingUINode ()));
+		uiManager.AddNode (nodes.back ());
+		if (i > 0) {
+			uiManager.ConnectOutputSlotToInputSlot (nodes[i - 1]->GetUIOutputSlot (SlotId ("out")), nodes[i]->GetUIInputSlot (SlotId ("in")));
+		}
+	}
+	return nodes;
+}
+
+TEST (CancellationTokenTest)
+{
+	CancellationToken token;
+	ASSERT (!token.IsCancelled ());
+	token.Cancel ();
+	ASSERT (token.IsCancelled ());
+	token.Reset ();
+	ASSERT (!token.IsCancelled ());
+
+	EvaluationEnv env (nullptr);
+	ASSERT (!env.IsCancelled ());
+	CancellationTokenPtr tokenPtr (new CancellationToken ());
+	env.SetCancellationToken (tokenPtr);
+	ASSERT (!env.IsCancelled ());
+	tokenPtr->Cancel ();
+	ASSERT (env.IsCancelled ());
+	env.SetCancellationToken (nullptr);
+	ASSERT (!env.IsCancelled ());
+}
+
+TEST (CancelDuringEvaluationTest)
+{
+	TestChainGraph graph (3);
+	CancellationTokenPtr token (new CancellationToken ());
+	EvaluationEnv env (nullptr);
+	env.SetCancellationToken (token);
+
+	graph.nodes[0]->tokenToCancel = token;
+	ASSERT (!graph.manager.EvaluateAllNodes (env));
+	ASSERT (graph.source->calculationCount == 1);
+	ASSERT (graph.nodes[0]->calculationCount == 1);
+	ASSERT (graph.nodes[1]->calculationCount == 0);
+	ASSERT (graph.nodes[2]->calculationCount == 0);
+	ASSERT (graph.source->GetCalculationStatus () == Node::CalculationStatus::Calculated);
+	ASSERT (graph.nodes[0]->GetCalculationStatus () == Node::CalculationStatus::NeedToCalculate);
+	ASSERT (graph.nodes[2]->GetCalculationStatus () == Node::CalculationStatus::NeedToCalculate);
+
+	graph.nodes[0]->tokenToCancel = nullptr;
+	token->Reset ();
+	ASSERT (graph.manager.EvaluateAllNodes (env));
+	ASSERT (graph.source->calculationCount == 1);
+	ASSERT (graph.nodes[0]->calculationCount == 2);
+	ASSERT (graph.nodes[1]->calculationCount == 1);
+	ASSERT (graph.nodes[2]->calculationCount == 1);
+	ASSERT (IntValue::Get (graph.nodes[2]->GetCalculatedValue ()) == 8);
+}
+
+TEST (CancelledParallelEvaluationTest)
+{
+	TestChainGraph graph (3);
+	graph.manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	CancellationTokenPtr token (new CancellationToken ());
+	EvaluationEnv env (nullptr);
+	env.SetCancellationToken (token);
+
+	graph.nodes[1]->tokenToCancel = token;
+	ASSERT (!graph.manager.EvaluateAllNodes (env));
+	ASSERT (graph.nodes[0]->GetCalculationStatus () == Node::CalculationStatus::Calculated);
+	ASSERT (graph.nodes[2]->calculationCount == 0);
+
+	graph.nodes[1]->tokenToCancel = nullptr;
+	token->Reset ();
+	ASSERT (graph.manager.EvaluateAllNodes (env));
+	ASSERT (graph.nodes[0]->calculationCount == 1);
+	ASSERT (IntValue::Get (graph.nodes[2]->GetCalculatedValue ()) == 8);
+}
+
+TEST (DeadlineTest)
+{
+	TestChainGraph graph (3);
+	EvaluationEnv env (nullptr);
+	env.SetDeadline (EvaluationEnv::Clock::now () - std::chrono::seconds (1));
+	ASSERT (env.HasDeadline ());
+	ASSERT (env.IsCancelled ());
+	ASSERT (!graph.manager.EvaluateAllNodes (env));
+	ASSERT (graph.source->calculationCount == 0);
+	ASSERT (graph.nodes[2]->Evaluate (env) == nullptr);
+	ASSERT (graph.source->calculationCount == 0);
+
+	env.SetTimeBudget (std::chrono::hours (1));
+	ASSERT (!env.IsCancelled ());
+	ASSERT (graph.manager.EvaluateAllNodes (env));
+	ASSERT (IntValue::Get (graph.nodes[2]->GetCalculatedValue ()) == 8);
+
+	env.ClearDeadline ();
+	ASSERT (!env.HasDeadline ());
+}
+
+TEST (LongRunningNodeTest)
+{
+	NodeManager manager;
+	CancellationTokenPtr token (new CancellationToken ());
+	std::shared_ptr<LongRunningNode> node (new LongRunningNode (token));
+	manager.AddNode (node);
+
+	EvaluationEnv env (nullptr);
+	env.SetCancellationToken (token);
+	ASSERT (!manager.EvaluateAllNodes (env));
+	ASSERT (node->calculationCount == 1);
+	ASSERT (node->GetCalculationStatus () == Node::CalculationStatus::NeedToCalculate);
+
+	token->Reset ();
+	env.SetCancellationToken (nullptr);
+	ASSERT (manager.EvaluateAllNodes (env));
+	ASSERT (node->calculationCount == 2);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 100);
+}
+
+TEST (CancelledManualUpdateResumeTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	uiManager.SetUpdateMode (NodeUIManager::UpdateMode::Manual);
+	std::vector<std::shared_ptr<CancellingUINode>> nodes = CreateUIChain (uiManager, 3);
+
+	CancellationTokenPtr token (new CancellationToken ());
+	env.GetEvaluationEnv ().SetCancellationToken (token);
+	nodes[1]->tokenToCancel = token;
+	uiManager.RequestRecalculateAndRedraw ();
+	uiManager.ManualUpdate (env);
+	ASSERT (nodes[1]->calculationCount == 1);
+	ASSERT (!nodes[2]->HasCalculatedValue ());
+
+	// the cancelled manual update is resumed by the next update, only the
+	// value calculated while the update was cancelled is calculated again
+	nodes[1]->tokenToCancel = nullptr;
+	token->Reset ();
+	uiManager.Update (env);
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+	ASSERT (nodes[0]->calculationCount == 1);
+	ASSERT (nodes[1]->calculationCount == 2);
+	ASSERT (nodes[2]->calculationCount == 1);
+
+	// without a pending manual update the calculation is disabled again
+	uiManager.InvalidateNodeValue (nodes[0]);
+	uiManager.Update (env);
+	ASSERT (!nodes[2]->HasCalculatedValue ());
+	uiManager.RequestRecalculateAndRedraw ();
+	uiManager.ManualUpdate (env);
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+}
+
+TEST (UpdateTimeBudgetTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	std::vector<std::shared_ptr<CancellingUINode>> nodes = CreateUIChain (uiManager, 3);
+
+	// every update gets the time budget again, and the deadline is cleared after it
+	uiManager.SetUpdateTimeBudget (std::chrono::hours (1));
+	uiManager.Update (env);
+	ASSERT (!env.GetEvaluationEnv ().HasDeadline ());
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+
+	uiManager.InvalidateNodeValue (nodes[0]);
+	uiManager.Update (env);
+	ASSERT (!env.GetEvaluationEnv ().HasDeadline ());
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+	ASSERT (nodes[0]->calculationCount == 2);
+
+	// a budget that is already spent cancels the update, but not the next one
+	uiManager.SetUpdateTimeBudget (std::chrono::nanoseconds (1));
+	uiManager.InvalidateNodeValue (nodes[0]);
+	uiManager.Update (env);
+	ASSERT (!nodes[2]->HasCalculatedValue ());
+	uiManager.SetUpdateTimeBudget (std::chrono::hours (1));
+	uiManager.Update (env);
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+}
+
+TEST (NodeLongerThanTimeBudgetTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+	std::vector<std::shared_ptr<CancellingUINode>> nodes = CreateUIChain (uiManager, 3);
+	for (const std::shared_ptr<CancellingUINode>& node : nodes) {
+		node->calculationTime = std::chrono::milliseconds (20);
+	}
+
+	// every node runs longer than the budget, but its value is kept,
+	// so every update continues where the previous one stopped
+	uiManager.SetUpdateTimeBudget (std::chrono::milliseconds (2));
+	for (int i = 0; i < 20 && !nodes[2]->HasCalculatedValue (); i++) {
+		uiManager.Update (env);
+	}
+	ASSERT (IntValue::Get (nodes[2]->GetCalculatedValue ()) == 3);
+	for (const std::shared_ptr<CancellingUINode>& node : nodes) {
+		ASSERT (node->calculationCount == 1);
+	}
+
+	uiManager.Update (env);
+	ASSERT (nodes[0]->calculationCount == 1);
+	ASSERT (nodes[2]->calculationCount == 1);
+}
+
+}
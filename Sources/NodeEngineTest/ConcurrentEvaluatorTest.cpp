@@ -0,0 +1,229 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_ConcurrentEvaluator.hpp"
+#include "NE_ReadWriteLock.hpp"
+#include "NE_Node.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+using namespace NE;
+
+namespace ConcurrentEvaluatorTest
+{
+
+class BlockingNode : public SerializableTestNode
+{
+public:
+	BlockingNode () :
+		SerializableTestNode (),
+		isCalculating (false),
+		isReleased (false)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv&) const override
+	{
+		isCalculating = true;
+		while (!isReleased) {
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		}
+		return ValuePtr (new IntValue (1));
+	}
+
+	mutable std::atomic<bool>	isCalculating;
+	std::atomic<bool>			isReleased;
+};
+
+TEST (ConcurrentEvaluationTest)
+{
+	TestChainGraph graph (2);
+
+	const size_t threadCount = 4;
+	std::vector<int> results (threadCount, 0);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.push_back (std::thread ([&, i] () {
+			ConcurrentEvaluator evaluator (graph.manager);
+			for (int j = 0; j < 10; j++) {
+				evaluator.InvalidateAllNodeValues ();
+				evaluator.EvaluateAllNodes (EmptyEvaluationEnv);
+			}
+			results[i] = IntValue::Get (evaluator.GetCalculatedNodeValue (graph.nodes[1]->GetId ()));
+		}));
+	}
+	for (std::thread& thread : threads) {
+		thread.join ();
+	}
+
+	for (int result : results) {
+		ASSERT (result == 7);
+	}
+	ASSERT (graph.source->calculationCount == (int) threadCount * 10);
+	ASSERT (graph.nodes[1]->calculationCount == (int) threadCount * 10);
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.nodes[1]->GetCalculatedValue ()) == 7);
+}
+
+TEST (ConcurrentEvaluatorInvalidationTest)
+{
+	TestChainGraph graph (2);
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	ConcurrentEvaluator evaluator (graph.manager);
+	ASSERT (evaluator.EvaluateNodes (NodeCollection ({ graph.nodes[0]->GetId () }), EmptyEvaluationEnv));
+	ASSERT (evaluator.HasCalculatedNodeValue (graph.nodes[0]->GetId ()));
+	ASSERT (!evaluator.HasCalculatedNodeValue (graph.nodes[1]->GetId ()));
+	ASSERT (evaluator.GetCalculatedNodeValue (graph.nodes[1]->GetId ()) == nullptr);
+
+	ASSERT (evaluator.EvaluateAllNodes (EmptyEvaluationEnv));
+	evaluator.InvalidateNodeValue (graph.nodes[0]->GetId ());
+	ASSERT (evaluator.HasCalculatedNodeValue (graph.source->GetId ()));
+	ASSERT (!evaluator.HasCalculatedNodeValue (graph.nodes[0]->GetId ()));
+	ASSERT (!evaluator.HasCalculatedNodeValue (graph.nodes[1]->GetId ()));
+	ASSERT (graph.nodes[1]->HasCalculatedValue ());
+
+	int sourceCalculationCount = graph.source->calculationCount;
+	ASSERT (evaluator.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == sourceCalculationCount);
+	ASSERT (IntValue::Get (evaluator.GetCalculatedNodeValue (graph.nodes[1]->GetId ())) == 7);
+}
+
+TEST (ConcurrentEvaluatorManualUpdateTest)
+{
+	TestChainGraph graph (2);
+	graph.manager.SetUpdateMode (NodeManager::UpdateMode::Manual);
+
+	ConcurrentEvaluator evaluator (graph.manager);
+	ASSERT (evaluator.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (IntValue::Get (evaluator.GetCalculatedNodeValue (graph.nodes[1]->GetId ())) == 7);
+	ASSERT (!graph.nodes[1]->HasCalculatedValue ());
+}
+
+TEST (EditWaitsForReadLockTest)
+{
+	TestChainGraph graph (2);
+	ASSERT (graph.manager.GetNodeCount () == 3);
+
+	graph.manager.GetGraphLock ().LockRead ();
+	std::atomic<bool> isAdded (false);
+	std::thread editorThread ([&] () {
+		graph.manager.AddNode (NodePtr (new TestIncreaseNode ()));
+		isAdded = true;
+	});
+	std::this_thread::sleep_for (std::chrono::milliseconds (50));
+	ASSERT (!isAdded);
+	ASSERT (graph.manager.GetNodeCount () == 3);
+	graph.manager.GetGraphLock ().UnlockRead ();
+
+	editorThread.join ();
+	ASSERT (isAdded);
+	ASSERT (graph.manager.GetNodeCount () == 4);
+}
+
+TEST (EditWaitsForEvaluationTest)
+{
+	TestChainGraph graph (2);
+	std::shared_ptr<BlockingNode> blockingNode (new BlockingNode ());
+	graph.manager.AddNode (blockingNode);
+
+	std::thread evaluatorThread ([&] () {
+		graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	});
+	while (!blockingNode->isCalculating) {
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+
+	std::atomic<bool> isAdded (false);
+	std::thread editorThread ([&] () {
+		graph.manager.AddNode (NodePtr (new TestIncreaseNode ()));
+		isAdded = true;
+	});
+	std::this_thread::sleep_for (std::chrono::milliseconds (50));
+	ASSERT (!isAdded);
+	blockingNode->isReleased = true;
+
+	evaluatorThread.join ();
+	editorThread.join ();
+	ASSERT (isAdded);
+	ASSERT (graph.manager.GetNodeCount () == 5);
+	ASSERT (IntValue::Get (blockingNode->GetCalculatedValue ()) == 1);
+}
+
+TEST (RecursiveReadLockTest)
+{
+	ReadWriteLock lock;
+	lock.LockRead ();
+
+	std::atomic<bool> isWritten (false);
+	std::thread writerThread ([&] () {
+		WriteLockGuard guard (lock);
+		isWritten = true;
+	});
+	std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+	// the waiting writer doesn't block the thread that already reads
+	lock.LockRead ();
+	ASSERT (!isWritten);
+	lock.UnlockRead ();
+	ASSERT (!isWritten);
+	lock.UnlockRead ();
+
+	writerThread.join ();
+	ASSERT (isWritten);
+}
+
+TEST (RecursiveWriteLockTest)
+{
+	ReadWriteLock lock;
+	lock.LockWrite ();
+	lock.LockWrite ();
+	lock.LockRead ();
+	lock.UnlockRead ();
+	lock.UnlockWrite ();
+	lock.UnlockWrite ();
+
+	std::atomic<bool> isLocked (false);
+	std::thread readerThread ([&] () {
+		ReadLockGuard guard (lock);
+		isLocked = true;
+	});
+	readerThread.join ();
+	ASSERT (isLocked);
+}
+
+TEST (WriteLockKeepsInnerReadLockTest)
+{
+	ReadWriteLock lock;
+	lock.LockWrite ();
+	lock.LockRead ();
+	lock.UnlockWrite ();
+
+	// the read lock taken inside the write lock still blocks the writers
+	std::atomic<bool> isWritten (false);
+	std::thread writerThread ([&] () {
+		WriteLockGuard guard (lock);
+		isWritten = true;
+	});
+	std::this_thread::sleep_for (std::chrono::milliseconds (50));
+	ASSERT (!isWritten);
+	lock.UnlockRead ();
+
+	writerThread.join ();
+	ASSERT (isWritten);
+}
+
+}
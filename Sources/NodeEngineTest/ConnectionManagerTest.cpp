@@ -0,0 +1,108 @@
+#include "SimpleTest.hpp"
+#include "NE_ConnectionManager.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+
+using namespace NE;
+
+namespace ConnectionManagerTest
+{
+
+static InputSlotConstPtr CreateInputSlot (const std::string& id, OutputSlotConnectionMode connectionMode)
+{
+	return InputSlotConstPtr (new InputSlot (SlotId (id), ValuePtr (new IntValue (0)), connectionMode));
+}
+
+static OutputSlotConstPtr CreateOutputSlot (const std::string& id)
+{
+	return OutputSlotConstPtr (new OutputSlot (SlotId (id)));
+}
+
+static std::vector<OutputSlotConstPtr> GetConnectedOutputSlots (const ConnectionManager& manager, const InputSlotConstPtr& inputSlot)
+{
+	std::vector<OutputSlotConstPtr> result;
+	manager.EnumerateConnectedOutputSlots (inputSlot, [&] (const OutputSlotConstPtr& outputSlot) {
+		result.push_back (outputSlot);
+	});
+	return result;
+}
+
+TEST (ConnectionCountTest)
+{
+	ConnectionManager manager;
+	InputSlotConstPtr inputSlot = CreateInputSlot ("in", OutputSlotConnectionMode::Multiple);
+	std::vector<OutputSlotConstPtr> outputSlots;
+	for (int i = 0; i < 10; i++) {
+		outputSlots.push_back (CreateOutputSlot ("out" + std::to_string (i)));
+		ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlots.back (), inputSlot));
+	}
+	ASSERT (!manager.IsEmpty ());
+	ASSERT (manager.GetConnectionCount () == 10);
+	ASSERT (manager.GetConnectedOutputSlotCount (inputSlot) == 10);
+	ASSERT (manager.GetConnectedInputSlotCount (outputSlots[0]) == 1);
+
+	ASSERT (manager.DisconnectAllOutputSlotsFromInputSlot (inputSlot));
+	ASSERT (manager.IsEmpty ());
+	ASSERT (manager.GetConnectionCount () == 0);
+	ASSERT (!manager.HasConnectedOutputSlots (inputSlot));
+	ASSERT (!manager.HasConnectedInputSlots (outputSlots[0]));
+}
+
+TEST (ConnectionOrderTest)
+{
+	ConnectionManager manager;
+	InputSlotConstPtr inputSlot = CreateInputSlot ("in", OutputSlotConnectionMode::Multiple);
+	OutputSlotConstPtr outputSlot1 = CreateOutputSlot ("out1");
+	OutputSlotConstPtr outputSlot2 = CreateOutputSlot ("out2");
+	OutputSlotConstPtr outputSlot3 = CreateOutputSlot ("out3");
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot1, inputSlot));
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot2, inputSlot));
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot3, inputSlot));
+
+	ASSERT (manager.DisconnectOutputSlotFromInputSlot (outputSlot1, inputSlot));
+	ASSERT (GetConnectedOutputSlots (manager, inputSlot) == std::vector<OutputSlotConstPtr> ({ outputSlot2, outputSlot3 }));
+
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot1, inputSlot));
+	ASSERT (GetConnectedOutputSlots (manager, inputSlot) == std::vector<OutputSlotConstPtr> ({ outputSlot2, outputSlot3, outputSlot1 }));
+	ASSERT (manager.IsOutputSlotConnectedToInputSlot (outputSlot1, inputSlot));
+	ASSERT (!manager.CanConnectOutputSlotToInputSlot (outputSlot1, inputSlot));
+	ASSERT (manager.GetConnectionCount () == 3);
+}
+
+TEST (SingleConnectionTest)
+{
+	ConnectionManager manager;
+	InputSlotConstPtr inputSlot = CreateInputSlot ("in", OutputSlotConnectionMode::Single);
+	OutputSlotConstPtr outputSlot1 = CreateOutputSlot ("out1");
+	OutputSlotConstPtr outputSlot2 = CreateOutputSlot ("out2");
+
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot1, inputSlot));
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot2, inputSlot));
+	ASSERT (manager.GetConnectionCount () == 1);
+	ASSERT (!manager.IsOutputSlotConnectedToInputSlot (outputSlot1, inputSlot));
+	ASSERT (manager.IsOutputSlotConnectedToInputSlot (outputSlot2, inputSlot));
+	ASSERT (!manager.HasConnectedInputSlots (outputSlot1));
+}
+
+TEST (ReleaseDisconnectedSlotsTest)
+{
+	ConnectionManager manager;
+	InputSlotConstPtr inputSlot = CreateInputSlot ("in", OutputSlotConnectionMode::Multiple);
+	OutputSlotConstPtr outputSlot = CreateOutputSlot ("out");
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot, inputSlot));
+	ASSERT (inputSlot.use_count () == 2);
+	ASSERT (outputSlot.use_count () == 2);
+
+	ASSERT (manager.DisconnectAllInputSlotsFromOutputSlot (outputSlot));
+	ASSERT (inputSlot.use_count () == 1);
+	ASSERT (outputSlot.use_count () == 1);
+
+	InputSlotConstPtr inputSlot2 = CreateInputSlot ("in2", OutputSlotConnectionMode::Multiple);
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot, inputSlot2));
+	ASSERT (manager.ConnectOutputSlotToInputSlot (outputSlot, inputSlot));
+	ASSERT (manager.GetConnectedInputSlotCount (outputSlot) == 2);
+	ASSERT (manager.GetConnectionCount () == 2);
+}
+
+}
@@ -0,0 +1,167 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "NUIE_NodeUIManager.hpp"
+#include "BI_InputUINodes.hpp"
+#include "BI_BinaryOperationNodes.hpp"
+#include "SvgDrawingContext.hpp"
+#include "TestNodes.hpp"
+#include "TestUtils.hpp"
+
+using namespace NE;
+using namespace NUIE;
+using namespace BI;
+
+namespace DemandEvaluationTest
+{
+
+class DrawingTestUIEnvironment : public TestUIEnvironment
+{
+public:
+	DrawingTestUIEnvironment () :
+		TestUIEnvironment (),
+		drawingContext (800, 600)
+	{
+
+	}
+
+	virtual DrawingContext& GetDrawingContext () override
+	{
+		return drawingContext;
+	}
+
+private:
+	SvgDrawingContext drawingContext;
+};
+
+class BranchingGraph
+{
+public:
+	BranchingGraph () :
+		manager (),
+		source (new TestSourceNode (5)),
+		node1 (new TestIncreaseNode ()),
+		node2 (new TestIncreaseNode ()),
+		node3 (new TestIncreaseNode ()),
+		node4 (new TestIncreaseNode ())
+	{
+		// source -> node1 -> node2
+		//        -> node3 -> node4
+		manager.AddNode (source);
+		manager.AddNode (node1);
+		manager.AddNode (node2);
+		manager.AddNode (node3);
+		manager.AddNode (node4);
+		ConnectTestNodes (manager, source, node1);
+		ConnectTestNodes (manager, node1, node2);
+		ConnectTestNodes (manager, source, node3);
+		ConnectTestNodes (manager, node3, node4);
+	}
+
+	NodeManager							manager;
+	std::shared_ptr<TestSourceNode>		source;
+	std::shared_ptr<TestIncreaseNode>	node1;
+	std::shared_ptr<TestIncreaseNode>	node2;
+	std::shared_ptr<TestIncreaseNode>	node3;
+	std::shared_ptr<TestIncreaseNode>	node4;
+};
+
+TEST (EvaluateNodesTest)
+{
+	BranchingGraph graph;
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection ({ graph.node2->GetId () }), EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == 1);
+	ASSERT (graph.node1->calculationCount == 1);
+	ASSERT (graph.node2->calculationCount == 1);
+	ASSERT (graph.node3->calculationCount == 0);
+	ASSERT (graph.node4->calculationCount == 0);
+	ASSERT (IntValue::Get (graph.node2->GetCalculatedValue ()) == 7);
+	ASSERT (!graph.node4->HasCalculatedValue ());
+
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection ({ graph.node3->GetId () }), EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == 1);
+	ASSERT (graph.node3->calculationCount == 1);
+	ASSERT (graph.node4->calculationCount == 0);
+
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (graph.node2->calculationCount == 1);
+	ASSERT (graph.node4->calculationCount == 1);
+}
+
+TEST (EvaluateNodesEmptyCollectionTest)
+{
+	BranchingGraph graph;
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection (), EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == 0);
+
+	NodeId deletedNodeId = graph.node4->GetId ();
+	ASSERT (graph.manager.DeleteNode (deletedNodeId));
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection ({ deletedNodeId }), EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == 0);
+}
+
+TEST (EvaluateNodesParallelTest)
+{
+	BranchingGraph graph;
+	graph.manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection ({ graph.node2->GetId (), graph.node3->GetId () }), EmptyEvaluationEnv));
+	ASSERT (graph.source->calculationCount == 1);
+	ASSERT (graph.node2->calculationCount == 1);
+	ASSERT (graph.node3->calculationCount == 1);
+	ASSERT (graph.node4->calculationCount == 0);
+}
+
+TEST (EvaluateNodesBoundedCacheTest)
+{
+	BranchingGraph graph;
+	graph.manager.SetNodeValueCacheMaxMemorySize (1);
+	ASSERT (graph.manager.EvaluateNodes (NodeCollection ({ graph.node2->GetId () }), EmptyEvaluationEnv));
+	ASSERT (graph.node2->calculationCount == 1);
+	ASSERT (graph.node4->calculationCount == 0);
+
+	// unrequested dependents do not keep their inputs in the cache
+	ASSERT (graph.manager.IsNodeValueEvicted (graph.source->GetId ()));
+}
+
+TEST (NodeUIManagerObservedNodesTest)
+{
+	DrawingTestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	UINodePtr intNode (new IntegerUpDownNode (LocString (L"Integer"), Point (100, 100), 5, 1));
+	UINodePtr visibleNode (new AdditionNode (LocString (L"Visible"), Point (300, 100)));
+	UINodePtr hiddenNode (new AdditionNode (LocString (L"Hidden"), Point (5000, 5000)));
+	uiManager.AddNode (intNode);
+	uiManager.AddNode (visibleNode);
+	uiManager.AddNode (hiddenNode);
+	uiManager.ConnectOutputSlotToInputSlot (intNode->GetUIOutputSlot (SlotId ("out")), visibleNode->GetUIInputSlot (SlotId ("a")));
+	uiManager.ConnectOutputSlotToInputSlot (intNode->GetUIOutputSlot (SlotId ("out")), hiddenNode->GetUIInputSlot (SlotId ("a")));
+
+	NodeCollection visibleNodes = uiManager.GetVisibleNodes (env);
+	ASSERT (visibleNodes.Contains (intNode->GetId ()));
+	ASSERT (visibleNodes.Contains (visibleNode->GetId ()));
+	ASSERT (!visibleNodes.Contains (hiddenNode->GetId ()));
+
+	uiManager.SetEvaluationScope (NodeUIManager::EvaluationScope::ObservedNodes);
+	uiManager.SetObservedNodes (visibleNodes);
+	uiManager.Update (env);
+	ASSERT (DoubleValue::Get (visibleNode->GetCalculatedValue ()) == 5.0);
+	ASSERT (!hiddenNode->HasCalculatedValue ());
+
+	uiManager.SetObservedNodes (NodeCollection ({ hiddenNode->GetId () }));
+	uiManager.Update (env);
+	ASSERT (DoubleValue::Get (hiddenNode->GetCalculatedValue ()) == 5.0);
+
+	uiManager.SetEvaluationMode (NodeUIManager::EvaluationMode::Background);
+	uiManager.InvalidateNodeValue (intNode);
+	uiManager.SetObservedNodes (NodeCollection ({ visibleNode->GetId () }));
+	uiManager.Update (env);
+	uiManager.WaitForBackgroundEvaluation (env);
+	ASSERT (visibleNode->HasCalculatedValue ());
+	ASSERT (!hiddenNode->HasCalculatedValue ());
+}
+
+}
@@ -3,6 +3,7 @@
 #include "TestNodes.hpp"
 
 #include "NE_SingleValues.hpp"
+#include "NE_LazyListValues.hpp"
 #include "NUIE_NodeUIManager.hpp"
 #include "NUIE_UIDispatcherOutputSlot.hpp"
 
@@ -38,6 +39,31 @@ public:
 	}
 };
 
+class RangeDispatcherNode : public SerializableTestUINode
+{
+public:
+	RangeDispatcherNode (const LocString& name, const Point& position) :
+		SerializableTestUINode (name, position)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterUIOutputSlot (UIOutputSlotPtr (new UIDispatcherOutputSlot (SlotId ("head"), NE::LocString (L"Head"), 0, 2)));
+		RegisterUIOutputSlot (UIOutputSlotPtr (new UIDispatcherOutputSlot (SlotId ("tail"), NE::LocString (L"Tail"), 2, 10)));
+	}
+
+	virtual ValueConstPtr Calculate (EvaluationEnv&) const override
+	{
+		ListValuePtr listVal (new ListValue ());
+		for (int i = 0; i < 5; i++) {
+			listVal->Push (ValueConstPtr (new IntValue (i)));
+		}
+		return listVal;
+	}
+};
+
 class ValueNode : public SerializableTestUINode
 {
 public:
@@ -121,4 +147,31 @@ TEST (DispatcherOutputSlotEvaluationTest)
 	ASSERT (Value::IsType<StringValue> (val2) && StringValue::Get (val2) == L"test");
 }
 
+TEST (DispatcherOutputSlotRangeTest)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	UINodePtr dispatcherNode (new RangeDispatcherNode (LocString (L"Node"), Point (0.0, 0.0)));
+	UINodePtr valueNode1 (new ValueNode (LocString (L"Node"), Point (0.0, 0.0)));
+	UINodePtr valueNode2 (new ValueNode (LocString (L"Node"), Point (0.0, 0.0)));
+
+	ASSERT (uiManager.AddNode (dispatcherNode) != nullptr);
+	ASSERT (uiManager.AddNode (valueNode1) != nullptr);
+	ASSERT (uiManager.AddNode (valueNode2) != nullptr);
+
+	ASSERT (uiManager.ConnectOutputSlotToInputSlot (dispatcherNode->GetUIOutputSlot (SlotId ("head")), valueNode1->GetUIInputSlot (SlotId ("in"))));
+	ASSERT (uiManager.ConnectOutputSlotToInputSlot (dispatcherNode->GetUIOutputSlot (SlotId ("tail")), valueNode2->GetUIInputSlot (SlotId ("in"))));
+
+	TestCalcEnvironment calcEnv;
+	uiManager.Update (calcEnv);
+
+	NE::ValueConstPtr val1 = valueNode1->GetCalculatedValue ();
+	NE::ValueConstPtr val2 = valueNode2->GetCalculatedValue ();
+	ASSERT (Value::IsType<ListSliceValue> (val1));
+	ASSERT (Value::IsType<ListSliceValue> (val2));
+	ASSERT (val1->ToString (GetDefaultStringConverter ()) == L"0, 1");
+	ASSERT (val2->ToString (GetDefaultStringConverter ()) == L"2, 3, 4");
+}
+
 }
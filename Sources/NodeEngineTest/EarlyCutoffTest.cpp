@@ -0,0 +1,181 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+
+namespace EarlyCutoffTest
+{
+
+class ClampNode : public SerializableTestNode
+{
+public:
+	ClampNode (int maxValue) :
+		SerializableTestNode (),
+		maxValue (maxValue),
+		calculationCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		return ValuePtr (new IntValue (std::min (IntValue::Get (in), maxValue)));
+	}
+
+	int				maxValue;
+	mutable int		calculationCount;
+};
+
+class TestGraph
+{
+public:
+	TestGraph (NodeManager& manager) :
+		source (new TestSourceNode (20)),
+		clamp (new ClampNode (10)),
+		sum1 (new TestSumNode ()),
+		sum2 (new TestSumNode ())
+	{
+		// source -> clamp -> sum1 -> sum2
+		//       \______________________/
+		manager.AddNode (source);
+		manager.AddNode (clamp);
+		manager.AddNode (sum1);
+		manager.AddNode (sum2);
+		ConnectTestNodes (manager, source, clamp);
+		ConnectTestNodes (manager, clamp, sum1);
+		ConnectTestNodes (manager, sum1, sum2);
+		ConnectTestNodes (manager, source, sum2);
+	}
+
+	std::shared_ptr<TestSourceNode>	source;
+	std::shared_ptr<ClampNode>		clamp;
+	std::shared_ptr<TestSumNode>	sum1;
+	std::shared_ptr<TestSumNode>	sum2;
+};
+
+TEST (EagerInvalidationTest)
+{
+	NodeManager manager;
+	TestGraph graph (manager);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 30);
+
+	graph.source->SetValue (30);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 40);
+	ASSERT (graph.clamp->calculationCount == 2);
+	ASSERT (graph.sum1->calculationCount == 2);
+	ASSERT (graph.sum2->calculationCount == 2);
+}
+
+TEST (EarlyCutoffUnchangedValueTest)
+{
+	NodeManager manager;
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	TestGraph graph (manager);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 30);
+
+	graph.source->SetValue (30);
+	ASSERT (graph.sum1->GetCalculationStatus () == Node::CalculationStatus::NeedToCalculate);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum1->GetCalculatedValue ()) == 10);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 40);
+	ASSERT (graph.source->calculationCount == 2);
+	ASSERT (graph.clamp->calculationCount == 2);
+	ASSERT (graph.sum1->calculationCount == 1);
+	ASSERT (graph.sum2->calculationCount == 2);
+
+	graph.source->SetValue (5);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 10);
+	ASSERT (graph.clamp->calculationCount == 3);
+	ASSERT (graph.sum1->calculationCount == 2);
+	ASSERT (graph.sum2->calculationCount == 3);
+}
+
+TEST (EarlyCutoffValueProcessingTest)
+{
+	// a reused value is processed like a calculated one, so the node can react to it
+	NodeManager manager;
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	TestGraph graph (manager);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (graph.sum1->processCount == 1);
+
+	graph.source->SetValue (30);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (graph.sum1->calculationCount == 1);
+	ASSERT (graph.sum1->processCount == 2);
+	ASSERT (graph.sum2->processCount == 2);
+}
+
+TEST (EarlyCutoffOnDemandEvaluationTest)
+{
+	NodeManager manager;
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	TestGraph graph (manager);
+	ASSERT (IntValue::Get (graph.sum1->Evaluate (EmptyEvaluationEnv)) == 10);
+
+	graph.source->SetValue (15);
+	graph.source->SetValue (25);
+	ASSERT (IntValue::Get (graph.sum1->Evaluate (EmptyEvaluationEnv)) == 10);
+	ASSERT (graph.clamp->calculationCount == 2);
+	ASSERT (graph.sum1->calculationCount == 1);
+	ASSERT (IntValue::Get (graph.sum2->Evaluate (EmptyEvaluationEnv)) == 35);
+	ASSERT (graph.sum2->calculationCount == 1);
+}
+
+TEST (EarlyCutoffStructureChangeTest)
+{
+	NodeManager manager;
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	TestGraph graph (manager);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 30);
+
+	ASSERT (manager.DeleteNode (graph.clamp));
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum1->GetCalculatedValue ()) == 0);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 20);
+
+	ASSERT (ConnectTestNodes (manager, graph.source, graph.sum1));
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.sum2->GetCalculatedValue ()) == 40);
+}
+
+TEST (ValueEqualityTest)
+{
+	ASSERT (Value::IsEqual (nullptr, nullptr));
+	ASSERT (!Value::IsEqual (ValuePtr (new IntValue (1)), nullptr));
+	ASSERT (Value::IsEqual (ValuePtr (new IntValue (1)), ValuePtr (new IntValue (1))));
+	ASSERT (!Value::IsEqual (ValuePtr (new IntValue (1)), ValuePtr (new IntValue (2))));
+	ASSERT (!Value::IsEqual (ValuePtr (new IntValue (0)), ValuePtr (new FloatValue (0.0f))));
+	ASSERT (Value::IsEqual (ValuePtr (new StringValue (L"a")), ValuePtr (new StringValue (L"a"))));
+
+	ListValuePtr list1 (new ListValue ());
+	list1->Push (ValuePtr (new IntValue (1)));
+	list1->Push (nullptr);
+	ListValuePtr list2 (new ListValue ());
+	list2->Push (ValuePtr (new IntValue (1)));
+	ASSERT (!Value::IsEqual (list1, list2));
+	list2->Push (nullptr);
+	ASSERT (Value::IsEqual (list1, list2));
+	list2->Push (ValuePtr (new IntValue (2)));
+	ASSERT (!Value::IsEqual (list1, list2));
+}
+
+}
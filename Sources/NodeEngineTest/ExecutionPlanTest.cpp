@@ -0,0 +1,111 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+
+namespace ExecutionPlanTest
+{
+
+class IncreaseNode : public SerializableTestNode
+{
+public:
+	IncreaseNode (std::vector<NodeId>* calculatedNodes) :
+		SerializableTestNode (),
+		calculatedNodes (calculatedNodes)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		return ValuePtr (new IntValue (IntValue::Get (in) + 1));
+	}
+
+	virtual void ProcessCalculatedValue (const ValueConstPtr&, EvaluationEnv&) const override
+	{
+		if (calculatedNodes != nullptr) {
+			calculatedNodes->push_back (GetId ());
+		}
+	}
+
+private:
+	std::vector<NodeId>* calculatedNodes;
+};
+
+static bool Connect (NodeManager& manager, const NodePtr& beg, const NodePtr& end)
+{
+	return manager.ConnectOutputSlotToInputSlot (beg->GetOutputSlot (SlotId ("out")), end->GetInputSlot (SlotId ("in")));
+}
+
+TEST (ExecutionPlanLongChainTest)
+{
+	// evaluating the last node recursively would need a stack frame chain for every node
+	const size_t nodeCount = 50000;
+
+	NodeManager manager;
+	std::vector<NodePtr> nodes;
+	for (size_t i = 0; i < nodeCount; ++i) {
+		nodes.push_back (manager.AddNode (NodePtr (new IncreaseNode (nullptr))));
+	}
+	for (size_t i = 1; i < nodeCount; ++i) {
+		ASSERT (Connect (manager, nodes[i - 1], nodes[i]));
+	}
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (nodes[0]->GetCalculatedValue ()) == 1);
+	ASSERT (IntValue::Get (nodes[nodeCount - 1]->GetCalculatedValue ()) == (int) nodeCount);
+
+	manager.InvalidateNodeValue (nodes[0]);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (nodes[nodeCount - 1]->GetCalculatedValue ()) == (int) nodeCount);
+}
+
+TEST (ExecutionPlanRebuildTest)
+{
+	std::vector<NodeId> calculatedNodes;
+
+	NodeManager manager;
+	NodePtr node1 = manager.AddNode (NodePtr (new IncreaseNode (&calculatedNodes)));
+	NodePtr node2 = manager.AddNode (NodePtr (new IncreaseNode (&calculatedNodes)));
+	NodePtr node3 = manager.AddNode (NodePtr (new IncreaseNode (&calculatedNodes)));
+
+	ASSERT (Connect (manager, node1, node2));
+	ASSERT (Connect (manager, node2, node3));
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculatedNodes == std::vector<NodeId> ({ node1->GetId (), node2->GetId (), node3->GetId () }));
+	ASSERT (IntValue::Get (node3->GetCalculatedValue ()) == 3);
+
+	ASSERT (manager.DisconnectOutputSlotFromInputSlot (node1->GetOutputSlot (SlotId ("out")), node2->GetInputSlot (SlotId ("in"))));
+	ASSERT (Connect (manager, node3, node1));
+	calculatedNodes.clear ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculatedNodes == std::vector<NodeId> ({ node2->GetId (), node3->GetId (), node1->GetId () }));
+	ASSERT (IntValue::Get (node1->GetCalculatedValue ()) == 3);
+
+	NodePtr node4 = manager.AddNode (NodePtr (new IncreaseNode (&calculatedNodes)));
+	ASSERT (Connect (manager, node1, node4));
+	calculatedNodes.clear ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculatedNodes == std::vector<NodeId> ({ node4->GetId () }));
+	ASSERT (IntValue::Get (node4->GetCalculatedValue ()) == 4);
+
+	ASSERT (manager.DeleteNode (node3));
+	calculatedNodes.clear ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculatedNodes == std::vector<NodeId> ({ node1->GetId (), node4->GetId () }));
+	ASSERT (IntValue::Get (node4->GetCalculatedValue ()) == 2);
+}
+
+}
@@ -0,0 +1,136 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_ExecutionProgram.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+
+namespace ExecutionProgramTest
+{
+
+class TestGraph
+{
+public:
+	TestGraph () :
+		manager (),
+		source (new TestSourceNode (5)),
+		increase1 (new TestIncreaseNode ()),
+		increase2 (new TestIncreaseNode ()),
+		increase3 (new TestIncreaseNode ()),
+		sum (new TestSumNode ())
+	{
+		// source -> increase1 -> sum
+		//        -> increase2 -> sum
+		// increase3 -> sum
+		manager.AddNode (source);
+		manager.AddNode (increase1);
+		manager.AddNode (increase2);
+		manager.AddNode (increase3);
+		manager.AddNode (sum);
+		ConnectTestNodes (manager, source, increase1);
+		ConnectTestNodes (manager, source, increase2);
+		ConnectTestNodes (manager, increase1, sum);
+		ConnectTestNodes (manager, increase2, sum);
+		ConnectTestNodes (manager, increase3, sum);
+		CountingTestNode::totalCalculationCount = 0;
+	}
+
+	NodeManager							manager;
+	std::shared_ptr<TestSourceNode>		source;
+	std::shared_ptr<TestIncreaseNode>	increase1;
+	std::shared_ptr<TestIncreaseNode>	increase2;
+	std::shared_ptr<TestIncreaseNode>	increase3;
+	std::shared_ptr<TestSumNode>		sum;
+};
+
+TEST (CompileAndRunTest)
+{
+	TestGraph graph;
+	ExecutionProgram program;
+	ASSERT (program.IsEmpty ());
+	ASSERT (program.Compile (graph.manager));
+	ASSERT (!program.IsEmpty ());
+	ASSERT (program.GetInstructionCount () == 5);
+	ASSERT (program.ContainsNode (graph.sum->GetId ()));
+
+	size_t sumIndex = program.GetNodeIndex (graph.sum->GetId ());
+	ASSERT (!program.HasNodeValue (sumIndex));
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (CountingTestNode::totalCalculationCount == 5);
+	ASSERT (program.HasNodeValue (sumIndex));
+	ASSERT (IntValue::Get (program.GetNodeValue (sumIndex)) == 13);
+
+	// the original graph is not evaluated
+	ASSERT (!graph.sum->HasCalculatedValue ());
+
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (IntValue::Get (graph.sum->GetCalculatedValue ()) == IntValue::Get (program.GetNodeValue (sumIndex)));
+}
+
+TEST (RunOnlyInvalidatedInstructionsTest)
+{
+	TestGraph graph;
+	ExecutionProgram program;
+	ASSERT (program.Compile (graph.manager));
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (CountingTestNode::totalCalculationCount == 5);
+
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (CountingTestNode::totalCalculationCount == 5);
+
+	size_t increase3Index = program.GetNodeIndex (graph.increase3->GetId ());
+	size_t sumIndex = program.GetNodeIndex (graph.sum->GetId ());
+	ASSERT (program.SetInputSlotDefaultValue (increase3Index, SlotId ("in"), ValuePtr (new IntValue (10))));
+	ASSERT (!program.HasNodeValue (increase3Index));
+	ASSERT (!program.HasNodeValue (sumIndex));
+	ASSERT (program.HasNodeValue (program.GetNodeIndex (graph.increase1->GetId ())));
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (CountingTestNode::totalCalculationCount == 7);
+	ASSERT (IntValue::Get (program.GetNodeValue (sumIndex)) == 23);
+
+	// the original graph keeps its own input values
+	ASSERT (IntValue::Get (graph.increase3->GetInputSlotDefaultValue (SlotId ("in"))) == 0);
+
+	program.InvalidateAllNodeValues ();
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (CountingTestNode::totalCalculationCount == 12);
+	ASSERT (IntValue::Get (program.GetNodeValue (sumIndex)) == 23);
+}
+
+TEST (RecompileTest)
+{
+	TestGraph graph;
+	ExecutionProgram program;
+	ASSERT (program.Compile (graph.manager));
+	ASSERT (program.Run (EmptyEvaluationEnv));
+
+	ASSERT (graph.manager.DeleteNode (graph.increase3->GetId ()));
+	ASSERT (program.Compile (graph.manager));
+	ASSERT (program.GetInstructionCount () == 4);
+	ASSERT (program.Run (EmptyEvaluationEnv));
+	ASSERT (IntValue::Get (program.GetNodeValue (program.GetNodeIndex (graph.sum->GetId ()))) == 12);
+
+	program.Clear ();
+	ASSERT (program.IsEmpty ());
+}
+
+TEST (CancelledRunTest)
+{
+	TestGraph graph;
+	ExecutionProgram program;
+	ASSERT (program.Compile (graph.manager));
+
+	EvaluationEnv env (nullptr);
+	CancellationTokenPtr token (new CancellationToken ());
+	env.SetCancellationToken (token);
+	token->Cancel ();
+	ASSERT (!program.Run (env));
+	ASSERT (CountingTestNode::totalCalculationCount == 0);
+
+	token->Reset ();
+	ASSERT (program.Run (env));
+	ASSERT (CountingTestNode::totalCalculationCount == 5);
+}
+
+}
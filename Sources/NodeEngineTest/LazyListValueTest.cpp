@@ -0,0 +1,260 @@
+#include "SimpleTest.hpp"
+#include "NE_Value.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_LazyListValues.hpp"
+#include "NE_MemoryStream.hpp"
+
+#include <limits>
+
+using namespace NE;
+
+namespace LazyListValueTest
+{
+
+static const BasicStringConverter DefaultStringConverter = GetDefaultStringConverter ();
+
+static ValueConstPtr CalculateSum (const ValueCombination& combination)
+{
+	int sum = 0;
+	for (size_t i = 0; i < combination.GetSize (); i++) {
+		sum += IntValue::Get (combination.GetValue (i));
+	}
+	return ValuePtr (new IntValue (sum));
+}
+
+static std::vector<int> GetEagerResult (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values)
+{
+	std::vector<int> result;
+	CombineValues (combinationMode, values, [&] (const ValueCombination& combination) {
+		result.push_back (IntValue::Get (CalculateSum (combination)));
+		return true;
+	});
+	return result;
+}
+
+static std::vector<int> GetLazyResult (ValueCombinationMode combinationMode, const std::vector<ValueConstPtr>& values, size_t chunkSize)
+{
+	std::vector<int> result;
+	CombinationListValue lazyList (combinationMode, values, CalculateSum, true, chunkSize);
+	for (size_t i = 0; i < lazyList.GetSize (); i++) {
+		result.push_back (IntValue::Get (lazyList.GetValue (i)));
+	}
+	return result;
+}
+
+TEST (CombinationIndicesTest)
+{
+	std::vector<size_t> indices;
+	size_t count = 0;
+	ASSERT (GetCombinationCount (ValueCombinationMode::Shortest, { 2, 3 }, count) && count == 2);
+	ASSERT (GetCombinationCount (ValueCombinationMode::Longest, { 2, 3 }, count) && count == 3);
+	ASSERT (GetCombinationCount (ValueCombinationMode::CrossProduct, { 2, 3, 4 }, count) && count == 24);
+
+	size_t largeSize = std::numeric_limits<size_t>::max () / 2;
+	ASSERT (GetCombinationCount (ValueCombinationMode::Longest, { largeSize, largeSize, 3 }, count) && count == largeSize);
+	ASSERT (!GetCombinationCount (ValueCombinationMode::CrossProduct, { largeSize, largeSize, 3 }, count));
+	ASSERT (!GetCombinationCount (ValueCombinationMode::CrossProduct, { largeSize, 3 }, count));
+	ASSERT (GetCombinationCount (ValueCombinationMode::CrossProduct, { largeSize, 2 }, count) && count == largeSize * 2);
+
+	GetCombinationIndices (ValueCombinationMode::Longest, { 2, 3 }, 2, indices);
+	ASSERT (indices == std::vector<size_t> ({ 1, 2 }));
+	GetCombinationIndices (ValueCombinationMode::CrossProduct, { 2, 3, 4 }, 23, indices);
+	ASSERT (indices == std::vector<size_t> ({ 1, 2, 3 }));
+	GetCombinationIndices (ValueCombinationMode::CrossProduct, { 2, 3, 4 }, 5, indices);
+	ASSERT (indices == std::vector<size_t> ({ 0, 1, 1 }));
+}
+
+TEST (CombinationListValueTest)
+{
+	std::vector<ValueConstPtr> values = {
+		ValuePtr (new IntListValue ({ 1, 2, 3 })),
+		ValuePtr (new IntValue (10)),
+		ValuePtr (new IntListValue ({ 100, 200, 300, 400, 500 }))
+	};
+
+	std::vector<ValueCombinationMode> modes = {
+		ValueCombinationMode::Shortest,
+		ValueCombinationMode::Longest,
+		ValueCombinationMode::CrossProduct
+	};
+	for (ValueCombinationMode mode : modes) {
+		std::vector<int> eagerResult = GetEagerResult (mode, values);
+		ASSERT (GetLazyResult (mode, values, 0) == eagerResult);
+		ASSERT (GetLazyResult (mode, values, 1) == eagerResult);
+		ASSERT (GetLazyResult (mode, values, 4) == eagerResult);
+	}
+}
+
+TEST (CombinationListValueInterfaceTest)
+{
+	ValuePtr lazyList (new CombinationListValue (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue ({ 1, 2 })),
+		ValuePtr (new IntListValue ({ 10, 20 }))
+	}, CalculateSum, true, 0));
+
+	ASSERT (IsListValue (lazyList));
+	ASSERT (!IsSingleValue (lazyList));
+	ASSERT (Value::IsType<LazyListValue> (lazyList));
+	ASSERT (Value::IsType<CombinationListValue> (lazyList));
+	ASSERT (!Value::IsType<ListValue> (lazyList));
+	ASSERT (IsComplexType<IntValue> (lazyList));
+	ASSERT (lazyList->ToString (DefaultStringConverter) == L"11, 21, 12, 22");
+
+	ValuePtr clonedList = lazyList->Clone ();
+	ASSERT (Value::IsType<CombinationListValue> (clonedList));
+	ASSERT (Value::IsEqual (lazyList, clonedList));
+
+	ListValuePtr materializedList = Value::Cast<LazyListValue> (lazyList)->Materialize ();
+	ASSERT (materializedList->GetSize () == 4);
+	ASSERT (Value::IsEqual (lazyList, materializedList));
+}
+
+TEST (CombinationListValueSerializationTest)
+{
+	ValuePtr lazyList (new CombinationListValue (ValueCombinationMode::Longest, {
+		ValuePtr (new IntListValue ({ 1, 2, 3 })),
+		ValuePtr (new IntValue (10))
+	}, CalculateSum, true, 2));
+
+	MemoryOutputStream outputStream;
+	ASSERT (WriteDynamicObject (outputStream, lazyList.get ()));
+
+	MemoryInputStream inputStream (outputStream.GetBuffer ());
+	ValuePtr readValue (ReadDynamicObject<Value> (inputStream));
+	ASSERT (Value::IsType<ListValue> (readValue));
+	ASSERT (Value::IsEqual (lazyList, readValue));
+}
+
+TEST (ChunkedMaterializationTest)
+{
+	CombinationListValue lazyList (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue (std::vector<int> (100, 1))),
+		ValuePtr (new IntListValue (std::vector<int> (100, 2)))
+	}, CalculateSum, true, 10);
+
+	ASSERT (lazyList.GetChunkSize () == 10);
+	ASSERT (lazyList.GetMaterializedChunkCount () == 0);
+	ASSERT (IntValue::Get (lazyList.GetValue (5)) == 3);
+	ASSERT (lazyList.GetMaterializedChunkCount () == 1);
+	ASSERT (IntValue::Get (lazyList.GetValue (9)) == 3);
+	ASSERT (lazyList.GetMaterializedChunkCount () == 1);
+	ASSERT (IntValue::Get (lazyList.GetValue (9999)) == 3);
+	ASSERT (lazyList.GetMaterializedChunkCount () == 2);
+
+	size_t itemCount = 0;
+	lazyList.Enumerate ([&] (const ValueConstPtr& value) {
+		if (IntValue::Get (value) == 3) {
+			itemCount++;
+		}
+		return true;
+	});
+	ASSERT (itemCount == 10000);
+	ASSERT (lazyList.GetMaterializedChunkCount () < 1000);
+}
+
+TEST (ListEqualityTest)
+{
+	// typed, lazy and generic lists with the same items are equal and have the same hash
+	ValuePtr intList (new IntListValue ({ 3, 4, 4, 5 }));
+	ValuePtr otherIntList (new IntListValue ({ 3, 4, 4, 5 }));
+	ValuePtr lazyList (new CombinationListValue (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue ({ 1, 2 })),
+		ValuePtr (new IntListValue ({ 2, 3 }))
+	}, CalculateSum, true, 0));
+	ListValuePtr list (new ListValue ());
+	for (int item : { 3, 4, 4, 5 }) {
+		list->Push (ValuePtr (new IntValue (item)));
+	}
+
+	std::vector<ValueConstPtr> equalValues = { intList, otherIntList, lazyList, list };
+	for (const ValueConstPtr& aValue : equalValues) {
+		for (const ValueConstPtr& bValue : equalValues) {
+			ASSERT (Value::IsEqual (aValue, bValue));
+			ASSERT (Value::GenerateHashValue (aValue) == Value::GenerateHashValue (bValue));
+		}
+	}
+
+	ValuePtr differentIntList (new IntListValue ({ 3, 4, 4, 6 }));
+	ValuePtr doubleList (new DoubleListValue ({ 3.0, 4.0, 4.0, 5.0 }));
+	ASSERT (!Value::IsEqual (intList, differentIntList));
+	ASSERT (!Value::IsEqual (lazyList, differentIntList));
+	ASSERT (!Value::IsEqual (intList, doubleList));
+	ASSERT (Value::IsEqual (doubleList, ValuePtr (new DoubleListValue ({ 3.0, 4.0, 4.0, 5.0 }))));
+	ASSERT (!Value::IsEqual (ValuePtr (new BooleanListValue ({ true, false })), ValuePtr (new BooleanListValue ({ true, true }))));
+}
+
+TEST (LargeCrossProductTest)
+{
+	std::vector<int> items;
+	for (int i = 0; i < 5000; i++) {
+		items.push_back (i);
+	}
+
+	CombinationListValue lazyList (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue (items)),
+		ValuePtr (new IntListValue (items))
+	}, CalculateSum, true, 1024);
+
+	ASSERT (lazyList.GetSize () == 25000000);
+	ASSERT (IntValue::Get (lazyList.GetValue (0)) == 0);
+	ASSERT (IntValue::Get (lazyList.GetValue (5001)) == 2);
+	ASSERT (IntValue::Get (lazyList.GetValue (24999999)) == 9998);
+	ASSERT (lazyList.GetMemorySize () < 1024 * 1024);
+}
+
+TEST (LargeCrossProductEqualityTest)
+{
+	std::vector<int> items;
+	for (int i = 0; i < 5000; i++) {
+		items.push_back (i);
+	}
+	std::vector<int> otherItems (items);
+	otherItems[1] = -1;
+
+	// the comparison stops at the first different item, and it doesn't hold the items
+	ValuePtr lazyList (new CombinationListValue (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue (items)),
+		ValuePtr (new IntListValue (items))
+	}, CalculateSum, true, 1024));
+	ValuePtr otherLazyList (new CombinationListValue (ValueCombinationMode::CrossProduct, {
+		ValuePtr (new IntListValue (items)),
+		ValuePtr (new IntListValue (otherItems))
+	}, CalculateSum, true, 1024));
+	ASSERT (!Value::IsEqual (lazyList, otherLazyList));
+	ASSERT (lazyList->GetMemorySize () < 1024 * 1024);
+	ASSERT (otherLazyList->GetMemorySize () < 1024 * 1024);
+}
+
+TEST (ListSliceValueTest)
+{
+	ValuePtr list (new IntListValue ({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+
+	ValueConstPtr slice = CreateListSlice (list, 2, 3, 1);
+	ASSERT (Value::IsType<ListSliceValue> (slice));
+	ASSERT (IsComplexType<IntValue> (slice));
+	ASSERT (slice->ToString (DefaultStringConverter) == L"2, 3, 4");
+
+	ValueConstPtr stridedSlice = CreateListSlice (list, 1, 100, 3);
+	ASSERT (stridedSlice->ToString (DefaultStringConverter) == L"1, 4, 7");
+
+	ValueConstPtr nestedSlice = CreateListSlice (stridedSlice, 1, 2, 1);
+	ASSERT (nestedSlice->ToString (DefaultStringConverter) == L"4, 7");
+	ASSERT (Value::Cast<ListSliceValue> (nestedSlice.get ())->GetSourceValue () == list);
+
+	ValueConstPtr emptySlice = CreateListSlice (list, 20, 5, 1);
+	ASSERT (Value::Cast<IListValue> (emptySlice.get ())->GetSize () == 0);
+
+	ValuePtr clonedSlice = slice->Clone ();
+	ASSERT (Value::IsEqual (slice, clonedSlice));
+}
+
+TEST (ListSliceValueNoCopyTest)
+{
+	ValuePtr list (new DoubleListValue (std::vector<double> (100000, 1.0)));
+	ValueConstPtr slice = CreateListSlice (list, 1000, 50000, 1);
+	ASSERT (Value::Cast<IListValue> (slice.get ())->GetSize () == 50000);
+	ASSERT (slice->GetMemorySize () < 1024);
+}
+
+}
@@ -0,0 +1,283 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_MemoryStream.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+
+namespace MemoizationTest
+{
+
+static int calculationCount = 0;
+
+class MultiplyNode : public SerializableTestNode
+{
+public:
+	MultiplyNode (int factor, bool isMemoizable) :
+		SerializableTestNode (),
+		factor (factor),
+		isMemoizable (isMemoizable)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (1)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		return ValuePtr (new IntValue (IntValue::Get (in) * factor));
+	}
+
+	virtual bool WriteMemoizationKey (OutputStream& outputStream) const override
+	{
+		if (!isMemoizable) {
+			return false;
+		}
+		outputStream.Write (factor);
+		return true;
+	}
+
+	void SetFactor (int newFactor)
+	{
+		factor = newFactor;
+		InvalidateValue ();
+	}
+
+private:
+	int		factor;
+	bool	isMemoizable;
+};
+
+class NotSerializableValue : public GenericValue<int>
+{
+public:
+	NotSerializableValue (int val) :
+		GenericValue<int> (val)
+	{
+
+	}
+
+	virtual ValuePtr Clone () const override
+	{
+		return ValuePtr (new NotSerializableValue (val));
+	}
+
+	virtual std::wstring ToString (const StringConverter&) const override
+	{
+		return std::to_wstring (val);
+	}
+
+	virtual const DynamicSerializationInfo* GetDynamicSerializationInfo () const override
+	{
+		return nullptr;
+	}
+
+	virtual Stream::Status Read (InputStream&) override
+	{
+		return Stream::Status::Error;
+	}
+
+	virtual Stream::Status Write (OutputStream&) const override
+	{
+		return Stream::Status::Error;
+	}
+};
+
+class NotSerializableSourceNode : public SerializableTestNode
+{
+public:
+	NotSerializableSourceNode (int value) :
+		SerializableTestNode (),
+		value (value)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv&) const override
+	{
+		return ValuePtr (new NotSerializableValue (value));
+	}
+
+private:
+	int value;
+};
+
+TEST (MemoizationDisabledTest)
+{
+	calculationCount = 0;
+
+	NodeManager manager;
+	ASSERT (!manager.GetMemoizationCache ().IsEnabled ());
+	std::shared_ptr<MultiplyNode> node (new MultiplyNode (2, true));
+	manager.AddNode (node);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	node->SetFactor (3);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	node->SetFactor (2);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 2);
+	ASSERT (calculationCount == 3);
+	ASSERT (manager.GetMemoizationCache ().GetMemorySize () == 0);
+}
+
+TEST (MemoizationParameterToggleTest)
+{
+	calculationCount = 0;
+
+	NodeManager manager;
+	manager.GetMemoizationCache ().SetMaxMemorySize (1024 * 1024);
+	std::shared_ptr<TestSourceNode> source (new TestSourceNode (5));
+	std::shared_ptr<MultiplyNode> node (new MultiplyNode (2, true));
+	manager.AddNode (source);
+	manager.AddNode (node);
+	ASSERT (ConnectTestNodes (manager, source, node));
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 10);
+	ASSERT (calculationCount == 1);
+
+	node->SetFactor (3);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 15);
+	ASSERT (calculationCount == 2);
+
+	node->SetFactor (2);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 10);
+	ASSERT (calculationCount == 2);
+
+	source->SetValue (6);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 12);
+	ASSERT (calculationCount == 3);
+
+	source->SetValue (5);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 10);
+	ASSERT (calculationCount == 3);
+}
+
+TEST (MemoizationIdenticalNodesTest)
+{
+	calculationCount = 0;
+
+	NodeManager manager;
+	manager.GetMemoizationCache ().SetMaxMemorySize (1024 * 1024);
+	for (int i = 0; i < 3; i++) {
+		NodePtr source = manager.AddNode (NodePtr (new TestSourceNode (5)));
+		NodePtr node = manager.AddNode (NodePtr (new MultiplyNode (2, true)));
+		ASSERT (ConnectTestNodes (manager, source, node));
+	}
+	NodePtr notMemoizedNode = manager.AddNode (NodePtr (new MultiplyNode (2, false)));
+	NodePtr otherNode = manager.AddNode (NodePtr (new MultiplyNode (3, true)));
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculationCount == 3);
+	ASSERT (IntValue::Get (notMemoizedNode->GetCalculatedValue ()) == 2);
+	ASSERT (IntValue::Get (otherNode->GetCalculatedValue ()) == 3);
+}
+
+TEST (MemoizationNotSerializableInputTest)
+{
+	calculationCount = 0;
+
+	NodeManager manager;
+	manager.GetMemoizationCache ().SetMaxMemorySize (1024 * 1024);
+	NodePtr source1 = manager.AddNode (NodePtr (new NotSerializableSourceNode (5)));
+	NodePtr source2 = manager.AddNode (NodePtr (new NotSerializableSourceNode (6)));
+	NodePtr node1 = manager.AddNode (NodePtr (new MultiplyNode (2, true)));
+	NodePtr node2 = manager.AddNode (NodePtr (new MultiplyNode (2, true)));
+	ASSERT (ConnectTestNodes (manager, source1, node1));
+	ASSERT (ConnectTestNodes (manager, source2, node2));
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node1->GetCalculatedValue ()) == 10);
+	ASSERT (IntValue::Get (node2->GetCalculatedValue ()) == 12);
+	ASSERT (calculationCount == 2);
+	ASSERT (manager.GetMemoizationCache ().GetMemorySize () == 0);
+}
+
+TEST (MemoizationMemoryLimitTest)
+{
+	calculationCount = 0;
+
+	NodeManager manager;
+	manager.GetMemoizationCache ().SetMaxMemorySize (1024 * 1024);
+	std::shared_ptr<MultiplyNode> node (new MultiplyNode (1, true));
+	manager.AddNode (node);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	size_t valueMemorySize = manager.GetMemoizationCache ().GetMemorySize ();
+	ASSERT (valueMemorySize > 0);
+
+	manager.GetMemoizationCache ().SetMaxMemorySize (2 * valueMemorySize);
+	for (int factor = 2; factor <= 3; factor++) {
+		node->SetFactor (factor);
+		manager.EvaluateAllNodes (EmptyEvaluationEnv);
+		ASSERT (manager.GetMemoizationCache ().GetMemorySize () <= 2 * valueMemorySize);
+	}
+	ASSERT (calculationCount == 3);
+
+	node->SetFactor (2);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (calculationCount == 3);
+
+	node->SetFactor (1);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (node->GetCalculatedValue ()) == 1);
+	ASSERT (calculationCount == 4);
+
+	manager.GetMemoizationCache ().Clear ();
+	ASSERT (manager.GetMemoizationCache ().GetMemorySize () == 0);
+}
+
+TEST (MemoizationKeyTest)
+{
+	MemoryOutputStream nodeDataStream;
+	nodeDataStream.Write (42);
+
+	// the key refers to the input values, so its size doesn't depend on their content
+	std::vector<int> items (100000, 1);
+	NodeMemoizationKey key;
+	key.SetNodeData (nodeDataStream.GetBuffer ());
+	key.AddInputValue (ValuePtr (new IntListValue (items)));
+	ASSERT (key.GetMemorySize () < 1024);
+
+	NodeMemoizationKey equalKey;
+	equalKey.SetNodeData (nodeDataStream.GetBuffer ());
+	equalKey.AddInputValue (ValuePtr (new IntListValue (items)));
+	ASSERT (key.GetHashValue () == equalKey.GetHashValue ());
+	ASSERT (key.IsEqual (equalKey));
+
+	items.back () = 2;
+	NodeMemoizationKey otherKey;
+	otherKey.SetNodeData (nodeDataStream.GetBuffer ());
+	otherKey.AddInputValue (ValuePtr (new IntListValue (items)));
+	ASSERT (!key.IsEqual (otherKey));
+
+	NodeMemoizationCache cache;
+	cache.SetMaxMemorySize (1024 * 1024);
+	ASSERT (cache.Add (key, ValuePtr (new IntValue (5))));
+	ValueConstPtr value;
+	ASSERT (cache.Get (equalKey, value));
+	ASSERT (IntValue::Get (value) == 5);
+	ASSERT (!cache.Get (otherKey, value));
+	ASSERT (cache.GetMemorySize () < 1024);
+}
+
+}
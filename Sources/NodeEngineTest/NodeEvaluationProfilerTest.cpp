@@ -0,0 +1,150 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_NodeEvaluationProfiler.hpp"
+#include "TestNodes.hpp"
+
+#include <algorithm>
+
+using namespace NE;
+
+namespace NodeEvaluationProfilerTest
+{
+
+static size_t CountLines (const std::string& str)
+{
+	return std::count (str.begin (), str.end (), '\n');
+}
+
+class TestGraph
+{
+public:
+	TestGraph () :
+		manager (),
+		source (new TestSourceNode (5)),
+		node1 (new TestIncreaseNode ()),
+		node2 (new TestIncreaseNode ())
+	{
+		manager.AddNode (source);
+		manager.AddNode (node1);
+		manager.AddNode (node2);
+		ConnectTestNodes (manager, source, node1);
+		ConnectTestNodes (manager, source, node2);
+	}
+
+	NodeManager							manager;
+	std::shared_ptr<TestSourceNode>		source;
+	std::shared_ptr<TestIncreaseNode>	node1;
+	std::shared_ptr<TestIncreaseNode>	node2;
+};
+
+TEST (ProfilerDisabledTest)
+{
+	TestGraph graph;
+	ASSERT (!graph.manager.GetProfiler ().IsEnabled ());
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.node1->GetCalculatedValue ()) == 6);
+	ASSERT (graph.manager.GetProfiler ().GetEventCount () == 0);
+
+	NodeEvaluationProfiler::NodeStatistics statistics;
+	ASSERT (!graph.manager.GetProfiler ().GetNodeStatistics (graph.source->GetId (), statistics));
+}
+
+TEST (ProfilerStatisticsTest)
+{
+	TestGraph graph;
+	NodeEvaluationProfiler& profiler = graph.manager.GetProfiler ();
+	profiler.SetEnabled (true);
+
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (profiler.GetEventCount () == 3);
+
+	NodeEvaluationProfiler::NodeStatistics sourceStatistics;
+	ASSERT (profiler.GetNodeStatistics (graph.source->GetId (), sourceStatistics));
+	ASSERT (sourceStatistics.calculationCount == 1);
+	ASSERT (sourceStatistics.cacheMissCount == 1);
+	ASSERT (sourceStatistics.cacheHitCount >= 1);
+	ASSERT (sourceStatistics.valueSize > 0);
+
+	NodeEvaluationProfiler::NodeStatistics node1Statistics;
+	ASSERT (profiler.GetNodeStatistics (graph.node1->GetId (), node1Statistics));
+	ASSERT (node1Statistics.calculationCount == 1);
+	ASSERT (node1Statistics.selfDuration <= node1Statistics.totalDuration);
+
+	graph.source->SetValue (6);
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (profiler.GetEventCount () == 6);
+	ASSERT (profiler.GetNodeStatistics (graph.source->GetId (), sourceStatistics));
+	ASSERT (sourceStatistics.calculationCount == 2);
+
+	profiler.Clear ();
+	ASSERT (profiler.GetEventCount () == 0);
+	profiler.SetEnabled (false);
+	graph.source->SetValue (7);
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (profiler.GetEventCount () == 0);
+}
+
+TEST (ProfilerNestedEventsTest)
+{
+	TestGraph graph;
+	NodeEvaluationProfiler& profiler = graph.manager.GetProfiler ();
+	profiler.SetEnabled (true);
+
+	graph.node1->Evaluate (EmptyEvaluationEnv);
+	std::vector<NodeEvaluationProfiler::Event> events;
+	profiler.EnumerateEvents ([&] (const NodeEvaluationProfiler::Event& event) {
+		events.push_back (event);
+	});
+	ASSERT (events.size () == 2);
+	ASSERT (events[0].nodeId == graph.source->GetId ());
+	ASSERT (events[1].nodeId == graph.node1->GetId ());
+	ASSERT (events[1].startTime <= events[0].startTime);
+	ASSERT (events[1].duration >= events[0].duration);
+	ASSERT (events[1].selfDuration <= events[1].duration - events[0].duration);
+}
+
+TEST (ProfilerExportTest)
+{
+	TestGraph graph;
+	NodeEvaluationProfiler& profiler = graph.manager.GetProfiler ();
+	profiler.SetEnabled (true);
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	std::string chromeTrace = profiler.ExportChromeTrace ();
+	ASSERT (chromeTrace.find ("{\"traceEvents\":[") == 0);
+	ASSERT (chromeTrace.find ("\"name\":\"Node " + std::to_string (graph.source->GetId ().GetUniqueId ()) + "\"") != std::string::npos);
+	ASSERT (chromeTrace.find ("\"ph\":\"X\"") != std::string::npos);
+
+	std::string namedTrace = profiler.ExportChromeTrace ([] (const NodeId&) {
+		return std::wstring (L"Quoted \"name\"");
+	});
+	ASSERT (namedTrace.find ("\"name\":\"Quoted \\\"name\\\"\"") != std::string::npos);
+
+	std::string csv = profiler.ExportCsv ();
+	ASSERT (csv.find ("node_id,name,calculation_count,cache_hit_count,cache_miss_count,total_time_us,self_time_us,value_size,thread\n") == 0);
+	ASSERT (CountLines (csv) == 4);
+
+	std::string namedCsv = profiler.ExportCsv ([] (const NodeId&) {
+		return std::wstring (L"Name, with comma");
+	});
+	ASSERT (namedCsv.find (",\"Name, with comma\",") != std::string::npos);
+}
+
+TEST (ProfilerParallelEvaluationTest)
+{
+	TestGraph graph;
+	graph.manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	NodeEvaluationProfiler& profiler = graph.manager.GetProfiler ();
+	profiler.SetEnabled (true);
+
+	graph.manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (graph.node2->GetCalculatedValue ()) == 6);
+
+	NodeEvaluationProfiler::NodeStatistics sourceStatistics;
+	ASSERT (profiler.GetNodeStatistics (graph.source->GetId (), sourceStatistics));
+	ASSERT (sourceStatistics.calculationCount == 1);
+	ASSERT (profiler.GetEventCount () == 3);
+}
+
+}
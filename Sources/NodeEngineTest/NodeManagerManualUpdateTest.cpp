@@ -292,4 +292,25 @@ TEST (ManualUpdateTest_RandomForced)
 	}
 }
 
+TEST (ManualUpdateTest_ForceCalculationEnv)
+{
+	NodeManager manager;
+	manager.SetUpdateMode (NodeManager::UpdateMode::Manual);
+
+	NE::NodePtr valueNode = manager.AddNode (NodePtr (new ValueNode (5)));
+	NE::NodePtr incNode = manager.AddNode (NodePtr (new IncreaseNode ()));
+	manager.ConnectOutputSlotToInputSlot (valueNode->GetOutputSlot (SlotId ("out")), incNode->GetInputSlot (SlotId ("in")));
+
+	// the forced evaluation doesn't change the env of the caller
+	EvaluationEnv env (nullptr);
+	ASSERT (manager.ForceEvaluateAllNodes (env));
+	ASSERT (!env.IsForceCalculation ());
+	ASSERT (NE::IntValue::Get (incNode->GetCalculatedValue ()) == 6);
+
+	NE::Node::Cast<ValueNode> (valueNode)->SetValue (10);
+	ASSERT (incNode->Evaluate (env) == nullptr);
+	env.SetForceCalculation (true);
+	ASSERT (NE::IntValue::Get (incNode->Evaluate (env)) == 11);
+}
+
 }
@@ -0,0 +1,190 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_NodeManagerSnapshot.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+
+using namespace NE;
+
+namespace NodeManagerSnapshotTest
+{
+
+class TestNode : public Node
+{
+	DYNAMIC_SERIALIZABLE (TestNode);
+
+public:
+	TestNode () :
+		TestNode (0)
+	{
+
+	}
+
+	TestNode (int value) :
+		Node (),
+		value (value)
+	{
+
+	}
+
+	void SetValue (int newValue)
+	{
+		value = newValue;
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("a"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("b"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		ValueConstPtr a = EvaluateInputSlot (SlotId ("a"), env);
+		ValueConstPtr b = EvaluateInputSlot (SlotId ("b"), env);
+		return ValuePtr (new IntValue (value + IntValue::Get (a) + IntValue::Get (b)));
+	}
+
+	virtual Stream::Status Read (InputStream& inputStream) override
+	{
+		ObjectHeader header (inputStream);
+		Node::Read (inputStream);
+		inputStream.Read (value);
+		return inputStream.GetStatus ();
+	}
+
+	virtual Stream::Status Write (OutputStream& outputStream) const override
+	{
+		ObjectHeader header (outputStream, serializationInfo);
+		Node::Write (outputStream);
+		outputStream.Write (value);
+		return outputStream.GetStatus ();
+	}
+
+private:
+	int value;
+};
+
+DYNAMIC_SERIALIZATION_INFO (TestNode, 1, "{59735152-3FF7-44AB-B833-77A5880EB213}");
+
+static bool Connect (NodeManager& manager, const NodeId& beg, const NodeId& end, const SlotId& slotId)
+{
+	return manager.ConnectOutputSlotToInputSlot (manager.GetNode (beg)->GetOutputSlot (SlotId ("out")), manager.GetNode (end)->GetInputSlot (slotId));
+}
+
+static int EvaluateNode (const NodeManager& manager, const NodeId& nodeId)
+{
+	return IntValue::Get (manager.GetNode (nodeId)->Evaluate (EmptyEvaluationEnv));
+}
+
+class TestGraph
+{
+public:
+	TestGraph () :
+		manager ()
+	{
+		// node1 -> node3 -> node4
+		// node2 ->
+		node1 = manager.AddNode (NodePtr (new TestNode (1)))->GetId ();
+		node2 = manager.AddNode (NodePtr (new TestNode (2)))->GetId ();
+		node3 = manager.AddNode (NodePtr (new TestNode (3)))->GetId ();
+		node4 = manager.AddNode (NodePtr (new TestNode (4)))->GetId ();
+		Connect (manager, node1, node3, SlotId ("a"));
+		Connect (manager, node2, node3, SlotId ("b"));
+		Connect (manager, node3, node4, SlotId ("a"));
+	}
+
+	NodeManager		manager;
+	NodeId			node1;
+	NodeId			node2;
+	NodeId			node3;
+	NodeId			node4;
+};
+
+static EmptyUpdateEventHandler updateHandler;
+
+TEST (SnapshotSharingTest)
+{
+	TestGraph graph;
+	NodeManagerSnapshot emptySnapshot;
+	ASSERT (emptySnapshot.IsEmpty ());
+
+	NodeManagerSnapshot snapshot1;
+	ASSERT (snapshot1.Capture (graph.manager, emptySnapshot));
+	ASSERT (snapshot1.GetNodeCount () == 4);
+	ASSERT (snapshot1.ContainsNode (graph.node4));
+
+	std::static_pointer_cast<TestNode> (graph.manager.GetNode (graph.node4))->SetValue (40);
+	NodeManagerSnapshot snapshot2;
+	ASSERT (snapshot2.Capture (graph.manager, snapshot1));
+	ASSERT (snapshot2.IsNodeShared (graph.node1, snapshot1));
+	ASSERT (snapshot2.IsNodeShared (graph.node2, snapshot1));
+	ASSERT (snapshot2.IsNodeShared (graph.node3, snapshot1));
+	ASSERT (!snapshot2.IsNodeShared (graph.node4, snapshot1));
+
+	graph.manager.DisconnectAllOutputSlotsFromInputSlot (graph.manager.GetNode (graph.node3)->GetInputSlot (SlotId ("b")));
+	NodeManagerSnapshot snapshot3;
+	ASSERT (snapshot3.Capture (graph.manager, snapshot2));
+	ASSERT (snapshot3.IsNodeShared (graph.node1, snapshot2));
+	ASSERT (snapshot3.IsNodeShared (graph.node2, snapshot2));
+	ASSERT (!snapshot3.IsNodeShared (graph.node3, snapshot2));
+	ASSERT (snapshot3.IsNodeShared (graph.node4, snapshot2));
+}
+
+TEST (SnapshotRestoreTest)
+{
+	TestGraph graph;
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 10);
+
+	NodeManagerSnapshot originalSnapshot;
+	ASSERT (originalSnapshot.Capture (graph.manager, NodeManagerSnapshot ()));
+
+	std::static_pointer_cast<TestNode> (graph.manager.GetNode (graph.node1))->SetValue (10);
+	graph.manager.InvalidateNodeValue (graph.node1);
+	graph.manager.DeleteNode (graph.node3);
+	NodeId node5 = graph.manager.AddNode (NodePtr (new TestNode (5)))->GetId ();
+	Connect (graph.manager, graph.node1, graph.node4, SlotId ("a"));
+	Connect (graph.manager, node5, graph.node4, SlotId ("b"));
+	ASSERT (graph.manager.GetNodeCount () == 4);
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 19);
+
+	NodeManagerSnapshot modifiedSnapshot;
+	ASSERT (modifiedSnapshot.Capture (graph.manager, originalSnapshot));
+	ASSERT (modifiedSnapshot.IsNodeShared (graph.node2, originalSnapshot));
+
+	ASSERT (originalSnapshot.Restore (modifiedSnapshot, graph.manager, updateHandler));
+	ASSERT (graph.manager.GetNodeCount () == 4);
+	ASSERT (graph.manager.GetConnectionCount () == 3);
+	ASSERT (graph.manager.ContainsNode (graph.node3));
+	ASSERT (!graph.manager.ContainsNode (node5));
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 10);
+
+	ASSERT (modifiedSnapshot.Restore (originalSnapshot, graph.manager, updateHandler));
+	ASSERT (graph.manager.GetConnectionCount () == 2);
+	ASSERT (!graph.manager.ContainsNode (graph.node3));
+	ASSERT (graph.manager.ContainsNode (node5));
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 19);
+}
+
+TEST (SnapshotRestoreChangedNodeTest)
+{
+	TestGraph graph;
+	NodeManagerSnapshot originalSnapshot;
+	ASSERT (originalSnapshot.Capture (graph.manager, NodeManagerSnapshot ()));
+
+	// recreating a node must restore the connections of its dependents
+	std::static_pointer_cast<TestNode> (graph.manager.GetNode (graph.node3))->SetValue (30);
+	graph.manager.InvalidateNodeValue (graph.node3);
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 37);
+
+	NodeManagerSnapshot modifiedSnapshot;
+	ASSERT (modifiedSnapshot.Capture (graph.manager, originalSnapshot));
+	ASSERT (originalSnapshot.Restore (modifiedSnapshot, graph.manager, updateHandler));
+	ASSERT (graph.manager.GetConnectionCount () == 3);
+	ASSERT (EvaluateNode (graph.manager, graph.node4) == 10);
+}
+
+}
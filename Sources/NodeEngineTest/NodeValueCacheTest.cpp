@@ -6,6 +6,8 @@
 #include "NE_SingleValues.hpp"
 #include "TestNodes.hpp"
 
+#include <algorithm>
+
 using namespace NE;
 
 namespace NodeValueCacheTest
@@ -70,6 +72,65 @@ public:
 	mutable int calculationPostProcessCount;
 };
 
+class MultiInputOutputNode : public SerializableTestNode
+{
+public:
+	MultiInputOutputNode () :
+		SerializableTestNode (),
+		calculationCount (0)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (1)), OutputSlotConnectionMode::Multiple)));
+		RegisterOutputSlot (OutputSlotPtr (new TestOutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		int result = 0;
+		FlatEnumerate (in, [&] (const ValueConstPtr& val) {
+			result = std::max (result, IntValue::Get (val));
+			return true;
+		});
+		return ValuePtr (new IntValue (result + 1));
+	}
+
+	mutable int calculationCount;
+};
+
+static std::vector<std::shared_ptr<MultiInputOutputNode>> CreateDiamondChain (NodeManager& manager, size_t diamondCount)
+{
+	//   -> 1 ->     -> 4 ->
+	// 0         3           6 ...
+	//   -> 2 ->     -> 5 ->
+
+	std::vector<std::shared_ptr<MultiInputOutputNode>> nodes;
+	nodes.push_back (std::shared_ptr<MultiInputOutputNode> (new MultiInputOutputNode ()));
+	manager.AddNode (nodes.back ());
+	for (size_t i = 0; i < diamondCount; ++i) {
+		std::shared_ptr<MultiInputOutputNode> begNode = nodes.back ();
+		std::shared_ptr<MultiInputOutputNode> leftNode (new MultiInputOutputNode ());
+		std::shared_ptr<MultiInputOutputNode> rightNode (new MultiInputOutputNode ());
+		std::shared_ptr<MultiInputOutputNode> endNode (new MultiInputOutputNode ());
+		manager.AddNode (leftNode);
+		manager.AddNode (rightNode);
+		manager.AddNode (endNode);
+		manager.ConnectOutputSlotToInputSlot (begNode->GetOutputSlot (SlotId ("out")), leftNode->GetInputSlot (SlotId ("in")));
+		manager.ConnectOutputSlotToInputSlot (begNode->GetOutputSlot (SlotId ("out")), rightNode->GetInputSlot (SlotId ("in")));
+		manager.ConnectOutputSlotToInputSlot (leftNode->GetOutputSlot (SlotId ("out")), endNode->GetInputSlot (SlotId ("in")));
+		manager.ConnectOutputSlotToInputSlot (rightNode->GetOutputSlot (SlotId ("out")), endNode->GetInputSlot (SlotId ("in")));
+		nodes.push_back (leftNode);
+		nodes.push_back (rightNode);
+		nodes.push_back (endNode);
+	}
+	return nodes;
+}
+
 class DummyEvaluationData : public NE::EvaluationData
 {
 public:
@@ -337,4 +398,55 @@ TEST (EvaluationEnvTest)
 	}
 }
 
+TEST (DiamondInvalidationTest)
+{
+	// the number of paths grows exponentially with the diamond count,
+	// so this test would never finish if nodes were visited once per path
+	NodeManager manager;
+	std::vector<std::shared_ptr<MultiInputOutputNode>> nodes = CreateDiamondChain (manager, 64);
+
+	manager.EvaluateAllNodes (NE::EmptyEvaluationEnv);
+	ASSERT (IntValue::Get (nodes.back ()->GetCalculatedValue ()) == 2 + 2 * 64);
+	for (const std::shared_ptr<MultiInputOutputNode>& node : nodes) {
+		ASSERT (node->calculationCount == 1);
+	}
+
+	size_t dependentCount = 0;
+	manager.EnumerateDependentNodesRecursive (nodes[0], [&] (const NodeConstPtr&) {
+		dependentCount++;
+	});
+	ASSERT (dependentCount == nodes.size () - 1);
+
+	nodes[0]->InvalidateValue ();
+	for (const std::shared_ptr<MultiInputOutputNode>& node : nodes) {
+		ASSERT (!node->HasCalculatedValue ());
+	}
+
+	manager.EvaluateAllNodes (NE::EmptyEvaluationEnv);
+	for (const std::shared_ptr<MultiInputOutputNode>& node : nodes) {
+		ASSERT (node->calculationCount == 2);
+	}
+}
+
+TEST (BatchInvalidationTest)
+{
+	NodeManager manager;
+	std::vector<std::shared_ptr<MultiInputOutputNode>> nodes = CreateDiamondChain (manager, 3);
+	manager.EvaluateAllNodes (NE::EmptyEvaluationEnv);
+
+	NodeCollection nodesToInvalidate;
+	nodesToInvalidate.Insert (nodes[4]->GetId ());
+	nodesToInvalidate.Insert (nodes[5]->GetId ());
+	nodesToInvalidate.Insert (nodes[8]->GetId ());
+	manager.InvalidateNodeValues (nodesToInvalidate);
+	for (size_t i = 0; i < nodes.size (); ++i) {
+		ASSERT (nodes[i]->HasCalculatedValue () == (i < 4));
+	}
+
+	manager.EvaluateAllNodes (NE::EmptyEvaluationEnv);
+	for (size_t i = 0; i < nodes.size (); ++i) {
+		ASSERT (nodes[i]->calculationCount == (i < 4 ? 1 : 2));
+	}
+}
+
 }
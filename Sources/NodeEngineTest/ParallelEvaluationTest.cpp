@@ -0,0 +1,147 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_WorkerThreadPool.hpp"
+#include "TestNodes.hpp"
+
+#include <thread>
+
+using namespace NE;
+
+namespace ParallelEvaluationTest
+{
+
+class BranchedGraph
+{
+public:
+	BranchedGraph (NodeManager& manager, size_t branchCount, size_t branchLength) :
+		startNode (new TestIncreaseNode ()),
+		sumNode (new TestSumNode ())
+	{
+		// start -> branch 0 -> ... -> sum
+		//       -> branch 1 -> ... ->
+		manager.AddNode (startNode);
+		manager.AddNode (sumNode);
+		for (size_t branchIndex = 0; branchIndex < branchCount; ++branchIndex) {
+			NodePtr prevNode = startNode;
+			for (size_t nodeIndex = 0; nodeIndex < branchLength; ++nodeIndex) {
+				std::shared_ptr<TestIncreaseNode> node (new TestIncreaseNode ());
+				manager.AddNode (node);
+				ConnectTestNodes (manager, prevNode, node);
+				branchNodes.push_back (node);
+				prevNode = node;
+			}
+			ConnectTestNodes (manager, prevNode, sumNode);
+		}
+	}
+
+	bool AreAllNodesCalculated (int expectedCount) const
+	{
+		if (startNode->calculationCount != expectedCount || sumNode->calculationCount != expectedCount) {
+			return false;
+		}
+		for (const std::shared_ptr<TestIncreaseNode>& node : branchNodes) {
+			if (node->calculationCount != expectedCount) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::shared_ptr<TestIncreaseNode>				startNode;
+	std::shared_ptr<TestSumNode>					sumNode;
+	std::vector<std::shared_ptr<TestIncreaseNode>>	branchNodes;
+};
+
+TEST (WorkerThreadPoolTest)
+{
+	WorkerThreadPool threadPool (4);
+	ASSERT (threadPool.GetThreadCount () == 4);
+
+	std::vector<int> results (1000, 0);
+	for (int run = 1; run <= 3; ++run) {
+		threadPool.ParallelFor (results.size (), [&] (size_t taskIndex) {
+			results[taskIndex] += (int) taskIndex;
+		});
+	}
+	for (size_t i = 0; i < results.size (); ++i) {
+		ASSERT (results[i] == 3 * (int) i);
+	}
+}
+
+TEST (NestedParallelForTest)
+{
+	// a job started from a task of a running job is processed by its caller
+	WorkerThreadPool& threadPool = WorkerThreadPool::GetSharedPool ();
+	std::vector<std::vector<int>> results (8, std::vector<int> (100, 0));
+	threadPool.ParallelFor (results.size (), [&] (size_t outerIndex) {
+		threadPool.ParallelFor (results[outerIndex].size (), [&] (size_t innerIndex) {
+			results[outerIndex][innerIndex] = (int) (outerIndex + innerIndex);
+		});
+	});
+	for (size_t i = 0; i < results.size (); ++i) {
+		for (size_t j = 0; j < results[i].size (); ++j) {
+			ASSERT (results[i][j] == (int) (i + j));
+		}
+	}
+}
+
+TEST (ParallelEvaluationTest)
+{
+	NodeManager manager;
+	ASSERT (manager.GetEvaluationMode () == NodeManager::EvaluationMode::Sequential);
+	manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+
+	BranchedGraph graph (manager, 20, 5);
+	ASSERT (graph.AreAllNodesCalculated (0));
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (graph.AreAllNodesCalculated (1));
+	ASSERT (IntValue::Get (graph.sumNode->GetCalculatedValue ()) == 20 * 6);
+
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (graph.AreAllNodesCalculated (1));
+
+	graph.startNode->InvalidateValue ();
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	ASSERT (graph.AreAllNodesCalculated (2));
+	ASSERT (IntValue::Get (graph.sumNode->GetCalculatedValue ()) == 20 * 6);
+}
+
+TEST (ParallelValueProcessingTest)
+{
+	NodeManager manager;
+	manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	BranchedGraph graph (manager, 20, 2);
+
+	// the values are processed once, and always on the calling thread
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	manager.EvaluateAllNodes (EmptyEvaluationEnv);
+	for (const std::shared_ptr<TestIncreaseNode>& node : graph.branchNodes) {
+		ASSERT (node->processCount == 1);
+		ASSERT (node->processThreadId == std::this_thread::get_id ());
+	}
+}
+
+TEST (ParallelEvaluationMatchesSequentialTest)
+{
+	NodeManager sequentialManager;
+	BranchedGraph sequentialGraph (sequentialManager, 8, 10);
+	sequentialManager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	NodeManager parallelManager;
+	parallelManager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	BranchedGraph parallelGraph (parallelManager, 8, 10);
+	parallelManager.EvaluateAllNodes (EmptyEvaluationEnv);
+
+	ASSERT (sequentialGraph.AreAllNodesCalculated (1));
+	ASSERT (parallelGraph.AreAllNodesCalculated (1));
+	for (size_t i = 0; i < sequentialGraph.branchNodes.size (); ++i) {
+		ValueConstPtr sequentialValue = sequentialGraph.branchNodes[i]->GetCalculatedValue ();
+		ValueConstPtr parallelValue = parallelGraph.branchNodes[i]->GetCalculatedValue ();
+		ASSERT (IntValue::Get (sequentialValue) == IntValue::Get (parallelValue));
+	}
+	ASSERT (IntValue::Get (sequentialGraph.sumNode->GetCalculatedValue ()) == IntValue::Get (parallelGraph.sumNode->GetCalculatedValue ()));
+}
+
+}
@@ -0,0 +1,181 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_ParameterSweep.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+
+namespace ParameterSweepTest
+{
+
+class AddNode : public Node
+{
+	DYNAMIC_SERIALIZABLE (AddNode);
+
+public:
+	AddNode () :
+		Node ()
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("a"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("b"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		ValueConstPtr a = EvaluateInputSlot (SlotId ("a"), env);
+		ValueConstPtr b = EvaluateInputSlot (SlotId ("b"), env);
+		return ValuePtr (new IntValue (IntValue::Get (a) + IntValue::Get (b)));
+	}
+
+	virtual Stream::Status Read (InputStream& inputStream) override
+	{
+		ObjectHeader header (inputStream);
+		Node::Read (inputStream);
+		return inputStream.GetStatus ();
+	}
+
+	virtual Stream::Status Write (OutputStream& outputStream) const override
+	{
+		ObjectHeader header (outputStream, serializationInfo);
+		Node::Write (outputStream);
+		return outputStream.GetStatus ();
+	}
+};
+
+DYNAMIC_SERIALIZATION_INFO (AddNode, 1, "{A41B67A7-8459-40B9-8736-5536EE63C30E}");
+
+class TestGraph
+{
+public:
+	TestGraph () :
+		manager (),
+		source (new TestSourceNode (5)),
+		increase (new TestIncreaseNode ()),
+		add (new AddNode ())
+	{
+		// source -> increase -> add.a
+		manager.AddNode (source);
+		manager.AddNode (increase);
+		manager.AddNode (add);
+		ConnectTestNodes (manager, source, increase);
+		manager.ConnectOutputSlotToInputSlot (increase->GetOutputSlot (SlotId ("out")), add->GetInputSlot (SlotId ("a")));
+		CountingTestNode::totalCalculationCount = 0;
+	}
+
+	NodeManager							manager;
+	std::shared_ptr<TestSourceNode>		source;
+	std::shared_ptr<TestIncreaseNode>	increase;
+	std::shared_ptr<AddNode>			add;
+};
+
+TEST (InputSlotParameterTest)
+{
+	TestGraph graph;
+	ParameterSweep sweep;
+	sweep.SetThreadCount (4);
+	ASSERT (sweep.AddInputSlotParameter (graph.add->GetId (), SlotId ("b")) == 0);
+	for (int i = 0; i < 20; i++) {
+		ASSERT (sweep.AddRow ({ ValuePtr (new IntValue (i)) }));
+	}
+	ASSERT (sweep.GetRowCount () == 20);
+
+	std::vector<std::vector<ValueConstPtr>> results;
+	ASSERT (sweep.Evaluate (graph.manager, { graph.add->GetId () }, EmptyEvaluationEnv, results));
+	ASSERT (results.size () == 20);
+	for (int i = 0; i < 20; i++) {
+		ASSERT (results[i].size () == 1);
+		ASSERT (IntValue::Get (results[i][0]) == 6 + i);
+	}
+
+	// the nodes that do not depend on the parameter are calculated only once
+	ASSERT (CountingTestNode::totalCalculationCount == 2);
+	ASSERT (!graph.add->HasCalculatedValue ());
+	ASSERT (IntValue::Get (graph.add->GetInputSlot (SlotId ("b"))->GetDefaultValue ()) == 0);
+}
+
+TEST (NodeValueParameterTest)
+{
+	TestGraph graph;
+	ParameterSweep sweep;
+	sweep.SetThreadCount (2);
+	sweep.AddNodeValueParameter (graph.source->GetId ());
+	sweep.AddInputSlotParameter (graph.add->GetId (), SlotId ("b"));
+	for (int i = 0; i < 10; i++) {
+		ASSERT (sweep.AddRow ({ ValuePtr (new IntValue (i)), ValuePtr (new IntValue (100)) }));
+	}
+
+	std::vector<std::vector<ValueConstPtr>> results;
+	ASSERT (sweep.Evaluate (graph.manager, { graph.increase->GetId (), graph.add->GetId () }, EmptyEvaluationEnv, results));
+	for (int i = 0; i < 10; i++) {
+		ASSERT (IntValue::Get (results[i][0]) == i + 1);
+		ASSERT (IntValue::Get (results[i][1]) == i + 101);
+	}
+	ASSERT (CountingTestNode::totalCalculationCount == 10);
+}
+
+TEST (BoundedCacheSweepTest)
+{
+	// the injected parameter values must survive the eviction of the worker caches
+	TestGraph graph;
+	graph.manager.SetNodeValueCacheMaxMemorySize (1);
+	ParameterSweep sweep;
+	sweep.SetThreadCount (2);
+	sweep.AddNodeValueParameter (graph.source->GetId ());
+	for (int i = 0; i < 10; i++) {
+		ASSERT (sweep.AddRow ({ ValuePtr (new IntValue (i)) }));
+	}
+
+	std::vector<std::vector<ValueConstPtr>> results;
+	ASSERT (sweep.Evaluate (graph.manager, { graph.increase->GetId (), graph.add->GetId () }, EmptyEvaluationEnv, results));
+	for (int i = 0; i < 10; i++) {
+		ASSERT (IntValue::Get (results[i][0]) == i + 1);
+		ASSERT (IntValue::Get (results[i][1]) == i + 1);
+	}
+}
+
+TEST (EmptyAndInvalidSweepTest)
+{
+	TestGraph graph;
+	ParameterSweep sweep;
+	sweep.AddInputSlotParameter (graph.add->GetId (), SlotId ("b"));
+
+	std::vector<std::vector<ValueConstPtr>> results;
+	ASSERT (sweep.Evaluate (graph.manager, { graph.add->GetId () }, EmptyEvaluationEnv, results));
+	ASSERT (results.empty ());
+	ASSERT (CountingTestNode::totalCalculationCount == 0);
+
+	sweep.SetThreadCount (0);
+	ASSERT (sweep.GetThreadCount () == 1);
+}
+
+TEST (CancelledSweepTest)
+{
+	TestGraph graph;
+	ParameterSweep sweep;
+	sweep.AddInputSlotParameter (graph.add->GetId (), SlotId ("b"));
+	for (int i = 0; i < 10; i++) {
+		sweep.AddRow ({ ValuePtr (new IntValue (i)) });
+	}
+
+	EvaluationEnv env (nullptr);
+	CancellationTokenPtr token (new CancellationToken ());
+	env.SetCancellationToken (token);
+	token->Cancel ();
+
+	std::vector<std::vector<ValueConstPtr>> results;
+	ASSERT (!sweep.Evaluate (graph.manager, { graph.add->GetId () }, env, results));
+	ASSERT (results.size () == 10);
+	ASSERT (results[0][0] == nullptr);
+}
+
+}
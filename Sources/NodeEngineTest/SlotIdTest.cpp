@@ -0,0 +1,64 @@
+#include "SimpleTest.hpp"
+#include "NE_SlotId.hpp"
+#include "NE_MemoryStream.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NE;
+
+namespace SlotIdTest
+{
+
+TEST (SlotIdInterningTest)
+{
+	SlotId a1 ("a");
+	SlotId a2 (std::string ("a"));
+	SlotId b ("b");
+	ASSERT (a1 == a2);
+	ASSERT (a1 != b);
+	ASSERT (a1.GenerateHashValue () == a2.GenerateHashValue ());
+	ASSERT (a1.GenerateHashValue () == std::hash<std::string> {} ("a"));
+	ASSERT (a1 < b);
+	ASSERT (b > a1);
+	ASSERT (!(a1 < a2));
+	ASSERT (a1.GetName () == "a");
+	ASSERT (SlotId () == NullSlotId);
+	ASSERT (SlotId ("") == NullSlotId);
+}
+
+TEST (SlotIdSerializationTest)
+{
+	SlotId slotId ("serialized");
+	MemoryOutputStream outputStream;
+	ASSERT (slotId.Write (outputStream) == Stream::Status::NoError);
+
+	SlotId readSlotId;
+	MemoryInputStream inputStream (outputStream.GetBuffer ());
+	ASSERT (readSlotId.Read (inputStream) == Stream::Status::NoError);
+	ASSERT (readSlotId == slotId);
+	ASSERT (readSlotId.GetName () == "serialized");
+}
+
+TEST (SlotIdConcurrentInterningTest)
+{
+	std::vector<std::vector<SlotId>> slotIds (4);
+	std::vector<std::thread> threads;
+	for (std::vector<SlotId>& threadSlotIds : slotIds) {
+		threads.push_back (std::thread ([&] () {
+			for (int i = 0; i < 100; i++) {
+				threadSlotIds.push_back (SlotId ("concurrent" + std::to_string (i)));
+			}
+		}));
+	}
+	for (std::thread& thread : threads) {
+		thread.join ();
+	}
+	for (size_t i = 0; i < 100; i++) {
+		ASSERT (slotIds[0][i] == slotIds[1][i]);
+		ASSERT (slotIds[0][i] == slotIds[2][i]);
+		ASSERT (slotIds[0][i] == slotIds[3][i]);
+	}
+}
+
+}
@@ -0,0 +1,223 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "BI_InputUINodes.hpp"
+#include "BI_BinaryOperationNodes.hpp"
+#include "TestNodes.hpp"
+
+using namespace NE;
+using namespace NUIE;
+using namespace BI;
+
+namespace StructureCacheTest
+{
+
+static int calculationCount = 0;
+
+class MultiplyNode : public SerializableTestNode
+{
+public:
+	MultiplyNode (int factor) :
+		SerializableTestNode (),
+		factor (factor)
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (1)), OutputSlotConnectionMode::Single)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv& env) const override
+	{
+		calculationCount++;
+		ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+		return ValuePtr (new IntValue (IntValue::Get (in) * factor));
+	}
+
+	virtual bool WriteMemoizationKey (OutputStream& outputStream) const override
+	{
+		outputStream.Write (factor);
+		return true;
+	}
+
+	void SetFactor (int newFactor)
+	{
+		factor = newFactor;
+		InvalidateValue ();
+	}
+
+private:
+	int		factor;
+};
+
+class DuplicatedGraph
+{
+public:
+	DuplicatedGraph () :
+		manager (),
+		source (new TestSourceNode (5)),
+		first1 (new MultiplyNode (2)),
+		first2 (new MultiplyNode (3)),
+		second1 (new MultiplyNode (2)),
+		second2 (new MultiplyNode (3)),
+		other (new MultiplyNode (4))
+	{
+		// source -> first1 -> first2
+		//        -> second1 -> second2
+		//        -> other
+		manager.AddNode (source);
+		manager.AddNode (first1);
+		manager.AddNode (first2);
+		manager.AddNode (second1);
+		manager.AddNode (second2);
+		manager.AddNode (other);
+		ConnectTestNodes (manager, source, first1);
+		ConnectTestNodes (manager, first1, first2);
+		ConnectTestNodes (manager, source, second1);
+		ConnectTestNodes (manager, second1, second2);
+		ConnectTestNodes (manager, source, other);
+		calculationCount = 0;
+	}
+
+	NodeManager						manager;
+	std::shared_ptr<TestSourceNode>	source;
+	std::shared_ptr<MultiplyNode>	first1;
+	std::shared_ptr<MultiplyNode>	first2;
+	std::shared_ptr<MultiplyNode>	second1;
+	std::shared_ptr<MultiplyNode>	second2;
+	std::shared_ptr<MultiplyNode>	other;
+};
+
+TEST (StructureCacheDisabledTest)
+{
+	DuplicatedGraph graph;
+	ASSERT (!graph.manager.GetStructureCache ().IsEnabled ());
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 5);
+	ASSERT (graph.first2->GetCalculatedValue () != graph.second2->GetCalculatedValue ());
+}
+
+TEST (IdenticalSubgraphsTest)
+{
+	DuplicatedGraph graph;
+	graph.manager.GetStructureCache ().SetEnabled (true);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 3);
+	ASSERT (IntValue::Get (graph.first2->GetCalculatedValue ()) == 30);
+	ASSERT (IntValue::Get (graph.other->GetCalculatedValue ()) == 20);
+	ASSERT (graph.first1->GetCalculatedValue () == graph.second1->GetCalculatedValue ());
+	ASSERT (graph.first2->GetCalculatedValue () == graph.second2->GetCalculatedValue ());
+
+	graph.source->SetValue (7);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 6);
+	ASSERT (IntValue::Get (graph.first2->GetCalculatedValue ()) == 42);
+	ASSERT (IntValue::Get (graph.second2->GetCalculatedValue ()) == 42);
+}
+
+TEST (ChangedDuplicateTest)
+{
+	DuplicatedGraph graph;
+	graph.manager.GetStructureCache ().SetEnabled (true);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 3);
+
+	// the changed node becomes identical to another node, but its
+	// dependent has no identical node, so only the dependent is calculated
+	graph.first1->SetFactor (4);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 4);
+	ASSERT (IntValue::Get (graph.first1->GetCalculatedValue ()) == 20);
+	ASSERT (graph.first1->GetCalculatedValue () == graph.other->GetCalculatedValue ());
+	ASSERT (IntValue::Get (graph.first2->GetCalculatedValue ()) == 60);
+	ASSERT (IntValue::Get (graph.second2->GetCalculatedValue ()) == 30);
+
+	// the node that shared its value changes, the other one keeps the shared value
+	graph.other->SetFactor (5);
+	graph.second1->SetFactor (4);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (IntValue::Get (graph.other->GetCalculatedValue ()) == 25);
+	ASSERT (IntValue::Get (graph.second1->GetCalculatedValue ()) == 20);
+	ASSERT (IntValue::Get (graph.second2->GetCalculatedValue ()) == 60);
+}
+
+TEST (DefaultValueDifferenceTest)
+{
+	NodeManager manager;
+	manager.GetStructureCache ().SetEnabled (true);
+	std::shared_ptr<MultiplyNode> node1 (new MultiplyNode (2));
+	std::shared_ptr<MultiplyNode> node2 (new MultiplyNode (2));
+	manager.AddNode (node1);
+	manager.AddNode (node2);
+	node2->SetInputSlotDefaultValue (SlotId ("in"), ValuePtr (new IntValue (3)));
+	calculationCount = 0;
+	ASSERT (manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 2);
+	ASSERT (IntValue::Get (node1->GetCalculatedValue ()) == 2);
+	ASSERT (IntValue::Get (node2->GetCalculatedValue ()) == 6);
+}
+
+TEST (EarlyCutoffReusedValueTest)
+{
+	NodeManager manager;
+	manager.GetStructureCache ().SetEnabled (true);
+	manager.SetInvalidationMode (NodeManager::InvalidationMode::EarlyCutoff);
+	std::shared_ptr<TestSourceNode> source (new TestSourceNode (5));
+	std::shared_ptr<MultiplyNode> first (new MultiplyNode (2));
+	manager.AddNode (source);
+	manager.AddNode (first);
+	ConnectTestNodes (manager, source, first);
+	calculationCount = 0;
+	ASSERT (manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 1);
+
+	// the value reused by early cutoff can be shared with a new identical node
+	std::shared_ptr<MultiplyNode> second (new MultiplyNode (2));
+	manager.AddNode (second);
+	ConnectTestNodes (manager, source, second);
+	source->SetValue (5);
+	ASSERT (IntValue::Get (first->Evaluate (EmptyEvaluationEnv)) == 10);
+	ASSERT (manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount == 1);
+	ASSERT (first->GetCalculatedValue () == second->GetCalculatedValue ());
+}
+
+TEST (ParallelEvaluationTest)
+{
+	DuplicatedGraph graph;
+	graph.manager.GetStructureCache ().SetEnabled (true);
+	graph.manager.SetEvaluationMode (NodeManager::EvaluationMode::Parallel);
+	ASSERT (graph.manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (calculationCount >= 3 && calculationCount <= 5);
+	ASSERT (IntValue::Get (graph.first2->GetCalculatedValue ()) == 30);
+	ASSERT (IntValue::Get (graph.second2->GetCalculatedValue ()) == 30);
+}
+
+TEST (BuiltInNodesTest)
+{
+	NodeManager manager;
+	manager.GetStructureCache ().SetEnabled (true);
+	NodePtr input (new IntegerUpDownNode (LocString (L"Integer"), Point (0, 0), 5, 1));
+	NodePtr addition1 (new AdditionNode (LocString (L"Addition"), Point (100, 0)));
+	NodePtr addition2 (new AdditionNode (LocString (L"Addition Copy"), Point (100, 200)));
+	NodePtr addition3 (new AdditionNode (LocString (L"Addition"), Point (100, 400)));
+	manager.AddNode (input);
+	manager.AddNode (addition1);
+	manager.AddNode (addition2);
+	manager.AddNode (addition3);
+	manager.ConnectOutputSlotToInputSlot (input->GetOutputSlot (SlotId ("out")), addition1->GetInputSlot (SlotId ("a")));
+	manager.ConnectOutputSlotToInputSlot (input->GetOutputSlot (SlotId ("out")), addition2->GetInputSlot (SlotId ("a")));
+	manager.ConnectOutputSlotToInputSlot (input->GetOutputSlot (SlotId ("out")), addition3->GetInputSlot (SlotId ("b")));
+	ASSERT (manager.EvaluateAllNodes (EmptyEvaluationEnv));
+	ASSERT (DoubleValue::Get (addition1->GetCalculatedValue ()) == 5.0);
+	ASSERT (addition1->GetCalculatedValue () == addition2->GetCalculatedValue ());
+	ASSERT (addition1->GetCalculatedValue () != addition3->GetCalculatedValue ());
+}
+
+}
@@ -1,7 +1,15 @@
 #include "TestNodes.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
 
 DYNAMIC_SERIALIZATION_INFO (SerializableTestNode, 1, "{73A78FBB-6563-4009-A1B2-7DF56900F522}");
 DYNAMIC_SERIALIZATION_INFO (SerializableTestUINode, 1, "{93A78362-DFD9-46CB-B9F3-2F2DA9E1F964}");
+DYNAMIC_SERIALIZATION_INFO (TestSourceNode, 1, "{0E22A362-57D3-4E54-ABD2-C581165F67C7}");
+DYNAMIC_SERIALIZATION_INFO (TestIncreaseNode, 1, "{00E111D4-D05F-4C8D-8BFC-CA98C3506D0C}");
+DYNAMIC_SERIALIZATION_INFO (TestSumNode, 1, "{F999B9F7-6F9A-4B5F-BC81-8434A6059427}");
+
+std::atomic<int> CountingTestNode::totalCalculationCount (0);
 
 SerializableTestNode::SerializableTestNode () :
 	Node ()
@@ -71,3 +79,166 @@ Stream::Status SerializableTestUINode::Write (OutputStream& outputStream) const
 	UINode::Write (outputStream);
 	return Stream::Status::NoError;
 }
+
+CountingTestNode::CountingTestNode () :
+	Node (),
+	calculationCount (0),
+	processCount (0),
+	processThreadId ()
+{
+
+}
+
+void CountingTestNode::CountCalculation () const
+{
+	calculationCount++;
+	totalCalculationCount++;
+}
+
+void CountingTestNode::ProcessCalculatedValue (const ValueConstPtr&, NE::EvaluationEnv&) const
+{
+	processCount++;
+	processThreadId = std::this_thread::get_id ();
+}
+
+TestSourceNode::TestSourceNode () :
+	TestSourceNode (0)
+{
+
+}
+
+TestSourceNode::TestSourceNode (int value) :
+	CountingTestNode (),
+	value (value)
+{
+
+}
+
+void TestSourceNode::Initialize ()
+{
+	RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+}
+
+ValueConstPtr TestSourceNode::Calculate (NE::EvaluationEnv&) const
+{
+	CountCalculation ();
+	return ValuePtr (new IntValue (value));
+}
+
+Stream::Status TestSourceNode::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Node::Read (inputStream);
+	inputStream.Read (value);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status TestSourceNode::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Node::Write (outputStream);
+	outputStream.Write (value);
+	return outputStream.GetStatus ();
+}
+
+void TestSourceNode::SetValue (int newValue)
+{
+	value = newValue;
+	InvalidateValue ();
+}
+
+TestIncreaseNode::TestIncreaseNode () :
+	CountingTestNode (),
+	tokenToCancel (nullptr)
+{
+
+}
+
+void TestIncreaseNode::Initialize ()
+{
+	RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Single)));
+	RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+}
+
+ValueConstPtr TestIncreaseNode::Calculate (NE::EvaluationEnv& env) const
+{
+	CountCalculation ();
+	ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+	if (tokenToCancel != nullptr) {
+		tokenToCancel->Cancel ();
+	}
+	return ValuePtr (new IntValue (IntValue::Get (in) + 1));
+}
+
+Stream::Status TestIncreaseNode::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Node::Read (inputStream);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status TestIncreaseNode::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Node::Write (outputStream);
+	return outputStream.GetStatus ();
+}
+
+TestSumNode::TestSumNode () :
+	CountingTestNode ()
+{
+
+}
+
+void TestSumNode::Initialize ()
+{
+	RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Multiple)));
+	RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+}
+
+ValueConstPtr TestSumNode::Calculate (NE::EvaluationEnv& env) const
+{
+	CountCalculation ();
+	ValueConstPtr in = EvaluateInputSlot (SlotId ("in"), env);
+	int sum = 0;
+	FlatEnumerate (in, [&] (const ValueConstPtr& val) {
+		sum += IntValue::Get (val);
+		return true;
+	});
+	return ValuePtr (new IntValue (sum));
+}
+
+Stream::Status TestSumNode::Read (InputStream& inputStream)
+{
+	ObjectHeader header (inputStream);
+	Node::Read (inputStream);
+	return inputStream.GetStatus ();
+}
+
+Stream::Status TestSumNode::Write (OutputStream& outputStream) const
+{
+	ObjectHeader header (outputStream, serializationInfo);
+	Node::Write (outputStream);
+	return outputStream.GetStatus ();
+}
+
+bool ConnectTestNodes (NodeManager& manager, const NodePtr& beg, const NodePtr& end)
+{
+	return manager.ConnectOutputSlotToInputSlot (beg->GetOutputSlot (SlotId ("out")), end->GetInputSlot (SlotId ("in")));
+}
+
+TestChainGraph::TestChainGraph (size_t nodeCount) :
+	manager (),
+	source (new TestSourceNode (5)),
+	nodes ()
+{
+	manager.AddNode (source);
+	NodePtr prevNode = source;
+	for (size_t i = 0; i < nodeCount; i++) {
+		nodes.push_back (std::shared_ptr<TestIncreaseNode> (new TestIncreaseNode ()));
+		manager.AddNode (nodes.back ());
+		ConnectTestNodes (manager, prevNode, nodes.back ());
+		prevNode = nodes.back ();
+	}
+	CountingTestNode::totalCalculationCount = 0;
+}
@@ -2,6 +2,11 @@
 #define TESTNODES_HPP
 
 #include "NUIE_UINode.hpp"
+#include "NE_NodeManager.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
 
 using namespace NE;
 using namespace NUIE;
@@ -36,4 +41,88 @@ public:
 	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
 };
 
+// counts the calculations and the processed values of the node, the total count
+// includes the nodes of cloned graphs, because they are calculated in the copy
+class CountingTestNode : public Node
+{
+public:
+	CountingTestNode ();
+
+	mutable std::atomic<int>	calculationCount;
+	mutable std::atomic<int>	processCount;
+	mutable std::thread::id		processThreadId;
+
+	static std::atomic<int>		totalCalculationCount;
+
+protected:
+	void						CountCalculation () const;
+
+private:
+	virtual void				ProcessCalculatedValue (const ValueConstPtr& value, NE::EvaluationEnv& env) const override;
+};
+
+class TestSourceNode : public CountingTestNode
+{
+	DYNAMIC_SERIALIZABLE (TestSourceNode);
+
+public:
+	TestSourceNode ();
+	TestSourceNode (int value);
+
+	virtual void				Initialize () override;
+	virtual ValueConstPtr		Calculate (NE::EvaluationEnv& env) const override;
+
+	virtual NE::Stream::Status	Read (NE::InputStream& inputStream) override;
+	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
+
+	void						SetValue (int newValue);
+
+private:
+	int							value;
+};
+
+// adds one to its input, and cancels the given token after the calculation
+class TestIncreaseNode : public CountingTestNode
+{
+	DYNAMIC_SERIALIZABLE (TestIncreaseNode);
+
+public:
+	TestIncreaseNode ();
+
+	virtual void				Initialize () override;
+	virtual ValueConstPtr		Calculate (NE::EvaluationEnv& env) const override;
+
+	virtual NE::Stream::Status	Read (NE::InputStream& inputStream) override;
+	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
+
+	CancellationTokenPtr		tokenToCancel;
+};
+
+class TestSumNode : public CountingTestNode
+{
+	DYNAMIC_SERIALIZABLE (TestSumNode);
+
+public:
+	TestSumNode ();
+
+	virtual void				Initialize () override;
+	virtual ValueConstPtr		Calculate (NE::EvaluationEnv& env) const override;
+
+	virtual NE::Stream::Status	Read (NE::InputStream& inputStream) override;
+	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
+};
+
+bool ConnectTestNodes (NodeManager& manager, const NodePtr& beg, const NodePtr& end);
+
+// source -> node 0 -> node 1 -> ...
+class TestChainGraph
+{
+public:
+	TestChainGraph (size_t nodeCount);
+
+	NodeManager										manager;
+	std::shared_ptr<TestSourceNode>					source;
+	std::vector<std::shared_ptr<TestIncreaseNode>>	nodes;
+};
+
 #endif
@@ -0,0 +1,187 @@
+#include "SimpleTest.hpp"
+#include "NE_TopologicalOrder.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_Node.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_SingleValues.hpp"
+#include "TestNodes.hpp"
+
+#include <unordered_map>
+
+using namespace NE;
+
+namespace TopologicalOrderTest
+{
+
+class TestGraph
+{
+public:
+	TestGraph (size_t nodeCount)
+	{
+		for (size_t i = 0; i < nodeCount; ++i) {
+			NodeId nodeId (i + 1);
+			order.AddNode (nodeId);
+			nodeIds.push_back (nodeId);
+		}
+	}
+
+	bool CanAddEdge (size_t beg, size_t end) const
+	{
+		return !order.IsReachable (nodeIds[end], nodeIds[beg], GetSuccessors ());
+	}
+
+	void AddEdge (size_t beg, size_t end)
+	{
+		order.AddEdge (nodeIds[beg], nodeIds[end], GetSuccessors (), GetPredecessors ());
+		successors[nodeIds[beg]].push_back (nodeIds[end]);
+		predecessors[nodeIds[end]].push_back (nodeIds[beg]);
+	}
+
+	bool IsOrderValid () const
+	{
+		for (const auto& it : successors) {
+			for (const NodeId& endNodeId : it.second) {
+				if (order.GetOrder (it.first) >= order.GetOrder (endNodeId)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	TopologicalOrder::NeighborEnumerator GetSuccessors () const
+	{
+		return [&] (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) {
+			auto found = successors.find (nodeId);
+			if (found != successors.end ()) {
+				for (const NodeId& neighborId : found->second) {
+					processor (neighborId);
+				}
+			}
+		};
+	}
+
+	TopologicalOrder::NeighborEnumerator GetPredecessors () const
+	{
+		return [&] (const NodeId& nodeId, const std::function<void (const NodeId&)>& processor) {
+			auto found = predecessors.find (nodeId);
+			if (found != predecessors.end ()) {
+				for (const NodeId& neighborId : found->second) {
+					processor (neighborId);
+				}
+			}
+		};
+	}
+
+	TopologicalOrder										order;
+	std::vector<NodeId>										nodeIds;
+	std::unordered_map<NodeId, std::vector<NodeId>>			successors;
+	std::unordered_map<NodeId, std::vector<NodeId>>			predecessors;
+};
+
+class TestNode : public SerializableTestNode
+{
+public:
+	TestNode () :
+		SerializableTestNode ()
+	{
+
+	}
+
+	virtual void Initialize () override
+	{
+		RegisterInputSlot (InputSlotPtr (new InputSlot (SlotId ("in"), ValuePtr (new IntValue (0)), OutputSlotConnectionMode::Multiple)));
+		RegisterOutputSlot (OutputSlotPtr (new OutputSlot (SlotId ("out"))));
+	}
+
+	virtual ValueConstPtr Calculate (NE::EvaluationEnv&) const override
+	{
+		return nullptr;
+	}
+};
+
+static bool CanConnect (const NodeManager& manager, const NodePtr& beg, const NodePtr& end)
+{
+	return manager.CanConnectOutputSlotToInputSlot (beg->GetOutputSlot (SlotId ("out")), end->GetInputSlot (SlotId ("in")));
+}
+
+static bool Connect (NodeManager& manager, const NodePtr& beg, const NodePtr& end)
+{
+	return manager.ConnectOutputSlotToInputSlot (beg->GetOutputSlot (SlotId ("out")), end->GetInputSlot (SlotId ("in")));
+}
+
+TEST (TopologicalOrderForwardEdgesTest)
+{
+	TestGraph graph (4);
+	graph.AddEdge (0, 1);
+	graph.AddEdge (1, 2);
+	graph.AddEdge (2, 3);
+	ASSERT (graph.IsOrderValid ());
+	ASSERT (graph.CanAddEdge (0, 3));
+	ASSERT (!graph.CanAddEdge (3, 0));
+	ASSERT (!graph.CanAddEdge (2, 1));
+	ASSERT (!graph.CanAddEdge (2, 2));
+}
+
+TEST (TopologicalOrderReorderTest)
+{
+	// edges are added against the initial order
+	TestGraph graph (6);
+	graph.AddEdge (5, 4);
+	ASSERT (graph.IsOrderValid ());
+	graph.AddEdge (4, 3);
+	ASSERT (graph.IsOrderValid ());
+	graph.AddEdge (3, 0);
+	ASSERT (graph.IsOrderValid ());
+	graph.AddEdge (1, 5);
+	ASSERT (graph.IsOrderValid ());
+	graph.AddEdge (2, 1);
+	ASSERT (graph.IsOrderValid ());
+
+	ASSERT (graph.CanAddEdge (2, 0));
+	ASSERT (!graph.CanAddEdge (0, 2));
+	ASSERT (!graph.CanAddEdge (0, 5));
+	ASSERT (!graph.CanAddEdge (3, 1));
+	ASSERT (graph.CanAddEdge (1, 3));
+}
+
+TEST (NodeManagerCycleDetectionTest)
+{
+	NodeManager manager;
+	std::vector<NodePtr> nodes;
+	for (size_t i = 0; i < 5; ++i) {
+		nodes.push_back (manager.AddNode (NodePtr (new TestNode ())));
+	}
+
+	// 4 -> 3 -> 2 -> 1 -> 0
+	for (size_t i = nodes.size () - 1; i > 0; --i) {
+		ASSERT (CanConnect (manager, nodes[i], nodes[i - 1]));
+		ASSERT (Connect (manager, nodes[i], nodes[i - 1]));
+	}
+
+	for (size_t i = 0; i < nodes.size (); ++i) {
+		ASSERT (!CanConnect (manager, nodes[i], nodes[i]));
+		for (size_t j = 0; j < nodes.size (); ++j) {
+			if (i == j) {
+				continue;
+			}
+			bool isConnected = (i == j + 1);
+			ASSERT (CanConnect (manager, nodes[i], nodes[j]) == (i > j && !isConnected));
+		}
+	}
+
+	ASSERT (manager.DisconnectOutputSlotFromInputSlot (nodes[2]->GetOutputSlot (SlotId ("out")), nodes[1]->GetInputSlot (SlotId ("in"))));
+	ASSERT (CanConnect (manager, nodes[0], nodes[4]));
+	ASSERT (Connect (manager, nodes[0], nodes[4]));
+	ASSERT (!CanConnect (manager, nodes[2], nodes[0]));
+	ASSERT (!CanConnect (manager, nodes[2], nodes[1]));
+	ASSERT (CanConnect (manager, nodes[1], nodes[2]));
+
+	ASSERT (manager.DeleteNode (nodes[4]));
+	ASSERT (CanConnect (manager, nodes[2], nodes[0]));
+	ASSERT (CanConnect (manager, nodes[0], nodes[3]));
+}
+
+}
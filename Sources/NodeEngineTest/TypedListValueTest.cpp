@@ -0,0 +1,129 @@
+#include "SimpleTest.hpp"
+#include "NE_Value.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+#include "NE_MemoryStream.hpp"
+
+using namespace NE;
+
+namespace TypedListValueTest
+{
+
+static const BasicStringConverter DefaultStringConverter = GetDefaultStringConverter ();
+
+TEST (DoubleListValueTest)
+{
+	DoubleListValuePtr list (new DoubleListValue ({ 1.0, 2.0, 3.0 }));
+	ASSERT (IsListValue (list));
+	ASSERT (!IsSingleValue (list));
+	ASSERT (Value::IsType<IListValue> (ValueConstPtr (list)));
+	ASSERT (list->GetSize () == 3);
+	ASSERT (list->GetItem (1) == 2.0);
+	ASSERT (Value::IsType<DoubleValue> (list->GetValue (1)));
+	ASSERT (DoubleValue::Get (list->GetValue (2)) == 3.0);
+	ASSERT (list->ToString (DefaultStringConverter) == L"1.00, 2.00, 3.00");
+
+	std::vector<double> values;
+	FlatEnumerate (list, [&] (const ValueConstPtr& val) {
+		values.push_back (NumberValue::ToDouble (val));
+		return true;
+	});
+	ASSERT (values == list->GetItems ());
+}
+
+TEST (TypedListComplexTypeTest)
+{
+	ASSERT (IsComplexType<NumberValue> (ValuePtr (new IntListValue ({ 1, 2 }))));
+	ASSERT (IsComplexType<IntValue> (ValuePtr (new IntListValue ({ 1, 2 }))));
+	ASSERT (!IsComplexType<DoubleValue> (ValuePtr (new IntListValue ({ 1, 2 }))));
+	ASSERT (!IsComplexType<NumberValue> (ValuePtr (new IntListValue ())));
+	ASSERT (IsComplexType<NumberValue> (ValuePtr (new DoubleListValue ({ 1.0 }))));
+	ASSERT (!IsComplexType<NumberValue> (ValuePtr (new BooleanListValue ({ true }))));
+	ASSERT (IsComplexType<BooleanValue> (ValuePtr (new BooleanListValue ({ true, false }))));
+
+	ListValuePtr nested (new ListValue ());
+	nested->Push (ValuePtr (new IntValue (1)));
+	nested->Push (ValuePtr (new DoubleListValue ({ 2.0, 3.0 })));
+	ASSERT (IsComplexType<NumberValue> (nested));
+	ASSERT (FlattenValue (nested)->ToString (DefaultStringConverter) == L"1, 2.00, 3.00");
+}
+
+TEST (TypedListSingleValueTest)
+{
+	ValuePtr list (new DoubleListValue ({ 5.0 }));
+	ASSERT (IsSingleType<NumberValue> (list));
+	ASSERT (!IsSingleType<NumberValue> (ValuePtr (new DoubleListValue ({ 1.0, 2.0 }))));
+	ASSERT (NumberValue::ToDouble (CreateSingleValue (list)) == 5.0);
+	ASSERT (NumberValue::ToInteger (CreateSingleValue (ValueConstPtr (new IntListValue ({ 7 })))) == 7);
+	ASSERT (Value::Cast<NumberValue> (list.get ()) == nullptr);
+}
+
+TEST (TypedListFlatEnumerateItemsTest)
+{
+	ListValuePtr nested (new ListValue ());
+	nested->Push (ValuePtr (new IntValue (1)));
+	nested->Push (ValuePtr (new IntListValue ({ 2, 3 })));
+	std::vector<int> values;
+	ASSERT (FlatEnumerateItems (nested.get (), [&] (const Value* item) {
+		values.push_back (Value::Cast<NumberValue> (item)->ToInteger ());
+		return true;
+	}));
+	ASSERT (values == std::vector<int> ({ 1, 2, 3 }));
+
+	MemoryOutputStream typedStream;
+	MemoryOutputStream genericStream;
+	ListValuePtr genericList (new ListValue ({ ValuePtr (new IntValue (2)), ValuePtr (new IntValue (3)) }));
+	ASSERT (Value::WriteContent (typedStream, nested->GetValue (1).get ()));
+	ASSERT (Value::WriteContent (genericStream, genericList.get ()));
+	ASSERT (typedStream.GetBuffer () == genericStream.GetBuffer ());
+}
+
+TEST (TypedListSerializationTest)
+{
+	std::vector<double> items;
+	for (int i = 0; i < 100; i++) {
+		items.push_back (i * 0.5);
+	}
+	DoubleListValuePtr doubleList (new DoubleListValue (items));
+	ListValuePtr genericList (new ListValue ());
+	for (double item : items) {
+		genericList->Push (ValuePtr (new DoubleValue (item)));
+	}
+
+	MemoryOutputStream typedStream;
+	MemoryOutputStream genericStream;
+	ASSERT (WriteDynamicObject (typedStream, doubleList.get ()));
+	ASSERT (WriteDynamicObject (genericStream, genericList.get ()));
+	ASSERT (typedStream.GetBuffer ().size () < genericStream.GetBuffer ().size () / 2);
+
+	MemoryInputStream inputStream (typedStream.GetBuffer ());
+	ValuePtr readValue (ReadDynamicObject<Value> (inputStream));
+	ASSERT (Value::IsType<DoubleListValue> (readValue));
+	ASSERT (Value::Cast<DoubleListValue> (readValue)->GetItems () == items);
+	ASSERT (Value::IsEqual (readValue, genericList));
+	ASSERT (Value::GenerateHashValue (readValue) == Value::GenerateHashValue (genericList));
+}
+
+TEST (TypedListCloneTest)
+{
+	BooleanListValuePtr original (new BooleanListValue ({ true, false, true }));
+	ValuePtr cloned = original->Clone ();
+	original->Push (false);
+	BooleanListValuePtr typedCloned = Value::Cast<BooleanListValue> (cloned);
+	ASSERT (typedCloned->GetSize () == 3);
+	ASSERT (typedCloned->GetItem (0) && !typedCloned->GetItem (1) && typedCloned->GetItem (2));
+	ASSERT (original->GetSize () == 4);
+}
+
+TEST (TypedListMemorySizeTest)
+{
+	std::vector<double> items (1000, 1.0);
+	DoubleListValue typedList (items);
+	ListValue genericList;
+	for (double item : items) {
+		genericList.Push (ValuePtr (new DoubleValue (item)));
+	}
+	ASSERT (typedList.GetMemorySize () * 4 < genericList.GetMemorySize ());
+}
+
+}
@@ -2,6 +2,7 @@
 #include "NUIE_NodeUIManager.hpp"
 #include "BI_UnaryOperationNodes.hpp"
 #include "BI_InputUINodes.hpp"
+#include "NE_TypedListValues.hpp"
 #include "TestUtils.hpp"
 
 using namespace NE;
@@ -44,7 +45,7 @@ TEST (TestAbsoluteNodeWithList)
 	uiManager.ConnectOutputSlotToInputSlot (listVal->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("a")));
 
 	ValueConstPtr value = op->Evaluate (EmptyEvaluationEnv);
-	ASSERT (Value::IsType<ListValue> (value));
+	ASSERT (Value::IsType<DoubleListValue> (value));
 	std::vector<double> values;
 	FlatEnumerate (value, [&] (const ValueConstPtr& v) {
 		values.push_back (NumberValue::ToDouble (v));
@@ -85,4 +86,22 @@ TEST (TestSqrtNode)
 	ASSERT (IsEqual (result, 3.0));
 }
 
+TEST (TestSqrtNodeWithNegativeListItem)
+{
+	TestUIEnvironment env;
+	NodeUIManager uiManager (env);
+
+	UINodePtr val = uiManager.AddNode (UINodePtr (new DoubleUpDownNode (LocString (L"Value"), Point (0, 0), -1.0, 1.0)));
+	UINodePtr listVal = uiManager.AddNode (UINodePtr (new DoubleIncrementedNode (LocString (L"Value"), Point (0, 0))));
+	UINodePtr op = uiManager.AddNode (UINodePtr (new SqrtNode (LocString (L"Sqrt"), Point (0, 0))));
+	uiManager.ConnectOutputSlotToInputSlot (listVal->GetUIOutputSlot (SlotId ("out")), op->GetUIInputSlot (SlotId ("a")));
+
+	ValueConstPtr value = op->Evaluate (EmptyEvaluationEnv);
+	ASSERT (Value::IsType<DoubleListValue> (value));
+	ASSERT (IsEqual (NumberValue::ToDouble (Value::Cast<DoubleListValue> (value)->GetValue (9)), 3.0));
+
+	uiManager.ConnectOutputSlotToInputSlot (val->GetUIOutputSlot (SlotId ("out")), listVal->GetUIInputSlot (SlotId ("start")));
+	ASSERT (op->Evaluate (EmptyEvaluationEnv) == nullptr);
+}
+
 }
@@ -0,0 +1,139 @@
+#include "SimpleTest.hpp"
+#include "NE_NodeManager.hpp"
+#include "NE_NodeManagerMerge.hpp"
+#include "NUIE_UndoHandler.hpp"
+#include "NUIE_UndoDelta.hpp"
+#include "BI_InputUINodes.hpp"
+
+using namespace NE;
+using namespace NUIE;
+using namespace BI;
+
+namespace UndoHandlerTest
+{
+
+static EmptyUpdateEventHandler updateHandler;
+
+static NodePtr CreateNode (const Point& position)
+{
+	return NodePtr (new IntegerUpDownNode (LocString (L"Integer"), position, 0, 1));
+}
+
+static UINodePtr GetUINode (NodeManager& manager, const NodeId& nodeId)
+{
+	return Node::Cast<UINode> (manager.GetNode (nodeId));
+}
+
+TEST (MoveNodesDeltaTest)
+{
+	NodeManager manager;
+	NodeCollection nodes;
+	for (int i = 0; i < 500; i++) {
+		NodePtr node = manager.AddNode (CreateNode (Point (i, 0.0)));
+		nodes.Insert (node->GetId ());
+	}
+	NodeId firstNodeId = nodes.Get (0);
+
+	UndoHandler undoHandler;
+	undoHandler.AddUndoStep (manager);
+	size_t snapshotMemorySize = undoHandler.GetMemorySize ();
+	undoHandler.Clear ();
+
+	// moving many nodes is recorded as a small delta instead of a snapshot
+	UndoDeltaPtr moveDelta (new MoveNodesDelta (nodes, Point (10.0, 20.0)));
+	undoHandler.AddUndoDelta (moveDelta);
+	ASSERT (moveDelta->Redo (manager));
+	ASSERT (undoHandler.GetMemorySize () < snapshotMemorySize / 10);
+	ASSERT (GetUINode (manager, firstNodeId)->GetPosition () == Point (10.0, 20.0));
+
+	ASSERT (undoHandler.Undo (manager, updateHandler) == UndoHandler::ChangeResult::Changed);
+	ASSERT (GetUINode (manager, firstNodeId)->GetPosition () == Point (0.0, 0.0));
+	ASSERT (undoHandler.CanRedo ());
+
+	ASSERT (undoHandler.Redo (manager, updateHandler) == UndoHandler::ChangeResult::Changed);
+	ASSERT (GetUINode (manager, firstNodeId)->GetPosition () == Point (10.0, 20.0));
+}
+
+TEST (MixedUndoStepsTest)
+{
+	NodeManager manager;
+	UndoHandler undoHandler;
+
+	undoHandler.AddUndoStep (manager);
+	NodeId nodeId = manager.AddNode (CreateNode (Point (0.0, 0.0)))->GetId ();
+
+	UndoDeltaPtr moveDelta (new MoveNodesDelta (NodeCollection ({ nodeId }), Point (5.0, 0.0)));
+	undoHandler.AddUndoDelta (moveDelta);
+	moveDelta->Redo (manager);
+	moveDelta->Finalize (manager);
+	ASSERT (undoHandler.GetUndoStepCount () == 2);
+
+	undoHandler.Undo (manager, updateHandler);
+	ASSERT (GetUINode (manager, nodeId)->GetPosition () == Point (0.0, 0.0));
+	undoHandler.Undo (manager, updateHandler);
+	ASSERT (manager.GetNodeCount () == 0);
+	ASSERT (!undoHandler.CanUndo ());
+
+	undoHandler.Redo (manager, updateHandler);
+	ASSERT (manager.GetNodeCount () == 1);
+	ASSERT (GetUINode (manager, nodeId)->GetPosition () == Point (0.0, 0.0));
+	undoHandler.Redo (manager, updateHandler);
+	ASSERT (GetUINode (manager, nodeId)->GetPosition () == Point (5.0, 0.0));
+	ASSERT (!undoHandler.CanRedo ());
+}
+
+TEST (UndoMemoryBudgetTest)
+{
+	NodeManager manager;
+	UndoHandler undoHandler;
+	UndoHandler lastStepUndoHandler;
+	for (int i = 0; i < 10; i++) {
+		undoHandler.AddUndoStep (manager);
+		if (i == 9) {
+			lastStepUndoHandler.AddUndoStep (manager);
+		}
+		manager.AddNode (CreateNode (Point (i, 0.0)));
+	}
+	ASSERT (undoHandler.GetUndoStepCount () == 10);
+
+	// the kept step shared its nodes with the dropped ones, so they are counted now
+	size_t allStepsMemorySize = undoHandler.GetMemorySize ();
+	undoHandler.SetMemoryBudget (0);
+	ASSERT (undoHandler.GetUndoStepCount () == 1);
+	ASSERT (undoHandler.GetMemorySize () < allStepsMemorySize);
+	ASSERT (undoHandler.GetMemorySize () == lastStepUndoHandler.GetMemorySize ());
+
+	undoHandler.AddUndoStep (manager);
+	ASSERT (undoHandler.GetUndoStepCount () == 1);
+	ASSERT (undoHandler.Undo (manager, updateHandler) == UndoHandler::ChangeResult::Changed);
+	ASSERT (manager.GetNodeCount () == 10);
+	ASSERT (!undoHandler.CanUndo ());
+}
+
+TEST (RedoMemoryBudgetTest)
+{
+	NodeManager manager;
+	UndoHandler undoHandler;
+	for (int i = 0; i < 10; i++) {
+		undoHandler.AddUndoStep (manager);
+		manager.AddNode (CreateNode (Point (i, 0.0)));
+	}
+	for (int i = 0; i < 10; i++) {
+		ASSERT (undoHandler.Undo (manager, updateHandler) == UndoHandler::ChangeResult::Changed);
+	}
+	ASSERT (manager.GetNodeCount () == 0);
+	ASSERT (undoHandler.GetRedoStepCount () == 10);
+
+	size_t allStepsMemorySize = undoHandler.GetMemorySize ();
+	undoHandler.SetMemoryBudget (allStepsMemorySize / 2);
+	ASSERT (undoHandler.GetRedoStepCount () < 10);
+	ASSERT (undoHandler.GetMemorySize () <= allStepsMemorySize / 2);
+
+	undoHandler.SetMemoryBudget (0);
+	ASSERT (undoHandler.GetRedoStepCount () == 1);
+	ASSERT (undoHandler.Redo (manager, updateHandler) == UndoHandler::ChangeResult::Changed);
+	ASSERT (manager.GetNodeCount () == 1);
+	ASSERT (undoHandler.GetRedoStepCount () == 0);
+}
+
+}
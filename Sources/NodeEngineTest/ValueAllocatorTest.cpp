@@ -0,0 +1,117 @@
+#include "SimpleTest.hpp"
+#include "NE_ValueAllocator.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+
+#include <thread>
+#include <cstdint>
+
+using namespace NE;
+
+namespace ValueAllocatorTest
+{
+
+class alignas (64) OverAlignedType
+{
+public:
+	OverAlignedType (int val) :
+		val (val)
+	{
+
+	}
+
+	int val;
+};
+
+TEST (MakeValueTest)
+{
+	std::shared_ptr<DoubleValue> doubleValue = MakeValue<DoubleValue> (2.5);
+	ASSERT (doubleValue->GetValue () == 2.5);
+	ASSERT (reinterpret_cast<uintptr_t> (doubleValue.get ()) % alignof (DoubleValue) == 0);
+
+	ListValuePtr listValue = MakeValue<ListValue> ();
+	for (int i = 0; i < 100; i++) {
+		listValue->Push (MakeValue<IntValue> (i));
+	}
+	ASSERT (listValue->GetSize () == 100);
+	ASSERT (IntValue::Get (listValue->GetValue (99)) == 99);
+
+	ValuePtr cloned = listValue->Clone ();
+	ASSERT (Value::IsEqual (cloned, listValue));
+
+	std::shared_ptr<OverAlignedType> overAligned = std::allocate_shared<OverAlignedType> (ValueAllocator<OverAlignedType> (), 5);
+	ASSERT (overAligned->val == 5);
+	ASSERT (reinterpret_cast<uintptr_t> (overAligned.get ()) % 64 == 0);
+}
+
+TEST (AllocationReuseTest)
+{
+	ValueAllocationStatistics before = GetValueAllocationStatistics ();
+	for (int i = 0; i < 10000; i++) {
+		ValuePtr value = MakeValue<DoubleValue> ((double) i);
+	}
+	ValueAllocationStatistics after = GetValueAllocationStatistics ();
+	ASSERT (after.allocationCount - before.allocationCount == 10000);
+	ASSERT (after.systemAllocationCount - before.systemAllocationCount <= 1);
+	ASSERT (after.GetAvoidedAllocationCount () - before.GetAvoidedAllocationCount () >= 9999);
+}
+
+TEST (TypedListItemAllocationTest)
+{
+	DoubleListValue list (std::vector<double> (1000, 1.0));
+	ValueAllocationStatistics before = GetValueAllocationStatistics ();
+	double sum = 0.0;
+	list.Enumerate ([&] (const ValueConstPtr& item) {
+		sum += NumberValue::ToDouble (item);
+		return true;
+	});
+	ValueAllocationStatistics after = GetValueAllocationStatistics ();
+	ASSERT (sum == 1000.0);
+	ASSERT (after.allocationCount - before.allocationCount == 1000);
+	ASSERT (after.systemAllocationCount - before.systemAllocationCount <= 1);
+}
+
+TEST (CrossThreadDeallocationTest)
+{
+	std::vector<ValuePtr> values;
+	std::thread producer ([&] () {
+		for (int i = 0; i < 1000; i++) {
+			values.push_back (MakeValue<IntValue> (i));
+		}
+	});
+	producer.join ();
+
+	int sum = 0;
+	for (const ValuePtr& value : values) {
+		sum += IntValue::Get (value);
+	}
+	ASSERT (sum == 999 * 1000 / 2);
+	values.clear ();
+
+	ValueAllocationStatistics statistics = GetValueAllocationStatistics ();
+	ASSERT (statistics.allocationCount >= 1000);
+	ASSERT (statistics.GetAvoidedAllocationCount () > 0);
+}
+
+TEST (SlabLimitTest)
+{
+	// the values over the pooled slab limit are allocated from the system,
+	// and they are given back to it, the pooled blocks are still reused
+	ValueAllocationStatistics before = GetValueAllocationStatistics ();
+	std::vector<ValuePtr> values;
+	for (int i = 0; i < 200000; i++) {
+		values.push_back (MakeValue<IntValue> (i));
+	}
+	ValueAllocationStatistics afterAllocation = GetValueAllocationStatistics ();
+	ASSERT (afterAllocation.systemAllocationCount - before.systemAllocationCount > 1000);
+	ASSERT (IntValue::Get (values.back ()) == 199999);
+	values.clear ();
+
+	for (int i = 0; i < 10000; i++) {
+		values.push_back (MakeValue<IntValue> (i));
+	}
+	ValueAllocationStatistics afterReuse = GetValueAllocationStatistics ();
+	ASSERT (afterReuse.systemAllocationCount == afterAllocation.systemAllocationCount);
+}
+
+}
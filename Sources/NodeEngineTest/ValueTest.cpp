@@ -78,8 +78,51 @@ public:
 	}
 };
 
+class ANumberValue :	public NumberValue,
+						public GenericValue<A>
+{
+	DYNAMIC_SERIALIZABLE (ANumberValue);
+
+public:
+	ANumberValue () :
+		GenericValue<A> (A (0))
+	{
+
+	}
+
+	virtual ValuePtr Clone () const override
+	{
+		return std::make_shared<ANumberValue> ();
+	}
+
+	virtual std::wstring ToString (const StringConverter&) const override
+	{
+		return std::to_wstring (GetValue ().x);
+	}
+
+	virtual int		ToInteger () const override	{ return val.x; }
+	virtual float	ToFloat () const override	{ return (float) val.x; }
+	virtual double	ToDouble () const override	{ return (double) val.x; }
+};
+
+class RegisteredAValue : public AValue
+{
+	DYNAMIC_SERIALIZABLE (RegisteredAValue);
+	VALUE_TYPE (RegisteredAValue);
+
+public:
+	RegisteredAValue () :
+		AValue ()
+	{
+
+	}
+};
+
 DYNAMIC_SERIALIZATION_INFO (AValue, 1, "{789CD6F8-A998-4A94-8B0A-96B5FD0925F4}");
 DYNAMIC_SERIALIZATION_INFO (AListValue, 1, "{7427D535-508F-44E5-A076-3FAF1A35A413}");
+DYNAMIC_SERIALIZATION_INFO (ANumberValue, 1, "{0C5E2B7A-43D1-4F86-9E0B-6A8D1F2C3B57}");
+DYNAMIC_SERIALIZATION_INFO (RegisteredAValue, 1, "{E1A4F6B2-7C39-4D0E-8B5A-2F9C6D1E7A34}");
+VALUE_TYPE_INFO (RegisteredAValue, GenericValue<A>);
 
 static const BasicStringConverter DefaultStringConverter = GetDefaultStringConverter ();
 
@@ -153,6 +196,63 @@ TEST (CustomValueTest)
 	ASSERT (aListVal.GetValue (2)->ToString (DefaultStringConverter) == L"3");
 }
 
+TEST (CustomValueTypeTest)
+{
+	ValuePtr aValue (new AValue (A (1)));
+	ASSERT (Value::IsType<AValue> (aValue));
+	ASSERT (Value::IsType<GenericValue<A>> (aValue));
+	ASSERT (Value::IsType<SingleValue> (aValue));
+	ASSERT (!Value::IsType<RegisteredAValue> (aValue));
+	ASSERT (!Value::IsType<NumberValue> (aValue));
+	ASSERT (!Value::IsType<IListValue> (aValue));
+
+	ValuePtr registeredValue (new RegisteredAValue ());
+	ASSERT (Value::IsType<RegisteredAValue> (registeredValue));
+	ASSERT (Value::IsType<AValue> (registeredValue));
+	ASSERT (Value::IsType<GenericValue<A>> (registeredValue));
+	ASSERT (!Value::IsType<GenericValue<int>> (registeredValue));
+	ASSERT (Value::Cast<RegisteredAValue> (registeredValue) != nullptr);
+
+	ValuePtr numberValue (new ANumberValue ());
+	ASSERT (Value::IsType<NumberValue> (numberValue));
+	ASSERT (NumberValue::ToDouble (numberValue) == 0.0);
+	ASSERT (IsComplexType<NumberValue> (numberValue));
+
+	ValuePtr aListValue (new AListValue ());
+	ValuePtr listValue (new ListValue ());
+	ASSERT (Value::IsType<ListValue> (aListValue));
+	ASSERT (Value::IsType<AListValue> (aListValue));
+	ASSERT (!Value::IsType<AListValue> (listValue));
+	ASSERT (Value::Cast<AListValue> (listValue) == nullptr);
+	ASSERT (Value::Cast<IListValue> (aListValue).get () == Value::Cast<AListValue> (aListValue).get ());
+	ASSERT (IsListValue (aListValue));
+
+	ASSERT (!Value::IsType<IntValue> (ValuePtr ()));
+	ASSERT (!Value::IsType<NumberValue> (ValuePtr ()));
+	ASSERT (Value::Cast<IntValue> (ValuePtr ()) == nullptr);
+}
+
+TEST (BuiltInValueTypeTest)
+{
+	ValuePtr intValue (new IntValue (1));
+	ValuePtr stringValue (new StringValue (L"a"));
+	ASSERT (Value::IsType<Value> (intValue));
+	ASSERT (Value::IsType<SingleValue> (intValue));
+	ASSERT (Value::IsType<GenericValue<int>> (intValue));
+	ASSERT (Value::IsType<NumberValue> (intValue));
+	ASSERT (!Value::IsType<DoubleValue> (intValue));
+	ASSERT (!Value::IsType<GenericValue<double>> (intValue));
+	ASSERT (!Value::IsType<IListValue> (intValue));
+	ASSERT (!Value::IsType<NumberValue> (stringValue));
+	ASSERT (!Value::IsType<ListValue> (stringValue));
+
+	const NumberValue* number = Value::Cast<NumberValue> (intValue.get ());
+	ASSERT (number != nullptr && number->ToDouble () == 1.0);
+	std::shared_ptr<IntValue> typedIntValue = Value::Cast<IntValue> (intValue);
+	ASSERT (typedIntValue.get () == intValue.get ());
+	ASSERT (typedIntValue.use_count () == 2);
+}
+
 TEST (CloneTest)
 {
 	std::shared_ptr<AValue> original (new AValue (A (1)));
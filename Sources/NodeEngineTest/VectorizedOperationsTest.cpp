@@ -0,0 +1,119 @@
+#include "SimpleTest.hpp"
+#include "BI_VectorizedOperations.hpp"
+#include "NE_SingleValues.hpp"
+#include "NE_TypedListValues.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace NE;
+using namespace BI;
+
+namespace VectorizedOperationsTest
+{
+
+static std::vector<double> GenerateValues (size_t count, double start)
+{
+	std::vector<double> values;
+	for (size_t i = 0; i < count; i++) {
+		values.push_back (start + i * 0.75);
+	}
+	return values;
+}
+
+TEST (BinaryArrayOperationTest)
+{
+	for (size_t count = 0; count < 12; count++) {
+		std::vector<double> a = GenerateValues (count, -3.5);
+		std::vector<double> b = GenerateValues (count, 1.25);
+		std::vector<double> result (count);
+		AddArrays (a.data (), 1, b.data (), 1, result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == a[i] + b[i]);
+		}
+		SubtractArrays (a.data (), 1, b.data (), 0, result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == a[i] - b[0]);
+		}
+		MultiplyArrays (a.data (), 0, b.data (), 1, result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == a[0] * b[i]);
+		}
+		DivideArrays (a.data (), 1, b.data (), 1, result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == a[i] / b[i]);
+		}
+	}
+}
+
+TEST (UnaryArrayOperationTest)
+{
+	for (size_t count = 0; count < 12; count++) {
+		std::vector<double> a = GenerateValues (count, -3.5);
+		std::vector<double> result (count);
+		AbsArray (a.data (), result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == std::abs (a[i]));
+		}
+		FloorArray (a.data (), result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == std::floor (a[i]));
+		}
+		CeilArray (a.data (), result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == std::ceil (a[i]));
+		}
+		NegateArray (a.data (), result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (result[i] == -a[i]);
+		}
+		SqrtArray (a.data (), result.data (), count);
+		for (size_t i = 0; i < count; i++) {
+			ASSERT (a[i] < 0.0 ? std::isnan (result[i]) : result[i] == std::sqrt (a[i]));
+		}
+	}
+}
+
+TEST (IsFiniteArrayTest)
+{
+	std::vector<double> values = GenerateValues (11, 1.0);
+	ASSERT (IsFiniteArray (values.data (), values.size ()));
+	ASSERT (IsFiniteArray (values.data (), 0));
+	for (size_t i = 0; i < values.size (); i++) {
+		std::vector<double> nanValues = values;
+		nanValues[i] = std::numeric_limits<double>::quiet_NaN ();
+		ASSERT (!IsFiniteArray (nanValues.data (), nanValues.size ()));
+		std::vector<double> infValues = values;
+		infValues[i] = -std::numeric_limits<double>::infinity ();
+		ASSERT (!IsFiniteArray (infValues.data (), infValues.size ()));
+	}
+}
+
+TEST (DoubleArrayTest)
+{
+	DoubleArray array;
+	ASSERT (array.Set (ValuePtr (new IntValue (5))));
+	ASSERT (array.GetSize () == 1 && array.GetData ()[0] == 5.0);
+
+	DoubleListValuePtr doubleList (new DoubleListValue ({ 1.0, 2.0, 3.0 }));
+	ASSERT (array.Set (doubleList));
+	ASSERT (array.GetSize () == 3 && array.GetData () == doubleList->GetItems ().data ());
+
+	ASSERT (array.Set (ValuePtr (new IntListValue ({ 4, 5 }))));
+	ASSERT (array.GetSize () == 2 && array.GetData ()[0] == 4.0 && array.GetData ()[1] == 5.0);
+
+	ListValuePtr numberList (new ListValue ());
+	numberList->Push (ValuePtr (new IntValue (1)));
+	numberList->Push (ValuePtr (new DoubleValue (2.5)));
+	ASSERT (array.Set (numberList));
+	ASSERT (array.GetSize () == 2 && array.GetData ()[1] == 2.5);
+
+	ListValuePtr nestedList (new ListValue ());
+	nestedList->Push (ValuePtr (new IntValue (1)));
+	nestedList->Push (ValuePtr (new DoubleListValue ({ 2.0 })));
+	ASSERT (!array.Set (nestedList));
+	ASSERT (!array.Set (ValuePtr (new StringValue (L"a"))));
+	ASSERT (array.GetSize () == 0);
+}
+
+}
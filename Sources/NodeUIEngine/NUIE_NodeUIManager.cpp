@@ -48,6 +48,7 @@ private:
 
 NodeUIManager::Status::Status () :
 	needToRecalculate (false),
+	needToResumeManualUpdate (false),
 	needToRedraw (false),
 	needToSave (false)
 {
@@ -57,6 +58,7 @@ NodeUIManager::Status::Status () :
 void NodeUIManager::Status::Reset ()
 {
 	needToRecalculate = false;
+	needToResumeManualUpdate = false;
 	needToRedraw = false;
 	needToSave = false;
 }
@@ -76,6 +78,21 @@ bool NodeUIManager::Status::NeedToRecalculate () const
 	return needToRecalculate;
 }
 
+void NodeUIManager::Status::RequestResumeManualUpdate ()
+{
+	needToResumeManualUpdate = true;
+}
+
+void NodeUIManager::Status::ResetResumeManualUpdate ()
+{
+	needToResumeManualUpdate = false;
+}
+
+bool NodeUIManager::Status::NeedToResumeManualUpdate () const
+{
+	return needToResumeManualUpdate;
+}
+
 void NodeUIManager::Status::RequestRedraw ()
 {
 	needToRedraw = true;
@@ -116,6 +133,11 @@ NodeUIManagerCommand::~NodeUIManagerCommand ()
 
 }
 
+UndoDeltaPtr NodeUIManagerCommand::CreateUndoDelta (const NE::NodeManager&) const
+{
+	return nullptr;
+}
+
 NodeUIManagerNodeInvalidator::NodeUIManagerNodeInvalidator (NodeUIManager& uiManager, UINodePtr& uiNode) :
 	UINodeInvalidator (),
 	uiManager (uiManager),
@@ -197,7 +219,12 @@ NodeUIManager::NodeUIManager (NodeUIEnvironment& uiEnvironment) :
 	undoHandler (),
 	selection (),
 	viewBox (),
-	status ()
+	status (),
+	evaluationMode (EvaluationMode::Synchronous),
+	evaluationScope (EvaluationScope::AllNodes),
+	observedNodes (),
+	updateTimeBudget (NE::EvaluationEnv::Clock::duration::zero ()),
+	backgroundEvaluator ()
 {
 	New (uiEnvironment);
 }
@@ -520,9 +547,10 @@ void NodeUIManager::InvalidateNodeDrawing (const UINodePtr& uiNode)
 {
 	uiNode->InvalidateDrawing ();
 	InvalidateNodeGroupDrawing (uiNode);
-	nodeManager.EnumerateDependentNodes (uiNode, [&] (const NE::NodeId& dependentNodeId) {
+	nodeManager.EnumerateDependentNodesRecursive (uiNode, [&] (const NE::NodeId& dependentNodeId) {
 		UINodePtr dependentNode = GetNode (dependentNodeId);
-		InvalidateNodeDrawing (dependentNode);
+		dependentNode->InvalidateDrawing ();
+		InvalidateNodeGroupDrawing (dependentNode);
 	});
 	status.RequestRedraw ();
 }
@@ -680,6 +708,91 @@ void NodeUIManager::SetUpdateMode (UpdateMode newUpdateMode)
 	}
 }
 
+NodeUIManager::EvaluationMode NodeUIManager::GetEvaluationMode () const
+{
+	return evaluationMode;
+}
+
+void NodeUIManager::SetEvaluationMode (EvaluationMode newEvaluationMode)
+{
+	if (newEvaluationMode == EvaluationMode::Synchronous) {
+		backgroundEvaluator.Cancel ();
+		RequestRecalculate ();
+	}
+	evaluationMode = newEvaluationMode;
+}
+
+bool NodeUIManager::IsBackgroundEvaluationRunning () const
+{
+	return backgroundEvaluator.IsStarted ();
+}
+
+NodeUIManager::EvaluationScope NodeUIManager::GetEvaluationScope () const
+{
+	return evaluationScope;
+}
+
+void NodeUIManager::SetEvaluationScope (EvaluationScope newEvaluationScope)
+{
+	if (newEvaluationScope != evaluationScope) {
+		RequestRecalculate ();
+	}
+	evaluationScope = newEvaluationScope;
+}
+
+const NE::NodeCollection& NodeUIManager::GetObservedNodes () const
+{
+	return observedNodes;
+}
+
+void NodeUIManager::SetObservedNodes (const NE::NodeCollection& newObservedNodes)
+{
+	// newly observed nodes may have no values yet, and their values
+	// are kept even if the node value cache is bounded
+	if (newObservedNodes != observedNodes) {
+		RequestRecalculate ();
+	}
+	observedNodes = newObservedNodes;
+	nodeManager.SetPinnedNodes (observedNodes);
+}
+
+NE::EvaluationEnv::Clock::duration NodeUIManager::GetUpdateTimeBudget () const
+{
+	return updateTimeBudget;
+}
+
+void NodeUIManager::SetUpdateTimeBudget (const NE::EvaluationEnv::Clock::duration& newUpdateTimeBudget)
+{
+	updateTimeBudget = newUpdateTimeBudget;
+}
+
+NE::NodeCollection NodeUIManager::GetVisibleNodes (NodeUIDrawingEnvironment& drawingEnv) const
+{
+	const DrawingContext& context = drawingEnv.GetDrawingContext ();
+	NE::NodeCollection visibleNodes;
+	EnumerateNodes ([&] (UINodeConstPtr uiNode) {
+		Rect nodeRect = viewBox.ModelToView (uiNode->GetRect (drawingEnv));
+		if (Rect::IsInBounds (nodeRect, context.GetWidth (), context.GetHeight ())) {
+			visibleNodes.Insert (uiNode->GetId ());
+		}
+		return true;
+	});
+	return visibleNodes;
+}
+
+void NodeUIManager::WaitForBackgroundEvaluation (NodeUICalculationEnvironment& calcEnv)
+{
+	if (!backgroundEvaluator.IsStarted ()) {
+		return;
+	}
+	backgroundEvaluator.Wait ();
+	PublishBackgroundEvaluation (calcEnv);
+	if (status.NeedToRedraw ()) {
+		calcEnv.OnRedrawRequested ();
+		status.ResetRedraw ();
+	}
+}
+
 void NodeUIManager::New (NodeUIEnvironment& uiEnvironment)
 {
 	Clear (uiEnvironment);
@@ -741,12 +854,33 @@ bool NodeUIManager::CanRedo () const
 	return undoHandler.CanRedo ();
 }
 
+size_t NodeUIManager::GetUndoMemoryBudget () const
+{
+	return undoHandler.GetMemoryBudget ();
+}
+
+void NodeUIManager::SetUndoMemoryBudget (size_t newMemoryBudget)
+{
+	undoHandler.SetMemoryBudget (newMemoryBudget);
+}
+
+size_t NodeUIManager::GetNodeValueCacheMaxMemorySize () const
+{
+	return nodeManager.GetNodeValueCacheMaxMemorySize ();
+}
+
+void NodeUIManager::SetNodeValueCacheMaxMemorySize (size_t newMaxMemorySize)
+{
+	nodeManager.SetNodeValueCacheMaxMemorySize (newMaxMemorySize);
+}
+
 void NodeUIManager::Undo (NE::EvaluationEnv& evalEnv, NodeUIInteractionEnvironment& interactionEnv)
 {
 	NodeUIManagerUpdateEventHandler eventHandler (*this, interactionEnv, evalEnv);
 	UndoHandler::ChangeResult undoResult = undoHandler.Undo (nodeManager, eventHandler);
 	HandleUndoStateChanged (undoResult, interactionEnv);
 	InvalidateDrawingsForInvalidatedNodes ();
+	InvalidateAllNodeGroupsDrawing ();
 	RequestRecalculateAndRedraw ();
 }
 
@@ -756,6 +890,7 @@ void NodeUIManager::Redo (NE::EvaluationEnv& evalEnv, NodeUIInteractionEnvironme
 	UndoHandler::ChangeResult undoResult = undoHandler.Redo (nodeManager, eventHandler);
 	HandleUndoStateChanged (undoResult, interactionEnv);
 	InvalidateDrawingsForInvalidatedNodes ();
+	InvalidateAllNodeGroupsDrawing ();
 	RequestRecalculateAndRedraw ();
 }
 
@@ -820,11 +955,22 @@ void NodeUIManager::EnumerateNodeGroups (const std::function<bool (UINodeGroupPt
 
 void NodeUIManager::ExecuteCommand (NodeUIManagerCommand& command, NodeUIInteractionEnvironment& interactionEnv)
 {
+	// commands that can record their changes don't need a snapshot of the whole graph
+	UndoDeltaPtr undoDelta = nullptr;
 	if (command.IsUndoable ()) {
-		UndoHandler::ChangeResult result = undoHandler.AddUndoStep (nodeManager);
+		undoDelta = command.CreateUndoDelta (nodeManager);
+		UndoHandler::ChangeResult result = UndoHandler::ChangeResult::NotChanged;
+		if (undoDelta != nullptr) {
+			result = undoHandler.AddUndoDelta (undoDelta);
+		} else {
+			result = undoHandler.AddUndoStep (nodeManager);
+		}
 		HandleUndoStateChanged (result, interactionEnv);
 	}
 	command.Do (*this);
+	if (undoDelta != nullptr) {
+		undoDelta->Finalize (nodeManager);
+	}
 	status.RequestSave ();
 }
 
@@ -846,6 +992,7 @@ void NodeUIManager::Clear (NodeUIEnvironment& uiEnvironment)
 	UndoHandler::ChangeResult undoResult = undoHandler.Clear ();
 	HandleUndoStateChanged (undoResult, uiEnvironment);
 
+	backgroundEvaluator.Cancel ();
 	nodeManager.Clear ();
 
 	viewBox.Set (Point (0.0, 0.0), windowScale);
@@ -856,6 +1003,10 @@ void NodeUIManager::InvalidateDrawingsForInvalidatedNodes ()
 {
 	std::vector<UINodePtr> nodesToInvalidate;
 	EnumerateNodes ([&] (UINodePtr uiNode) {
+		// evicted values are up to date, so their drawings remain valid
+		if (uiNode->IsValueEvicted ()) {
+			return true;
+		}
 		NE::Node::CalculationStatus calcStatus = uiNode->GetCalculationStatus ();
 		if (calcStatus == NE::Node::CalculationStatus::NeedToCalculate || calcStatus == NE::Node::CalculationStatus::NeedToCalculateButDisabled) {
 			nodesToInvalidate.push_back (uiNode);
@@ -870,17 +1021,42 @@ void NodeUIManager::InvalidateDrawingsForInvalidatedNodes ()
 
 void NodeUIManager::UpdateInternal (NodeUICalculationEnvironment& calcEnv, InternalUpdateMode mode)
 {
-	if (status.NeedToRecalculate ()) {
+	if (evaluationMode == EvaluationMode::Background) {
+		UpdateInBackground (calcEnv, mode);
+	} else if (status.NeedToRecalculate ()) {
+		// the time budget is given to every update, so an expired deadline
+		// of a previous update doesn't cancel the next ones
+		NE::EvaluationEnv& evalEnv = calcEnv.GetEvaluationEnv ();
+		bool hasTimeBudget = (updateTimeBudget > NE::EvaluationEnv::Clock::duration::zero ());
+		if (hasTimeBudget) {
+			evalEnv.SetTimeBudget (updateTimeBudget);
+		}
+
 		calcEnv.OnEvaluationBegin ();
-		if (mode == InternalUpdateMode::Normal) {
-			nodeManager.EvaluateAllNodes (calcEnv.GetEvaluationEnv ());
+		bool isFinished = true;
+		if (status.NeedToResumeManualUpdate ()) {
+			// the nodes of a cancelled manual update are already invalidated
+			isFinished = nodeManager.ResumeForceEvaluateAllNodes (evalEnv);
+		} else if (mode == InternalUpdateMode::Normal && evaluationScope == EvaluationScope::ObservedNodes) {
+			isFinished = nodeManager.EvaluateNodes (observedNodes, evalEnv);
+		} else if (mode == InternalUpdateMode::Normal) {
+			isFinished = nodeManager.EvaluateAllNodes (evalEnv);
 		} else if (mode == InternalUpdateMode::Manual) {
-			nodeManager.ForceEvaluateAllNodes (calcEnv.GetEvaluationEnv ());
+			isFinished = nodeManager.ForceEvaluateAllNodes (evalEnv);
+			if (!isFinished) {
+				status.RequestResumeManualUpdate ();
+			}
 		}
 		calcEnv.OnEvaluationEnd ();
 
+		if (hasTimeBudget) {
+			evalEnv.ClearDeadline ();
+		}
 		calcEnv.OnValuesRecalculated ();
-		status.ResetRecalculate ();
+		if (isFinished) {
+			status.ResetRecalculate ();
+			status.ResetResumeManualUpdate ();
+		}
 	}
 	if (status.NeedToRedraw ()) {
 		calcEnv.OnRedrawRequested ();
@@ -888,6 +1064,63 @@ void NodeUIManager::UpdateInternal (NodeUICalculationEnvironment& calcEnv, Inter
 	}
 }
 
+void NodeUIManager::UpdateInBackground (NodeUICalculationEnvironment& calcEnv, InternalUpdateMode mode)
+{
+	if (backgroundEvaluator.IsStarted ()) {
+		if (backgroundEvaluator.IsFinished ()) {
+			PublishBackgroundEvaluation (calcEnv);
+		} else if (backgroundEvaluator.IsOutdated (nodeManager)) {
+			// the graph has changed since the evaluation started, so its result would be dropped anyway
+			backgroundEvaluator.Cancel ();
+		} else if (mode == InternalUpdateMode::Manual) {
+			// the running evaluation may not calculate the nodes disabled in manual update mode
+			backgroundEvaluator.Cancel ();
+			status.RequestRecalculate ();
+		} else {
+			return;
+		}
+	}
+
+	if (status.NeedToRecalculate ()) {
+		bool isStarted = false;
+		if (mode == InternalUpdateMode::Normal && evaluationScope == EvaluationScope::ObservedNodes) {
+			isStarted = backgroundEvaluator.Start (nodeManager, observedNodes, calcEnv.GetEvaluationEnv ());
+		} else {
+			isStarted = backgroundEvaluator.Start (nodeManager, calcEnv.GetEvaluationEnv (), mode == InternalUpdateMode::Manual);
+		}
+		if (isStarted) {
+			status.ResetRecalculate ();
+		}
+	}
+}
+
+void NodeUIManager::PublishBackgroundEvaluation (NodeUICalculationEnvironment& calcEnv)
+{
+	NE::NodeCollection publishedNodes;
+	calcEnv.OnEvaluationBegin ();
+	NE::BackgroundEvaluator::PublishResult result = backgroundEvaluator.Publish (nodeManager, calcEnv.GetEvaluationEnv (), publishedNodes);
+	calcEnv.OnEvaluationEnd ();
+	if (result == NE::BackgroundEvaluator::PublishResult::NotFinished) {
+		return;
+	}
+
+	// the nodes were drawn without values while the evaluation was running
+	publishedNodes.Enumerate ([&] (const NE::NodeId& nodeId) {
+		InvalidateNodeDrawing (nodeId);
+		return true;
+	});
+	if (!publishedNodes.IsEmpty ()) {
+		status.RequestRedraw ();
+	}
+
+	if (result != NE::BackgroundEvaluator::PublishResult::Outdated) {
+		calcEnv.OnValuesRecalculated ();
+	}
+	if (result != NE::BackgroundEvaluator::PublishResult::Completed) {
+		status.RequestRecalculate ();
+	}
+}
+
 void NodeUIManager::HandleSelectionChanged (Selection::ChangeResult changeResult, NodeUIInteractionEnvironment& interactionEnv)
 {
 	if (changeResult == Selection::ChangeResult::Changed) {
@@ -3,6 +3,7 @@
 
 #include "NE_NodeManager.hpp"
 #include "NE_NodeCollection.hpp"
+#include "NE_BackgroundEvaluator.hpp"
 #include "NUIE_UINode.hpp"
 #include "NUIE_UINodeGroup.hpp"
 #include "NUIE_NodeUIEnvironment.hpp"
@@ -27,8 +28,9 @@ public:
 	NodeUIManagerCommand ();
 	virtual ~NodeUIManagerCommand ();
 
-	virtual bool IsUndoable () const = 0;
-	virtual void Do (NodeUIManager& uiManager) = 0;
+	virtual bool			IsUndoable () const = 0;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const;
+	virtual void			Do (NodeUIManager& uiManager) = 0;
 };
 
 using NodeUIManagerCommandPtr = std::shared_ptr<NodeUIManagerCommand>;
@@ -96,6 +98,18 @@ public:
 		Manual
 	};
 
+	enum class EvaluationMode
+	{
+		Synchronous,
+		Background
+	};
+
+	enum class EvaluationScope
+	{
+		AllNodes,
+		ObservedNodes
+	};
+
 	NodeUIManager (NodeUIEnvironment& uiEnvironment);
 	NodeUIManager (const NodeUIManager& src) = delete;
 	NodeUIManager (NodeUIManager&& src) = delete;
@@ -177,6 +191,19 @@ public:
 	UpdateMode						GetUpdateMode () const;
 	void							SetUpdateMode (UpdateMode newUpdateMode);
 
+	EvaluationMode					GetEvaluationMode () const;
+	void							SetEvaluationMode (EvaluationMode newEvaluationMode);
+	bool							IsBackgroundEvaluationRunning () const;
+	void							WaitForBackgroundEvaluation (NodeUICalculationEnvironment& calcEnv);
+
+	EvaluationScope					GetEvaluationScope () const;
+	void							SetEvaluationScope (EvaluationScope newEvaluationScope);
+	NE::EvaluationEnv::Clock::duration	GetUpdateTimeBudget () const;
+	void							SetUpdateTimeBudget (const NE::EvaluationEnv::Clock::duration& newUpdateTimeBudget);
+	const NE::NodeCollection&		GetObservedNodes () const;
+	void							SetObservedNodes (const NE::NodeCollection& newObservedNodes);
+	NE::NodeCollection				GetVisibleNodes (NodeUIDrawingEnvironment& drawingEnv) const;
+
 	void							New (NodeUIEnvironment& uiEnvironment);
 	bool							Open (NodeUIEnvironment& uiEnvironment, NE::InputStream& inputStream);
 	bool							Save (NE::OutputStream& outputStream);
@@ -188,6 +215,10 @@ public:
 
 	bool							CanUndo () const;
 	bool							CanRedo () const;
+	size_t							GetUndoMemoryBudget () const;
+	void							SetUndoMemoryBudget (size_t newMemoryBudget);
+	size_t							GetNodeValueCacheMaxMemorySize () const;
+	void							SetNodeValueCacheMaxMemorySize (size_t newMaxMemorySize);
 	void							Undo (NE::EvaluationEnv& evalEnv, NodeUIInteractionEnvironment& interactionEnv);
 	void							Redo (NE::EvaluationEnv& evalEnv, NodeUIInteractionEnvironment& interactionEnv);
 
@@ -217,6 +248,10 @@ private:
 		void	ResetRecalculate ();
 		bool	NeedToRecalculate () const;
 
+		void	RequestResumeManualUpdate ();
+		void	ResetResumeManualUpdate ();
+		bool	NeedToResumeManualUpdate () const;
+
 		void	RequestRedraw ();
 		void	ResetRedraw ();
 		bool	NeedToRedraw () const;
@@ -227,6 +262,7 @@ private:
 
 	private:
 		bool	needToRecalculate;
+		bool	needToResumeManualUpdate;
 		bool	needToRedraw;
 		bool	needToSave;
 	};
@@ -240,17 +276,24 @@ private:
 	void				Clear (NodeUIEnvironment& uiEnvironment);
 	void				InvalidateDrawingsForInvalidatedNodes ();
 	void				UpdateInternal (NodeUICalculationEnvironment& calcEnv, InternalUpdateMode mode);
+	void				UpdateInBackground (NodeUICalculationEnvironment& calcEnv, InternalUpdateMode mode);
+	void				PublishBackgroundEvaluation (NodeUICalculationEnvironment& calcEnv);
 	void				HandleSelectionChanged (Selection::ChangeResult changeResult, NodeUIInteractionEnvironment& interactionEnv);
 	void				HandleUndoStateChanged (UndoHandler::ChangeResult changeResult, NodeUIInteractionEnvironment& interactionEnv);
 
 	NE::Stream::Status	Read (NE::InputStream& inputStream);
 	NE::Stream::Status	Write (NE::OutputStream& outputStream) const;
 
-	NE::NodeManager		nodeManager;
-	UndoHandler			undoHandler;
-	Selection			selection;
-	ViewBox				viewBox;
-	Status				status;
+	NE::NodeManager				nodeManager;
+	UndoHandler					undoHandler;
+	Selection					selection;
+	ViewBox						viewBox;
+	Status						status;
+	EvaluationMode				evaluationMode;
+	EvaluationScope				evaluationScope;
+	NE::NodeCollection			observedNodes;
+	NE::EvaluationEnv::Clock::duration	updateTimeBudget;
+	NE::BackgroundEvaluator		backgroundEvaluator;
 };
 
 }
@@ -4,6 +4,21 @@
 namespace NUIE
 {
 
+static NE::SlotInfo GetSlotInfo (const NE::InputSlotConstPtr& inputSlot)
+{
+	return NE::SlotInfo (inputSlot->GetOwnerNodeId (), inputSlot->GetId ());
+}
+
+static std::vector<NE::SlotInfo> GetSlotInfos (const NE::InputSlotList& inputSlots)
+{
+	std::vector<NE::SlotInfo> result;
+	inputSlots.Enumerate ([&] (const NE::InputSlotConstPtr& inputSlot) {
+		result.push_back (GetSlotInfo (inputSlot));
+		return true;
+	});
+	return result;
+}
+
 UndoableCommand::UndoableCommand () :
 	NodeUIManagerCommand ()
 {
@@ -70,6 +85,11 @@ MoveNodesCommand::MoveNodesCommand (const NE::NodeCollection& nodes, const Point
 {
 }
 
+UndoDeltaPtr MoveNodesCommand::CreateUndoDelta (const NE::NodeManager&) const
+{
+	return UndoDeltaPtr (new MoveNodesDelta (nodes, offset));
+}
+
 void MoveNodesCommand::Do (NodeUIManager& uiManager)
 {
 	for (size_t i = 0; i < nodes.Count (); i++) {
@@ -87,6 +107,11 @@ MoveNodesWithOffsetsCommand::MoveNodesWithOffsetsCommand (const std::unordered_m
 {
 }
 
+UndoDeltaPtr MoveNodesWithOffsetsCommand::CreateUndoDelta (const NE::NodeManager&) const
+{
+	return UndoDeltaPtr (new MoveNodesDelta (offsets));
+}
+
 void MoveNodesWithOffsetsCommand::Do (NodeUIManager& uiManager)
 {
 	for (const auto& nodeOffset : offsets) {
@@ -127,6 +152,11 @@ ConnectSlotsCommand::ConnectSlotsCommand (const UIOutputSlotConstPtr& outputSlot
 {
 }
 
+UndoDeltaPtr ConnectSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, { GetSlotInfo (inputSlot) }));
+}
+
 void ConnectSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.ConnectOutputSlotToInputSlot (outputSlot, inputSlot);
@@ -140,6 +170,11 @@ ReconnectInputSlotCommand::ReconnectInputSlotCommand (const UIOutputSlotList& ou
 {
 }
 
+UndoDeltaPtr ReconnectInputSlotCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, { GetSlotInfo (oldInputSlot), GetSlotInfo (newInputSlot) }));
+}
+
 void ReconnectInputSlotCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectOutputSlotsFromInputSlot (outputSlots, oldInputSlot);
@@ -154,6 +189,11 @@ ReconnectOutputSlotCommand::ReconnectOutputSlotCommand (const UIOutputSlotConstP
 {
 }
 
+UndoDeltaPtr ReconnectOutputSlotCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, GetSlotInfos (inputSlots)));
+}
+
 void ReconnectOutputSlotCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectOutputSlotFromInputSlots (oldOutputSlot, inputSlots);
@@ -167,6 +207,11 @@ DisconnectSlotsCommand::DisconnectSlotsCommand (const UIOutputSlotConstPtr& outp
 {
 }
 
+UndoDeltaPtr DisconnectSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, { GetSlotInfo (inputSlot) }));
+}
+
 void DisconnectSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectOutputSlotFromInputSlot (outputSlot, inputSlot);
@@ -179,6 +224,11 @@ DisconnectOutputSlotsCommand::DisconnectOutputSlotsCommand (const UIOutputSlotLi
 {
 }
 
+UndoDeltaPtr DisconnectOutputSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, { GetSlotInfo (inputSlot) }));
+}
+
 void DisconnectOutputSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectOutputSlotsFromInputSlot (outputSlots, inputSlot);
@@ -192,6 +242,11 @@ DisconnectInputSlotsCommand::DisconnectInputSlotsCommand (const UIOutputSlotCons
 
 }
 
+UndoDeltaPtr DisconnectInputSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, GetSlotInfos (inputSlots)));
+}
+
 void DisconnectInputSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectOutputSlotFromInputSlots (outputSlot, inputSlots);
@@ -203,6 +258,15 @@ DisconnectAllInputSlotsCommand::DisconnectAllInputSlotsCommand (const UIOutputSl
 {
 }
 
+UndoDeltaPtr DisconnectAllInputSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	std::vector<NE::SlotInfo> inputSlots;
+	nodeManager.EnumerateConnectedInputSlots (outputSlot, [&] (const NE::InputSlotConstPtr& inputSlot) {
+		inputSlots.push_back (GetSlotInfo (inputSlot));
+	});
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, inputSlots));
+}
+
 void DisconnectAllInputSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectAllInputSlotsFromOutputSlot (outputSlot);
@@ -215,6 +279,11 @@ DisconnectAllOutputSlotsCommand::DisconnectAllOutputSlotsCommand (const UIInputS
 
 }
 
+UndoDeltaPtr DisconnectAllOutputSlotsCommand::CreateUndoDelta (const NE::NodeManager& nodeManager) const
+{
+	return UndoDeltaPtr (new ConnectionsDelta (nodeManager, { GetSlotInfo (inputSlot) }));
+}
+
 void DisconnectAllOutputSlotsCommand::Do (NodeUIManager& uiManager)
 {
 	uiManager.DisconnectAllOutputSlotsFromInputSlot (inputSlot);
@@ -54,7 +54,8 @@ class MoveNodesCommand : public UndoableCommand
 public:
 	MoveNodesCommand (const NE::NodeCollection& nodes, const Point& offset);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const NE::NodeCollection&	nodes;
@@ -66,7 +67,8 @@ class MoveNodesWithOffsetsCommand : public UndoableCommand
 public:
 	MoveNodesWithOffsetsCommand (const std::unordered_map<NE::NodeId, Point>& offsets);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const std::unordered_map<NE::NodeId, Point>&	offsets;
@@ -90,7 +92,8 @@ class ConnectSlotsCommand : public UndoableCommand
 public:
 	ConnectSlotsCommand (const UIOutputSlotConstPtr& outputSlot, const UIInputSlotConstPtr& inputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotConstPtr&		outputSlot;
@@ -102,7 +105,8 @@ class ReconnectInputSlotCommand : public UndoableCommand
 public:
 	ReconnectInputSlotCommand (const UIOutputSlotList& outputSlots, const UIInputSlotConstPtr& oldInputSlot, const UIInputSlotConstPtr& newInputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotList&			outputSlots;
@@ -115,7 +119,8 @@ class ReconnectOutputSlotCommand : public UndoableCommand
 public:
 	ReconnectOutputSlotCommand (const UIOutputSlotConstPtr& oldOutputSlot, const UIOutputSlotConstPtr& newOutputSlot, const UIInputSlotList& inputSlots);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotConstPtr&		oldOutputSlot;
@@ -128,7 +133,8 @@ class DisconnectSlotsCommand : public UndoableCommand
 public:
 	DisconnectSlotsCommand (const UIOutputSlotConstPtr& outputSlot, const UIInputSlotConstPtr& inputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotConstPtr&		outputSlot;
@@ -140,7 +146,8 @@ class DisconnectOutputSlotsCommand : public UndoableCommand
 public:
 	DisconnectOutputSlotsCommand (const UIOutputSlotList& outputSlots, const UIInputSlotConstPtr& inputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotList&		outputSlots;
@@ -152,7 +159,8 @@ class DisconnectInputSlotsCommand : public UndoableCommand
 public:
 	DisconnectInputSlotsCommand (const UIOutputSlotConstPtr& outputSlot, const UIInputSlotList& inputSlots);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotConstPtr&		outputSlot;
@@ -164,7 +172,8 @@ class DisconnectAllInputSlotsCommand : public UndoableCommand
 public:
 	DisconnectAllInputSlotsCommand (const UIOutputSlotConstPtr& outputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIOutputSlotConstPtr& outputSlot;
@@ -175,7 +184,8 @@ class DisconnectAllOutputSlotsCommand : public UndoableCommand
 public:
 	DisconnectAllOutputSlotsCommand (const UIInputSlotConstPtr& inputSlot);
 
-	virtual void Do (NodeUIManager& uiManager) override;
+	virtual UndoDeltaPtr	CreateUndoDelta (const NE::NodeManager& nodeManager) const override;
+	virtual void			Do (NodeUIManager& uiManager) override;
 
 private:
 	const UIInputSlotConstPtr& inputSlot;
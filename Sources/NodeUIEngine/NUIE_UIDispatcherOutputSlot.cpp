@@ -1,20 +1,27 @@
 #include "NUIE_UIDispatcherOutputSlot.hpp"
+#include "NE_LazyListValues.hpp"
 
 namespace NUIE
 {
 
-DYNAMIC_SERIALIZATION_INFO (UIDispatcherOutputSlot, 1, "{F6F046E1-7809-4C26-A1A7-1E68C3CCCFED}");
+DYNAMIC_SERIALIZATION_INFO (UIDispatcherOutputSlot, 2, "{F6F046E1-7809-4C26-A1A7-1E68C3CCCFED}");
 
 UIDispatcherOutputSlot::UIDispatcherOutputSlot () :
-	UIOutputSlot (),
-	listIndex (0)
+	UIDispatcherOutputSlot (NE::SlotId (), NE::LocString (), 0)
 {
 
 }
 
 UIDispatcherOutputSlot::UIDispatcherOutputSlot (const NE::SlotId& id, const NE::LocString& name, size_t listIndex) :
+	UIDispatcherOutputSlot (id, name, listIndex, 1)
+{
+
+}
+
+UIDispatcherOutputSlot::UIDispatcherOutputSlot (const NE::SlotId& id, const NE::LocString& name, size_t listIndex, size_t itemCount) :
 	UIOutputSlot (id, name),
-	listIndex (listIndex)
+	listIndex (listIndex),
+	itemCount (itemCount)
 {
 
 }
@@ -30,14 +37,18 @@ NE::ValueConstPtr UIDispatcherOutputSlot::Evaluate (NE::EvaluationEnv& env) cons
 	if (value == nullptr) {
 		return nullptr;
 	}
-	if (DBGERROR (!NE::Value::IsType<NE::ListValue> (value))) {
+	if (DBGERROR (!NE::Value::IsType<NE::IListValue> (value))) {
 		return nullptr;
 	}
-	NE::ListValueConstPtr listValue = NE::Value::Cast<NE::ListValue> (value);
-	if (DBGERROR (listIndex > listValue->GetSize ())) {
+	const NE::IListValue* listValue = NE::Value::Cast<NE::IListValue> (value.get ());
+	if (DBGERROR (listIndex >= listValue->GetSize ())) {
 		return nullptr;
 	}
-	return listValue->GetValue (listIndex);
+	if (itemCount == 1) {
+		return listValue->GetValue (listIndex);
+	}
+	// the dispatched items refer to the evaluated list, so nothing is copied
+	return NE::CreateListSlice (value, listIndex, itemCount, 1);
 }
 
 NE::Stream::Status UIDispatcherOutputSlot::Read (NE::InputStream& inputStream)
@@ -45,6 +56,9 @@ NE::Stream::Status UIDispatcherOutputSlot::Read (NE::InputStream& inputStream)
 	NE::ObjectHeader header (inputStream);
 	UIOutputSlot::Read (inputStream);
 	inputStream.Read (listIndex);
+	if (header.GetVersion () > 1) {
+		inputStream.Read (itemCount);
+	}
 	return inputStream.GetStatus ();
 }
 
@@ -53,6 +67,7 @@ NE::Stream::Status UIDispatcherOutputSlot::Write (NE::OutputStream& outputStream
 	NE::ObjectHeader header (outputStream, serializationInfo);
 	UIOutputSlot::Write (outputStream);
 	outputStream.Write (listIndex);
+	outputStream.Write (itemCount);
 	return outputStream.GetStatus ();
 }
 
@@ -13,6 +13,7 @@ class UIDispatcherOutputSlot : public UIOutputSlot
 public:
 	UIDispatcherOutputSlot ();
 	UIDispatcherOutputSlot (const NE::SlotId& id, const NE::LocString& name, size_t listIndex);
+	UIDispatcherOutputSlot (const NE::SlotId& id, const NE::LocString& name, size_t listIndex, size_t itemCount);
 	~UIDispatcherOutputSlot ();
 
 	virtual NE::ValueConstPtr	Evaluate (NE::EvaluationEnv& env) const override;
@@ -22,6 +23,7 @@ public:
 
 private:
 	size_t listIndex;
+	size_t itemCount;
 };
 
 }
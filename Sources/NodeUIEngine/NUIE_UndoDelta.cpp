@@ -0,0 +1,173 @@
+#include "NUIE_UndoDelta.hpp"
+#include "NUIE_UINode.hpp"
+#include "NE_InputSlot.hpp"
+#include "NE_OutputSlot.hpp"
+#include "NE_Debug.hpp"
+
+#include <algorithm>
+
+namespace NUIE
+{
+
+UndoDelta::UndoDelta ()
+{
+
+}
+
+UndoDelta::~UndoDelta ()
+{
+
+}
+
+void UndoDelta::Finalize (const NE::NodeManager&)
+{
+
+}
+
+MoveNodesDelta::MoveNodesDelta (const NE::NodeCollection& nodes, const Point& offset) :
+	UndoDelta (),
+	offsets ()
+{
+	offsets.reserve (nodes.Count ());
+	nodes.Enumerate ([&] (const NE::NodeId& nodeId) {
+		offsets.push_back ({ nodeId, offset });
+		return true;
+	});
+}
+
+MoveNodesDelta::MoveNodesDelta (const std::unordered_map<NE::NodeId, Point>& offsets) :
+	UndoDelta (),
+	offsets (offsets.begin (), offsets.end ())
+{
+
+}
+
+MoveNodesDelta::~MoveNodesDelta ()
+{
+
+}
+
+bool MoveNodesDelta::Undo (NE::NodeManager& nodeManager) const
+{
+	return MoveNodes (nodeManager, true);
+}
+
+bool MoveNodesDelta::Redo (NE::NodeManager& nodeManager) const
+{
+	return MoveNodes (nodeManager, false);
+}
+
+size_t MoveNodesDelta::GetMemorySize () const
+{
+	return sizeof (MoveNodesDelta) + offsets.size () * sizeof (std::pair<NE::NodeId, Point>);
+}
+
+bool MoveNodesDelta::MoveNodes (NE::NodeManager& nodeManager, bool isReversed) const
+{
+	for (const auto& nodeOffset : offsets) {
+		UINodePtr uiNode = NE::Node::Cast<UINode> (nodeManager.GetNode (nodeOffset.first));
+		if (DBGERROR (uiNode == nullptr)) {
+			return false;
+		}
+		const Point& offset = nodeOffset.second;
+		uiNode->SetPosition (uiNode->GetPosition () + (isReversed ? -offset : offset));
+	}
+	return true;
+}
+
+ConnectionsDelta::ConnectionsDelta (const NE::NodeManager& nodeManager, const std::vector<NE::SlotInfo>& changedInputSlots) :
+	UndoDelta (),
+	inputSlots (),
+	oldConnections (),
+	newConnections ()
+{
+	for (const NE::SlotInfo& inputSlot : changedInputSlots) {
+		if (std::find (inputSlots.begin (), inputSlots.end (), inputSlot) != inputSlots.end ()) {
+			continue;
+		}
+		inputSlots.push_back (inputSlot);
+		oldConnections.push_back (GetConnectedOutputSlots (nodeManager, inputSlot));
+	}
+}
+
+ConnectionsDelta::~ConnectionsDelta ()
+{
+
+}
+
+void ConnectionsDelta::Finalize (const NE::NodeManager& nodeManager)
+{
+	newConnections.clear ();
+	for (const NE::SlotInfo& inputSlot : inputSlots) {
+		newConnections.push_back (GetConnectedOutputSlots (nodeManager, inputSlot));
+	}
+}
+
+bool ConnectionsDelta::Undo (NE::NodeManager& nodeManager) const
+{
+	return SetConnectedOutputSlots (nodeManager, oldConnections);
+}
+
+bool ConnectionsDelta::Redo (NE::NodeManager& nodeManager) const
+{
+	return SetConnectedOutputSlots (nodeManager, newConnections);
+}
+
+size_t ConnectionsDelta::GetMemorySize () const
+{
+	size_t memorySize = sizeof (ConnectionsDelta) + inputSlots.size () * sizeof (NE::SlotInfo);
+	for (const ConnectedOutputSlots& outputSlots : oldConnections) {
+		memorySize += sizeof (ConnectedOutputSlots) + outputSlots.size () * sizeof (NE::SlotInfo);
+	}
+	for (const ConnectedOutputSlots& outputSlots : newConnections) {
+		memorySize += sizeof (ConnectedOutputSlots) + outputSlots.size () * sizeof (NE::SlotInfo);
+	}
+	return memorySize;
+}
+
+ConnectionsDelta::ConnectedOutputSlots ConnectionsDelta::GetConnectedOutputSlots (const NE::NodeManager& nodeManager, const NE::SlotInfo& inputSlot) const
+{
+	ConnectedOutputSlots result;
+	NE::NodeConstPtr node = nodeManager.GetNode (inputSlot.GetNodeId ());
+	if (DBGERROR (node == nullptr)) {
+		return result;
+	}
+	nodeManager.EnumerateConnectedOutputSlots (node->GetInputSlot (inputSlot.GetSlotId ()), [&] (const NE::OutputSlotConstPtr& outputSlot) {
+		result.push_back (NE::SlotInfo (outputSlot->GetOwnerNodeId (), outputSlot->GetId ()));
+	});
+	return result;
+}
+
+bool ConnectionsDelta::SetConnectedOutputSlots (NE::NodeManager& nodeManager, const std::vector<ConnectedOutputSlots>& connections) const
+{
+	if (DBGERROR (connections.size () != inputSlots.size ())) {
+		return false;
+	}
+
+	// the input slots are disconnected first, so the connections can be moved between them
+	for (const NE::SlotInfo& inputSlotInfo : inputSlots) {
+		NE::NodeConstPtr node = nodeManager.GetNode (inputSlotInfo.GetNodeId ());
+		if (DBGERROR (node == nullptr)) {
+			return false;
+		}
+		nodeManager.DisconnectAllOutputSlotsFromInputSlot (node->GetInputSlot (inputSlotInfo.GetSlotId ()));
+	}
+
+	for (size_t inputSlotIndex = 0; inputSlotIndex < inputSlots.size (); inputSlotIndex++) {
+		const NE::SlotInfo& inputSlotInfo = inputSlots[inputSlotIndex];
+		NE::InputSlotConstPtr inputSlot = nodeManager.GetNode (inputSlotInfo.GetNodeId ())->GetInputSlot (inputSlotInfo.GetSlotId ());
+		for (const NE::SlotInfo& outputSlotInfo : connections[inputSlotIndex]) {
+			NE::NodeConstPtr outputNode = nodeManager.GetNode (outputSlotInfo.GetNodeId ());
+			if (DBGERROR (outputNode == nullptr)) {
+				return false;
+			}
+			if (DBGERROR (!nodeManager.ConnectOutputSlotToInputSlot (outputNode->GetOutputSlot (outputSlotInfo.GetSlotId ()), inputSlot))) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef NUIE_UNDODELTA_HPP
+#define NUIE_UNDODELTA_HPP
+
+#include "NE_NodeManager.hpp"
+#include "NE_NodeCollection.hpp"
+#include "NE_ConnectionInfo.hpp"
+#include "NUIE_Geometry.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace NUIE
+{
+
+// a reversible change of the node manager that is recorded by an undoable command,
+// it is created before the command is executed, and finalized after it
+class UndoDelta
+{
+public:
+	UndoDelta ();
+	virtual ~UndoDelta ();
+
+	virtual void	Finalize (const NE::NodeManager& nodeManager);
+
+	virtual bool	Undo (NE::NodeManager& nodeManager) const = 0;
+	virtual bool	Redo (NE::NodeManager& nodeManager) const = 0;
+	virtual size_t	GetMemorySize () const = 0;
+};
+
+using UndoDeltaPtr = std::shared_ptr<UndoDelta>;
+using UndoDeltaConstPtr = std::shared_ptr<const UndoDelta>;
+
+class MoveNodesDelta : public UndoDelta
+{
+public:
+	MoveNodesDelta (const NE::NodeCollection& nodes, const Point& offset);
+	MoveNodesDelta (const std::unordered_map<NE::NodeId, Point>& offsets);
+	virtual ~MoveNodesDelta ();
+
+	virtual bool	Undo (NE::NodeManager& nodeManager) const override;
+	virtual bool	Redo (NE::NodeManager& nodeManager) const override;
+	virtual size_t	GetMemorySize () const override;
+
+private:
+	bool			MoveNodes (NE::NodeManager& nodeManager, bool isReversed) const;
+
+	std::vector<std::pair<NE::NodeId, Point>>	offsets;
+};
+
+class ConnectionsDelta : public UndoDelta
+{
+public:
+	ConnectionsDelta (const NE::NodeManager& nodeManager, const std::vector<NE::SlotInfo>& changedInputSlots);
+	virtual ~ConnectionsDelta ();
+
+	virtual void	Finalize (const NE::NodeManager& nodeManager) override;
+
+	virtual bool	Undo (NE::NodeManager& nodeManager) const override;
+	virtual bool	Redo (NE::NodeManager& nodeManager) const override;
+	virtual size_t	GetMemorySize () const override;
+
+private:
+	using ConnectedOutputSlots = std::vector<NE::SlotInfo>;
+
+	ConnectedOutputSlots	GetConnectedOutputSlots (const NE::NodeManager& nodeManager, const NE::SlotInfo& inputSlot) const;
+	bool					SetConnectedOutputSlots (NE::NodeManager& nodeManager, const std::vector<ConnectedOutputSlots>& connections) const;
+
+	std::vector<NE::SlotInfo>			inputSlots;
+	std::vector<ConnectedOutputSlots>	oldConnections;
+	std::vector<ConnectedOutputSlots>	newConnections;
+};
+
+}
+
+#endif
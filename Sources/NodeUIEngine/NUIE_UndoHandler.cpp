@@ -1,17 +1,39 @@
 #include "NUIE_UndoHandler.hpp"
 #include "NE_Debug.hpp"
 
+#include <limits>
+#include <algorithm>
+
 namespace NUIE
 {
 
-static void AddStateToStack (const NE::NodeManager& nodeManager, std::vector<std::shared_ptr<NE::NodeManager>>& stack)
+UndoHandler::UndoStep::UndoStep (const NE::NodeManagerSnapshot& snapshot) :
+	snapshot (snapshot),
+	delta (nullptr)
+{
+
+}
+
+UndoHandler::UndoStep::UndoStep (const UndoDeltaPtr& delta) :
+	snapshot (),
+	delta (delta)
+{
+
+}
+
+size_t UndoHandler::UndoStep::GetMemorySize (std::unordered_set<const void*>& countedParts) const
 {
-	std::shared_ptr<NE::NodeManager> undoState (new NE::NodeManager ());
-	NE::NodeManager::Clone (nodeManager, *undoState.get ());
-	stack.push_back (undoState);
+	if (delta != nullptr) {
+		return delta->GetMemorySize ();
+	}
+	return snapshot.GetMemorySize (countedParts);
 }
 
-UndoHandler::UndoHandler ()
+UndoHandler::UndoHandler () :
+	undoStack (),
+	redoStack (),
+	lastSnapshot (),
+	memoryBudget (std::numeric_limits<size_t>::max ())
 {
 
 }
@@ -29,27 +51,30 @@ bool UndoHandler::CanRedo () const
 UndoHandler::ChangeResult UndoHandler::AddUndoStep (const NE::NodeManager& nodeManager)
 {
 	redoStack.clear ();
-	AddStateToStack (nodeManager, undoStack);
+	AddSnapshotToStack (nodeManager, undoStack);
+	ApplyMemoryBudget ();
 	return UndoHandler::ChangeResult::Changed;
 }
 
-UndoHandler::ChangeResult UndoHandler::Undo (NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler)
+UndoHandler::ChangeResult UndoHandler::AddUndoDelta (const UndoDeltaPtr& undoDelta)
 {
-	if (!CanUndo ()) {
+	if (DBGERROR (undoDelta == nullptr)) {
 		return ChangeResult::NotChanged;
 	}
+	redoStack.clear ();
+	undoStack.push_back (UndoStep (undoDelta));
+	ApplyMemoryBudget ();
+	return UndoHandler::ChangeResult::Changed;
+}
 
-	AddStateToStack (targetNodeManager, redoStack);
-
-	std::shared_ptr<NE::NodeManager> undoState = undoStack.back ();
-	undoStack.pop_back ();
-
-	bool success = NE::NodeManagerMerge::UpdateNodeManager (*undoState.get (), targetNodeManager, eventHandler);
-	if (DBGERROR (!success)) {
+UndoHandler::ChangeResult UndoHandler::Undo (NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler)
+{
+	if (!CanUndo ()) {
 		return ChangeResult::NotChanged;
 	}
-
-	return ChangeResult::Changed;
+	ChangeResult result = RestoreStep (undoStack, redoStack, true, targetNodeManager, eventHandler);
+	ApplyMemoryBudget ();
+	return result;
 }
 
 UndoHandler::ChangeResult UndoHandler::Redo (NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler)
@@ -57,29 +82,128 @@ UndoHandler::ChangeResult UndoHandler::Redo (NE::NodeManager& targetNodeManager,
 	if (!CanRedo ()) {
 		return ChangeResult::NotChanged;
 	}
+	ChangeResult result = RestoreStep (redoStack, undoStack, false, targetNodeManager, eventHandler);
+	ApplyMemoryBudget ();
+	return result;
+}
 
-	AddStateToStack (targetNodeManager, undoStack);
+UndoHandler::ChangeResult UndoHandler::Clear ()
+{
+	ChangeResult result = ChangeResult::NotChanged;
+	if (!undoStack.empty () || !redoStack.empty ()) {
+		undoStack.clear ();
+		redoStack.clear ();
+		result = ChangeResult::Changed;
+	}
+	lastSnapshot.Clear ();
+	return result;
+}
 
-	std::shared_ptr<NE::NodeManager> redoState = redoStack.back ();
-	redoStack.pop_back ();
+size_t UndoHandler::GetUndoStepCount () const
+{
+	return undoStack.size ();
+}
+
+size_t UndoHandler::GetRedoStepCount () const
+{
+	return redoStack.size ();
+}
+
+size_t UndoHandler::GetMemorySize () const
+{
+	std::unordered_set<const void*> countedParts;
+	size_t memorySize = 0;
+	for (const UndoStep& undoStep : undoStack) {
+		memorySize += undoStep.GetMemorySize (countedParts);
+	}
+	for (const UndoStep& redoStep : redoStack) {
+		memorySize += redoStep.GetMemorySize (countedParts);
+	}
+	return memorySize;
+}
 
-	bool success = NE::NodeManagerMerge::UpdateNodeManager (*redoState.get (), targetNodeManager, eventHandler);
+size_t UndoHandler::GetMemoryBudget () const
+{
+	return memoryBudget;
+}
+
+void UndoHandler::SetMemoryBudget (size_t newMemoryBudget)
+{
+	memoryBudget = newMemoryBudget;
+	ApplyMemoryBudget ();
+}
+
+UndoHandler::ChangeResult UndoHandler::RestoreStep (std::vector<UndoStep>& sourceStack, std::vector<UndoStep>& targetStack, bool isUndo, NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler)
+{
+	UndoStep step = sourceStack.back ();
+	sourceStack.pop_back ();
+
+	// a delta can be applied in both directions, so the same delta goes to the other stack
+	if (step.delta != nullptr) {
+		bool success = isUndo ? step.delta->Undo (targetNodeManager) : step.delta->Redo (targetNodeManager);
+		if (DBGERROR (!success)) {
+			return ChangeResult::NotChanged;
+		}
+		targetStack.push_back (step);
+		return ChangeResult::Changed;
+	}
+
+	if (DBGERROR (!AddSnapshotToStack (targetNodeManager, targetStack))) {
+		return ChangeResult::NotChanged;
+	}
+
+	bool success = step.snapshot.Restore (targetStack.back ().snapshot, targetNodeManager, eventHandler);
 	if (DBGERROR (!success)) {
 		return ChangeResult::NotChanged;
 	}
 
+	lastSnapshot = step.snapshot;
 	return ChangeResult::Changed;
 }
 
-UndoHandler::ChangeResult UndoHandler::Clear ()
+bool UndoHandler::AddSnapshotToStack (const NE::NodeManager& nodeManager, std::vector<UndoStep>& stack)
 {
-	ChangeResult result = ChangeResult::NotChanged;
-	if (!undoStack.empty () || !redoStack.empty ()) {
-		undoStack.clear ();
-		redoStack.clear ();
-		result = ChangeResult::Changed;
+	// the new snapshot shares the unchanged nodes with the last one
+	NE::NodeManagerSnapshot snapshot;
+	if (DBGERROR (!snapshot.Capture (nodeManager, lastSnapshot))) {
+		return false;
 	}
-	return result;
+	stack.push_back (UndoStep (snapshot));
+	lastSnapshot = snapshot;
+	return true;
+}
+
+void UndoHandler::ApplyMemoryBudget ()
+{
+	// the steps are counted from the nearest ones, so the memory shared by more steps
+	// belongs to the nearest one, and dropping the farther steps doesn't change it,
+	// the nearest undo and redo steps are always kept, so they can be applied
+	std::unordered_set<const void*> countedParts;
+	size_t memorySize = 0;
+	size_t keptUndoStepCount = std::min (undoStack.size (), (size_t) 1);
+	size_t keptRedoStepCount = std::min (redoStack.size (), (size_t) 1);
+	if (keptUndoStepCount > 0) {
+		memorySize += undoStack.back ().GetMemorySize (countedParts);
+	}
+	if (keptRedoStepCount > 0) {
+		memorySize += redoStack.back ().GetMemorySize (countedParts);
+	}
+
+	auto countKeptSteps = [&] (const std::vector<UndoStep>& stack, size_t& keptStepCount) {
+		while (keptStepCount < stack.size ()) {
+			const UndoStep& step = stack[stack.size () - keptStepCount - 1];
+			memorySize += step.GetMemorySize (countedParts);
+			if (memorySize > memoryBudget) {
+				break;
+			}
+			keptStepCount++;
+		}
+	};
+	countKeptSteps (undoStack, keptUndoStepCount);
+	countKeptSteps (redoStack, keptRedoStepCount);
+
+	undoStack.erase (undoStack.begin (), undoStack.end () - keptUndoStepCount);
+	redoStack.erase (redoStack.begin (), redoStack.end () - keptRedoStepCount);
 }
 
 }
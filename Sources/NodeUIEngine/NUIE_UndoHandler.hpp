@@ -3,12 +3,21 @@
 
 #include "NE_NodeManager.hpp"
 #include "NE_NodeManagerMerge.hpp"
+#include "NE_NodeManagerSnapshot.hpp"
+#include "NUIE_UndoDelta.hpp"
 
 #include <vector>
+#include <unordered_set>
 
 namespace NUIE
 {
 
+// every undo step is either a delta recorded by the command, or a snapshot of the
+// whole node manager for the commands that can't record their changes, the farthest
+// undo and redo steps are dropped when the steps use more memory than the budget,
+// only the move and connection commands record deltas, the delete, paste, parameter
+// and all the other commands record snapshots, there are no periodic checkpoints,
+// because every step is applied to the current state, so no step needs an older one
 class UndoHandler
 {
 public:
@@ -24,15 +33,40 @@ public:
 	bool			CanRedo () const;
 
 	ChangeResult	AddUndoStep (const NE::NodeManager& nodeManager);
+	ChangeResult	AddUndoDelta (const UndoDeltaPtr& undoDelta);
 
 	ChangeResult	Undo (NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler);
 	ChangeResult	Redo (NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler);
 
 	ChangeResult	Clear ();
 
+	size_t			GetUndoStepCount () const;
+	size_t			GetRedoStepCount () const;
+	size_t			GetMemorySize () const;
+	size_t			GetMemoryBudget () const;
+	void			SetMemoryBudget (size_t newMemoryBudget);
+
 private:
-	std::vector<std::shared_ptr<NE::NodeManager>>	undoStack;
-	std::vector<std::shared_ptr<NE::NodeManager>>	redoStack;
+	class UndoStep
+	{
+	public:
+		UndoStep (const NE::NodeManagerSnapshot& snapshot);
+		UndoStep (const UndoDeltaPtr& delta);
+
+		size_t		GetMemorySize (std::unordered_set<const void*>& countedParts) const;
+
+		NE::NodeManagerSnapshot		snapshot;
+		UndoDeltaPtr				delta;
+	};
+
+	ChangeResult	RestoreStep (std::vector<UndoStep>& sourceStack, std::vector<UndoStep>& targetStack, bool isUndo, NE::NodeManager& targetNodeManager, NE::UpdateEventHandler& eventHandler);
+	bool			AddSnapshotToStack (const NE::NodeManager& nodeManager, std::vector<UndoStep>& stack);
+	void			ApplyMemoryBudget ();
+
+	std::vector<UndoStep>		undoStack;
+	std::vector<UndoStep>		redoStack;
+	NE::NodeManagerSnapshot		lastSnapshot;
+	size_t						memoryBudget;
 };
 
 }